@@ -0,0 +1,253 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * BladeEngine.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef BLADEENGINE_H_
+#define BLADEENGINE_H_
+
+#include "Arduino.h"
+#include "AMotionReactive.h"
+#include "IBladeDriver.h"
+
+//Most pixels a blade can have
+#if not defined NSABER_MAX_BLADE_PIXELS
+#define NSABER_MAX_BLADE_PIXELS (144)
+#endif
+
+//Time between frames in milliseconds
+#if not defined NSABER_BLADE_FRAME_MS
+#define NSABER_BLADE_FRAME_MS (10)
+#endif
+
+//What the blade is doing
+enum EBladeState
+{
+	eeBladeOff,
+	eeBladeIgniting,
+	eeBladeOn,
+	eeBladeRetracting
+};
+
+/**
+ * Counters kept by the blade engine.
+ */
+struct tBladeStats
+{
+	//Frames sent to the driver
+	uint32_t mFrames = 0;
+	//Longest and total time spent rendering frames, in microseconds
+	uint32_t mMaxRenderUs = 0;
+	uint32_t mTotalRenderUs = 0;
+	//Frames that were due while the driver was still busy
+	uint32_t mBusySkips = 0;
+};
+
+/**
+ * Renders blade effects into a frame buffer and hands the frames to an
+ * IBladeDriver: ignition and retraction wipes, flicker, a brighter blade
+ * while swinging, clash and blaster flashes, and lockup sparks.
+ *
+ * Motion events arrive through AMotionReactive. Rendering is fixed point
+ * (8-bit brightness and colors) into a preallocated buffer, and a frame
+ * is only rendered when one is due and the driver is ready for it, so
+ * Update() never waits on the output.
+ */
+class BladeEngine : public AMotionReactive
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apDriver - Output for the rendered frames
+	 */
+	BladeEngine(IBladeDriver* apDriver);
+
+	/**
+	 * Sets the blade color.
+	 */
+	void SetColor(tBladePixel aColor);
+
+	/**
+	 * Sets the color of clash, blaster and lockup flashes.
+	 */
+	void SetFlashColor(tBladePixel aColor);
+
+	/**
+	 * Sets how deep the flicker goes.
+	 * Args:
+	 *  aDepth - Brightness the flicker may take away, 0 (steady) to 255
+	 */
+	void SetFlickerDepth(uint8_t aDepth);
+
+	/**
+	 * Makes the flicker follow an audio level instead of running at random,
+	 * so the blade pulses with the hum. The blade is at full brightness on
+	 * the loudest recent level and dims by up to the flicker depth.
+	 * Args:
+	 *  apLevel - Level to follow, such as MixBus::GetLevelTap(). NULL
+	 *            goes back to random flicker.
+	 */
+	void SetLevelSource(const volatile uint16_t* apLevel);
+
+	/**
+	 * Starts the ignition wipe from the base to the tip.
+	 * Args:
+	 *  aTimeMs - Length of the wipe
+	 */
+	void Ignite(uint16_t aTimeMs);
+
+	/**
+	 * Starts the retraction wipe from the tip to the base.
+	 * Args:
+	 *  aTimeMs - Length of the wipe
+	 */
+	void Retract(uint16_t aTimeMs);
+
+	/**
+	 * Turns lockup sparks on or off.
+	 */
+	void SetLockup(bool aLockup);
+
+	/**
+	 * Flashes a spot on the blade, as for a deflected blaster bolt.
+	 */
+	void Blast();
+
+	/**
+	 * Returns what the blade is doing.
+	 */
+	EBladeState GetState();
+
+	/**
+	 * Brightens the blade with the swing speed.
+	 * Args:
+	 *  aSpeed - Rotation speed in degrees per second.
+	 */
+	virtual void NotifySwing(float aSpeed);
+
+	/**
+	 * Flashes the whole blade.
+	 * Args:
+	 *  aMagnitude - Magnitude in G
+	 */
+	virtual void NotifyClash(float aMagnitude);
+
+	/**
+	 * Brightens the blade a little.
+	 * Args:
+	 *  aSpeed - Rotation speed in degrees per second.
+	 */
+	virtual void NotifyTwist(float aSpeed);
+
+	/**
+	 * Call this in a loop. Renders and sends a frame if one is due and the
+	 * driver is ready.
+	 * Returns:
+	 *  TRUE if a frame was sent, FALSE otherwise
+	 */
+	bool Update();
+
+	/**
+	 * Gets the engine's counters.
+	 * Args:
+	 *  arStats - Output parameter, populated with the counters
+	 */
+	void GetStats(tBladeStats& arStats);
+
+	/**
+	 * Clears the engine's counters.
+	 */
+	void ResetStats();
+
+protected:
+
+	/**
+	 * Renders the frame for a point in time into maFrame.
+	 * Args:
+	 *  aNowMs - millis() of the frame
+	 * Returns:
+	 *  TRUE if any pixel is lit, FALSE if the frame is black
+	 */
+	bool Render(uint32_t aNowMs);
+
+	/**
+	 * Works out how much of the blade is lit.
+	 * Returns:
+	 *  Lit length in 1/256ths of a pixel
+	 */
+	uint32_t GetLitLength(uint32_t aNowMs, uint16_t aNumPixels);
+
+	/**
+	 * Returns the next value of a cheap 8-bit pseudo random sequence.
+	 */
+	uint8_t NextRandom();
+
+	//Output for the rendered frames
+	IBladeDriver* mpDriver;
+
+	//Frame being rendered
+	tBladePixel maFrame[NSABER_MAX_BLADE_PIXELS];
+
+	//Colors
+	tBladePixel mColor;
+	tBladePixel mFlashColor;
+
+	//Current state and when it began
+	EBladeState mState;
+	uint32_t mStateStartMs;
+	uint16_t mWipeMs;
+
+	//millis() of the next frame
+	uint32_t mNextFrameMs;
+
+	//TRUE if the last frame sent had anything lit
+	bool mLastLit;
+
+	//Flicker depth and smoothed flicker level (0-255)
+	uint8_t mFlickerDepth;
+	int16_t mFlicker;
+
+	//Audio level the flicker follows, if any, and its recent peak
+	const volatile uint16_t* mpLevel;
+	uint16_t mLevelPeak;
+
+	//Extra brightness from swings and twists (0-255), decays every frame
+	uint8_t mBoost;
+
+	//Whole blade flash strength (0-255), decays every frame
+	uint8_t mFlash;
+
+	//Spot flash strength (0-255), position in pixels and half width
+	uint8_t mSpot;
+	uint16_t mSpotPos;
+	uint8_t mSpotWidth;
+
+	//TRUE while lockup sparks are on
+	bool mLockup;
+
+	//Pseudo random state
+	uint16_t mRandom;
+
+	//Counters
+	tBladeStats mStats;
+};
+
+#endif /* BLADEENGINE_H_ */
@@ -0,0 +1,74 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * IBladeDriver.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef IBLADEDRIVER_H_
+#define IBLADEDRIVER_H_
+
+#include <Arduino.h> //For uint8_t
+
+/**
+ * One blade pixel, 8 bits per color.
+ */
+struct tBladePixel
+{
+	uint8_t mRed;
+	uint8_t mGreen;
+	uint8_t mBlue;
+};
+
+/**
+ * Interface for whatever lights the blade: a strip of addressable pixels,
+ * a PWM driven LED, or a capture sink on a PC.
+ *
+ * Show() must not block. Drivers that stream a frame in the background
+ * (such as with DMA) encode the pixels into their own buffer during
+ * Show(), and report IsReady() once the transfer has finished.
+ */
+class IBladeDriver
+{
+public:
+
+	virtual ~IBladeDriver()
+	{
+		//Do nothing
+	}
+
+	/**
+	 * Returns the number of pixels the driver lights.
+	 */
+	virtual uint16_t GetNumPixels() = 0;
+
+	/**
+	 * Returns TRUE if the driver can take another frame.
+	 */
+	virtual bool IsReady() = 0;
+
+	/**
+	 * Starts sending a frame. Only called when IsReady() is TRUE. The
+	 * pixels may only be read before this returns.
+	 * Args:
+	 *  apPixels - Frame to send, base to tip
+	 *  aNumPixels - Number of pixels in apPixels
+	 */
+	virtual void Show(const tBladePixel* apPixels, uint16_t aNumPixels) = 0;
+};
+
+#endif /* IBLADEDRIVER_H_ */
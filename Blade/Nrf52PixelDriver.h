@@ -0,0 +1,93 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * Nrf52PixelDriver.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef NRF52PIXELDRIVER_H_
+#define NRF52PIXELDRIVER_H_
+
+#if defined(NRF52) || defined(NRF52_SERIES)
+
+#include <nrf.h>
+#include "IBladeDriver.h"
+#include "BladeEngine.h" //For NSABER_MAX_BLADE_PIXELS
+
+//PWM words per pixel, one per bit
+#define NRF52_PIXEL_WORDS_PER_PIXEL (24)
+
+//Low words after a frame, 40 x 1.25us covers the 50us latch time
+#define NRF52_PIXEL_RESET_WORDS (40)
+
+/**
+ * Drives a WS2812 (NeoPixel) strip from a PWM peripheral. Each bit of a
+ * frame becomes one 16-bit PWM compare value, and EasyDMA streams the
+ * values out while the CPU carries on, so Show() returns as soon as the
+ * frame is encoded. A 144 pixel frame takes about 4.4ms to send.
+ *
+ * The PWM peripheral is used only by this driver; pick one that
+ * analogWrite() and the sound library are not using.
+ */
+class Nrf52PixelDriver : public IBladeDriver
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  aPin - Data pin of the strip
+	 *  aNumPixels - Number of pixels on the strip
+	 *  apPwm - PWM peripheral to use
+	 */
+	Nrf52PixelDriver(uint8_t aPin, uint16_t aNumPixels, NRF_PWM_Type* apPwm = NRF_PWM2);
+
+	/**
+	 * Sets the PWM peripheral up. Call once before Show().
+	 */
+	void Init();
+
+	virtual uint16_t GetNumPixels();
+
+	virtual bool IsReady();
+
+	virtual void Show(const tBladePixel* apPixels, uint16_t aNumPixels);
+
+protected:
+
+	/**
+	 * Encodes one color byte, most significant bit first.
+	 * Args:
+	 *  apWords - Where to write the 8 PWM words
+	 *  aValue - Color byte
+	 */
+	void EncodeByte(uint16_t* apWords, uint8_t aValue);
+
+	NRF_PWM_Type* mpPwm;
+	uint8_t mPin;
+	uint16_t mNumPixels;
+
+	//TRUE from Show() until the PWM reports the sequence is done
+	bool mBusy;
+
+	//PWM compare values streamed by EasyDMA, must stay in RAM
+	uint16_t maWords[NSABER_MAX_BLADE_PIXELS * NRF52_PIXEL_WORDS_PER_PIXEL + NRF52_PIXEL_RESET_WORDS];
+};
+
+#endif
+
+#endif /* NRF52PIXELDRIVER_H_ */
@@ -0,0 +1,62 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * PwmBladeDriver.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef PWMBLADEDRIVER_H_
+#define PWMBLADEDRIVER_H_
+
+#include "IBladeDriver.h"
+
+/**
+ * Drives a single RGB LED (or three LED dies) from three PWM pins. The
+ * blade is one pixel, so wipes show as a fade in and out.
+ */
+class PwmBladeDriver : public IBladeDriver
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  aRedPin - PWM pin of the red channel
+	 *  aGreenPin - PWM pin of the green channel
+	 *  aBluePin - PWM pin of the blue channel
+	 */
+	PwmBladeDriver(uint8_t aRedPin, uint8_t aGreenPin, uint8_t aBluePin);
+
+	/**
+	 * Sets the pins up and turns the LED off.
+	 */
+	void Init();
+
+	virtual uint16_t GetNumPixels();
+
+	virtual bool IsReady();
+
+	virtual void Show(const tBladePixel* apPixels, uint16_t aNumPixels);
+
+protected:
+
+	uint8_t mRedPin;
+	uint8_t mGreenPin;
+	uint8_t mBluePin;
+};
+
+#endif /* PWMBLADEDRIVER_H_ */
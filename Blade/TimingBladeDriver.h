@@ -0,0 +1,97 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * TimingBladeDriver.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef TIMINGBLADEDRIVER_H_
+#define TIMINGBLADEDRIVER_H_
+
+#include "IBladeDriver.h"
+#include "BladeEngine.h" //For NSABER_MAX_BLADE_PIXELS
+
+/**
+ * Counters kept by the timing driver.
+ */
+struct tBladeTiming
+{
+	//Frames received
+	uint32_t mFrames = 0;
+	//Shortest and longest time between frames, in microseconds
+	uint32_t mMinIntervalUs = 0xFFFFFFFF;
+	uint32_t mMaxIntervalUs = 0;
+	//Sum of the times between frames, for the average
+	uint32_t mTotalIntervalUs = 0;
+};
+
+/**
+ * A blade driver that lights nothing. It keeps the last frame so it can be
+ * inspected, measures the time between frames, and can pretend to take
+ * a while to send each one like a real strip would. Useful on a PC or on
+ * a board without a blade attached.
+ */
+class TimingBladeDriver : public IBladeDriver
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  aNumPixels - Number of pixels to pretend to have
+	 *  aUsPerPixel - Pretend send time of one pixel (30 for WS2812)
+	 */
+	TimingBladeDriver(uint16_t aNumPixels, uint16_t aUsPerPixel = 0);
+
+	virtual uint16_t GetNumPixels();
+
+	virtual bool IsReady();
+
+	virtual void Show(const tBladePixel* apPixels, uint16_t aNumPixels);
+
+	/**
+	 * Returns the last frame received.
+	 */
+	const tBladePixel* GetFrame();
+
+	/**
+	 * Gets the frame timing counters.
+	 * Args:
+	 *  arTiming - Output parameter, populated with the counters
+	 */
+	void GetTiming(tBladeTiming& arTiming);
+
+	/**
+	 * Clears the frame timing counters.
+	 */
+	void ResetTiming();
+
+protected:
+
+	uint16_t mNumPixels;
+	uint16_t mUsPerPixel;
+
+	//micros() of the last frame and when its pretend send is done
+	uint32_t mLastShowUs;
+	uint32_t mBusyUntilUs;
+
+	tBladeTiming mTiming;
+
+	tBladePixel maFrame[NSABER_MAX_BLADE_PIXELS];
+};
+
+#endif /* TIMINGBLADEDRIVER_H_ */
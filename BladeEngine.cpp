@@ -0,0 +1,369 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * BladeEngine.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Blade/BladeEngine.h"
+
+//Full scale of 8-bit brightness and mixing values
+#define BLADE_Q8_ONE (256)
+
+//Swing speed that gives the full brightness boost, degrees per second
+#define BLADE_FULL_BOOST_SPEED (720)
+
+//Brightness boost of a twist
+#define BLADE_TWIST_BOOST (64)
+
+//Chance out of 256 of a new lockup spark each frame
+#define BLADE_LOCKUP_SPARK_CHANCE (96)
+
+//Lowest audio level treated as the peak, keeps silence from flickering
+#define BLADE_MIN_LEVEL_PEAK (256)
+
+BladeEngine::BladeEngine(IBladeDriver* apDriver)
+{
+	mpDriver = apDriver;
+
+	mColor.mRed = 0;
+	mColor.mGreen = 0;
+	mColor.mBlue = 255;
+	mFlashColor.mRed = 255;
+	mFlashColor.mGreen = 255;
+	mFlashColor.mBlue = 255;
+
+	mState = eeBladeOff;
+	mStateStartMs = 0;
+	mWipeMs = 0;
+	mNextFrameMs = 0;
+	mLastLit = false;
+
+	mFlickerDepth = 48;
+	mFlicker = 0;
+	mpLevel = NULL;
+	mLevelPeak = BLADE_MIN_LEVEL_PEAK;
+	mBoost = 0;
+	mFlash = 0;
+	mSpot = 0;
+	mSpotPos = 0;
+	mSpotWidth = 1;
+	mLockup = false;
+
+	mRandom = 0xACE1;
+
+	memset(maFrame, 0, sizeof(maFrame));
+}
+
+void BladeEngine::SetColor(tBladePixel aColor)
+{
+	mColor = aColor;
+}
+
+void BladeEngine::SetFlashColor(tBladePixel aColor)
+{
+	mFlashColor = aColor;
+}
+
+void BladeEngine::SetFlickerDepth(uint8_t aDepth)
+{
+	mFlickerDepth = aDepth;
+}
+
+void BladeEngine::SetLevelSource(const volatile uint16_t* apLevel)
+{
+	mpLevel = apLevel;
+	mLevelPeak = BLADE_MIN_LEVEL_PEAK;
+}
+
+void BladeEngine::Ignite(uint16_t aTimeMs)
+{
+	if(eeBladeOn == mState || eeBladeIgniting == mState)
+	{
+		return;
+	}
+
+	//Carry on from however much of the blade is still lit
+	uint32_t lNow = millis();
+	uint32_t lLit = GetLitLength(lNow, 1);
+
+	mState = eeBladeIgniting;
+	mWipeMs = aTimeMs;
+	mStateStartMs = lNow - ((lLit * aTimeMs) >> 8);
+}
+
+void BladeEngine::Retract(uint16_t aTimeMs)
+{
+	if(eeBladeOff == mState || eeBladeRetracting == mState)
+	{
+		return;
+	}
+
+	//Carry on from however much of the blade is already lit
+	uint32_t lNow = millis();
+	uint32_t lLit = GetLitLength(lNow, 1);
+
+	mState = eeBladeRetracting;
+	mWipeMs = aTimeMs;
+	mStateStartMs = lNow - (((BLADE_Q8_ONE - lLit) * aTimeMs) >> 8);
+}
+
+void BladeEngine::SetLockup(bool aLockup)
+{
+	mLockup = aLockup;
+}
+
+void BladeEngine::Blast()
+{
+	uint16_t lNumPixels = min(mpDriver->GetNumPixels(), (uint16_t)NSABER_MAX_BLADE_PIXELS);
+
+	//Somewhere in the upper three quarters of the blade
+	mSpotPos = (lNumPixels >> 2) + (((uint32_t)NextRandom() * (lNumPixels - (lNumPixels >> 2))) >> 8);
+	mSpotWidth = (lNumPixels >> 4) + 1;
+	mSpot = 255;
+}
+
+EBladeState BladeEngine::GetState()
+{
+	return mState;
+}
+
+void BladeEngine::NotifySwing(float aSpeed)
+{
+	uint16_t lBoost = (uint16_t)(constrain(aSpeed, 0.0, (float)BLADE_FULL_BOOST_SPEED) * 255.0 / BLADE_FULL_BOOST_SPEED);
+
+	if(lBoost > mBoost)
+	{
+		mBoost = lBoost;
+	}
+}
+
+void BladeEngine::NotifyClash(float aMagnitude)
+{
+	mFlash = 255;
+}
+
+void BladeEngine::NotifyTwist(float aSpeed)
+{
+	if(mBoost < BLADE_TWIST_BOOST)
+	{
+		mBoost = BLADE_TWIST_BOOST;
+	}
+}
+
+bool BladeEngine::Update()
+{
+	uint32_t lNow = millis();
+
+	if((int32_t)(lNow - mNextFrameMs) < 0)
+	{
+		return false;
+	}
+
+	mNextFrameMs += NSABER_BLADE_FRAME_MS;
+	if((int32_t)(lNow - mNextFrameMs) >= 0)
+	{
+		//Fell behind, don't try to catch up
+		mNextFrameMs = lNow + NSABER_BLADE_FRAME_MS;
+	}
+
+	if(!mpDriver->IsReady())
+	{
+		//Still sending the last frame, drop this one
+		mStats.mBusySkips++;
+		return false;
+	}
+
+	uint32_t lStartUs = micros();
+	bool lLit = Render(lNow);
+	uint32_t lRenderUs = micros() - lStartUs;
+
+	mStats.mTotalRenderUs += lRenderUs;
+	if(lRenderUs > mStats.mMaxRenderUs)
+	{
+		mStats.mMaxRenderUs = lRenderUs;
+	}
+
+	//Send one black frame when the blade goes out, then stay quiet
+	if(!lLit && !mLastLit)
+	{
+		return false;
+	}
+	mLastLit = lLit;
+
+	mpDriver->Show(maFrame, min(mpDriver->GetNumPixels(), (uint16_t)NSABER_MAX_BLADE_PIXELS));
+	mStats.mFrames++;
+
+	return true;
+}
+
+void BladeEngine::GetStats(tBladeStats& arStats)
+{
+	arStats = mStats;
+}
+
+void BladeEngine::ResetStats()
+{
+	mStats = tBladeStats();
+}
+
+bool BladeEngine::Render(uint32_t aNowMs)
+{
+	uint16_t lNumPixels = min(mpDriver->GetNumPixels(), (uint16_t)NSABER_MAX_BLADE_PIXELS);
+	uint32_t lLit = GetLitLength(aNowMs, lNumPixels);
+	uint16_t lFullPixels = lLit >> 8;
+	uint16_t lTipScale = lLit & 0xFF;
+
+	if(NULL != mpLevel)
+	{
+		//Dim with the audio level, which is already smoothed
+		uint16_t lLevel = *mpLevel;
+		mLevelPeak = max((uint16_t)(mLevelPeak - (mLevelPeak >> 8)), (uint16_t)BLADE_MIN_LEVEL_PEAK);
+		mLevelPeak = max(mLevelPeak, lLevel);
+		mFlicker = ((uint32_t)(mLevelPeak - lLevel) * mFlickerDepth) / mLevelPeak;
+	}
+	else
+	{
+		//Ease toward a new random dip every frame
+		int16_t lDip = ((uint16_t)NextRandom() * mFlickerDepth) >> 8;
+		mFlicker += (lDip - mFlicker) >> 2;
+	}
+
+	//Swinging fills in the flicker and pushes toward the flash color
+	int16_t lLevel = BLADE_Q8_ONE - mFlicker + mBoost;
+	if(lLevel > BLADE_Q8_ONE)
+	{
+		lLevel = BLADE_Q8_ONE;
+	}
+
+	if(mLockup && lLit > 0 && NextRandom() < BLADE_LOCKUP_SPARK_CHANCE)
+	{
+		mSpotPos = ((uint32_t)NextRandom() * lNumPixels) >> 8;
+		mSpotWidth = (lNumPixels >> 4) + 1;
+		mSpot = 128 + (NextRandom() >> 1);
+		mFlash = max(mFlash, (uint8_t)(NextRandom() >> 2));
+	}
+
+	uint16_t lMix = mFlash + (mBoost >> 2);
+	if(lMix > 255)
+	{
+		lMix = 255;
+	}
+
+	//Color of the blade outside the spot
+	tBladePixel lBase;
+	lBase.mRed = mColor.mRed + (((mFlashColor.mRed - mColor.mRed) * lMix) >> 8);
+	lBase.mGreen = mColor.mGreen + (((mFlashColor.mGreen - mColor.mGreen) * lMix) >> 8);
+	lBase.mBlue = mColor.mBlue + (((mFlashColor.mBlue - mColor.mBlue) * lMix) >> 8);
+
+	for(uint16_t lIdx = 0; lIdx < lNumPixels; lIdx++)
+	{
+		tBladePixel& lrPixel = maFrame[lIdx];
+		uint16_t lScale = lLevel;
+
+		if(lIdx >= lFullPixels)
+		{
+			//Soft edge at the tip while the blade moves
+			lScale = lIdx == lFullPixels ? (lScale * lTipScale) >> 8 : 0;
+		}
+
+		if(0 == lScale)
+		{
+			lrPixel.mRed = 0;
+			lrPixel.mGreen = 0;
+			lrPixel.mBlue = 0;
+			continue;
+		}
+
+		tBladePixel lColor = lBase;
+		uint16_t lDistance = lIdx > mSpotPos ? lIdx - mSpotPos : mSpotPos - lIdx;
+		if(mSpot > 0 && lDistance < mSpotWidth)
+		{
+			//Spot fades out toward its edges
+			uint16_t lSpotMix = (mSpot * (mSpotWidth - lDistance)) / mSpotWidth;
+			lColor.mRed += ((mFlashColor.mRed - lColor.mRed) * lSpotMix) >> 8;
+			lColor.mGreen += ((mFlashColor.mGreen - lColor.mGreen) * lSpotMix) >> 8;
+			lColor.mBlue += ((mFlashColor.mBlue - lColor.mBlue) * lSpotMix) >> 8;
+		}
+
+		lrPixel.mRed = (lColor.mRed * lScale) >> 8;
+		lrPixel.mGreen = (lColor.mGreen * lScale) >> 8;
+		lrPixel.mBlue = (lColor.mBlue * lScale) >> 8;
+	}
+
+	//Decay the transient effects
+	mBoost = (mBoost * 15) >> 4;
+	mFlash = (mFlash * 7) >> 3;
+	mSpot = (mSpot * 3) >> 2;
+
+	return lLit > 0;
+}
+
+uint32_t BladeEngine::GetLitLength(uint32_t aNowMs, uint16_t aNumPixels)
+{
+	uint32_t lFull = (uint32_t)aNumPixels << 8;
+	uint32_t lElapsed = aNowMs - mStateStartMs;
+	uint32_t lLit = 0;
+
+	switch(mState)
+	{
+		case eeBladeIgniting:
+			if(lElapsed >= mWipeMs)
+			{
+				mState = eeBladeOn;
+				lLit = lFull;
+			}
+			else
+			{
+				lLit = lFull * lElapsed / mWipeMs;
+			}
+			break;
+		case eeBladeOn:
+			lLit = lFull;
+			break;
+		case eeBladeRetracting:
+			if(lElapsed >= mWipeMs)
+			{
+				mState = eeBladeOff;
+				mLockup = false;
+				lLit = 0;
+			}
+			else
+			{
+				lLit = lFull - lFull * lElapsed / mWipeMs;
+			}
+			break;
+		default:
+			lLit = 0;
+			break;
+	}
+
+	return lLit;
+}
+
+uint8_t BladeEngine::NextRandom()
+{
+	//16-bit Galois LFSR
+	uint16_t lLsb = mRandom & 1;
+	mRandom >>= 1;
+	if(lLsb)
+	{
+		mRandom ^= 0xB400;
+	}
+
+	return mRandom & 0xFF;
+}
@@ -0,0 +1,105 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * BootSequence.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "BootSequence.h"
+
+BootSequence::BootSequence(NECSoundManager* apSoundManager, AMotionManager* apMotionManager)
+{
+	mpSoundManager = apSoundManager;
+	mpMotionManager = apMotionManager;
+	mStarted = false;
+
+	for(int lIdx = 0; lIdx < eeBootMaxSteps; lIdx++)
+	{
+		mTimeline.maStepMs[lIdx] = BOOT_STEP_PENDING;
+	}
+}
+
+bool BootSequence::Start(uint8_t aSdCsPin, uint32_t aSdClockHz, uint8_t aFontIndex)
+{
+	MarkStep(eeBootStarted);
+
+	if(!SD.begin(aSdClockHz, aSdCsPin))
+	{
+		return false;
+	}
+	MarkStep(eeBootSdReady);
+
+	//Only the sounds needed to get going, the rest are found in Run()
+	mpSoundManager->SetBackgroundIndexing(true);
+	mpSoundManager->SetFont(aFontIndex);
+	MarkStep(eeBootFontSelected);
+
+	if(mpSoundManager->PlaySound(SoundTypes::eeBootSnd))
+	{
+		MarkStep(eeBootSoundStarted);
+	}
+
+	mStarted = true;
+
+	return true;
+}
+
+bool BootSequence::Run(uint32_t aDeadlineUs)
+{
+	if(!mStarted || IsDone())
+	{
+		return false;
+	}
+
+	//The motion sensor first, it's all that stands between us and ignition
+	if(BOOT_STEP_PENDING == mTimeline.maStepMs[eeBootMotionReady])
+	{
+		mpMotionManager->Init();
+		MarkStep(eeBootMotionReady);
+		MarkStep(eeBootReady);
+		return true;
+	}
+
+	if(mpSoundManager->ContinueFontIndex(aDeadlineUs))
+	{
+		return true;
+	}
+
+	MarkStep(eeBootFontIndexed);
+
+	return false;
+}
+
+bool BootSequence::IsReady()
+{
+	return BOOT_STEP_PENDING != mTimeline.maStepMs[eeBootReady];
+}
+
+bool BootSequence::IsDone()
+{
+	return BOOT_STEP_PENDING != mTimeline.maStepMs[eeBootFontIndexed];
+}
+
+void BootSequence::GetTimeline(tBootTimeline& arTimeline)
+{
+	arTimeline = mTimeline;
+}
+
+void BootSequence::MarkStep(EBootStep aStep)
+{
+	mTimeline.maStepMs[aStep] = millis();
+}
@@ -0,0 +1,140 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * BootSequence.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef BOOTSEQUENCE_H_
+#define BOOTSEQUENCE_H_
+
+#include "Arduino.h"
+#include "RunLoop.h"
+#include "Sound/NECSoundManager.h"
+#include "Motion/AMotionManager.h"
+
+//Timeline value of a step that hasn't happened
+#define BOOT_STEP_PENDING (0xFFFFFFFF)
+
+/**
+ * Milestones of the boot sequence.
+ */
+enum EBootStep
+{
+	eeBootStarted,       //Start() called
+	eeBootSdReady,       //SD card initialized
+	eeBootFontSelected,  //Boot, font, power up and hum sounds found
+	eeBootSoundStarted,  //Boot sound playing
+	eeBootMotionReady,   //Motion sensor configured
+	eeBootReady,         //Ready to ignite
+	eeBootFontIndexed,   //Every sound of the font found
+	eeBootMaxSteps
+};
+
+/**
+ * millis() at each boot milestone, BOOT_STEP_PENDING for those not reached.
+ * millis() counts from reset, so the values are times since power on.
+ */
+struct tBootTimeline
+{
+	uint32_t maStepMs[eeBootMaxSteps];
+};
+
+/**
+ * Boots the saber with the slow steps overlapped instead of one after the
+ * other. Start() brings up the SD card, finds only the sounds needed to
+ * boot and ignite, and starts the boot sound. Added to a run loop as a
+ * background task, it then configures the motion sensor and finds the
+ * rest of the font between audio blocks, while the boot sound plays.
+ *
+ * The saber is ready to ignite once the motion sensor is configured; the
+ * rest of the font keeps being indexed after that, each sound type
+ * becoming playable as soon as it has been found.
+ *
+ * Example:
+ *  gBoot.Start(PIN_SPI_CS, 8000000, 0);
+ *  gRunLoop.AddTask(&gBoot, eeBackgroundPriority, 0, 2000);
+ *  while(!gBoot.IsReady()) gRunLoop.RunOnce();
+ */
+class BootSequence : public ARunLoopTask
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apSoundManager - Sound manager to boot, already initialized
+	 *  apMotionManager - Motion manager to initialize
+	 */
+	BootSequence(NECSoundManager* apSoundManager, AMotionManager* apMotionManager);
+
+	/**
+	 * Runs the steps that must happen before anything else can: SD card,
+	 * boot sounds of the font and the boot sound itself.
+	 * Args:
+	 *  aSdCsPin - Chip select pin of the SD card reader
+	 *  aSdClockHz - SPI clock for the SD card
+	 *  aFontIndex - Font to select
+	 * Returns:
+	 *  TRUE if successful, FALSE if the SD card couldn't be started
+	 */
+	bool Start(uint8_t aSdCsPin, uint32_t aSdClockHz, uint8_t aFontIndex);
+
+	/**
+	 * Does one slice of the background steps. Called by the run loop.
+	 * Args:
+	 *  aDeadlineUs - micros() value to be done by
+	 * Returns:
+	 *  TRUE if there is more work to do right away, FALSE otherwise
+	 */
+	virtual bool Run(uint32_t aDeadlineUs);
+
+	/**
+	 * Returns TRUE once the saber can ignite.
+	 */
+	bool IsReady();
+
+	/**
+	 * Returns TRUE once every step is done and the task can be removed
+	 * from the run loop.
+	 */
+	bool IsDone();
+
+	/**
+	 * Gets the time of each boot milestone.
+	 * Args:
+	 *  arTimeline - Output parameter, populated with the timeline
+	 */
+	void GetTimeline(tBootTimeline& arTimeline);
+
+protected:
+
+	/**
+	 * Records the time of a milestone.
+	 */
+	void MarkStep(EBootStep aStep);
+
+	NECSoundManager* mpSoundManager;
+	AMotionManager* mpMotionManager;
+
+	//TRUE once Start() has succeeded
+	bool mStarted;
+
+	tBootTimeline mTimeline;
+};
+
+#endif /* BOOTSEQUENCE_H_ */
@@ -50,6 +50,14 @@ bool DynamicNECSoundManager::PlaySound(SoundTypes::ESoundTypes aSoundType, uint1
 			mpEffectSound->SetVolume(maSoundVols[aSoundType]);
 			mpEffectSound->SetRate(maSoundPitchs[aSoundType]);
 		}
+
+		SaberVoice* lpVoice = GetVoiceForType(aSoundType);
+		if(nullptr != lpVoice)
+		{
+			lpVoice->SetVolume(maSoundVols[aSoundType]);
+			lpVoice->SetRate(maSoundPitchs[aSoundType]);
+			lpVoice->SetFilter(maSoundCutoffs[aSoundType], maSoundResonances[aSoundType]);
+		}
 	}
 
 	return lSuccess;
@@ -74,10 +82,16 @@ void DynamicNECSoundManager::SetSoundVolume(SoundTypes::ESoundTypes aType, float
 	{
 		mpEffectSound->SetVolume(aVol);
 	}
-	else if(SoundTypes::eeHumSnd == aType)
+	else if(SoundTypes::eeHumSnd == aType && nullptr != mpHumSound)
 	{
 		mpHumSound->SetVolume(aVol);
 	}
+
+	SaberVoice* lpVoice = GetVoiceForType(aType);
+	if(nullptr != lpVoice)
+	{
+		lpVoice->SetVolume(aVol);
+	}
 }
 
 void DynamicNECSoundManager::SetSoundPitch(SoundTypes::ESoundTypes aType, float aPitch)
@@ -90,10 +104,29 @@ void DynamicNECSoundManager::SetSoundPitch(SoundTypes::ESoundTypes aType, float
 	{
 		mpEffectSound->SetRate(aPitch);
 	}
-	else if(SoundTypes::eeHumSnd == aType)
+	else if(SoundTypes::eeHumSnd == aType && nullptr != mpHumSound)
 	{
 		mpHumSound->SetRate(aPitch);
 	}
+
+	SaberVoice* lpVoice = GetVoiceForType(aType);
+	if(nullptr != lpVoice)
+	{
+		lpVoice->SetRate(aPitch);
+	}
+}
+
+void DynamicNECSoundManager::SetSoundFilter(SoundTypes::ESoundTypes aType, float aCutoffHz, float aResonance)
+{
+	maSoundCutoffs[aType] = aCutoffHz;
+	maSoundResonances[aType] = aResonance;
+
+	//The I2SWavPlayer can't filter, only voices can
+	SaberVoice* lpVoice = GetVoiceForType(aType);
+	if(nullptr != lpVoice)
+	{
+		lpVoice->SetFilter(aCutoffHz, aResonance);
+	}
 }
 
 void DynamicNECSoundManager::LoadDefaults()
@@ -102,6 +135,8 @@ void DynamicNECSoundManager::LoadDefaults()
 	{
 		maSoundVols[lIdx] = 1.0;
 		maSoundPitchs[lIdx] = 0.0;
+		maSoundCutoffs[lIdx] = 0.0;
+		maSoundResonances[lIdx] = 0.707;
 	}
 }
 
@@ -0,0 +1,196 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * EventQueue.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef EVENTQUEUE_H_
+#define EVENTQUEUE_H_
+
+#include <Arduino.h>
+
+//Events a saber event queue holds, must be a power of two
+#if not defined NSABER_EVENT_QUEUE_SIZE
+#define NSABER_EVENT_QUEUE_SIZE (16)
+#endif
+
+/**
+ * Fixed-size queue for handing items from one producer to one consumer,
+ * such as from an interrupt to the main loop, without locks. Push() and
+ * Pop() never wait and each touches only its own index, so neither side
+ * can block the other. When the queue is full, Push() drops the new item
+ * and counts it.
+ *
+ * Only one context may push and only one may pop. Use one queue per
+ * producer.
+ *
+ * Template args:
+ *  T - Type of the items, copied in and out
+ *  tCapacity - Most items held at once, a power of two up to 32768
+ */
+template<typename T, uint16_t tCapacity>
+class SpscQueue
+{
+	static_assert(tCapacity > 0 && 0 == (tCapacity & (tCapacity - 1)), "Queue capacity must be a power of two");
+
+public:
+
+	/**
+	 * Constructor.
+	 */
+	SpscQueue()
+	{
+		mHead = 0;
+		mTail = 0;
+		mDropped = 0;
+	}
+
+	/**
+	 * Adds an item. Call only from the producer.
+	 * Args:
+	 *  arItem - Item to add
+	 * Returns:
+	 *  TRUE if successful, FALSE if the queue was full
+	 */
+	bool Push(const T& arItem)
+	{
+		uint16_t lHead = mHead;
+		if((uint16_t)(lHead - mTail) >= tCapacity)
+		{
+			mDropped = mDropped + 1;
+			return false;
+		}
+
+		maItems[lHead & (tCapacity - 1)] = arItem;
+
+		//The item must be written before the consumer can see it
+		__sync_synchronize();
+		mHead = lHead + 1;
+
+		return true;
+	}
+
+	/**
+	 * Takes the oldest item. Call only from the consumer.
+	 * Args:
+	 *  arItem - Output parameter, populated with the item
+	 * Returns:
+	 *  TRUE if an item was taken, FALSE if the queue was empty
+	 */
+	bool Pop(T& arItem)
+	{
+		uint16_t lTail = mTail;
+		if(lTail == mHead)
+		{
+			return false;
+		}
+
+		//Don't read the item before seeing that it's there
+		__sync_synchronize();
+		arItem = maItems[lTail & (tCapacity - 1)];
+
+		//Done with the slot before the producer can reuse it
+		__sync_synchronize();
+		mTail = lTail + 1;
+
+		return true;
+	}
+
+	/**
+	 * Returns the number of items waiting. Exact from the consumer, a lower
+	 * bound from the producer.
+	 */
+	uint16_t GetCount()
+	{
+		return mHead - mTail;
+	}
+
+	/**
+	 * Returns the number of items Push() has dropped because the queue
+	 * was full.
+	 */
+	uint32_t GetDropped()
+	{
+		return mDropped;
+	}
+
+protected:
+
+	T maItems[tCapacity];
+
+	//Free-running positions of the next push and the next pop. Only the
+	//producer writes mHead and only the consumer writes mTail.
+	volatile uint16_t mHead;
+	volatile uint16_t mTail;
+
+	//Items dropped by Push(), only written by the producer
+	volatile uint32_t mDropped;
+};
+
+/**
+ * What happened.
+ */
+enum ESaberEvent
+{
+	eeSwingEvent,        //Swing began, mDetail is the EMagnitudes
+	eeClashEvent,        //Clash, mDetail is the EMagnitudes
+	eeTwistEvent,        //Twist began
+	eeSoundStartedEvent, //Sound started, mDetail is the sound type
+	eeSoundEndedEvent,   //Effect sound ended
+	eeCalibrationEvent   //Motion calibration finished, mDetail is 1 if it succeeded
+};
+
+/**
+ * A timestamped motion or sound event.
+ */
+struct tSaberEvent
+{
+	//micros() when the event was detected
+	uint32_t mTimeUs;
+	//ESaberEvent
+	uint8_t mType;
+	//Depends on the type, see ESaberEvent
+	uint8_t mDetail;
+	//Depends on the type, 0 if unused
+	int16_t mValue;
+};
+
+typedef SpscQueue<tSaberEvent, NSABER_EVENT_QUEUE_SIZE> SaberEventQueue;
+
+/**
+ * Posts an event stamped with the current time.
+ * Args:
+ *  apQueue - Queue to post to, nothing is posted if nullptr
+ *  aType - What happened
+ *  aDetail - Detail, depends on the type
+ *  aValue - Value, depends on the type
+ */
+inline void PostSaberEvent(SaberEventQueue* apQueue, ESaberEvent aType, uint8_t aDetail = 0, int16_t aValue = 0)
+{
+	if(nullptr != apQueue)
+	{
+		tSaberEvent lEvent;
+		lEvent.mTimeUs = micros();
+		lEvent.mType = aType;
+		lEvent.mDetail = aDetail;
+		lEvent.mValue = aValue;
+		apQueue->Push(lEvent);
+	}
+}
+
+#endif /* EVENTQUEUE_H_ */
@@ -24,9 +24,18 @@
 
 #include <SD.h>
 #include "Arduino.h"
+#include "NSaberLog.h"
 
 #define MAX_FILE_NAME_SIZE 35
 
+//Set to 1 (here or with a build flag) to keep sound playback off the heap
+//once a font is selected. The I2SWavPlayer's WAV files then come from a
+//fixed pool, and voice engine streams keep their file open between sounds
+//so a packed font is opened only once.
+#if not defined NSABER_STATIC_ALLOCATION
+#define NSABER_STATIC_ALLOCATION (0)
+#endif
+
 namespace FileUtils
 {
 
@@ -59,9 +68,7 @@ inline int Count(const char* aFileName, const char* aBaseDir)
 	strcat(lFileName, "/");
 	strcat(lFileName, aFileName); //"clash, swing, lockup, etc."
 
-	String lFileNameStr((const char*)lFileName);
-
-	if(SD.exists(lFileNameStr))
+	if(SD.exists((const char*)lFileName))
 	{
 		return 1;
 	}
@@ -97,16 +104,14 @@ inline int Count(const char* aBeginsWith, const char* aEndsWith, const char* aBa
 		strcat(lFileName, aBeginsWith); //"clash, swing, lockup, etc."
 		strcat(lFileName, aEndsWith);   //".wav, .txt, etc."
 
-		String lFileNameStr((const char*)lFileName);
-
-		if(	SD.exists(lFileNameStr) )
+		if(	SD.exists((const char*)lFileName) )
 		{
 			lCount++;
-			Serial.print(lFileNameStr);Serial.println(" exists.");
+			NSABER_LOG_DEBUG("Found ", lFileName);
 		}
 		else
 		{
-			Serial.print(lFileNameStr);Serial.println(" DNE.");
+			NSABER_LOG_DEBUG("Missing ", lFileName);
 			lContinue = false;
 		}
 	}
@@ -142,12 +147,9 @@ inline int Count(const char* aBeginsWith, const char* aEndsWith, const char* aBa
 		strcat(lFileName, lIdxStr);     //"1, 2, 3, 4..."
 		strcat(lFileName, aEndsWith);   //".wav, .txt, etc."
 
-		String lFileNameStr((const char*)lFileName);
-
-		if(	SD.exists(lFileNameStr) )
+		if(	SD.exists((const char*)lFileName) )
 		{
-			Serial.print((const char*)lFileName);
-			Serial.println(" exists.");
+			NSABER_LOG_DEBUG("Found ", lFileName);
 
 			lCount++;
 		}
@@ -0,0 +1,327 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * FlightRecorder.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "FlightRecorder.h"
+
+using namespace FlightLog;
+
+FlightRecorder::FlightRecorder(VoiceEngine* apEngine)
+{
+	mpEngine = apEngine;
+	mFilled = 0;
+	mFlushed = 0;
+	mRecordIdx = 0;
+	mLastUs = 0;
+	mPendingDrops = 0;
+	mRecording = false;
+	mWriteEstimateUs = RECORDER_INITIAL_WRITE_US;
+	mEstimateMs = 0;
+	mDecayMs = RECORDER_DECAY_MS;
+	mUnsyncedSectors = 0;
+}
+
+FlightRecorder::~FlightRecorder()
+{
+	Stop();
+}
+
+bool FlightRecorder::Start(const char* apPath)
+{
+	Stop();
+
+	//FILE_WRITE appends, so start from an empty file
+	if(SD.exists(apPath))
+	{
+		SD.remove(apPath);
+	}
+
+	mFile = SD.open(apPath, FILE_WRITE);
+	if(!mFile)
+	{
+		NSABER_LOG_ERROR("Could not open flight log ", apPath);
+		return false;
+	}
+
+	mFilled = 0;
+	mFlushed = 0;
+	mRecordIdx = 0;
+	mPendingDrops = 0;
+	mWriteEstimateUs = RECORDER_INITIAL_WRITE_US;
+	mEstimateMs = millis();
+	mDecayMs = RECORDER_DECAY_MS;
+	mUnsyncedSectors = 0;
+	mStats = tFlightRecorderStats();
+
+	tFlightRecord lRecord;
+	memset(&lRecord, 0, sizeof(lRecord));
+	lRecord.mType = eeHeaderRecord;
+	lRecord.mDetail = FLIGHT_LOG_VERSION;
+	lRecord.maValues[0] = FLIGHT_LOG_MAGIC;
+	Put(lRecord);
+
+	mLastUs = micros();
+	memset(&lRecord, 0, sizeof(lRecord));
+	lRecord.mType = eeSyncRecord;
+	SetWord32(lRecord, mLastUs);
+	Put(lRecord);
+
+	mRecording = true;
+
+	return true;
+}
+
+void FlightRecorder::Stop()
+{
+	if(!mFile)
+	{
+		return;
+	}
+
+	mRecording = false;
+
+	while(mFilled != mFlushed)
+	{
+		WriteSectors(NSABER_RECORDER_SECTORS);
+	}
+
+	//Mark records dropped since the last one that made it in
+	if(mPendingDrops > 0)
+	{
+		tFlightRecord lDropped;
+		memset(&lDropped, 0, sizeof(lDropped));
+		lDropped.mType = eeDroppedRecord;
+		SetWord32(lDropped, mPendingDrops);
+		Put(lDropped);
+		mPendingDrops = 0;
+	}
+
+	//Pad out the last sector
+	tFlightRecord lPad;
+	memset(&lPad, 0, sizeof(lPad));
+	while(mRecordIdx > 0)
+	{
+		Put(lPad);
+	}
+
+	WriteSectors(NSABER_RECORDER_SECTORS);
+
+	mFile.close();
+}
+
+void FlightRecorder::RecordSample(uint32_t aTimeUs, const int16_t* apValues)
+{
+	if(!mRecording)
+	{
+		return;
+	}
+
+	tFlightRecord lRecord;
+	lRecord.mType = eeSampleRecord;
+	lRecord.mDetail = 0;
+	memcpy(lRecord.maValues, apValues, sizeof(lRecord.maValues));
+
+	Append(lRecord, aTimeUs);
+}
+
+void FlightRecorder::RecordEvent(uint32_t aTimeUs, uint8_t aType, uint8_t aDetail)
+{
+	if(!mRecording)
+	{
+		return;
+	}
+
+	tFlightRecord lRecord;
+	memset(&lRecord, 0, sizeof(lRecord));
+	lRecord.mType = eeEventRecord;
+	lRecord.mDetail = aType;
+	lRecord.maValues[0] = aDetail;
+
+	Append(lRecord, aTimeUs);
+}
+
+void FlightRecorder::Append(tFlightRecord& arRecord, uint32_t aTimeUs)
+{
+	if(mPendingDrops > 0 && HasRoom())
+	{
+		tFlightRecord lDropped;
+		memset(&lDropped, 0, sizeof(lDropped));
+		lDropped.mType = eeDroppedRecord;
+		SetWord32(lDropped, mPendingDrops);
+		Put(lDropped);
+		mPendingDrops = 0;
+	}
+
+	uint32_t lDeltaUs = aTimeUs - mLastUs;
+	if(lDeltaUs > 0xFFFF && HasRoom())
+	{
+		tFlightRecord lSync;
+		memset(&lSync, 0, sizeof(lSync));
+		lSync.mType = eeSyncRecord;
+		SetWord32(lSync, aTimeUs);
+		Put(lSync);
+		mLastUs = aTimeUs;
+		lDeltaUs = 0;
+	}
+
+	if(!HasRoom())
+	{
+		mPendingDrops++;
+		mStats.mDropped++;
+		return;
+	}
+
+	arRecord.mDeltaUs = lDeltaUs;
+	Put(arRecord);
+	mLastUs = aTimeUs;
+}
+
+void FlightRecorder::Put(const tFlightRecord& arRecord)
+{
+	maSectors[mFilled % NSABER_RECORDER_SECTORS][mRecordIdx] = arRecord;
+	mRecordIdx++;
+	mStats.mRecords++;
+
+	if(FLIGHT_LOG_SECTOR_RECORDS == mRecordIdx)
+	{
+		//The sector must be filled before the consumer can see it
+		__sync_synchronize();
+		mFilled = mFilled + 1;
+		mRecordIdx = 0;
+	}
+}
+
+bool FlightRecorder::Run(uint32_t aDeadlineUs)
+{
+	if(!mFile)
+	{
+		return false;
+	}
+
+	uint16_t lReady = mFilled - mFlushed;
+
+	//Bring the file size on the card up to date once there's nothing to write
+	if(mUnsyncedSectors >= NSABER_RECORDER_SYNC_SECTORS && lReady < NSABER_RECORDER_FLUSH_SECTORS)
+	{
+		if(HasGap(aDeadlineUs, mWriteEstimateUs))
+		{
+			uint32_t lStartUs = micros();
+			mFile.flush();
+			NoteWriteTime(micros() - lStartUs);
+			mUnsyncedSectors = 0;
+		}
+		else
+		{
+			DecayWriteEstimate();
+		}
+		return false;
+	}
+
+	if(lReady < NSABER_RECORDER_FLUSH_SECTORS)
+	{
+		return false;
+	}
+
+	if(!HasGap(aDeadlineUs, mWriteEstimateUs))
+	{
+		mStats.mDeferrals++;
+		DecayWriteEstimate();
+		return false;
+	}
+
+	WriteSectors(NSABER_RECORDER_FLUSH_SECTORS);
+
+	return (uint16_t)(mFilled - mFlushed) >= NSABER_RECORDER_FLUSH_SECTORS;
+}
+
+bool FlightRecorder::HasGap(uint32_t aDeadlineUs, uint32_t aTimeUs)
+{
+	if(nullptr != mpEngine)
+	{
+		return mpEngine->GetBufferedUs() >= aTimeUs + NSABER_RECORDER_AUDIO_MARGIN_US;
+	}
+
+	int32_t lSlackUs = (int32_t)(aDeadlineUs - micros());
+	return lSlackUs >= (int32_t)aTimeUs;
+}
+
+void FlightRecorder::WriteSectors(uint16_t aMaxSectors)
+{
+	uint16_t lFirst = mFlushed % NSABER_RECORDER_SECTORS;
+	uint16_t lCount = min((uint16_t)(mFilled - mFlushed), aMaxSectors);
+
+	//Write up to the end of the buffer, the rest goes next time
+	lCount = min(lCount, (uint16_t)(NSABER_RECORDER_SECTORS - lFirst));
+	if(0 == lCount)
+	{
+		return;
+	}
+
+	//Don't read the sectors before seeing that they're full
+	__sync_synchronize();
+
+	uint32_t lStartUs = micros();
+	size_t lBytes = (size_t)lCount * FLIGHT_LOG_SECTOR_SIZE;
+	if(mFile.write((const uint8_t*)maSectors[lFirst], lBytes) != lBytes)
+	{
+		//The data is lost either way, move on rather than hold up recording
+		mStats.mWriteErrors++;
+	}
+	NoteWriteTime(micros() - lStartUs);
+
+	mStats.mSectorsWritten += lCount;
+	mUnsyncedSectors += lCount;
+
+	//Done with the sectors before the producer can reuse them
+	__sync_synchronize();
+	mFlushed = mFlushed + lCount;
+}
+
+void FlightRecorder::NoteWriteTime(uint32_t aElapsedUs)
+{
+	mStats.mMaxWriteUs = max(mStats.mMaxWriteUs, aElapsedUs);
+
+	//A write the audio may not have covered, wait longer before trusting
+	//the estimate to come down again
+	if(aElapsedUs > mWriteEstimateUs + NSABER_RECORDER_AUDIO_MARGIN_US)
+	{
+		mStats.mSlowWrites++;
+		mDecayMs = min(mDecayMs * 4, (uint32_t)RECORDER_MAX_DECAY_MS);
+	}
+
+	//Jump up to a slow write straight away, but come back down slowly
+	mWriteEstimateUs = max(aElapsedUs, mWriteEstimateUs - mWriteEstimateUs / 8);
+	mEstimateMs = millis();
+}
+
+void FlightRecorder::DecayWriteEstimate()
+{
+	uint32_t lNowMs = millis();
+	if(lNowMs - mEstimateMs >= mDecayMs)
+	{
+		mWriteEstimateUs -= mWriteEstimateUs / 8;
+		mEstimateMs = lNowMs;
+	}
+}
+
+void FlightRecorder::GetStats(tFlightRecorderStats& arStats)
+{
+	arStats = mStats;
+}
@@ -0,0 +1,272 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * FlightRecorder.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef FLIGHTRECORDER_H_
+#define FLIGHTRECORDER_H_
+
+#include "Arduino.h"
+#include <SD.h>
+#include "RunLoop.h"
+#include "Sound/VoiceEngine.h"
+#include "Motion/FlightLog.h"
+
+//Sectors of records held in RAM waiting to be written
+#if not defined NSABER_RECORDER_SECTORS
+#define NSABER_RECORDER_SECTORS (8)
+#endif
+
+//Sectors written to the card at once
+#if not defined NSABER_RECORDER_FLUSH_SECTORS
+#define NSABER_RECORDER_FLUSH_SECTORS (4)
+#endif
+
+//Sectors written between updates of the file's size on the card, so a
+//log survives the power going off
+#if not defined NSABER_RECORDER_SYNC_SECTORS
+#define NSABER_RECORDER_SYNC_SECTORS (64)
+#endif
+
+//Audio that must be left buffered after a write, in microseconds
+#if not defined NSABER_RECORDER_AUDIO_MARGIN_US
+#define NSABER_RECORDER_AUDIO_MARGIN_US (2000)
+#endif
+
+//Time a card write is assumed to take before any have been timed
+#define RECORDER_INITIAL_WRITE_US (5000)
+
+//While no write fits, the estimate of the next write's time comes down by
+//an eighth this often. Grows fourfold, up to the maximum, for each write
+//that overruns the estimate by more than the audio margin, so a card that
+//is always too slow is tried less and less often.
+#define RECORDER_DECAY_MS (100)
+#define RECORDER_MAX_DECAY_MS (409600)
+
+static_assert(0 == (NSABER_RECORDER_SECTORS & (NSABER_RECORDER_SECTORS - 1)), "Buffered sectors must be a power of two");
+static_assert(NSABER_RECORDER_FLUSH_SECTORS <= NSABER_RECORDER_SECTORS, "Can't flush more sectors than are buffered");
+static_assert(0 == NSABER_RECORDER_SECTORS % NSABER_RECORDER_FLUSH_SECTORS, "Buffered sectors must be a multiple of the flush size");
+
+/**
+ * What a flight recorder has done.
+ */
+struct tFlightRecorderStats
+{
+	//Records written into the buffer, including headers and sync records
+	uint32_t mRecords = 0;
+	//Records dropped because the buffer was full
+	uint32_t mDropped = 0;
+	//Sectors written to the card
+	uint32_t mSectorsWritten = 0;
+	//Times a full chunk had to wait for a gap in the audio
+	uint32_t mDeferrals = 0;
+	//Card writes that came up short, their data is lost
+	uint32_t mWriteErrors = 0;
+	//Card operations that overran the estimate by more than the audio margin
+	uint32_t mSlowWrites = 0;
+	//Longest card write or file update in microseconds
+	uint32_t mMaxWriteUs = 0;
+};
+
+/**
+ * Records every motion sensor reading and every detected motion to a log
+ * on the SD card, for working out afterwards why a clash was missed. See
+ * Motion/FlightLog.h for the format.
+ *
+ * Records are gathered in RAM a sector at a time and written out in
+ * chunks of NSABER_RECORDER_FLUSH_SECTORS whole sectors, so the card never
+ * has to read a sector back to change part of it. A chunk is only written
+ * when the audio has enough buffered to cover the longest recent write
+ * with NSABER_RECORDER_AUDIO_MARGIN_US to spare, that is, in the gap
+ * before the voice engine next needs servicing. Such a write may run past
+ * the run loop's deadline, which only delays the motion task, and shows
+ * up in the recorder task's overruns. Without a voice engine, chunks are
+ * only written when they fit before the deadline. Recording never waits.
+ * When the buffer is full, records are dropped and counted, and a dropped
+ * record in the log marks the gap.
+ *
+ * Add it to the run loop at background priority. Records may be added
+ * from a different context, such as a timer interrupt, than the one that
+ * runs it.
+ *
+ * Example:
+ *  FlightRecorder gRecorder(&gEngine);
+ *  gRunLoop.AddTask(&gRecorder, eeBackgroundPriority, 0, 5000);
+ *  gRecorder.Start("/motion.nfl");
+ *  gMotion.SetRecorder(&gRecorder);
+ */
+class FlightRecorder : public ARunLoopTask
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apEngine - Voice engine to keep fed, or nullptr to go by the run
+	 *             loop's deadline alone
+	 */
+	FlightRecorder(VoiceEngine* apEngine = nullptr);
+
+	virtual ~FlightRecorder();
+
+	/**
+	 * Starts recording to a new log, replacing any file of the same name.
+	 * Call from the context records are added from, or while none are.
+	 * Args:
+	 *  apPath - Path of the log on the SD card
+	 * Returns:
+	 *  TRUE if successful, FALSE if the file couldn't be opened
+	 */
+	bool Start(const char* apPath);
+
+	/**
+	 * Stops recording, writes out what is buffered and closes the log.
+	 * This waits for the card, so call it when audio doesn't matter, such
+	 * as after the blade is retracted. Call from the context records are
+	 * added from, or while none are.
+	 */
+	void Stop();
+
+	/**
+	 * Returns TRUE if recording.
+	 */
+	bool IsRecording()
+	{
+		return mRecording;
+	}
+
+	/**
+	 * Adds a motion sensor reading.
+	 * Args:
+	 *  aTimeUs - micros() of the reading
+	 *  apValues - Raw accelerometer X, Y, Z and gyro X, Y, Z
+	 */
+	void RecordSample(uint32_t aTimeUs, const int16_t* apValues);
+
+	/**
+	 * Adds a detected event.
+	 * Args:
+	 *  aTimeUs - micros() when it was detected
+	 *  aType - ESaberEvent
+	 *  aDetail - Detail, depends on the type
+	 */
+	void RecordEvent(uint32_t aTimeUs, uint8_t aType, uint8_t aDetail);
+
+	/**
+	 * Writes a chunk to the card if one is ready and there's a gap for it.
+	 * Called by the run loop.
+	 * Args:
+	 *  aDeadlineUs - micros() value to be done by
+	 * Returns:
+	 *  TRUE if another chunk is ready, FALSE otherwise
+	 */
+	virtual bool Run(uint32_t aDeadlineUs);
+
+	/**
+	 * Gets what the recorder has done since it was last started.
+	 * Args:
+	 *  arStats - Output parameter, populated with the statistics
+	 */
+	void GetStats(tFlightRecorderStats& arStats);
+
+protected:
+
+	/**
+	 * Adds a record, first adding a dropped record if some were dropped and
+	 * a sync record if the time since the last record is too long.
+	 */
+	void Append(FlightLog::tFlightRecord& arRecord, uint32_t aTimeUs);
+
+	/**
+	 * Puts a record in the sector being filled and hands the sector over
+	 * for writing when it's full. There must be room.
+	 */
+	void Put(const FlightLog::tFlightRecord& arRecord);
+
+	/**
+	 * Returns TRUE if there is a sector to put records in.
+	 */
+	bool HasRoom()
+	{
+		return (uint16_t)(mFilled - mFlushed) < NSABER_RECORDER_SECTORS;
+	}
+
+	/**
+	 * Returns TRUE if a card operation expected to take aTimeUs fits in the
+	 * audio's buffer, or before the deadline without a voice engine.
+	 */
+	bool HasGap(uint32_t aDeadlineUs, uint32_t aTimeUs);
+
+	/**
+	 * Writes full sectors to the card, up to the end of the buffer.
+	 * Args:
+	 *  aMaxSectors - Most sectors to write
+	 */
+	void WriteSectors(uint16_t aMaxSectors);
+
+	/**
+	 * Folds the time of a card operation into the estimate of how long the
+	 * next one will take.
+	 */
+	void NoteWriteTime(uint32_t aElapsedUs);
+
+	/**
+	 * Brings the estimate of the next write's time down a step if it has
+	 * stood long enough, so one slow write doesn't stop writes for good.
+	 */
+	void DecayWriteEstimate();
+
+	//Records waiting to be written, a sector at a time
+	FlightLog::tFlightRecord maSectors[NSABER_RECORDER_SECTORS][FLIGHT_LOG_SECTOR_RECORDS];
+
+	//Free-running counts of sectors filled and sectors written. Only the
+	//producer writes mFilled and only the consumer writes mFlushed.
+	volatile uint16_t mFilled;
+	volatile uint16_t mFlushed;
+
+	//Next record in the sector being filled, producer only
+	uint16_t mRecordIdx;
+
+	//Time of the last record put, producer only
+	uint32_t mLastUs;
+
+	//Records dropped since the last dropped record, producer only
+	uint32_t mPendingDrops;
+
+	VoiceEngine* mpEngine;
+
+	File mFile;
+
+	volatile bool mRecording;
+
+	//Estimate of how long the next card operation will take
+	uint32_t mWriteEstimateUs;
+
+	//millis() when the estimate last changed, and how long it must stand
+	//before it comes down without a write
+	uint32_t mEstimateMs;
+	uint32_t mDecayMs;
+
+	//Sectors written since the file size was last updated on the card
+	uint16_t mUnsyncedSectors;
+
+	tFlightRecorderStats mStats;
+};
+
+#endif /* FLIGHTRECORDER_H_ */
@@ -0,0 +1,184 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * FontDescriptor.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Sound/FontDescriptor.h"
+#include "NSaberLog.h"
+
+FontDescriptor::FontDescriptor()
+{
+	Clear();
+}
+
+void FontDescriptor::Clear()
+{
+	for(int lIdx = 0; lIdx < SoundTypes::eeMaxSoundTypes; lIdx++)
+	{
+		mapNaming[lIdx] = nullptr;
+	}
+
+	uint8_t laNoCounts[SoundTypes::eeMaxSoundTypes] = {0};
+	SetCounts(laNoCounts);
+}
+
+bool FontDescriptor::SetCounts(const uint8_t* apCounts)
+{
+	bool lFits = true;
+	uint16_t lNumSlots = 0;
+
+	for(int lIdx = 0; lIdx < SoundTypes::eeMaxSoundTypes; lIdx++)
+	{
+		maFirstSlot[lIdx] = lNumSlots;
+
+		uint16_t lCount = apCounts[lIdx];
+		if(lNumSlots + lCount > NSABER_MAX_FONT_SOUNDS)
+		{
+			lCount = NSABER_MAX_FONT_SOUNDS - lNumSlots;
+			lFits = false;
+		}
+		lNumSlots += lCount;
+	}
+	maFirstSlot[SoundTypes::eeMaxSoundTypes] = lNumSlots;
+
+	if(!lFits)
+	{
+		NSABER_LOG_ERROR("Font has too many sounds, keeping ", (int32_t)lNumSlots);
+	}
+
+	memset(maFormat, FONT_DESCRIPTOR_NO_FORMAT, sizeof(maFormat));
+	mNumFormats = 0;
+	mNumLoops = 0;
+
+	return lFits;
+}
+
+void FontDescriptor::SetNaming(SoundTypes::ESoundTypes aSoundType, const FontLayout::tSoundNaming* apNaming)
+{
+	if(aSoundType < SoundTypes::eeMaxSoundTypes)
+	{
+		mapNaming[aSoundType] = apNaming;
+	}
+}
+
+bool FontDescriptor::SetRegion(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex, const WavHeader::tWavInfo& arInfo)
+{
+	int lSlot = GetSlot(aSoundType, aIndex);
+	if(lSlot < 0)
+	{
+		return false;
+	}
+
+	//Most fonts use a single format, share it between all their sounds
+	uint8_t lFormat = 0;
+	while(lFormat < mNumFormats
+	      && !(maFormats[lFormat].mFormat == arInfo.mFormat
+	           && maFormats[lFormat].mNumChannels == arInfo.mNumChannels
+	           && maFormats[lFormat].mSampleRate == arInfo.mSampleRate
+	           && maFormats[lFormat].mByteRate == arInfo.mByteRate
+	           && maFormats[lFormat].mBlockAlign == arInfo.mBlockAlign
+	           && maFormats[lFormat].mBitsPerSample == arInfo.mBitsPerSample))
+	{
+		lFormat++;
+	}
+
+	if(lFormat == mNumFormats)
+	{
+		if(mNumFormats >= FONT_DESCRIPTOR_MAX_FORMATS)
+		{
+			return false;
+		}
+
+		maFormats[lFormat] = arInfo;
+		maFormats[lFormat].mDataStart = 0;
+		maFormats[lFormat].mDataLength = 0;
+		maFormats[lFormat].mLoopStart = 0;
+		maFormats[lFormat].mLoopEnd = 0;
+		mNumFormats++;
+	}
+
+	maFormat[lSlot] = lFormat;
+	maDataStart[lSlot] = arInfo.mDataStart;
+	maDataLength[lSlot] = arInfo.mDataLength;
+
+	bool lWholeLoop = 0 == arInfo.mLoopStart && (0 == arInfo.mLoopEnd || arInfo.mDataLength == arInfo.mLoopEnd);
+	if(!lWholeLoop && mNumLoops < FONT_DESCRIPTOR_MAX_LOOPS)
+	{
+		maLoopSlot[mNumLoops] = lSlot;
+		maLoopStart[mNumLoops] = arInfo.mLoopStart;
+		maLoopEnd[mNumLoops] = arInfo.mLoopEnd;
+		mNumLoops++;
+	}
+
+	return true;
+}
+
+uint8_t FontDescriptor::GetCount(SoundTypes::ESoundTypes aSoundType) const
+{
+	if(aSoundType >= SoundTypes::eeMaxSoundTypes)
+	{
+		return 0;
+	}
+
+	return maFirstSlot[aSoundType + 1] - maFirstSlot[aSoundType];
+}
+
+bool FontDescriptor::GetName(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex, char* apStrOut) const
+{
+	if(GetSlot(aSoundType, aIndex) < 0 || nullptr == mapNaming[aSoundType])
+	{
+		return false;
+	}
+
+	return FontLayout::FormatName(*mapNaming[aSoundType], aIndex, apStrOut);
+}
+
+bool FontDescriptor::GetRegion(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex, WavHeader::tWavInfo& arInfo) const
+{
+	int lSlot = GetSlot(aSoundType, aIndex);
+	if(lSlot < 0 || FONT_DESCRIPTOR_NO_FORMAT == maFormat[lSlot])
+	{
+		return false;
+	}
+
+	arInfo = maFormats[maFormat[lSlot]];
+	arInfo.mDataStart = maDataStart[lSlot];
+	arInfo.mDataLength = maDataLength[lSlot];
+
+	for(uint8_t lLoop = 0; lLoop < mNumLoops; lLoop++)
+	{
+		if(maLoopSlot[lLoop] == lSlot)
+		{
+			arInfo.mLoopStart = maLoopStart[lLoop];
+			arInfo.mLoopEnd = maLoopEnd[lLoop];
+		}
+	}
+
+	return true;
+}
+
+int FontDescriptor::GetSlot(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex) const
+{
+	if(aIndex >= GetCount(aSoundType))
+	{
+		return -1;
+	}
+
+	return maFirstSlot[aSoundType] + aIndex;
+}
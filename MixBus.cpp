@@ -0,0 +1,145 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * MixBus.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Sound/MixBus.h"
+
+#define MIX_BUS_UNITY (32768)
+
+MixBus::MixBus()
+{
+	mMasterGain = MIX_BUS_UNITY;
+	mLimiterGain = MIX_BUS_UNITY;
+	mLimiterEnabled = true;
+	mClippedSamples = 0;
+	mLevel = 0;
+}
+
+void MixBus::SetMasterVolume(float aVolume)
+{
+	mMasterGain = (int32_t)(constrain(aVolume, 0.0, 1.0) * 32768.0);
+}
+
+void MixBus::SetLimiterEnabled(bool aEnabled)
+{
+	mLimiterEnabled = aEnabled;
+	mLimiterGain = MIX_BUS_UNITY;
+}
+
+void MixBus::Process(const int32_t* apMix, int16_t* apOut, uint16_t aNumSamples)
+{
+	if(0 == aNumSamples)
+	{
+		return;
+	}
+
+	//Peak of the block after the master volume
+	int32_t lPeak = 0;
+	for(int lIdx = 0; lIdx < aNumSamples; lIdx++)
+	{
+		int32_t lLevel = abs(apMix[lIdx]);
+		lPeak = max(lPeak, lLevel);
+	}
+	lPeak = (int32_t)(((int64_t)lPeak * mMasterGain) >> 15);
+
+	//Gain that would just fit the block under the threshold
+	int32_t lTarget = MIX_BUS_UNITY;
+	if(mLimiterEnabled && lPeak > MIX_BUS_LIMIT_THRESHOLD)
+	{
+		lTarget = (int32_t)(((int64_t)MIX_BUS_LIMIT_THRESHOLD << 15) / lPeak);
+	}
+
+	//Attack within this block, release over many
+	int32_t lEndGain = lTarget;
+	if(lTarget > mLimiterGain)
+	{
+		lEndGain = mLimiterGain + ((lTarget - mLimiterGain) >> MIX_BUS_RELEASE_SHIFT) + 1;
+		lEndGain = min(lEndGain, lTarget);
+	}
+
+	//Ramp the combined gain across the block (16.16 on top of Q15)
+	int64_t lGain = ((int64_t)mLimiterGain * mMasterGain) << 1;
+	int64_t lStep = ((((int64_t)lEndGain * mMasterGain) << 1) - lGain) / aNumSamples;
+
+	uint32_t lSum = 0;
+	for(int lIdx = 0; lIdx < aNumSamples; lIdx++)
+	{
+		lGain += lStep;
+		int32_t lSample = (int32_t)(((int64_t)apMix[lIdx] * (int32_t)(lGain >> 16)) >> 15);
+		apOut[lIdx] = SoftClip(lSample);
+		lSum += abs(apOut[lIdx]);
+	}
+
+	mLimiterGain = lEndGain;
+
+	//Follow the block's average level, quickly up and slowly down
+	int32_t lBlockLevel = lSum / aNumSamples;
+	int32_t lLevel = mLevel;
+	if(lBlockLevel > lLevel)
+	{
+		lLevel += (lBlockLevel - lLevel + (1 << MIX_BUS_ENVELOPE_ATTACK_SHIFT) - 1) >> MIX_BUS_ENVELOPE_ATTACK_SHIFT;
+	}
+	else
+	{
+		lLevel -= (lLevel - lBlockLevel + (1 << MIX_BUS_ENVELOPE_RELEASE_SHIFT) - 1) >> MIX_BUS_ENVELOPE_RELEASE_SHIFT;
+	}
+	mLevel = (uint16_t)lLevel;
+}
+
+int32_t MixBus::GetLimiterGain()
+{
+	return mLimiterGain;
+}
+
+uint32_t MixBus::TakeClippedSamples()
+{
+	uint32_t lCount = mClippedSamples;
+	mClippedSamples = 0;
+	return lCount;
+}
+
+uint16_t MixBus::GetLevel()
+{
+	return mLevel;
+}
+
+const volatile uint16_t* MixBus::GetLevelTap()
+{
+	return &mLevel;
+}
+
+int16_t MixBus::SoftClip(int32_t aSample)
+{
+	int32_t lLevel = abs(aSample);
+	if(lLevel <= MIX_BUS_LIMIT_THRESHOLD)
+	{
+		return (int16_t)aSample;
+	}
+
+	mClippedSamples++;
+
+	//Above the threshold, the curve starts with a slope of one and
+	//approaches full scale without reaching it
+	const int32_t lRoom = 32767 - MIX_BUS_LIMIT_THRESHOLD;
+	int32_t lOver = lLevel - MIX_BUS_LIMIT_THRESHOLD;
+	int32_t lBent = MIX_BUS_LIMIT_THRESHOLD + (int32_t)(((int64_t)lOver * lRoom) / (lOver + lRoom));
+
+	return (int16_t)(aSample < 0 ? -lBent : lBent);
+}
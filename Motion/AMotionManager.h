@@ -22,6 +22,8 @@
 #if not defined IMOTIONMANAGER_H_
 #define IMOTIONMANAGER_H_
 
+#include "EventQueue.h"
+
 enum EMagnitudes {
 	eeSmall, eeMedium, eeLarge
 };
@@ -105,6 +107,40 @@ public:
 		return eeLarge;
 	}
 
+	/**
+	 * Sets a queue to post swing, clash and twist events to as Update()
+	 * detects them, each with the time it was detected. Events are posted
+	 * when a motion begins, so one that lasts several updates is posted
+	 * once. The queue must be popped from a single context.
+	 * Args:
+	 *  apQueue - Queue to post to, or nullptr for none
+	 */
+	virtual void SetEventQueue(SaberEventQueue* apQueue)
+	{
+		mpEventQueue = apQueue;
+	}
+
+protected:
+
+	AMotionManager()
+	{
+		mpEventQueue = nullptr;
+	}
+
+	/**
+	 * Posts an event to the event queue, if there is one.
+	 * Args:
+	 *  aType - What happened
+	 *  aDetail - Detail, depends on the type
+	 */
+	void PostEvent(ESaberEvent aType, uint8_t aDetail = 0)
+	{
+		PostSaberEvent(mpEventQueue, aType, aDetail);
+	}
+
+	//Queue events are posted to, nullptr for none
+	SaberEventQueue* mpEventQueue;
+
 };
 
 #endif /* IMOTIONMANAGER_H_ */
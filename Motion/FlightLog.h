@@ -0,0 +1,103 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * FlightLog.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef FLIGHTLOG_H_
+#define FLIGHTLOG_H_
+
+#include <stdint.h>
+
+/**
+ * Motion flight log (".nfl"), written by FlightRecorder.
+ *
+ * A log is a run of 512 byte sectors, each holding 32 records of 16 bytes,
+ * so records never straddle a sector. All values are little-endian. The
+ * first record is a header and the second a sync record. Each record's
+ * time is the time of the record before it plus its mDeltaUs, except sync
+ * records, which give the time outright. A sync record is written whenever
+ * the gap is too long for mDeltaUs. Pad records fill out the last sector
+ * and are skipped.
+ *
+ * Logs are decoded on a PC by tools/flightlog.
+ */
+
+#define FLIGHT_LOG_MAGIC       (0x4C46) //"FL"
+#define FLIGHT_LOG_VERSION     (1)
+
+//Size of a sector, records are grouped into these for writing
+#define FLIGHT_LOG_SECTOR_SIZE (512)
+
+//File name extension of flight logs
+#define FLIGHT_LOG_EXTENSION ".nfl"
+
+namespace FlightLog
+{
+
+//What a record holds
+enum ERecordType
+{
+	eePadRecord,    //Filler, skip it
+	eeHeaderRecord, //mDetail is FLIGHT_LOG_VERSION, maValues[0] is FLIGHT_LOG_MAGIC
+	eeSyncRecord,   //maValues[0] and [1] are the low and high words of micros()
+	eeSampleRecord, //maValues are the raw accelerometer X, Y, Z and gyro X, Y, Z
+	eeEventRecord,  //mDetail is the ESaberEvent, maValues[0] its detail
+	eeDroppedRecord //maValues[0] and [1] are the low and high words of the
+	                //number of records dropped just before this one
+};
+
+//One record
+struct tFlightRecord
+{
+	//ERecordType
+	uint8_t mType;
+	//Depends on the type, see ERecordType
+	uint8_t mDetail;
+	//Microseconds since the record before
+	uint16_t mDeltaUs;
+	//Depends on the type, see ERecordType
+	int16_t maValues[6];
+};
+
+static_assert(sizeof(tFlightRecord) == 16, "Flight log record layout changed");
+static_assert(0 == FLIGHT_LOG_SECTOR_SIZE % sizeof(tFlightRecord), "Records must fill a sector exactly");
+
+//Records in a sector
+#define FLIGHT_LOG_SECTOR_RECORDS (FLIGHT_LOG_SECTOR_SIZE / sizeof(FlightLog::tFlightRecord))
+
+/**
+ * Stores a 32-bit value in two record values, low word first.
+ */
+inline void SetWord32(tFlightRecord& arRecord, uint32_t aValue)
+{
+	arRecord.maValues[0] = (int16_t)(aValue & 0xFFFF);
+	arRecord.maValues[1] = (int16_t)(aValue >> 16);
+}
+
+/**
+ * Fetches a 32-bit value stored by SetWord32().
+ */
+inline uint32_t GetWord32(const tFlightRecord& arRecord)
+{
+	return (uint32_t)(uint16_t)arRecord.maValues[0] | ((uint32_t)(uint16_t)arRecord.maValues[1] << 16);
+}
+
+};
+
+#endif /* FLIGHTLOG_H_ */
@@ -0,0 +1,181 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * MotionCalibrator.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef MOTIONCALIBRATOR_H_
+#define MOTIONCALIBRATOR_H_
+
+#include <stdint.h>
+#include "P2Quantile.h"
+
+//Percentiles of the rotation seen while swinging that become the small,
+//medium and large swing thresholds
+#if not defined NSABER_CALIBRATE_SWING_SMALL
+#define NSABER_CALIBRATE_SWING_SMALL (0.25)
+#endif
+#if not defined NSABER_CALIBRATE_SWING_MEDIUM
+#define NSABER_CALIBRATE_SWING_MEDIUM (0.60)
+#endif
+#if not defined NSABER_CALIBRATE_SWING_LARGE
+#define NSABER_CALIBRATE_SWING_LARGE (0.90)
+#endif
+
+//Percentile of the rotation about the blade seen while twisting that
+//becomes the twist threshold
+#if not defined NSABER_CALIBRATE_TWIST
+#define NSABER_CALIBRATE_TWIST (0.50)
+#endif
+
+//Percentile of the change in acceleration between reads that swinging
+//alone reaches, and how far above it, in percent, a clash must be
+#if not defined NSABER_CALIBRATE_CLASH
+#define NSABER_CALIBRATE_CLASH (0.99)
+#endif
+#if not defined NSABER_CALIBRATE_CLASH_MARGIN
+#define NSABER_CALIBRATE_CLASH_MARGIN (150)
+#endif
+
+//Rotation below which the blade is taken to be held still, so the sample
+//doesn't count towards the swing and twist thresholds
+#if not defined NSABER_CALIBRATE_ACTIVE_FLOOR
+#define NSABER_CALIBRATE_ACTIVE_FLOOR (50)
+#endif
+
+//Swinging samples needed for a calibration to succeed
+#if not defined NSABER_CALIBRATE_MIN_SAMPLES
+#define NSABER_CALIBRATE_MIN_SAMPLES (100)
+#endif
+
+//Limits the swing and twist thresholds are kept within, the recommended range
+#define CALIBRATE_SWING_MIN (50)
+#define CALIBRATE_SWING_MAX (512)
+
+/**
+ * Where a calibration is at.
+ */
+enum ECalibrationState
+{
+	eeCalibrationIdle,    //Not started
+	eeCalibrationRunning, //Gathering samples
+	eeCalibrationDone,    //Finished, thresholds are ready
+	eeCalibrationFailed   //Finished without enough swinging to go on
+};
+
+/**
+ * Thresholds worked out by a calibration, in the units of the motion
+ * manager's tolerance data.
+ */
+struct tCalibrationResult
+{
+	unsigned int mSwingSmall;
+	unsigned int mSwingMedium;
+	unsigned int mSwingLarge;
+	unsigned int mTwist;
+	//Change in acceleration between reads a clash must exceed
+	unsigned int mClash;
+};
+
+/**
+ * Works out swing, twist and clash thresholds from how the saber is
+ * actually swung. Start it, swing the saber the way it will be used for the
+ * length of the calibration, and the thresholds are taken as percentiles of
+ * the motion seen. Percentiles are estimated on the fly, so memory use is
+ * the same however long the calibration runs.
+ */
+class MotionCalibrator
+{
+public:
+
+	MotionCalibrator();
+
+	/**
+	 * Starts a calibration, forgetting any earlier one.
+	 * Args:
+	 *  aDurationMs - How long to gather samples for
+	 */
+	void Start(uint32_t aDurationMs);
+
+	/**
+	 * Adds a motion sensor reading. Does nothing unless running.
+	 * Args:
+	 *  aNowMs - millis() of the reading
+	 *  aRotation - Rotation across the blade, as compared to swing thresholds
+	 *  aTwist - Rotation about the blade, as compared to the twist threshold
+	 *  aJerk - Largest change on any axis of the accelerometer since the
+	 *          last reading
+	 */
+	void AddSample(uint32_t aNowMs, uint16_t aRotation, uint16_t aTwist, uint16_t aJerk);
+
+	/**
+	 * Fetch where the calibration is at.
+	 */
+	ECalibrationState GetState() const
+	{
+		return mState;
+	}
+
+	/**
+	 * Fetch the thresholds, with the swing and twist thresholds limited to
+	 * the recommended range and the swing thresholds in order.
+	 * Args:
+	 *  arOut - Output parameter, populated with the thresholds
+	 * Returns:
+	 *  TRUE if the calibration is done, FALSE if not, leaving arOut alone
+	 */
+	bool GetResult(tCalibrationResult& arOut) const;
+
+	/**
+	 * Fetch the number of readings added, and of those, the ones taken
+	 * while swinging.
+	 */
+	uint32_t GetSamples() const
+	{
+		return mSamples;
+	}
+
+	uint32_t GetSwingSamples() const
+	{
+		return maSwing[0].GetCount();
+	}
+
+protected:
+
+	//Estimates of the swing threshold percentiles, small, medium and large
+	P2Quantile maSwing[3];
+
+	//Estimate of the twist threshold percentile
+	P2Quantile mTwist;
+
+	//Estimate of the clash threshold percentile, before the margin
+	P2Quantile mJerk;
+
+	//Readings added
+	uint32_t mSamples;
+
+	//millis() of the first reading
+	uint32_t mStartMs;
+
+	//How long to gather samples for
+	uint32_t mDurationMs;
+
+	ECalibrationState mState;
+};
+
+#endif /* MOTIONCALIBRATOR_H_ */
@@ -23,6 +23,7 @@
 #define MPU6050LITEMOTIONMANAGER_H_
 
 #include "AMotionManager.h"
+#include "MotionCalibrator.h"
 #include <Arduino.h>
 
 #define MPU6050_CLOCK_INTERNAL          0x00
@@ -43,6 +44,7 @@
 #define MPU6050_ACCEL_FS_8          0x02
 #define MPU6050_ACCEL_FS_16         0x03
 
+#define MPU6050_RA_MOT_THR          0x1F
 #define MPU6050_RA_INT_ENABLE       0x38
 #define MPU6050_RA_INT_STATUS       0x3A
 
@@ -52,6 +54,17 @@
 #define MPU6050_RA_PWR_MGMT_1       0x6B
 #define MPU6050_RA_PWR_MGMT_2       0x6C
 
+//Acceleration of one step of the motion detection threshold, in mg
+#if not defined MPU6050_MOT_THR_MG
+#define MPU6050_MOT_THR_MG (2)
+#endif
+
+//Recommended limits of the motion detection (clash) threshold
+#define MPU6050_MOT_THR_MIN (10)
+#define MPU6050_MOT_THR_MAX (64)
+
+
+class FlightRecorder;
 
 //Container to define motion tolerance data
 struct MPU6050LiteTolData
@@ -101,6 +114,24 @@ public:
 	virtual EMagnitudes GetSwingMagnitude();
 
 	virtual void Sleep();
+
+	/**
+	 * Calibrates the thresholds from the motion seen by Update(). Start the
+	 * calibrator first. When it's done, the swing, twist and clash
+	 * thresholds in the tolerance data are replaced, the clash threshold is
+	 * programmed into the MPU6050 and an eeCalibrationEvent is posted, with
+	 * a detail of 1 if the thresholds changed or 0 if the calibration failed.
+	 * Args:
+	 *  apCalibrator - Running calibrator, or nullptr to stop calibrating
+	 */
+	void SetCalibrator(MotionCalibrator* apCalibrator);
+
+	/**
+	 * Sets a recorder to log every raw sensor reading and detected event to.
+	 * Args:
+	 *  apRecorder - Recorder, or nullptr for none
+	 */
+	void SetRecorder(FlightRecorder* apRecorder);
 protected :
 	//Container for time-stamped axis data
 	typedef struct
@@ -132,6 +163,22 @@ protected :
 	 */
 	void I2CWrite(uint8_t aAddr, uint8_t aByte);
 
+	/**
+	 * Feeds the latest readings to the calibrator, and applies the
+	 * thresholds when it's done.
+	 * Args:
+	 *  aNowMs - millis() of the readings
+	 */
+	void Calibrate(unsigned long aNowMs);
+
+	/**
+	 * Posts an event to the event queue and the recorder, if there are any.
+	 * Args:
+	 *  aType - What happened
+	 *  aDetail - Detail, depends on the type
+	 */
+	void ReportEvent(ESaberEvent aType, uint8_t aDetail = 0);
+
 	// Magnitude of last detected swing
 	EMagnitudes mSwingMagnitude;
 
@@ -148,6 +195,15 @@ protected :
 	// Last time we checked for swing events
 	unsigned long mLastSwingDetectTime;
 
+	// Calibration in progress, nullptr for none
+	MotionCalibrator* mpCalibrator;
+
+	// Recorder of sensor readings, nullptr for none
+	FlightRecorder* mpRecorder;
+
+	// micros() of the last sensor read, for latency tracing
+	uint32_t mLastSampleUs;
+
 	//Flags if swing was detected in last update cycle
 	bool mIsSwing;
 
@@ -0,0 +1,226 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * P2Quantile.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef P2QUANTILE_H_
+#define P2QUANTILE_H_
+
+#include <stdint.h>
+
+/**
+ * Streaming estimate of one quantile, such as the median or the 90th
+ * percentile, using the P-squared algorithm of Jain and Chlamtac. Five
+ * markers are kept whatever the number of samples, and they are nudged
+ * towards their ideal positions along a parabola as samples arrive, so
+ * memory and time per sample are constant.
+ *
+ * Header only so the PC tools can use it.
+ */
+class P2Quantile
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  aQuantile - Quantile to estimate, 0.0 to 1.0
+	 */
+	P2Quantile(float aQuantile = 0.5)
+	{
+		Reset(aQuantile);
+	}
+
+	/**
+	 * Forgets all samples.
+	 * Args:
+	 *  aQuantile - Quantile to estimate, 0.0 to 1.0
+	 */
+	void Reset(float aQuantile)
+	{
+		mQuantile = aQuantile;
+		mCount = 0;
+
+		maRateDesired[0] = 0.0;
+		maRateDesired[1] = aQuantile / 2.0;
+		maRateDesired[2] = aQuantile;
+		maRateDesired[3] = (1.0 + aQuantile) / 2.0;
+		maRateDesired[4] = 1.0;
+	}
+
+	/**
+	 * Adds a sample.
+	 * Args:
+	 *  aValue - The sample
+	 */
+	void Add(float aValue)
+	{
+		//The first five samples become the markers
+		if(mCount < 5)
+		{
+			int lIdx = mCount;
+			while(lIdx > 0 && maHeights[lIdx - 1] > aValue)
+			{
+				maHeights[lIdx] = maHeights[lIdx - 1];
+				lIdx--;
+			}
+			maHeights[lIdx] = aValue;
+			mCount++;
+
+			if(5 == mCount)
+			{
+				for(int lMarker = 0; lMarker < 5; lMarker++)
+				{
+					maPositions[lMarker] = lMarker + 1;
+					maDesired[lMarker] = 1.0 + 4.0 * maRateDesired[lMarker];
+				}
+			}
+			return;
+		}
+
+		mCount++;
+
+		//Find the cell the sample falls in, stretching the ends if needed
+		int lCell;
+		if(aValue < maHeights[0])
+		{
+			maHeights[0] = aValue;
+			lCell = 0;
+		}
+		else if(aValue >= maHeights[4])
+		{
+			maHeights[4] = aValue;
+			lCell = 3;
+		}
+		else
+		{
+			lCell = 0;
+			while(aValue >= maHeights[lCell + 1])
+			{
+				lCell++;
+			}
+		}
+
+		for(int lMarker = lCell + 1; lMarker < 5; lMarker++)
+		{
+			maPositions[lMarker]++;
+		}
+		for(int lMarker = 0; lMarker < 5; lMarker++)
+		{
+			maDesired[lMarker] += maRateDesired[lMarker];
+		}
+
+		//Move the middle markers that have fallen a whole place behind
+		for(int lMarker = 1; lMarker < 4; lMarker++)
+		{
+			float lOffset = maDesired[lMarker] - maPositions[lMarker];
+
+			if((lOffset >= 1.0 && maPositions[lMarker + 1] - maPositions[lMarker] > 1)
+			   || (lOffset <= -1.0 && maPositions[lMarker - 1] - maPositions[lMarker] < -1))
+			{
+				int lStep = lOffset >= 0.0 ? 1 : -1;
+				float lHeight = Parabolic(lMarker, lStep);
+
+				if(maHeights[lMarker - 1] < lHeight && lHeight < maHeights[lMarker + 1])
+				{
+					maHeights[lMarker] = lHeight;
+				}
+				else
+				{
+					//The parabola overshoots a neighbour, go in a straight line
+					maHeights[lMarker] += lStep * (maHeights[lMarker + lStep] - maHeights[lMarker])
+					                      / (maPositions[lMarker + lStep] - maPositions[lMarker]);
+				}
+				maPositions[lMarker] += lStep;
+			}
+		}
+	}
+
+	/**
+	 * Fetch the estimate.
+	 * Returns:
+	 *  The quantile of the samples so far, exact for up to five samples,
+	 *  or 0 when there are none.
+	 */
+	float Get() const
+	{
+		if(0 == mCount)
+		{
+			return 0.0;
+		}
+
+		if(mCount < 5)
+		{
+			//Nearest rank among the samples so far
+			int lRank = (int)(mQuantile * (mCount - 1) + 0.5);
+			return maHeights[lRank];
+		}
+
+		return maHeights[2];
+	}
+
+	/**
+	 * Fetch the number of samples added.
+	 */
+	uint32_t GetCount() const
+	{
+		return mCount;
+	}
+
+protected:
+
+	/**
+	 * Works out the height of a marker moved one place along the parabola
+	 * through it and its neighbours.
+	 * Args:
+	 *  aMarker - Marker to move, 1 to 3
+	 *  aStep - Direction to move it, 1 or -1
+	 */
+	float Parabolic(int aMarker, int aStep) const
+	{
+		float lLeft = maPositions[aMarker] - maPositions[aMarker - 1];
+		float lRight = maPositions[aMarker + 1] - maPositions[aMarker];
+
+		return maHeights[aMarker]
+		       + (float)aStep / (maPositions[aMarker + 1] - maPositions[aMarker - 1])
+		         * ((lLeft + aStep) * (maHeights[aMarker + 1] - maHeights[aMarker]) / lRight
+		            + (lRight - aStep) * (maHeights[aMarker] - maHeights[aMarker - 1]) / lLeft);
+	}
+
+	//Quantile being estimated
+	float mQuantile;
+
+	//Samples added
+	uint32_t mCount;
+
+	//Marker heights, the estimates of the minimum, the quantile halfway to
+	//it, the quantile, the quantile halfway to the maximum and the maximum
+	float maHeights[5];
+
+	//Marker positions, the ranks of the markers among the samples
+	int32_t maPositions[5];
+
+	//Positions the markers should be at
+	float maDesired[5];
+
+	//How far each desired position moves per sample
+	float maRateDesired[5];
+};
+
+#endif /* P2QUANTILE_H_ */
@@ -0,0 +1,124 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * MotionCalibrator.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Motion/MotionCalibrator.h"
+
+/**
+ * Rounds a threshold estimate and keeps it within limits.
+ */
+static unsigned int ClampThreshold(float aValue, unsigned int aMin, unsigned int aMax)
+{
+	if(aValue <= aMin)
+	{
+		return aMin;
+	}
+	if(aValue >= aMax)
+	{
+		return aMax;
+	}
+	return (unsigned int)(aValue + 0.5);
+}
+
+MotionCalibrator::MotionCalibrator()
+{
+	mSamples = 0;
+	mStartMs = 0;
+	mDurationMs = 0;
+	mState = eeCalibrationIdle;
+}
+
+void MotionCalibrator::Start(uint32_t aDurationMs)
+{
+	maSwing[0].Reset(NSABER_CALIBRATE_SWING_SMALL);
+	maSwing[1].Reset(NSABER_CALIBRATE_SWING_MEDIUM);
+	maSwing[2].Reset(NSABER_CALIBRATE_SWING_LARGE);
+	mTwist.Reset(NSABER_CALIBRATE_TWIST);
+	mJerk.Reset(NSABER_CALIBRATE_CLASH);
+
+	mSamples = 0;
+	mStartMs = 0;
+	mDurationMs = aDurationMs;
+	mState = eeCalibrationRunning;
+}
+
+void MotionCalibrator::AddSample(uint32_t aNowMs, uint16_t aRotation, uint16_t aTwist, uint16_t aJerk)
+{
+	if(eeCalibrationRunning != mState)
+	{
+		return;
+	}
+
+	if(0 == mSamples)
+	{
+		mStartMs = aNowMs;
+	}
+	else
+	{
+		//There's nothing to compare the first reading's acceleration with
+		mJerk.Add(aJerk);
+	}
+	mSamples++;
+
+	//Swings and twists are told apart the way the motion manager does it
+	if(aRotation >= NSABER_CALIBRATE_ACTIVE_FLOOR && aRotation > aTwist)
+	{
+		for(int lIdx = 0; lIdx < 3; lIdx++)
+		{
+			maSwing[lIdx].Add(aRotation);
+		}
+	}
+	else if(aTwist >= NSABER_CALIBRATE_ACTIVE_FLOOR)
+	{
+		mTwist.Add(aTwist);
+	}
+
+	if(aNowMs - mStartMs >= mDurationMs)
+	{
+		mState = maSwing[0].GetCount() >= NSABER_CALIBRATE_MIN_SAMPLES
+		         ? eeCalibrationDone : eeCalibrationFailed;
+	}
+}
+
+bool MotionCalibrator::GetResult(tCalibrationResult& arOut) const
+{
+	if(eeCalibrationDone != mState)
+	{
+		return false;
+	}
+
+	arOut.mSwingSmall = ClampThreshold(maSwing[0].Get(), CALIBRATE_SWING_MIN, CALIBRATE_SWING_MAX - 2);
+	arOut.mSwingMedium = ClampThreshold(maSwing[1].Get(), arOut.mSwingSmall + 1, CALIBRATE_SWING_MAX - 1);
+	arOut.mSwingLarge = ClampThreshold(maSwing[2].Get(), arOut.mSwingMedium + 1, CALIBRATE_SWING_MAX);
+
+	//Without any twisting to go on, only a twist as big as a large swing counts
+	if(0 == mTwist.GetCount())
+	{
+		arOut.mTwist = arOut.mSwingLarge;
+	}
+	else
+	{
+		arOut.mTwist = ClampThreshold(mTwist.Get(), CALIBRATE_SWING_MIN, CALIBRATE_SWING_MAX);
+	}
+
+	arOut.mClash = (unsigned int)(mJerk.Get() * NSABER_CALIBRATE_CLASH_MARGIN / 100.0 + 0.5);
+
+	return true;
+}
@@ -21,6 +21,8 @@
 
 
 #include "Motion/Mpu6050LiteMotionManager.h"
+#include "Sound/SoundTelemetry.h"
+#include "FlightRecorder.h"
 #include <Arduino.h>
 
 #if I2CDEV_IMPLEMENTATION == I2CDEV_ARDUINO_WIRE
@@ -36,6 +38,9 @@ Mpu6050LiteMotionManager::Mpu6050LiteMotionManager(MPU6050LiteTolData* apTolData
 	mIsTwist = false;
 	mSwingMagnitude = eeSmall;
 	mLastSwingDetectTime = 0;
+	mLastSampleUs = 0;
+	mpCalibrator = nullptr;
+	mpRecorder = nullptr;
 	mWireStarted = false;
 }
 
@@ -58,7 +63,7 @@ void Mpu6050LiteMotionManager::Init()
 
 	//Set up clash detection
 	I2CWrite(0x38, 0b00100000); //Enable motion detection interrupt status
-	I2CWrite(0x1F, (uint8_t)mpTolData->mClash); //Set motion detection threshold for interrupt
+	I2CWrite(MPU6050_RA_MOT_THR, (uint8_t)mpTolData->mClash); //Set motion detection threshold for interrupt
 	I2CWrite(0x20, 2);  //Set motion detection duration samples
 
 	mWireStarted = true;
@@ -94,6 +99,10 @@ void Mpu6050LiteMotionManager::Update()
 		return;
 	}
 
+	uint32_t lSampleUs = SoundTelemetry::Now();
+	uint32_t lIntervalUs = lSampleUs - mLastSampleUs;
+	mLastSampleUs = lSampleUs;
+
 	Wire.beginTransmission(mMpuAddr);
 	Wire.write(0x3B);  // starting with register 0x3B (ACCEL_XOUT_H)
 	Wire.endTransmission(false);
@@ -113,6 +122,14 @@ void Mpu6050LiteMotionManager::Update()
 	mCurGyroReading.mnY=Wire.read()<<8|Wire.read();  // 0x45 (GYRO_YOUT_H) & 0x46 (GYRO_YOUT_L)
 	mCurGyroReading.mnZ=Wire.read()<<8|Wire.read();  // 0x47 (GYRO_ZOUT_H) & 0x48 (GYRO_ZOUT_L)
 
+	//Record the readings at full resolution
+	if(nullptr != mpRecorder)
+	{
+		int16_t laRaw[6] = { mCurAcclReading.mnX, mCurAcclReading.mnY, mCurAcclReading.mnZ,
+		                     mCurGyroReading.mnX, mCurGyroReading.mnY, mCurGyroReading.mnZ };
+		mpRecorder->RecordSample(micros(), laRaw);
+	}
+
 	//Chop off low order bits so our readings don't jiggle and wiggle like Jell-O
 	int lChopBits = 6;
 	mCurAcclReading.mnX = (mCurAcclReading.mnX >> lChopBits);
@@ -126,17 +143,103 @@ void Mpu6050LiteMotionManager::Update()
 	mCurAcclReading.mTimeStamp = lNow;
 	mCurGyroReading.mTimeStamp = lNow;
 
+	bool lWasClash = mIsClash;
 	mIsClash = ClashDetect();
+	if(mIsClash && !lWasClash)
+	{
+		ReportEvent(eeClashEvent, GetClashMagnitude());
+		SoundTelemetry::NoteMotion(lSampleUs, lIntervalUs);
+	}
 
 	//Check for swings
 	if(!mIsClash && lNow - mLastSwingDetectTime >= 5)
 	{
+		bool lWasSwing = mIsSwing;
+		bool lWasTwist = mIsTwist;
+
 		mLastSwingDetectTime = lNow;
 		mIsTwist = false; //Reset the twist flag, may be set to true by SwingDetect()
 		mIsSwing = SwingDetect();
+
+		if(mIsSwing && !lWasSwing)
+		{
+			ReportEvent(eeSwingEvent, mSwingMagnitude);
+			SoundTelemetry::NoteMotion(lSampleUs, lIntervalUs);
+		}
+
+		if(mIsTwist && !lWasTwist)
+		{
+			ReportEvent(eeTwistEvent);
+		}
+	}
+
+	if(nullptr != mpCalibrator)
+	{
+		Calibrate(lNow);
 	}
 }
 
+void Mpu6050LiteMotionManager::SetCalibrator(MotionCalibrator* apCalibrator)
+{
+	mpCalibrator = apCalibrator;
+}
+
+void Mpu6050LiteMotionManager::SetRecorder(FlightRecorder* apRecorder)
+{
+	mpRecorder = apRecorder;
+}
+
+void Mpu6050LiteMotionManager::ReportEvent(ESaberEvent aType, uint8_t aDetail)
+{
+	PostEvent(aType, aDetail);
+
+	if(nullptr != mpRecorder)
+	{
+		mpRecorder->RecordEvent(micros(), aType, aDetail);
+	}
+}
+
+void Mpu6050LiteMotionManager::Calibrate(unsigned long aNowMs)
+{
+	uint16_t lRotation = max(abs(mCurGyroReading.mnX),abs(mCurGyroReading.mnZ));
+	uint16_t lTwist = abs(mCurGyroReading.mnY);
+	uint16_t lJerk = max(abs(mCurAcclReading.mnX - mLastAcclReading.mnX),
+	                     abs(mCurAcclReading.mnY - mLastAcclReading.mnY));
+	lJerk = max(lJerk, (uint16_t)abs(mCurAcclReading.mnZ - mLastAcclReading.mnZ));
+
+	mpCalibrator->AddSample(aNowMs, lRotation, lTwist, lJerk);
+
+	switch(mpCalibrator->GetState())
+	{
+	case eeCalibrationRunning:
+		return;
+	case eeCalibrationDone:
+	{
+		tCalibrationResult lResult;
+		mpCalibrator->GetResult(lResult);
+
+		mpTolData->mSwingSmall = lResult.mSwingSmall;
+		mpTolData->mSwingMedium = lResult.mSwingMedium;
+		mpTolData->mSwingLarge = lResult.mSwingLarge;
+		mpTolData->mTwist = lResult.mTwist;
+
+		//Readings are taken at +/- 2g with the low 6 bits chopped off, so each
+		//step is 64 / 16384 g
+		unsigned int lClash = lResult.mClash * 125 / (32 * MPU6050_MOT_THR_MG);
+		mpTolData->mClash = constrain(lClash, MPU6050_MOT_THR_MIN, MPU6050_MOT_THR_MAX);
+		I2CWrite(MPU6050_RA_MOT_THR, (uint8_t)mpTolData->mClash);
+
+		ReportEvent(eeCalibrationEvent, 1);
+		break;
+	}
+	default:
+		ReportEvent(eeCalibrationEvent, 0);
+		break;
+	}
+
+	mpCalibrator = nullptr;
+}
+
 bool Mpu6050LiteMotionManager::SwingDetect()
 {
 	bool lSwingDetected = false;
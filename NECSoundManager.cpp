@@ -23,35 +23,93 @@
 #include "Sound/NECSoundManager.h"
 
 #include "FileUtils.h"
+#include "Sound/FontPack.h"
+#include <new> //For placement new
 
-static const char* sFontFileStr = "font";
-static const char* sBootFileStr = "boot";
-static const char* sBlasterFileStr = "blst";
-static const char* sClashFileStr = "clsh";
-static const char* sForceFileStr = "force";
-static const char* sHumFileStr = "hum";
-static const char* sLockupFileStr = "lock";
-static const char* sPowerUpFileStr = "out";
-static const char* sPowerDownFileStr = "in";
-static const char* sSwingFileStr = "swng";
+//Sounds needed to boot and ignite, probed before the rest of a font
+static const SoundTypes::ESoundTypes saBootSoundTypes[] =
+{
+	SoundTypes::eeBootSnd,
+	SoundTypes::eeFontIdSnd,
+	SoundTypes::eePowerUpSnd,
+	SoundTypes::eeHumSnd
+};
+#define NUM_BOOT_SOUND_TYPES (sizeof(saBootSoundTypes) / sizeof(saBootSoundTypes[0]))
+
+/**
+ * Gets the sound type at a position of the font probe order: the boot
+ * sounds, then every other type in order.
+ * Args:
+ *  aPos - Position, less than eeMaxSoundTypes
+ * Returns:
+ *  Sound type
+ */
+static SoundTypes::ESoundTypes GetIndexType(uint8_t aPos)
+{
+	if(aPos < NUM_BOOT_SOUND_TYPES)
+	{
+		return saBootSoundTypes[aPos];
+	}
+
+	int lSkip = aPos - NUM_BOOT_SOUND_TYPES;
+	for(int lType = 0; lType < SoundTypes::eeMaxSoundTypes; lType++)
+	{
+		bool lBootType = false;
+		for(uint8_t lIdx = 0; lIdx < NUM_BOOT_SOUND_TYPES; lIdx++)
+		{
+			lBootType = lBootType || saBootSoundTypes[lIdx] == lType;
+		}
+
+		if(!lBootType && 0 == lSkip--)
+		{
+			return (SoundTypes::ESoundTypes)lType;
+		}
+	}
+
+	return SoundTypes::eeMaxSoundTypes;
+}
 
 NECSoundManager::NECSoundManager(I2SWavPlayer* apWavPlayer)
 {
 	mpWavPlayer = apWavPlayer;
+	mpVoiceEngine = nullptr;
+	mFontPackLoaded = false;
+	mBackgroundIndexing = false;
+	mpEventQueue = nullptr;
+	mEffectEventPending = false;
+	mEffectEventType = SoundTypes::eeMaxSoundTypes;
+	mIndexPos = SoundTypes::eeMaxSoundTypes;
+	mIndexNext = 0;
+	memset(maIndexCounts, 0, sizeof(maIndexCounts));
 
 	mpEffectSound = nullptr;
 	mpHumSound = nullptr;
 
-	for(int lIdx = 0; lIdx < SoundTypes::eeMaxSoundTypes; lIdx++)
-	{
-		maSoundCounts[lIdx] = 0;
-	}
+	mFontLayout = SoundTypes::eeClassicNEC;
 
 	mEffectSoundType = SoundTypes::eeMaxSoundTypes;
+	mEffectSoundIndex = 0;
+	mPreloadType = SoundTypes::eeMaxSoundTypes;
+	mPreloadedType = SoundTypes::eeMaxSoundTypes;
+	mPreloadedIndex = 0;
+	mLockupState = eeLockupIdle;
+	mLockupBeginType = SoundTypes::eeMaxSoundTypes;
+	mLockupLoopType = SoundTypes::eeMaxSoundTypes;
+	mLockupEndType = SoundTypes::eeMaxSoundTypes;
+	mLockupQueued = false;
+	mHumQueued = false;
+	mHumStartPending = false;
+	mHumStopPending = false;
+	mHumStartMs = 0;
+	mHumStopMs = 0;
 	mHumChannel = 0;
 	mEffectChannel = 1;
 
-	mFontBaseNameStr = "necfont";
+	SetFontDirNameBase("necfont");
+
+#if NSABER_STATIC_ALLOCATION
+	memset(maWavFileInUse, 0, sizeof(maWavFileInUse));
+#endif
 }
 
 NECSoundManager::~NECSoundManager()
@@ -59,15 +117,8 @@ NECSoundManager::~NECSoundManager()
 	mpWavPlayer->SetWavFile(nullptr, mEffectChannel);
 	mpWavPlayer->SetWavFile(nullptr, mHumChannel);
 
-	if(nullptr != mpEffectSound)
-	{
-		delete mpEffectSound;
-	}
-
-	if(nullptr != mpHumSound)
-	{
-		delete mpHumSound;
-	}
+	DestroyWavFile(mpEffectSound);
+	DestroyWavFile(mpHumSound);
 }
 
 /**
@@ -93,15 +144,21 @@ void NECSoundManager::Init()
  */
 bool NECSoundManager::PlaySound(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex)
 {
-	char laNewFileName[MAX_FILE_NAME_SIZE];
-	GenerateFileName(aSoundType, laNewFileName, aIndex);
+	if(nullptr != mpVoiceEngine)
+	{
+		return PostSoundStarted(aSoundType, PlaySoundOnVoice(aSoundType, aIndex));
+	}
 
-	Serial.print("Trying to play ");Serial.println((const char*)laNewFileName);
-	//SDWavFile* lpNewSound = new SDWavFile((const char*)laNewFileName);
+	char laNewFileName[MAX_FILE_NAME_SIZE];
+	if(!GenerateFileName(aSoundType, laNewFileName, aIndex))
+	{
+		return false;
+	}
 
-	PitchShiftSDWavFile* lpNewSound = new PitchShiftSDWavFile((const char*)laNewFileName);
+	NSABER_LOG_DEBUG("Trying to play ", laNewFileName);
 
-	ISDWavFile* lpDeletePtr = nullptr;;
+	PitchShiftSDWavFile* lpNewSound = nullptr;
+	PitchShiftSDWavFile* lpDeletePtr = nullptr;
 
 	//To improve performance, rapid requests for the same effect sound
 	//simply reset same sound to play again to avoid time-expensive seeking
@@ -113,6 +170,10 @@ bool NECSoundManager::PlaySound(SoundTypes::ESoundTypes aSoundType, uint16_t aIn
 	{
 		mpEffectSound->SeekStartOfData();
 	}
+	else if(nullptr == (lpNewSound = CreateWavFile((const char*)laNewFileName)))
+	{
+		return false;
+	}
 	else if(SoundTypes::eeHumSnd == aSoundType)
 	{
 		lpDeletePtr = mpHumSound;
@@ -123,31 +184,23 @@ bool NECSoundManager::PlaySound(SoundTypes::ESoundTypes aSoundType, uint16_t aIn
 	}
 	else
 	{
-		mpEffectSound->Pause();
+		if(nullptr != mpEffectSound)
+		{
+			mpEffectSound->Pause();
+		}
 
 		lpDeletePtr = mpEffectSound;
 		mpEffectSound = lpNewSound;
 
-		if(SoundTypes::eeLockupSnd == aSoundType)
-		{
-			mpEffectSound->SetLooping(true);
-		}
-		else
-		{
-			mpEffectSound->SetLooping(false);
-		}
+		mpEffectSound->SetLooping(IsLoopingSoundType(aSoundType));
 
 		mpWavPlayer->SetWavFile(mpEffectSound, mEffectChannel);
 		mEffectSoundType = aSoundType;
 	}
 
-	if(nullptr != lpDeletePtr)
-	{
-		lpDeletePtr->Close();
-		delete lpDeletePtr;
-	}
+	DestroyWavFile(lpDeletePtr);
 
-	return true;
+	return PostSoundStarted(aSoundType, true);
 }
 
 /**
@@ -162,9 +215,21 @@ bool NECSoundManager::PlaySound(SoundTypes::ESoundTypes aSoundType, uint16_t aIn
  */
 bool NECSoundManager::PlayRandomSound(SoundTypes::ESoundTypes aSoundType)
 {
-	int lRandomSoundIdx = random(0, maSoundCounts[aSoundType]-1);
+	if(aSoundType >= SoundTypes::eeMaxSoundTypes)
+	{
+		return false;
+	}
 
-	return PlaySound(aSoundType, lRandomSoundIdx);
+	bool lSuccess = PlaySound(aSoundType, maShuffleBags[aSoundType].Next());
+
+	//Effects tend to come in runs (swing after swing), so have the next
+	//one of the same type ready
+	if(IsHighPerformanceSoundType(aSoundType))
+	{
+		mPreloadType = aSoundType;
+	}
+
+	return lSuccess;
 }
 
 /**
@@ -177,30 +242,98 @@ bool NECSoundManager::PlayRandomSound(SoundTypes::ESoundTypes aSoundType)
  */
 void NECSoundManager::SetFont(unsigned char aFontIndex)
 {
-	//const char* lDirBaseStr = "2205/ifont";
-	const char* lDirBaseStr = mFontBaseNameStr.c_str();
+	//Figure out new font base directory, such as "2205/ifont1"
+	snprintf(maFontBaseDir, sizeof(maFontBaseDir), "%s%d", maFontBaseName, aFontIndex + 1);
+
+	//The voice engine opens files on demand, and can play from a packed
+	//font if there is one next to the font directory
+	if(nullptr != mpVoiceEngine)
+	{
+		//Let go of the last font's sounds, hum and effects alike
+		mpVoiceEngine->StopAll();
+		mLockupState = eeLockupIdle;
+		mLockupQueued = false;
+		mHumQueued = false;
+
+		if(LoadFontPack())
+		{
+			mIndexPos = SoundTypes::eeMaxSoundTypes;
 
-	int lFontIdxAppend = aFontIndex + 1;
-	char laIdxStrBuf[3];
-	itoa(lFontIdxAppend, laIdxStrBuf, 10);
+#if NSABER_STATIC_ALLOCATION
+			//Open the pack on every voice now rather than on first use
+			mpVoiceEngine->OpenFileOnAllVoices(maFontPackPath);
+#endif
+		}
+		else
+		{
+			ResolveFontSounds();
+		}
+		ResetShuffleBags();
 
-	//Figure out new font base directory
-	memset(maFontBaseDir, 0, 10);
-	strcat(maFontBaseDir, lDirBaseStr);
-	strcat(maFontBaseDir, (const char*)laIdxStrBuf);
+		//Swings are the most frequent effect, have one ready from the start
+		mpVoiceEngine->CancelPreload();
+		mPreloadType = SoundTypes::eeSwingSnd;
+		return;
+	}
 
-	//Count sounds of each type in the new font
-	CountSoundsInFont();
+	//Find the sounds of each type in the new font
+	mFontPackLoaded = false;
+	ResolveFontSounds();
+	ResetShuffleBags();
+
+	//Let go of the last font's sounds
+	mpWavPlayer->SetWavFile(nullptr, mEffectChannel);
+	mpWavPlayer->SetWavFile(nullptr, mHumChannel);
+	DestroyWavFile(mpEffectSound);
+	DestroyWavFile(mpHumSound);
+	mpEffectSound = nullptr;
+	mpHumSound = nullptr;
+	mEffectSoundType = SoundTypes::eeMaxSoundTypes;
 
 	//Figure out hum file path
 	char laHumFileName[MAX_FILE_NAME_SIZE];
-	GenerateFileName(SoundTypes::eeHumSnd, laHumFileName, 0);
-	mpHumSound = new PitchShiftSDWavFile((const char*)laHumFileName);
-	mpHumSound->SetLooping(true);
+	if(GenerateFileName(SoundTypes::eeHumSnd, laHumFileName, 0))
+	{
+		mpHumSound = CreateWavFile((const char*)laHumFileName);
+		if(nullptr != mpHumSound)
+		{
+			mpHumSound->SetLooping(true);
+		}
+	}
 
 	char laFontIdFileName[MAX_FILE_NAME_SIZE];
-	GenerateFileName(SoundTypes::eeFontIdSnd, laFontIdFileName);
-	mpEffectSound = new PitchShiftSDWavFile((const char*)laFontIdFileName);
+	if(GenerateFileName(SoundTypes::eeFontIdSnd, laFontIdFileName))
+	{
+		mpEffectSound = CreateWavFile((const char*)laFontIdFileName);
+	}
+}
+
+void NECSoundManager::SetBackgroundIndexing(bool aEnabled)
+{
+	mBackgroundIndexing = aEnabled;
+}
+
+bool NECSoundManager::ContinueFontIndex(uint32_t aDeadlineUs)
+{
+	if(IsFontIndexed())
+	{
+		return false;
+	}
+
+	do
+	{
+		if(!IndexNextSound())
+		{
+			return false;
+		}
+	} while((int32_t)(micros() - aDeadlineUs) < 0);
+
+	return true;
+}
+
+bool NECSoundManager::IsFontIndexed()
+{
+	return mIndexPos >= SoundTypes::eeMaxSoundTypes;
 }
 
 /**
@@ -208,6 +341,32 @@ void NECSoundManager::SetFont(unsigned char aFontIndex)
  */
 bool NECSoundManager::ContinuePlay(bool aFillMixingBuffer)
 {
+	if(nullptr != mpVoiceEngine)
+	{
+		uint32_t lStartUs = SoundTelemetry::Now();
+		bool lEnded = mpVoiceEngine->Service();
+		ContinueLockup();
+		PreloadNextSound();
+		PostSoundEnded();
+		SoundTelemetry::NoteContinuePlay(lStartUs);
+
+		return lEnded;
+	}
+
+	if(mHumStartPending && (int32_t)(millis() - mHumStartMs) >= 0)
+	{
+		mHumStartPending = false;
+		PlaySound(SoundTypes::eeHumSnd);
+	}
+
+	if(mHumStopPending && (int32_t)(millis() - mHumStopMs) >= 0)
+	{
+		mHumStopPending = false;
+		mpWavPlayer->SetWavFile(nullptr, mHumChannel);
+	}
+
+	PostSoundEnded();
+
 	if(this->mpWavPlayer->IsEnded())
 	{
 		return true;
@@ -218,6 +377,17 @@ bool NECSoundManager::ContinuePlay(bool aFillMixingBuffer)
 	}
 }
 
+void NECSoundManager::GetTelemetry(tSoundTelemetry& arTelemetry)
+{
+	SoundTelemetry::Get(arTelemetry);
+}
+
+void NECSoundManager::SetEventQueue(SaberEventQueue* apQueue)
+{
+	mpEventQueue = apQueue;
+	mEffectEventPending = false;
+}
+
 void NECSoundManager::SetMasterVolume(int aVolume)
 {
 	if(nullptr != mpWavPlayer)
@@ -225,148 +395,369 @@ void NECSoundManager::SetMasterVolume(int aVolume)
 		float lVol = (float)aVolume / 100.0;
 		mpWavPlayer->SetVolume(lVol);
 	}
+
+	if(nullptr != mpVoiceEngine)
+	{
+		mpVoiceEngine->SetMasterVolume((float)aVolume / 100.0);
+	}
 }
 
 void NECSoundManager::SetFontDirNameBase(const char* aBaseStr)
 {
-	mFontBaseNameStr = aBaseStr;
+	strncpy(maFontBaseName, aBaseStr, NEC_FONT_BASE_NAME_SIZE - 1);
+	maFontBaseName[NEC_FONT_BASE_NAME_SIZE - 1] = '\0';
 }
 
-bool NECSoundManager::GenerateFileName(SoundTypes::ESoundTypes aSoundType, char* apStrOut, uint16_t aIndex)
+bool NECSoundManager::Ignite(uint16_t aOverlapMs)
 {
-	bool lbSuccess = true;
+	uint16_t lIndex = maShuffleBags[SoundTypes::eePowerUpSnd].Next();
+	uint32_t lOverlapSamples = (uint32_t)aOverlapMs * NSABER_OUTPUT_SAMPLE_RATE / 1000;
 
-	memset(apStrOut, 0, MAX_FILE_NAME_SIZE);
+	if(nullptr == mpVoiceEngine)
+	{
+		uint32_t lLengthMs = GetSoundLengthMs(SoundTypes::eePowerUpSnd, lIndex);
 
-	strcat(apStrOut, (const char*)maFontBaseDir);
-	strcat(apStrOut, "/");
+		mHumStopPending = false;
+		mHumStartPending = true;
+		mHumStartMs = millis() + (lLengthMs > aOverlapMs ? lLengthMs - aOverlapMs : 0);
 
+		return PlaySound(SoundTypes::eePowerUpSnd, lIndex);
+	}
 
-	int lIdxValue = aIndex + 1; //NEC starts counting at 1, there is no zero
-	char lStrBuf[3]; //Temporary buffer to create index number strings
-	memset(lStrBuf, 0, 3);
+	SoundTelemetry::NoteTrigger(mEffectChannel, SoundTypes::eePowerUpSnd);
 
-	switch(aSoundType)
+	//The standby voice carries the hum until it comes in
+	mLockupState = eeLockupIdle;
+	mHumQueued = false;
+	mpVoiceEngine->CancelPreload();
+
+	bool lHumReady = PreloadSound(SoundTypes::eeHumSnd, 0);
+	bool lSuccess = PostSoundStarted(SoundTypes::eePowerUpSnd,
+	                                 StartVoice(mEffectChannel, SoundTypes::eePowerUpSnd, lIndex, false));
+
+	mEffectSoundType = SoundTypes::eePowerUpSnd;
+	mEffectSoundIndex = lIndex;
+
+	if(!lHumReady)
 	{
-	case SoundTypes::eeFontIdSnd:
-		strcat(apStrOut, sFontFileStr);
-		break;
-	case SoundTypes::eeBootSnd:
-		strcat(apStrOut, sBootFileStr);
-		break;
-	case SoundTypes::eePowerUpSnd:
-		strcat(apStrOut, sPowerUpFileStr);
-		itoa(lIdxValue, lStrBuf, 10);
-		strcat(apStrOut, "0");
-		strcat(apStrOut, (const char*)lStrBuf);
+		return PostSoundStarted(SoundTypes::eeHumSnd, StartVoice(mHumChannel, SoundTypes::eeHumSnd, 0, true))
+		       && lSuccess;
+	}
 
-		break;
-	case SoundTypes::eeSwingSnd:
-		strcat(apStrOut, sSwingFileStr);
+	mPreloadedType = SoundTypes::eeHumSnd;
+	mPreloadedIndex = 0;
 
-		itoa(lIdxValue, lStrBuf, 10);
-		if(lIdxValue < 10)
-		{
-			strcat(apStrOut, "0"); //Leading zero
-		}
-		strcat(apStrOut, (const char*)lStrBuf);
+	uint32_t lLength = lSuccess ? mpVoiceEngine->GetVoice(mEffectChannel)->GetLengthSamples() : 0;
+	mHumQueued = mpVoiceEngine->SchedulePreloaded(mHumChannel, true,
+			                                      lLength > lOverlapSamples ? lLength - lOverlapSamples : 0);
 
-		break;
-	case SoundTypes::eeClashSnd:
-		strcat(apStrOut, sClashFileStr);
+	return lSuccess;
+}
 
-		itoa(lIdxValue, lStrBuf, 10);
-		if(lIdxValue < 10)
-		{
-			strcat(apStrOut, "0"); //Leading zero
-		}
-		strcat(apStrOut, (const char*)lStrBuf);
+bool NECSoundManager::Retract(uint16_t aOverlapMs)
+{
+	uint16_t lIndex = maShuffleBags[SoundTypes::eePowerDownSnd].Next();
 
-		break;
-	case SoundTypes::eeBlasterSnd:
-		strcat(apStrOut, sBlasterFileStr);
+	if(nullptr == mpVoiceEngine)
+	{
+		mHumStartPending = false;
+		mHumStopPending = true;
+		mHumStopMs = millis() + aOverlapMs;
 
-		itoa(lIdxValue, lStrBuf, 10);
-		strcat(apStrOut, "0");
-		strcat(apStrOut, (const char*)lStrBuf);
+		return PlaySound(SoundTypes::eePowerDownSnd, lIndex);
+	}
 
+	//A hum that hasn't come in yet never will
+	if(mHumQueued)
+	{
+		mpVoiceEngine->CancelPreload();
+		mHumQueued = false;
+	}
 
-		break;
-	case SoundTypes::eeLockupSnd:
-		strcat(apStrOut, sLockupFileStr);
+	//Power down cuts any lockup short, end segment included
+	if(eeLockupIdle != mLockupState)
+	{
+		mLockupState = eeLockupIdle;
+		mLockupQueued = false;
+		mpVoiceEngine->CancelPreload();
+	}
 
-		itoa(lIdxValue, lStrBuf, 10);
-		strcat(apStrOut, "0");
-		strcat(apStrOut, (const char*)lStrBuf);
+	bool lSuccess = PostSoundStarted(SoundTypes::eePowerDownSnd, PlaySoundOnVoice(SoundTypes::eePowerDownSnd, lIndex));
 
+	mpVoiceEngine->StopAfter(mHumChannel, (uint32_t)aOverlapMs * NSABER_OUTPUT_SAMPLE_RATE / 1000);
 
-		break;
-	case SoundTypes::eeForceSnd:
-		strcat(apStrOut, sForceFileStr);
+	//Nothing to swing with until the next ignition
+	mPreloadType = SoundTypes::eeMaxSoundTypes;
 
-		itoa(lIdxValue, lStrBuf, 10);
-		strcat(apStrOut, "0");
-		strcat(apStrOut, (const char*)lStrBuf);
+	return lSuccess;
+}
 
+bool NECSoundManager::StartLockup(SoundTypes::ESoundTypes aLoopType)
+{
+	if(!IsLoopingSoundType(aLoopType) || 0 == mFont.GetCount(aLoopType))
+	{
+		aLoopType = SoundTypes::eeLockupSnd;
+	}
 
-		break;
-	case SoundTypes::eePowerDownSnd:
-		strcat(apStrOut, sPowerDownFileStr);
+	//Goes through PlaySound() so the started event is posted the same way
+	return PlaySound(aLoopType);
+}
 
-		itoa(lIdxValue, lStrBuf, 10);
-		strcat(apStrOut, "0");
-		strcat(apStrOut, (const char*)lStrBuf);
+bool NECSoundManager::StartLockupOnVoice(SoundTypes::ESoundTypes aLoopType)
+{
+	SoundTypes::ESoundTypes lBeginType = SoundTypes::eeLockupBeginSnd;
+	SoundTypes::ESoundTypes lEndType = SoundTypes::eeLockupEndSnd;
 
-		break;
-	case SoundTypes::eeHumSnd:
-		itoa(lIdxValue, lStrBuf, 10);
+	if(SoundTypes::eeDragSnd == aLoopType && mFont.GetCount(aLoopType) > 0)
+	{
+		lBeginType = SoundTypes::eeDragBeginSnd;
+		lEndType = SoundTypes::eeDragEndSnd;
+	}
+	else if(SoundTypes::eeMeltSnd == aLoopType && mFont.GetCount(aLoopType) > 0)
+	{
+		lBeginType = SoundTypes::eeMeltBeginSnd;
+		lEndType = SoundTypes::eeMeltEndSnd;
+	}
+	else
+	{
+		aLoopType = SoundTypes::eeLockupSnd;
+	}
 
-		strcat(apStrOut, sHumFileStr);
-		strcat(apStrOut, "0");
-		strcat(apStrOut, (const char*)lStrBuf);
+	mLockupBeginType = mFont.GetCount(lBeginType) > 0 ? lBeginType : SoundTypes::eeMaxSoundTypes;
+	mLockupLoopType = aLoopType;
+	mLockupEndType = mFont.GetCount(lEndType) > 0 ? lEndType : SoundTypes::eeMaxSoundTypes;
+	mLockupQueued = false;
 
+	//The standby voice is needed for the segments
+	if(mHumQueued)
+	{
+		PostSoundStarted(SoundTypes::eeHumSnd, true);
+	}
+	StartQueuedHum();
+	mpVoiceEngine->CancelPreload();
 
-		break;
-	case SoundTypes::eeMenuSoundSnd:
-		//TODO: Figure out how to handle menu sounds
-		break;
-	case SoundTypes::eeLowSwingSnd:
-	case SoundTypes::eeHighSwingSnd:
-	default:
-		Serial.println("Unhandled sound type.");
-		lbSuccess = false;
-		break;
+	bool lSuccess;
+	if(SoundTypes::eeMaxSoundTypes != mLockupBeginType)
+	{
+		lSuccess = StartVoice(mEffectChannel, mLockupBeginType, 0, false);
+		mLockupState = eeLockupBegin;
+	}
+	else
+	{
+		lSuccess = StartVoice(mEffectChannel, mLockupLoopType, 0, true);
+		mLockupState = eeLockupLoop;
+	}
+
+	if(!lSuccess)
+	{
+		mLockupState = eeLockupIdle;
 	}
 
-	strcat(apStrOut, ".wav");
+	mEffectSoundType = aLoopType;
+	mEffectSoundIndex = 0;
 
-	return lbSuccess;
+	return lSuccess;
 }
 
-void NECSoundManager::CountSoundsInFont()
+void NECSoundManager::StopLockup()
 {
-	for(int lIdx = 0; lIdx < SoundTypes::eeMaxSoundTypes; lIdx++)
+	if(nullptr == mpVoiceEngine || (eeLockupBegin != mLockupState && eeLockupLoop != mLockupState))
 	{
-		maSoundCounts[lIdx] = 0;
+		return;
 	}
 
-	FileUtils::CountConfig.mCountIfNoIndex = false;
-	FileUtils::CountConfig.mLeadingZero = true;
-	FileUtils::CountConfig.mbSkip1 = false;
-	maSoundCounts[SoundTypes::eeBlasterSnd] = FileUtils::Count(sBlasterFileStr, ".wav", (const char*)maFontBaseDir, 1, 4);
-	maSoundCounts[SoundTypes::eeBootSnd] = FileUtils::Count(sBootFileStr, ".wav", (const char*)maFontBaseDir, 1, 4);
-	maSoundCounts[SoundTypes::eeForceSnd] = FileUtils::Count(sForceFileStr, ".wav", (const char*)maFontBaseDir, 1, 4);
-	maSoundCounts[SoundTypes::eeHumSnd] = FileUtils::Count(sHumFileStr, ".wav", (const char*)maFontBaseDir, 1, 4);
-	maSoundCounts[SoundTypes::eeLockupSnd] = FileUtils::Count(sLockupFileStr, ".wav", (const char*)maFontBaseDir, 1, 1);
-	maSoundCounts[SoundTypes::eePowerDownSnd] = FileUtils::Count(sPowerDownFileStr, ".wav", (const char*)maFontBaseDir, 1, 4);
-	maSoundCounts[SoundTypes::eePowerUpSnd] = FileUtils::Count(sPowerUpFileStr, ".wav", (const char*)maFontBaseDir, 1, 4);
-	maSoundCounts[SoundTypes::eeClashSnd] = FileUtils::Count(sClashFileStr, ".wav", (const char*)maFontBaseDir, 1, 16);
-	maSoundCounts[SoundTypes::eeSwingSnd] = FileUtils::Count(sSwingFileStr, ".wav", (const char*)maFontBaseDir, 1, 16);
+	mLockupState = eeLockupIdle;
+	mLockupQueued = false;
+
+	if(SoundTypes::eeMaxSoundTypes == mLockupEndType)
+	{
+		mpVoiceEngine->CancelPreload();
+		mpVoiceEngine->Stop(mEffectChannel);
+		return;
+	}
 
-	FileUtils::CountConfig.mCountIfNoIndex = true;
-	FileUtils::CountConfig.mLeadingZero = false;
-	FileUtils::CountConfig.mbSkip1 = false;
-	maSoundCounts[SoundTypes::eeFontIdSnd] = FileUtils::Count(sFontFileStr, ".wav", (const char*)maFontBaseDir, 0, 1);
+	//Normally the end segment was preloaded while the loop played
+	bool lSuccess;
+	if(mpVoiceEngine->IsPreloaded() && !mpVoiceEngine->IsQueued() && mPreloadedType == mLockupEndType)
+	{
+		lSuccess = mpVoiceEngine->PlayPreloaded(mEffectChannel, false);
+	}
+	else
+	{
+		mpVoiceEngine->CancelPreload();
+		lSuccess = StartVoice(mEffectChannel, mLockupEndType, 0, false);
+	}
+
+	if(lSuccess)
+	{
+		mLockupState = eeLockupEnd;
+		mEffectSoundType = mLockupEndType;
+		mEffectSoundIndex = 0;
+	}
+}
+
+bool NECSoundManager::IsLockupActive()
+{
+	return eeLockupBegin == mLockupState || eeLockupLoop == mLockupState;
+}
+
+void NECSoundManager::SetFontLayout(SoundTypes::EChannelMapType aLayout)
+{
+	mFontLayout = aLayout;
+}
+
+void NECSoundManager::SetVoiceEngine(VoiceEngine* apEngine)
+{
+	mpVoiceEngine = apEngine;
+}
+
+bool NECSoundManager::GenerateFileName(SoundTypes::ESoundTypes aSoundType, char* apStrOut, uint16_t aIndex)
+{
+	memset(apStrOut, 0, MAX_FILE_NAME_SIZE);
+
+	char laName[FONT_LAYOUT_MAX_NAME];
+	if(!mFont.GetName(aSoundType, aIndex, laName))
+	{
+		return false;
+	}
+
+	strcat(apStrOut, (const char*)maFontBaseDir);
+	strcat(apStrOut, "/");
+	strcat(apStrOut, laName);
+
+	return true;
+}
+
+void NECSoundManager::ResolveFontSounds()
+{
+	BeginFontIndex();
+
+	uint8_t lEndPos = mBackgroundIndexing ? (uint8_t)NUM_BOOT_SOUND_TYPES : (uint8_t)SoundTypes::eeMaxSoundTypes;
+	while(mIndexPos < lEndPos && IndexNextSound())
+	{
+		//Keep probing
+	}
+}
+
+void NECSoundManager::BeginFontIndex()
+{
+	const FontLayout::tFontLayout& lLayout = FontLayout::GetLayout(mFontLayout);
+
+	mFont.Clear();
+	memset(maIndexCounts, 0, sizeof(maIndexCounts));
+	mIndexPos = 0;
+	mIndexNext = 0;
+
+	for(int lType = 0; lType < SoundTypes::eeMaxSoundTypes; lType++)
+	{
+		mFont.SetNaming((SoundTypes::ESoundTypes)lType, FontLayout::FindNaming(lLayout, (SoundTypes::ESoundTypes)lType));
+	}
+}
+
+bool NECSoundManager::IndexNextSound()
+{
+	if(IsFontIndexed())
+	{
+		return false;
+	}
+
+	SoundTypes::ESoundTypes lType = GetIndexType(mIndexPos);
+	const FontLayout::tSoundNaming* lpNaming = FontLayout::FindNaming(FontLayout::GetLayout(mFontLayout), lType);
+	bool lTypeDone = nullptr == lpNaming || mIndexNext >= lpNaming->mMaxCount;
+
+	if(!lTypeDone)
+	{
+		char laPath[MAX_FILE_NAME_SIZE];
+		memset(laPath, 0, MAX_FILE_NAME_SIZE);
+		strcat(laPath, (const char*)maFontBaseDir);
+		strcat(laPath, "/");
+		FontLayout::FormatName(*lpNaming, mIndexNext, laPath + strlen(laPath));
+
+		//Numbering has no gaps, stop at the first missing file
+		if(SD.exists(laPath))
+		{
+			NSABER_LOG_DEBUG("Found ", laPath);
+			maIndexCounts[lType]++;
+			mIndexNext++;
+		}
+		else
+		{
+			lTypeDone = true;
+		}
+	}
+
+	if(lTypeDone)
+	{
+		//The type can play from now on
+		if(maIndexCounts[lType] > 0)
+		{
+			mFont.SetCounts(maIndexCounts);
+			maShuffleBags[lType].Reset(maIndexCounts[lType]);
+		}
+
+		mIndexPos++;
+		mIndexNext = 0;
+	}
+
+	return !IsFontIndexed();
+}
+
+bool NECSoundManager::IsLoopingSoundType(SoundTypes::ESoundTypes aSoundType)
+{
+	return SoundTypes::eeLockupSnd == aSoundType
+		   || SoundTypes::eeDragSnd == aSoundType
+		   || SoundTypes::eeMeltSnd == aSoundType;
+}
+
+void NECSoundManager::ContinueLockup()
+{
+	SaberVoice* lpVoice = mpVoiceEngine->GetVoice(mEffectChannel);
+
+	switch(mLockupState)
+	{
+	case eeLockupBegin:
+		if(!mLockupQueued)
+		{
+			if(PreloadSound(mLockupLoopType, 0) && mpVoiceEngine->QueuePreloaded(mEffectChannel, true))
+			{
+				mPreloadedType = mLockupLoopType;
+				mPreloadedIndex = 0;
+				mLockupQueued = true;
+			}
+			else if(lpVoice->IsEnded())
+			{
+				//Couldn't queue the loop in time, start it now
+				StartVoice(mEffectChannel, mLockupLoopType, 0, true);
+				mLockupState = eeLockupLoop;
+			}
+		}
+		else if(!mpVoiceEngine->IsQueued())
+		{
+			//The engine has moved on to the loop
+			mLockupQueued = false;
+			mLockupState = eeLockupLoop;
+		}
+		break;
+	case eeLockupLoop:
+		//Have the end segment ready for StopLockup()
+		if(SoundTypes::eeMaxSoundTypes != mLockupEndType
+		   && !(mpVoiceEngine->IsPreloaded() && mPreloadedType == mLockupEndType)
+		   && PreloadSound(mLockupEndType, 0))
+		{
+			mPreloadedType = mLockupEndType;
+			mPreloadedIndex = 0;
+		}
+		break;
+	case eeLockupEnd:
+		if((mLockupQueued && !mpVoiceEngine->IsQueued()) || lpVoice->IsEnded())
+		{
+			mLockupQueued = false;
+			mLockupState = eeLockupIdle;
+		}
+		break;
+	default:
+		break;
+	}
 }
 
 bool NECSoundManager::IsHighPerformanceSoundType(SoundTypes::ESoundTypes aSoundType)
@@ -386,3 +777,408 @@ bool NECSoundManager::IsHighPerformanceSoundType(SoundTypes::ESoundTypes aSoundT
 
 	return lIsHighPerformanceSoundType;
 }
+
+bool NECSoundManager::PlaySoundOnVoice(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex)
+{
+	bool lSuccess = true;
+
+	SoundTelemetry::NoteTrigger(SoundTypes::eeHumSnd == aSoundType ? mHumChannel : mEffectChannel, aSoundType);
+
+	if(SoundTypes::eeHumSnd == aSoundType && mHumQueued && 0 == aIndex)
+	{
+		//Ignition is under way and the hum is already buffered
+		StartQueuedHum();
+	}
+	else if(SoundTypes::eeHumSnd == aSoundType)
+	{
+		lSuccess = StartVoice(mHumChannel, aSoundType, aIndex, true);
+	}
+	else if(IsLoopingSoundType(aSoundType))
+	{
+		lSuccess = StartLockupOnVoice(aSoundType);
+	}
+	else
+	{
+		SaberVoice* lpVoice = mpVoiceEngine->GetVoice(mEffectChannel);
+		bool lLooping = false;
+
+		StartQueuedHum();
+
+		if(eeLockupBegin == mLockupState || eeLockupLoop == mLockupState)
+		{
+			StopLockup();
+
+			//Let the end segment finish, then start this effect on the next sample
+			if(eeLockupEnd == mLockupState
+			   && PreloadSound(aSoundType, aIndex)
+			   && mpVoiceEngine->QueuePreloaded(mEffectChannel, lLooping))
+			{
+				mPreloadedType = aSoundType;
+				mPreloadedIndex = aIndex;
+				mLockupQueued = true;
+				mEffectSoundType = aSoundType;
+				mEffectSoundIndex = aIndex;
+				return true;
+			}
+		}
+
+		if(eeLockupEnd == mLockupState)
+		{
+			//A new effect cuts the end segment, and whatever was queued after it
+			mLockupState = eeLockupIdle;
+			if(mpVoiceEngine->IsQueued())
+			{
+				mpVoiceEngine->CancelPreload();
+			}
+		}
+
+		if(mpVoiceEngine->IsPreloaded()
+		   && mPreloadedType == aSoundType
+		   && mPreloadedIndex == aIndex)
+		{
+			lSuccess = mpVoiceEngine->PlayPreloaded(mEffectChannel, lLooping);
+		}
+		//Same shortcut as the I2SWavPlayer path: retrigger instead of reopening
+		else if(mEffectSoundType == aSoundType
+		        && mEffectSoundIndex == aIndex
+		        && IsHighPerformanceSoundType(aSoundType)
+		        && false == lpVoice->IsEnded())
+		{
+			mpVoiceEngine->Restart(mEffectChannel);
+		}
+		else
+		{
+			lSuccess = StartVoice(mEffectChannel, aSoundType, aIndex, lLooping);
+		}
+
+		mEffectSoundType = aSoundType;
+		mEffectSoundIndex = aIndex;
+	}
+
+	return lSuccess;
+}
+
+bool NECSoundManager::StartVoice(uint8_t aChannel,
+		                         SoundTypes::ESoundTypes aSoundType,
+		                         uint16_t aIndex,
+		                         bool aLooping)
+{
+	if(mFontPackLoaded)
+	{
+		WavHeader::tWavInfo lInfo;
+		if(!mFont.GetRegion(aSoundType, aIndex, lInfo))
+		{
+			return false;
+		}
+
+		return mpVoiceEngine->PlayRegion(aChannel, maFontPackPath, lInfo, aLooping);
+	}
+
+	char laFileName[MAX_FILE_NAME_SIZE];
+	if(!GenerateFileName(aSoundType, laFileName, aIndex))
+	{
+		return false;
+	}
+
+	return mpVoiceEngine->Play(aChannel, laFileName, aLooping);
+}
+
+bool NECSoundManager::PreloadSound(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex)
+{
+	if(mFontPackLoaded)
+	{
+		WavHeader::tWavInfo lInfo;
+		if(!mFont.GetRegion(aSoundType, aIndex, lInfo))
+		{
+			return false;
+		}
+
+		return mpVoiceEngine->PreloadRegion(maFontPackPath, lInfo);
+	}
+
+	char laFileName[MAX_FILE_NAME_SIZE];
+	if(!GenerateFileName(aSoundType, laFileName, aIndex))
+	{
+		return false;
+	}
+
+	return mpVoiceEngine->Preload(laFileName);
+}
+
+void NECSoundManager::PreloadNextSound()
+{
+	//The standby voice belongs to the lockup sequence while one is running,
+	//and to the hum while an ignition is under way
+	if(eeLockupIdle != mLockupState || mpVoiceEngine->IsQueued())
+	{
+		return;
+	}
+
+	//The hum Ignite() scheduled has come in
+	if(mHumQueued)
+	{
+		PostSoundStarted(SoundTypes::eeHumSnd, true);
+	}
+	mHumQueued = false;
+
+	if(SoundTypes::eeMaxSoundTypes == mPreloadType || 0 == mFont.GetCount(mPreloadType))
+	{
+		return;
+	}
+
+	uint8_t lNextIdx = maShuffleBags[mPreloadType].Peek();
+	if(mpVoiceEngine->IsPreloaded() && mPreloadedType == mPreloadType && mPreloadedIndex == lNextIdx)
+	{
+		return;
+	}
+
+	if(mpVoiceEngine->GetLowestLevel() < NSABER_PRELOAD_MIN_LEVEL)
+	{
+		return;
+	}
+
+	if(PreloadSound(mPreloadType, lNextIdx))
+	{
+		mPreloadedType = mPreloadType;
+		mPreloadedIndex = lNextIdx;
+	}
+	else
+	{
+		//Don't keep retrying a sound that won't open
+		mPreloadType = SoundTypes::eeMaxSoundTypes;
+	}
+}
+
+void NECSoundManager::StartQueuedHum()
+{
+	if(mHumQueued && mpVoiceEngine->IsQueued())
+	{
+		mpVoiceEngine->PlayPreloaded(mHumChannel, true);
+	}
+
+	mHumQueued = false;
+}
+
+uint32_t NECSoundManager::GetSoundLengthMs(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex)
+{
+	char laFileName[MAX_FILE_NAME_SIZE];
+	if(!GenerateFileName(aSoundType, laFileName, aIndex))
+	{
+		return 0;
+	}
+
+	File lFile = SD.open(laFileName);
+	if(!lFile)
+	{
+		return 0;
+	}
+
+	WavHeader::tWavInfo lInfo;
+	bool lValid = WavHeader::Parse(lFile, lInfo);
+	lFile.close();
+
+	if(!lValid || 0 == lInfo.mByteRate)
+	{
+		return 0;
+	}
+
+	return (uint32_t)((uint64_t)lInfo.mDataLength * 1000 / lInfo.mByteRate);
+}
+
+PitchShiftSDWavFile* NECSoundManager::CreateWavFile(const char* apPath)
+{
+#if NSABER_STATIC_ALLOCATION
+	for(int lIdx = 0; lIdx < NEC_WAV_FILE_POOL_SIZE; lIdx++)
+	{
+		if(!maWavFileInUse[lIdx])
+		{
+			maWavFileInUse[lIdx] = true;
+			return new (maWavFilePool[lIdx]) PitchShiftSDWavFile(apPath);
+		}
+	}
+
+	return nullptr;
+#else
+	return new PitchShiftSDWavFile(apPath);
+#endif
+}
+
+void NECSoundManager::DestroyWavFile(PitchShiftSDWavFile* apFile)
+{
+	if(nullptr == apFile)
+	{
+		return;
+	}
+
+	apFile->Close();
+
+#if NSABER_STATIC_ALLOCATION
+	for(int lIdx = 0; lIdx < NEC_WAV_FILE_POOL_SIZE; lIdx++)
+	{
+		if((void*)maWavFilePool[lIdx] == (void*)apFile)
+		{
+			apFile->~PitchShiftSDWavFile();
+			maWavFileInUse[lIdx] = false;
+		}
+	}
+#else
+	delete apFile;
+#endif
+}
+
+bool NECSoundManager::PostSoundStarted(SoundTypes::ESoundTypes aSoundType, bool aStarted)
+{
+	if(aStarted && nullptr != mpEventQueue)
+	{
+		if(SoundTypes::eeHumSnd != aSoundType)
+		{
+			//A new effect cuts off the one before it
+			if(mEffectEventPending)
+			{
+				PostSaberEvent(mpEventQueue, eeSoundEndedEvent, mEffectEventType);
+			}
+
+			mEffectEventPending = true;
+			mEffectEventType = aSoundType;
+		}
+
+		PostSaberEvent(mpEventQueue, eeSoundStartedEvent, aSoundType);
+	}
+
+	return aStarted;
+}
+
+void NECSoundManager::PostSoundEnded()
+{
+	if(!mEffectEventPending)
+	{
+		return;
+	}
+
+	bool lEnded = false;
+	if(nullptr != mpVoiceEngine)
+	{
+		lEnded = mpVoiceEngine->GetVoice(mEffectChannel)->IsEnded();
+	}
+	else
+	{
+		lEnded = nullptr == mpEffectSound || mpEffectSound->IsEnded();
+	}
+
+	if(lEnded)
+	{
+		mEffectEventPending = false;
+		PostSaberEvent(mpEventQueue, eeSoundEndedEvent, mEffectEventType);
+	}
+}
+
+void NECSoundManager::ResetShuffleBags()
+{
+	for(int lIdx = 0; lIdx < SoundTypes::eeMaxSoundTypes; lIdx++)
+	{
+		maShuffleBags[lIdx].Reset(mFont.GetCount((SoundTypes::ESoundTypes)lIdx));
+	}
+}
+
+bool NECSoundManager::LoadFontPack()
+{
+	mFontPackLoaded = false;
+
+	//Packed font sits next to the font directory: "fontX.nfp"
+	snprintf(maFontPackPath, sizeof(maFontPackPath), "%s%s", maFontBaseDir, FONT_PACK_EXTENSION);
+
+	if(!SD.exists(maFontPackPath))
+	{
+		return false;
+	}
+
+	File lFile = SD.open(maFontPackPath);
+	if(!lFile)
+	{
+		return false;
+	}
+
+	FontPack::tFontPackHeader lHeader;
+	FontPack::tFontPackEntry lEntry;
+	uint8_t laCounts[SoundTypes::eeMaxSoundTypes] = {0};
+
+	bool lValid = sizeof(lHeader) == lFile.read(&lHeader, sizeof(lHeader))
+			      && 0 == memcmp(lHeader.maMagic, FONT_PACK_MAGIC, 4)
+			      && FONT_PACK_VERSION == lHeader.mVersion
+			      && lHeader.mNumEntries <= FONT_PACK_MAX_ENTRIES;
+
+	//The table of contents is read twice, once to count the sounds of
+	//each type and once to store where they are. Only the descriptor is
+	//kept in RAM.
+	for(uint16_t lIdx = 0; lValid && lIdx < lHeader.mNumEntries; lIdx++)
+	{
+		lValid = sizeof(lEntry) == lFile.read(&lEntry, sizeof(lEntry));
+
+		if(lValid && lEntry.mSoundType < SoundTypes::eeMaxSoundTypes)
+		{
+			laCounts[lEntry.mSoundType]++;
+		}
+	}
+
+	mFont.Clear();
+	lValid = lValid && mFont.SetCounts(laCounts) && lFile.seek(sizeof(lHeader));
+
+	for(uint16_t lIdx = 0; lValid && lIdx < lHeader.mNumEntries; lIdx++)
+	{
+		lValid = sizeof(lEntry) == lFile.read(&lEntry, sizeof(lEntry));
+
+		if(lValid && lEntry.mSoundType < SoundTypes::eeMaxSoundTypes)
+		{
+			WavHeader::tWavInfo lInfo;
+			lInfo.mFormat = lEntry.mFormat;
+			lInfo.mNumChannels = lEntry.mNumChannels;
+			lInfo.mSampleRate = lEntry.mSampleRate;
+			lInfo.mBlockAlign = lEntry.mBlockAlign;
+			lInfo.mBitsPerSample = lEntry.mBitsPerSample;
+			lInfo.mByteRate = lEntry.mSampleRate * lEntry.mBlockAlign;
+			if(WAV_FORMAT_IMA_ADPCM == lInfo.mFormat)
+			{
+				lInfo.mByteRate /= ImaAdpcm::SamplesPerBlock(lEntry.mBlockAlign);
+			}
+			lInfo.mDataStart = lEntry.mDataOffset;
+			lInfo.mDataLength = lEntry.mDataLength;
+			lInfo.mLoopStart = lEntry.mLoopStart;
+			lInfo.mLoopEnd = lEntry.mLoopEnd;
+
+			lValid = mFont.SetRegion((SoundTypes::ESoundTypes)lEntry.mSoundType, lEntry.mIndex, lInfo);
+		}
+	}
+
+	lFile.close();
+
+	if(!lValid)
+	{
+		NSABER_LOG_WARN("Ignoring bad font pack ", maFontPackPath);
+		mFont.Clear();
+		return false;
+	}
+
+	NSABER_LOG_INFO("Loaded font pack ", maFontPackPath, lHeader.mNumEntries);
+	mFontPackLoaded = true;
+
+	return true;
+}
+
+SaberVoice* NECSoundManager::GetVoiceForType(SoundTypes::ESoundTypes aSoundType)
+{
+	SaberVoice* lpVoice = nullptr;
+
+	if(nullptr != mpVoiceEngine)
+	{
+		if(SoundTypes::eeHumSnd == aSoundType)
+		{
+			lpVoice = mpVoiceEngine->GetVoice(mHumChannel);
+		}
+		else if(mEffectSoundType == aSoundType)
+		{
+			lpVoice = mpVoiceEngine->GetVoice(mEffectChannel);
+		}
+	}
+
+	return lpVoice;
+}
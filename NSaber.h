@@ -27,12 +27,25 @@
 
 #include "Sound/NECSoundManager.h"
 #include "Sound/DynamicNECSoundManager.h"
+#include "Sound/VoiceEngine.h"
 
 #include "FileUtils.h"
+#include "NSaberLog.h"
 #include "AMotionReactive.h"
+#include "RunLoop.h"
+#include "EventQueue.h"
+#include "BootSequence.h"
+#include "QualityGovernor.h"
+#include "FlightRecorder.h"
 
 #include "Motion/AMotionManager.h"
 #include "Motion/Mpu6050LiteMotionManager.h"
 #include "Motion/Mpu6050AdvancedMotionManager.h"
+#include "Motion/MotionCalibrator.h"
+
+#include "Blade/BladeEngine.h"
+#include "Blade/PwmBladeDriver.h"
+#include "Blade/Nrf52PixelDriver.h"
+#include "Blade/TimingBladeDriver.h"
 
 #endif /* NSABER_H_ */
@@ -0,0 +1,154 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * NSaberLog.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "NSaberLog.h"
+
+#if NSABER_LOG_LEVEL > NSABER_LOG_LEVEL_NONE
+
+//Which optional arguments a record carries
+#define LOG_HAS_VALUE (0x01)
+#define LOG_HAS_TEXT (0x02)
+
+/**
+ * One logged message.
+ */
+struct tLogRecord
+{
+	uint32_t mTimeUs;
+	const char* mpMessage;
+	int32_t mValue;
+	uint8_t mLevel;
+	uint8_t mFlags;
+	char maText[NSABER_LOG_TEXT_SIZE];
+};
+
+//Letters marking each level in the output
+static const char saLevelTags[] = "-EWID";
+
+//The ring. Write() only moves the head and Flush() only moves the tail.
+static tLogRecord saRecords[NSABER_LOG_RECORDS];
+static volatile uint16_t sHead = 0;
+static volatile uint16_t sTail = 0;
+
+//Messages dropped by Write(), and how many of those Flush() has reported
+static volatile uint32_t sDropped = 0;
+static uint32_t sReportedDropped = 0;
+
+/**
+ * Stores a record in the ring, or drops it if the ring is full.
+ */
+static void Store(uint8_t aLevel, uint8_t aFlags, const char* apMessage, const char* apText, int32_t aValue)
+{
+	uint16_t lHead = sHead;
+	uint16_t lNext = (lHead + 1) % NSABER_LOG_RECORDS;
+
+	if(lNext == sTail)
+	{
+		sDropped = sDropped + 1;
+		return;
+	}
+
+	tLogRecord& lrRecord = saRecords[lHead];
+	lrRecord.mTimeUs = micros();
+	lrRecord.mpMessage = apMessage;
+	lrRecord.mValue = aValue;
+	lrRecord.mLevel = aLevel;
+	lrRecord.mFlags = aFlags;
+	lrRecord.maText[0] = '\0';
+	if(nullptr != apText)
+	{
+		strncpy(lrRecord.maText, apText, NSABER_LOG_TEXT_SIZE - 1);
+		lrRecord.maText[NSABER_LOG_TEXT_SIZE - 1] = '\0';
+	}
+
+	//The record must be complete before the reader can see it
+	__sync_synchronize();
+	sHead = lNext;
+}
+
+void NSaberLog::Write(uint8_t aLevel, const char* apMessage)
+{
+	Store(aLevel, 0, apMessage, nullptr, 0);
+}
+
+void NSaberLog::Write(uint8_t aLevel, const char* apMessage, int32_t aValue)
+{
+	Store(aLevel, LOG_HAS_VALUE, apMessage, nullptr, aValue);
+}
+
+void NSaberLog::Write(uint8_t aLevel, const char* apMessage, const char* apText)
+{
+	Store(aLevel, LOG_HAS_TEXT, apMessage, apText, 0);
+}
+
+void NSaberLog::Write(uint8_t aLevel, const char* apMessage, const char* apText, int32_t aValue)
+{
+	Store(aLevel, LOG_HAS_TEXT | LOG_HAS_VALUE, apMessage, apText, aValue);
+}
+
+bool NSaberLog::Flush(Print& arOut, uint32_t aDeadlineUs)
+{
+	uint32_t lDropped = sDropped;
+	if(lDropped != sReportedDropped)
+	{
+		arOut.print(lDropped - sReportedDropped);
+		arOut.println(" log messages dropped");
+		sReportedDropped = lDropped;
+	}
+
+	while(sTail != sHead)
+	{
+		uint16_t lTail = sTail;
+		const tLogRecord& lrRecord = saRecords[lTail];
+
+		arOut.print(lrRecord.mTimeUs);
+		arOut.print(' ');
+		arOut.print(saLevelTags[lrRecord.mLevel <= NSABER_LOG_LEVEL_DEBUG ? lrRecord.mLevel : 0]);
+		arOut.print(' ');
+		arOut.print(lrRecord.mpMessage);
+		if(lrRecord.mFlags & LOG_HAS_TEXT)
+		{
+			arOut.print((const char*)lrRecord.maText);
+		}
+		if(lrRecord.mFlags & LOG_HAS_VALUE)
+		{
+			if(lrRecord.mFlags & LOG_HAS_TEXT)
+			{
+				arOut.print(' ');
+			}
+			arOut.print(lrRecord.mValue);
+		}
+		arOut.println();
+
+		//Done with the record before the writer can reuse it
+		__sync_synchronize();
+		sTail = (lTail + 1) % NSABER_LOG_RECORDS;
+
+		if((int32_t)(micros() - aDeadlineUs) >= 0)
+		{
+			break;
+		}
+	}
+
+	return sTail != sHead;
+}
+
+#endif
@@ -0,0 +1,137 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * NSaberLog.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef NSABERLOG_H_
+#define NSABERLOG_H_
+
+#include <Arduino.h>
+
+//Log levels, most severe first
+#define NSABER_LOG_LEVEL_NONE (0)
+#define NSABER_LOG_LEVEL_ERROR (1)
+#define NSABER_LOG_LEVEL_WARN (2)
+#define NSABER_LOG_LEVEL_INFO (3)
+#define NSABER_LOG_LEVEL_DEBUG (4)
+
+//Most detailed level kept (here or with a build flag). Calls to more
+//detailed levels compile away, arguments and all.
+#if not defined NSABER_LOG_LEVEL
+#define NSABER_LOG_LEVEL NSABER_LOG_LEVEL_WARN
+#endif
+
+//Messages the log holds before it has to drop them
+#if not defined NSABER_LOG_RECORDS
+#define NSABER_LOG_RECORDS (32)
+#endif
+
+//Longest text argument kept with a message, longer ones are cut short
+#define NSABER_LOG_TEXT_SIZE (24)
+
+#if NSABER_LOG_LEVEL >= NSABER_LOG_LEVEL_ERROR
+#define NSABER_LOG_ERROR(...) NSaberLog::Write(NSABER_LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define NSABER_LOG_ERROR(...) do {} while(0)
+#endif
+
+#if NSABER_LOG_LEVEL >= NSABER_LOG_LEVEL_WARN
+#define NSABER_LOG_WARN(...) NSaberLog::Write(NSABER_LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define NSABER_LOG_WARN(...) do {} while(0)
+#endif
+
+#if NSABER_LOG_LEVEL >= NSABER_LOG_LEVEL_INFO
+#define NSABER_LOG_INFO(...) NSaberLog::Write(NSABER_LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define NSABER_LOG_INFO(...) do {} while(0)
+#endif
+
+#if NSABER_LOG_LEVEL >= NSABER_LOG_LEVEL_DEBUG
+#define NSABER_LOG_DEBUG(...) NSaberLog::Write(NSABER_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define NSABER_LOG_DEBUG(...) do {} while(0)
+#endif
+
+/**
+ * Deferred logging. A message is stored as a small fixed-size record (time,
+ * level, pointer to the message literal, and an optional number and text)
+ * in a ring buffer; nothing is formatted or sent at the time of the call.
+ * Flush() writes the records out later, from a low priority task.
+ *
+ * Use the NSABER_LOG_xxx macros rather than calling Write() directly:
+ *  NSABER_LOG_DEBUG("Trying to play ", laFileName);
+ *  NSABER_LOG_WARN("Underruns: ", lCount);
+ *
+ * The ring has one writer and one reader and needs no locks, as long as
+ * messages are logged from one context (not from interrupts) and flushed
+ * from one context. When the ring is full new messages are dropped and
+ * counted, and Flush() reports how many were lost.
+ */
+namespace NSaberLog
+{
+
+#if NSABER_LOG_LEVEL > NSABER_LOG_LEVEL_NONE
+
+/**
+ * Logs a message.
+ * Args:
+ *  aLevel - Level of the message
+ *  apMessage - Message, must be a string literal (only the pointer is kept)
+ */
+void Write(uint8_t aLevel, const char* apMessage);
+
+/**
+ * Logs a message followed by a number.
+ */
+void Write(uint8_t aLevel, const char* apMessage, int32_t aValue);
+
+/**
+ * Logs a message followed by text, such as a file name. The text is copied.
+ */
+void Write(uint8_t aLevel, const char* apMessage, const char* apText);
+
+/**
+ * Logs a message followed by text and a number.
+ */
+void Write(uint8_t aLevel, const char* apMessage, const char* apText, int32_t aValue);
+
+/**
+ * Writes out logged messages, oldest first, one per line.
+ * Args:
+ *  arOut - Where to write, such as Serial
+ *  aDeadlineUs - micros() value to be done by. At least one message is
+ *                written per call.
+ * Returns:
+ *  TRUE if there are more messages to write, FALSE otherwise
+ */
+bool Flush(Print& arOut, uint32_t aDeadlineUs);
+
+#else
+
+inline bool Flush(Print& arOut, uint32_t aDeadlineUs)
+{
+	return false;
+}
+
+#endif
+
+};
+
+#endif /* NSABERLOG_H_ */
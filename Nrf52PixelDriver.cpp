@@ -0,0 +1,119 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * Nrf52PixelDriver.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Blade/Nrf52PixelDriver.h"
+
+#if defined(NRF52) || defined(NRF52_SERIES)
+
+//16MHz ticks per bit, 1.25us
+#define NRF52_PIXEL_PERIOD (20)
+
+//High time of a 0 and a 1 bit, 0.375us and 0.8125us. The top bit selects
+//the polarity so the output starts high.
+#define NRF52_PIXEL_BIT_0 (6 | 0x8000)
+#define NRF52_PIXEL_BIT_1 (13 | 0x8000)
+
+//Output low for the whole period
+#define NRF52_PIXEL_LOW (0 | 0x8000)
+
+Nrf52PixelDriver::Nrf52PixelDriver(uint8_t aPin, uint16_t aNumPixels, NRF_PWM_Type* apPwm)
+{
+	mpPwm = apPwm;
+	mPin = aPin;
+	mNumPixels = min(aNumPixels, (uint16_t)NSABER_MAX_BLADE_PIXELS);
+	mBusy = false;
+
+	for(uint16_t lIdx = 0; lIdx < sizeof(maWords) / sizeof(maWords[0]); lIdx++)
+	{
+		maWords[lIdx] = NRF52_PIXEL_LOW;
+	}
+}
+
+void Nrf52PixelDriver::Init()
+{
+	pinMode(mPin, OUTPUT);
+	digitalWrite(mPin, LOW);
+
+	mpPwm->MODE = PWM_MODE_UPDOWN_Up << PWM_MODE_UPDOWN_Pos;
+	mpPwm->PRESCALER = PWM_PRESCALER_PRESCALER_DIV_1 << PWM_PRESCALER_PRESCALER_Pos;
+	mpPwm->COUNTERTOP = NRF52_PIXEL_PERIOD << PWM_COUNTERTOP_COUNTERTOP_Pos;
+	mpPwm->LOOP = PWM_LOOP_CNT_Disabled << PWM_LOOP_CNT_Pos;
+	mpPwm->DECODER = (PWM_DECODER_LOAD_Common << PWM_DECODER_LOAD_Pos) |
+			(PWM_DECODER_MODE_RefreshCount << PWM_DECODER_MODE_Pos);
+	mpPwm->SEQ[0].REFRESH = 0;
+	mpPwm->SEQ[0].ENDDELAY = 0;
+	mpPwm->PSEL.OUT[0] = g_ADigitalPinMap[mPin];
+	mpPwm->ENABLE = PWM_ENABLE_ENABLE_Enabled << PWM_ENABLE_ENABLE_Pos;
+}
+
+uint16_t Nrf52PixelDriver::GetNumPixels()
+{
+	return mNumPixels;
+}
+
+bool Nrf52PixelDriver::IsReady()
+{
+	if(mBusy && mpPwm->EVENTS_SEQEND[0])
+	{
+		mpPwm->EVENTS_SEQEND[0] = 0;
+		mBusy = false;
+	}
+
+	return !mBusy;
+}
+
+void Nrf52PixelDriver::Show(const tBladePixel* apPixels, uint16_t aNumPixels)
+{
+	uint16_t lNumPixels = min(aNumPixels, mNumPixels);
+	uint16_t* lpWords = maWords;
+
+	//The strip takes green, red, blue
+	for(uint16_t lIdx = 0; lIdx < lNumPixels; lIdx++)
+	{
+		EncodeByte(lpWords, apPixels[lIdx].mGreen);
+		EncodeByte(lpWords + 8, apPixels[lIdx].mRed);
+		EncodeByte(lpWords + 16, apPixels[lIdx].mBlue);
+		lpWords += NRF52_PIXEL_WORDS_PER_PIXEL;
+	}
+
+	//Hold the line low so the strip latches the frame
+	uint16_t lNumWords = lNumPixels * NRF52_PIXEL_WORDS_PER_PIXEL + NRF52_PIXEL_RESET_WORDS;
+	for(uint16_t lIdx = 0; lIdx < NRF52_PIXEL_RESET_WORDS; lIdx++)
+	{
+		lpWords[lIdx] = NRF52_PIXEL_LOW;
+	}
+
+	mpPwm->SEQ[0].PTR = ((uint32_t)maWords) << PWM_SEQ_PTR_PTR_Pos;
+	mpPwm->SEQ[0].CNT = lNumWords << PWM_SEQ_CNT_CNT_Pos;
+	mpPwm->EVENTS_SEQEND[0] = 0;
+	mpPwm->TASKS_SEQSTART[0] = 1;
+	mBusy = true;
+}
+
+void Nrf52PixelDriver::EncodeByte(uint16_t* apWords, uint8_t aValue)
+{
+	for(uint8_t lBit = 0; lBit < 8; lBit++)
+	{
+		apWords[lBit] = (aValue & (0x80 >> lBit)) ? NRF52_PIXEL_BIT_1 : NRF52_PIXEL_BIT_0;
+	}
+}
+
+#endif
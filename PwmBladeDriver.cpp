@@ -0,0 +1,61 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * PwmBladeDriver.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Blade/PwmBladeDriver.h"
+
+PwmBladeDriver::PwmBladeDriver(uint8_t aRedPin, uint8_t aGreenPin, uint8_t aBluePin)
+{
+	mRedPin = aRedPin;
+	mGreenPin = aGreenPin;
+	mBluePin = aBluePin;
+}
+
+void PwmBladeDriver::Init()
+{
+	pinMode(mRedPin, OUTPUT);
+	pinMode(mGreenPin, OUTPUT);
+	pinMode(mBluePin, OUTPUT);
+
+	analogWrite(mRedPin, 0);
+	analogWrite(mGreenPin, 0);
+	analogWrite(mBluePin, 0);
+}
+
+uint16_t PwmBladeDriver::GetNumPixels()
+{
+	return 1;
+}
+
+bool PwmBladeDriver::IsReady()
+{
+	//Duty cycle changes take effect right away
+	return true;
+}
+
+void PwmBladeDriver::Show(const tBladePixel* apPixels, uint16_t aNumPixels)
+{
+	if(aNumPixels > 0)
+	{
+		analogWrite(mRedPin, apPixels[0].mRed);
+		analogWrite(mGreenPin, apPixels[0].mGreen);
+		analogWrite(mBluePin, apPixels[0].mBlue);
+	}
+}
@@ -0,0 +1,181 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * QualityGovernor.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "QualityGovernor.h"
+
+//mRunsSinceUp when no step up is being watched
+#define NO_STEP_UP (0xFFFF)
+
+//Longest wait before a step up, as a multiple of NSABER_GOVERNOR_RECOVER_RUNS
+#define MAX_RECOVER_FACTOR (16)
+
+QualityGovernor::QualityGovernor(RunLoop& arLoop, VoiceEngine* apEngine)
+{
+	mpLoop = &arLoop;
+	mpEngine = apEngine;
+	mpMotionTask = nullptr;
+	mMotionPeriodUs = 0;
+	mSlowMotionPeriodUs = 0;
+	mMaxLevel = eeQualityFewerVoices;
+
+	mStarted = false;
+	mLastUs = 0;
+	mLastMs = 0;
+	mLastBusyUs = 0;
+	mLastUnderruns = 0;
+	mHighRuns = 0;
+	mRunsSinceUp = NO_STEP_UP;
+
+	memset(&mStats, 0, sizeof(mStats));
+	mStats.mLevel = eeQualityFull;
+	mStats.mMinHeadroomPct = 100;
+	mStats.mRecoverRuns = NSABER_GOVERNOR_RECOVER_RUNS;
+}
+
+void QualityGovernor::SetMotionTask(ARunLoopTask* apTask, uint32_t aPeriodUs, uint32_t aSlowPeriodUs)
+{
+	mpMotionTask = apTask;
+	mMotionPeriodUs = aPeriodUs;
+	mSlowMotionPeriodUs = aSlowPeriodUs;
+	mMaxLevel = nullptr != apTask ? eeQualitySlowMotion : eeQualityFewerVoices;
+}
+
+bool QualityGovernor::Run(uint32_t aDeadlineUs)
+{
+	uint32_t lNowUs = micros();
+	uint32_t lNowMs = millis();
+	uint32_t lBusyUs = mpLoop->GetBusyUs(eeAudioPriority) + mpLoop->GetBusyUs(eeMotionPriority);
+	uint32_t lUnderruns = mpEngine->GetUnderruns();
+
+	uint32_t lElapsedUs = lNowUs - mLastUs;
+	uint32_t lBusyDeltaUs = lBusyUs - mLastBusyUs;
+	bool lUnderrun = lUnderruns != mLastUnderruns;
+
+	//Start measuring from the first run, setup before it isn't typical
+	if(mStarted)
+	{
+		mStats.maLevelMs[mStats.mLevel] += lNowMs - mLastMs;
+	}
+	else
+	{
+		lElapsedUs = 0;
+		mStarted = true;
+	}
+
+	mLastUs = lNowUs;
+	mLastMs = lNowMs;
+	mLastBusyUs = lBusyUs;
+	mLastUnderruns = lUnderruns;
+
+	if(0 == lElapsedUs)
+	{
+		return false;
+	}
+
+	uint8_t lHeadroom = 0;
+	if(lBusyDeltaUs < lElapsedUs)
+	{
+		lHeadroom = 100 - (uint8_t)((uint64_t)lBusyDeltaUs * 100 / lElapsedUs);
+	}
+
+	mStats.mHeadroomPct = lHeadroom;
+	mStats.mMinHeadroomPct = min(mStats.mMinHeadroomPct, lHeadroom);
+
+	if(lUnderrun || lHeadroom < NSABER_GOVERNOR_LOW_HEADROOM)
+	{
+		mHighRuns = 0;
+
+		if(NO_STEP_UP != mRunsSinceUp)
+		{
+			//The last step up didn't hold, wait longer before the next
+			mStats.mRecoverRuns = min(mStats.mRecoverRuns * 2, NSABER_GOVERNOR_RECOVER_RUNS * MAX_RECOVER_FACTOR);
+			mRunsSinceUp = NO_STEP_UP;
+		}
+
+		if(mStats.mLevel < mMaxLevel)
+		{
+			SetLevel((EQualityLevel)(mStats.mLevel + 1), lUnderrun ? eeGovernorUnderrun : eeGovernorLowHeadroom);
+			mStats.mStepsDown++;
+		}
+
+		return false;
+	}
+
+	if(NO_STEP_UP != mRunsSinceUp && ++mRunsSinceUp >= mStats.mRecoverRuns)
+	{
+		//The last step up held
+		mStats.mRecoverRuns = NSABER_GOVERNOR_RECOVER_RUNS;
+		mRunsSinceUp = NO_STEP_UP;
+	}
+
+	if(lHeadroom <= NSABER_GOVERNOR_HIGH_HEADROOM)
+	{
+		mHighRuns = 0;
+	}
+	else if(++mHighRuns >= mStats.mRecoverRuns && mStats.mLevel > eeQualityFull)
+	{
+		mHighRuns = 0;
+		mRunsSinceUp = 0;
+		SetLevel((EQualityLevel)(mStats.mLevel - 1), eeGovernorRecovered);
+		mStats.mStepsUp++;
+	}
+
+	return false;
+}
+
+EQualityLevel QualityGovernor::GetLevel()
+{
+	return (EQualityLevel)mStats.mLevel;
+}
+
+void QualityGovernor::GetStats(tGovernorStats& arStats)
+{
+	arStats = mStats;
+}
+
+void QualityGovernor::ResetStats()
+{
+	uint8_t lLevel = mStats.mLevel;
+	uint16_t lRecoverRuns = mStats.mRecoverRuns;
+
+	memset(&mStats, 0, sizeof(mStats));
+	mStats.mLevel = lLevel;
+	mStats.mMinHeadroomPct = 100;
+	mStats.mRecoverRuns = lRecoverRuns;
+}
+
+void QualityGovernor::SetLevel(EQualityLevel aLevel, EGovernorReason aReason)
+{
+	mStats.mLevel = aLevel;
+	mStats.mLastReason = aReason;
+	mStats.mLastChangeMs = millis();
+
+	mpEngine->SetPolyphaseEnabled(aLevel < eeQualityLinearResampling);
+	mpEngine->SetFiltersEnabled(aLevel < eeQualityNoFilters);
+	mpEngine->SetVoiceLimit(aLevel < eeQualityFewerVoices ? NSABER_MAX_VOICES : NSABER_MAX_VOICES - 1);
+
+	if(nullptr != mpMotionTask)
+	{
+		mpLoop->SetTaskPeriod(mpMotionTask, aLevel < eeQualitySlowMotion ? mMotionPeriodUs : mSlowMotionPeriodUs);
+	}
+
+	NSABER_LOG_INFO("Quality level ", (int32_t)aLevel);
+}
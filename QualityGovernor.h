@@ -0,0 +1,197 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * QualityGovernor.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef QUALITYGOVERNOR_H_
+#define QUALITYGOVERNOR_H_
+
+#include "Arduino.h"
+#include "RunLoop.h"
+#include "Sound/VoiceEngine.h"
+
+//Headroom, in percent of the loop's time, below which quality steps down
+#if not defined NSABER_GOVERNOR_LOW_HEADROOM
+#define NSABER_GOVERNOR_LOW_HEADROOM (15)
+#endif
+
+//Headroom above which quality may step back up
+#if not defined NSABER_GOVERNOR_HIGH_HEADROOM
+#define NSABER_GOVERNOR_HIGH_HEADROOM (40)
+#endif
+
+//Runs in a row with high headroom needed before stepping back up
+#if not defined NSABER_GOVERNOR_RECOVER_RUNS
+#define NSABER_GOVERNOR_RECOVER_RUNS (10)
+#endif
+
+/**
+ * Quality levels, highest first. Each level keeps the cuts of the ones
+ * above it.
+ */
+enum EQualityLevel
+{
+	eeQualityFull,             //Everything on
+	eeQualityLinearResampling, //Files at other rates interpolated linearly
+	eeQualityNoFilters,        //Voice tone filters bypassed
+	eeQualityFewerVoices,      //One voice fewer mixed at once
+	eeQualitySlowMotion,       //Motion sensor read less often
+	eeMaxQualityLevels
+};
+
+/**
+ * Why the quality level last changed.
+ */
+enum EGovernorReason
+{
+	eeGovernorNoChange,    //Level hasn't changed
+	eeGovernorLowHeadroom, //Stepped down, the loop was too busy
+	eeGovernorUnderrun,    //Stepped down, a voice ran out of data
+	eeGovernorRecovered    //Stepped up, headroom was high for long enough
+};
+
+/**
+ * What the governor has seen and done.
+ */
+struct tGovernorStats
+{
+	//Current EQualityLevel
+	uint8_t mLevel;
+	//Headroom over the last run, in percent
+	uint8_t mHeadroomPct;
+	//Lowest headroom seen
+	uint8_t mMinHeadroomPct;
+	//EGovernorReason of the last change
+	uint8_t mLastReason;
+	//millis() of the last change
+	uint32_t mLastChangeMs;
+	//Times quality stepped down and up
+	uint32_t mStepsDown;
+	uint32_t mStepsUp;
+	//Runs of high headroom needed before the next step up
+	uint16_t mRecoverRuns;
+	//Milliseconds spent at each level
+	uint32_t maLevelMs[eeMaxQualityLevels];
+};
+
+/**
+ * Trades fidelity for time when the loop runs short. Each run it works out
+ * the headroom, the share of time since the last run not spent in audio or
+ * motion tasks. When the headroom falls too low or a voice underruns, it
+ * steps quality down one level; once the headroom has stayed high for a
+ * while it steps back up one level. Background work doesn't count against
+ * the headroom, as it only uses time that is spare.
+ *
+ * A step up that runs straight back out of headroom doubles the wait
+ * before the next try, so a load that sits between two levels doesn't make
+ * the quality hunt up and down.
+ *
+ * Add it to the run loop at motion priority, so it still runs when the
+ * loop is too busy for background work. The time between runs sets how
+ * quickly it reacts.
+ *
+ * Example:
+ *  gGovernor.SetMotionTask(&gMotionTask, 5000, 10000);
+ *  gRunLoop.AddTask(&gGovernor, eeMotionPriority, 50000, 100);
+ */
+class QualityGovernor : public ARunLoopTask
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  arLoop - Run loop to measure, and to slow the motion task in
+	 *  apEngine - Voice engine whose quality to adjust
+	 */
+	QualityGovernor(RunLoop& arLoop, VoiceEngine* apEngine);
+
+	/**
+	 * Sets the motion task to read less often at eeQualitySlowMotion.
+	 * Without one, quality stops at eeQualityFewerVoices.
+	 * Args:
+	 *  apTask - Motion task, already added to the run loop
+	 *  aPeriodUs - Period the task was added with
+	 *  aSlowPeriodUs - Period to use at eeQualitySlowMotion
+	 */
+	void SetMotionTask(ARunLoopTask* apTask, uint32_t aPeriodUs, uint32_t aSlowPeriodUs);
+
+	/**
+	 * Measures the headroom and steps quality if needed. Called by the run
+	 * loop.
+	 * Args:
+	 *  aDeadlineUs - micros() value to be done by
+	 * Returns:
+	 *  FALSE, there is never more work to do right away
+	 */
+	virtual bool Run(uint32_t aDeadlineUs);
+
+	/**
+	 * Returns the current EQualityLevel.
+	 */
+	EQualityLevel GetLevel();
+
+	/**
+	 * Gets what the governor has seen and done.
+	 * Args:
+	 *  arStats - Output parameter, populated with the statistics
+	 */
+	void GetStats(tGovernorStats& arStats);
+
+	/**
+	 * Clears the counters. The level is kept.
+	 */
+	void ResetStats();
+
+protected:
+
+	/**
+	 * Moves to a quality level and applies its cuts.
+	 */
+	void SetLevel(EQualityLevel aLevel, EGovernorReason aReason);
+
+	RunLoop* mpLoop;
+	VoiceEngine* mpEngine;
+
+	//Motion task to slow down, nullptr for none
+	ARunLoopTask* mpMotionTask;
+	uint32_t mMotionPeriodUs;
+	uint32_t mSlowMotionPeriodUs;
+
+	//Lowest level that can be reached
+	EQualityLevel mMaxLevel;
+
+	//TRUE once the first run has taken readings to measure from
+	bool mStarted;
+
+	//Readings at the last run
+	uint32_t mLastUs;
+	uint32_t mLastMs;
+	uint32_t mLastBusyUs;
+	uint32_t mLastUnderruns;
+
+	//Runs in a row with high headroom
+	uint16_t mHighRuns;
+	//Runs since the last step up, stops counting at mStats.mRecoverRuns
+	uint16_t mRunsSinceUp;
+
+	tGovernorStats mStats;
+};
+
+#endif /* QUALITYGOVERNOR_H_ */
@@ -0,0 +1,231 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * ReadAheadScheduler.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Sound/ReadAheadScheduler.h"
+
+//Amount of data read per transfer length when probing the card
+#define PROBE_BYTES (READ_AHEAD_BUFFER_SIZE * 2)
+
+ReadAheadScheduler::ReadAheadScheduler()
+{
+	for(int lIdx = 0; lIdx < READ_AHEAD_MAX_STREAMS; lIdx++)
+	{
+		mapStreams[lIdx] = nullptr;
+	}
+
+	mTransferSectors = READ_AHEAD_DEFAULT_TRANSFER_SECTORS;
+	ResetStats();
+}
+
+bool ReadAheadScheduler::Add(ReadAheadStream* apStream)
+{
+	for(int lIdx = 0; lIdx < READ_AHEAD_MAX_STREAMS; lIdx++)
+	{
+		if(nullptr == mapStreams[lIdx])
+		{
+			mapStreams[lIdx] = apStream;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ReadAheadScheduler::Remove(ReadAheadStream* apStream)
+{
+	for(int lIdx = 0; lIdx < READ_AHEAD_MAX_STREAMS; lIdx++)
+	{
+		if(apStream == mapStreams[lIdx])
+		{
+			mapStreams[lIdx] = nullptr;
+		}
+	}
+}
+
+uint8_t ReadAheadScheduler::Service(uint8_t aMaxTransfers)
+{
+	uint8_t lTransfers = 0;
+	uint32_t lTransferBytes = (uint32_t)mTransferSectors * READ_AHEAD_SECTOR_SIZE;
+
+	while(lTransfers < aMaxTransfers)
+	{
+		//Find the stream that will run out first and has room for a whole
+		//transfer. A stream below half full takes what room there is, so a
+		//long transfer length can't starve it.
+		ReadAheadStream* lpNeediest = nullptr;
+		uint32_t lShortestTime = 0xFFFFFFFF;
+
+		for(int lIdx = 0; lIdx < READ_AHEAD_MAX_STREAMS; lIdx++)
+		{
+			ReadAheadStream* lpStream = mapStreams[lIdx];
+			if(nullptr == lpStream || !lpStream->IsOpen())
+			{
+				continue;
+			}
+
+			uint8_t lLevel = lpStream->GetLevel();
+			if(lLevel < mMinLevel && !lpStream->IsFullyRead())
+			{
+				mMinLevel = lLevel;
+			}
+
+			uint32_t lTime = lpStream->GetTimeToEmptyUs();
+			uint32_t lFree = lpStream->GetFreeBytes();
+			bool lHasRoom = lFree >= lTransferBytes || (lFree >= READ_AHEAD_SECTOR_SIZE && lLevel < 50);
+			if(lHasRoom && lTime < lShortestTime)
+			{
+				lShortestTime = lTime;
+				lpNeediest = lpStream;
+			}
+		}
+
+		if(nullptr == lpNeediest)
+		{
+			//Everything is full or finished
+			break;
+		}
+
+		uint32_t lRead = lpNeediest->Refill(lTransferBytes);
+		if(0 == lRead)
+		{
+			break;
+		}
+
+		mTransfers++;
+		mBytesRead += lRead;
+		lTransfers++;
+	}
+
+	return lTransfers;
+}
+
+void ReadAheadScheduler::SetTransferSectors(uint8_t aNumSectors)
+{
+	mTransferSectors = constrain(aNumSectors, 1, READ_AHEAD_BUFFER_SECTORS);
+}
+
+uint8_t ReadAheadScheduler::GetTransferSectors()
+{
+	return mTransferSectors;
+}
+
+uint8_t ReadAheadScheduler::ProbeTransferSectors(const char* apPath, uint8_t* apScratch, uint16_t aScratchSize)
+{
+	File lFile = SD.open(apPath);
+	if(!lFile)
+	{
+		return mTransferSectors;
+	}
+
+	uint8_t lBestSectors = mTransferSectors;
+	uint32_t lBestTime = 0xFFFFFFFF;
+
+	for(uint8_t lSectors = 1; lSectors <= READ_AHEAD_BUFFER_SECTORS
+	                          && lSectors * READ_AHEAD_SECTOR_SIZE <= aScratchSize; lSectors *= 2)
+	{
+		uint16_t lChunk = lSectors * READ_AHEAD_SECTOR_SIZE;
+		uint32_t lTotal = 0;
+
+		lFile.seek(0);
+		unsigned long lStart = micros();
+		while(lTotal < PROBE_BYTES)
+		{
+			int lRead = lFile.read(apScratch, lChunk);
+			if(lRead <= 0)
+			{
+				break;
+			}
+			lTotal += lRead;
+		}
+		unsigned long lElapsed = micros() - lStart;
+
+		if(lTotal < PROBE_BYTES)
+		{
+			//File too short to give a fair comparison
+			break;
+		}
+
+		//Prefer shorter transfers unless a longer one is clearly faster,
+		//since shorter transfers block the loop for less time
+		if(lElapsed + lElapsed / 10 < lBestTime)
+		{
+			lBestTime = lElapsed;
+			lBestSectors = lSectors;
+		}
+	}
+
+	lFile.close();
+
+	SetTransferSectors(lBestSectors);
+
+	return mTransferSectors;
+}
+
+uint8_t ReadAheadScheduler::GetLevel(uint8_t aSlot)
+{
+	if(aSlot >= READ_AHEAD_MAX_STREAMS || nullptr == mapStreams[aSlot] || !mapStreams[aSlot]->IsOpen())
+	{
+		return 0;
+	}
+
+	return mapStreams[aSlot]->GetLevel();
+}
+
+uint32_t ReadAheadScheduler::GetTimeToEmptyUs()
+{
+	uint32_t lShortestTime = 0xFFFFFFFF;
+
+	for(int lIdx = 0; lIdx < READ_AHEAD_MAX_STREAMS; lIdx++)
+	{
+		ReadAheadStream* lpStream = mapStreams[lIdx];
+		if(nullptr != lpStream && lpStream->IsOpen())
+		{
+			lShortestTime = min(lShortestTime, lpStream->GetTimeToEmptyUs());
+		}
+	}
+
+	return lShortestTime;
+}
+
+void ReadAheadScheduler::GetStats(tReadAheadStats& arStats)
+{
+	arStats.mTransfers = mTransfers;
+	arStats.mBytesRead = mBytesRead;
+	arStats.mMinLevel = mMinLevel;
+	arStats.mUnderruns = 0;
+
+	for(int lIdx = 0; lIdx < READ_AHEAD_MAX_STREAMS; lIdx++)
+	{
+		arStats.maLevels[lIdx] = GetLevel(lIdx);
+
+		if(nullptr != mapStreams[lIdx])
+		{
+			arStats.mUnderruns += mapStreams[lIdx]->GetUnderruns();
+		}
+	}
+}
+
+void ReadAheadScheduler::ResetStats()
+{
+	mTransfers = 0;
+	mBytesRead = 0;
+	mMinLevel = 100;
+}
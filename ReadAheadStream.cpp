@@ -0,0 +1,415 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * ReadAheadStream.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Sound/ReadAheadStream.h"
+
+#define READ_AHEAD_BUFFER_MASK (READ_AHEAD_BUFFER_SIZE - 1)
+
+ReadAheadStream::ReadAheadStream()
+{
+	mIsOpen = false;
+	mFileOpen = false;
+	mLooping = false;
+	mFilePos = 0;
+	mDataEnd = 0;
+	mHead = 0;
+	mTail = 0;
+	mUnderruns = 0;
+	mReadGranule = 1;
+	mLoopStart = 0;
+	mLoopEnd = 0;
+	mLoopHeadLength = 0;
+	mLoopHeadFill = 0;
+	maPath[0] = '\0';
+}
+
+ReadAheadStream::~ReadAheadStream()
+{
+	Close();
+	CloseFile();
+}
+
+bool ReadAheadStream::Open(const char* apPath)
+{
+	Close();
+
+	if(!OpenFile(apPath))
+	{
+		return false;
+	}
+
+	mWavInfo = WavHeader::tWavInfo();
+	if(!WavHeader::Parse(mFile, mWavInfo))
+	{
+		CloseFile();
+		return false;
+	}
+
+	mDataEnd = mWavInfo.mDataStart + mWavInfo.mDataLength;
+	mUnderruns = 0;
+	mIsOpen = true;
+	UpdateReadGranule();
+	UpdateLoop();
+
+	Reset(mWavInfo.mDataStart);
+
+	return true;
+}
+
+bool ReadAheadStream::OpenRegion(const char* apPath, const WavHeader::tWavInfo& arInfo)
+{
+	if(!OpenFile(apPath))
+	{
+		mIsOpen = false;
+		return false;
+	}
+	mIsOpen = true;
+
+	mWavInfo = arInfo;
+	mDataEnd = mWavInfo.mDataStart + mWavInfo.mDataLength;
+	mUnderruns = 0;
+	UpdateReadGranule();
+	UpdateLoop();
+
+	Reset(mWavInfo.mDataStart);
+
+	return true;
+}
+
+void ReadAheadStream::Close()
+{
+	mIsOpen = false;
+	mHead = 0;
+	mTail = 0;
+
+#if !NSABER_STATIC_ALLOCATION
+	CloseFile();
+#endif
+}
+
+bool ReadAheadStream::OpenFile(const char* apPath)
+{
+	if(mFileOpen && 0 == strncmp(maPath, apPath, MAX_FILE_NAME_SIZE - 1))
+	{
+		return true;
+	}
+
+	CloseFile();
+
+	mFile = SD.open(apPath);
+	if(!mFile)
+	{
+		return false;
+	}
+
+	strncpy(maPath, apPath, MAX_FILE_NAME_SIZE - 1);
+	maPath[MAX_FILE_NAME_SIZE - 1] = '\0';
+	mFileOpen = true;
+
+	return true;
+}
+
+void ReadAheadStream::CloseFile()
+{
+	if(mFileOpen)
+	{
+		mFile.close();
+		mFileOpen = false;
+	}
+
+	maPath[0] = '\0';
+}
+
+bool ReadAheadStream::IsOpen()
+{
+	return mIsOpen;
+}
+
+uint16_t ReadAheadStream::Read(uint8_t* apOut, uint16_t aNumBytes)
+{
+	if(mReadGranule > 1)
+	{
+		aNumBytes -= aNumBytes % mReadGranule;
+	}
+
+	uint16_t lNumBytes = (uint16_t)min((uint32_t)aNumBytes, GetBufferedBytes());
+
+	if(mReadGranule > 1)
+	{
+		lNumBytes -= lNumBytes % mReadGranule;
+	}
+
+	//Copy out in up to two pieces in case the data wraps around the ring
+	uint32_t lTailIdx = mTail & READ_AHEAD_BUFFER_MASK;
+	uint32_t lFirstPart = min((uint32_t)lNumBytes, READ_AHEAD_BUFFER_SIZE - lTailIdx);
+
+	memcpy(apOut, maBuffer + lTailIdx, lFirstPart);
+	memcpy(apOut + lFirstPart, maBuffer, lNumBytes - lFirstPart);
+
+	mTail += lNumBytes;
+
+	if(lNumBytes < aNumBytes && !IsFullyRead())
+	{
+		mUnderruns++;
+	}
+
+	return lNumBytes;
+}
+
+uint32_t ReadAheadStream::Refill(uint32_t aMaxBytes)
+{
+	if(!mIsOpen)
+	{
+		return 0;
+	}
+
+	uint32_t lEnd = mLooping ? mLoopEnd : mDataEnd;
+
+	if(mFilePos >= lEnd)
+	{
+		if(!mLooping)
+		{
+			return 0;
+		}
+
+		//The loop's start and end needn't be at the same offset within a
+		//sector. Line the ring up with the start again, or every transfer
+		//that reaches the end of the ring would stop part way into a sector.
+		//A loop that fits in RAM never goes back to the card.
+		bool lFromRam = mLoopHeadLength > 0 && mLoopHeadFill == mLoopHeadLength;
+		uint32_t lShift = 0;
+		if(!lFromRam || mLoopStart + mLoopHeadLength < lEnd)
+		{
+			lShift = (mLoopStart - mHead) & (READ_AHEAD_SECTOR_SIZE - 1);
+		}
+		if(GetFreeBytes() < lShift + (lFromRam ? mLoopHeadLength : 0))
+		{
+			return 0;
+		}
+		Realign(lShift);
+
+		if(lFromRam)
+		{
+			//Wrap around from RAM, the card picks up on a sector boundary
+			uint32_t lHeadIdx = mHead & READ_AHEAD_BUFFER_MASK;
+			uint32_t lFirstPart = min((uint32_t)mLoopHeadLength, READ_AHEAD_BUFFER_SIZE - lHeadIdx);
+
+			memcpy(maBuffer + lHeadIdx, maLoopHead, lFirstPart);
+			memcpy(maBuffer, maLoopHead + lFirstPart, mLoopHeadLength - lFirstPart);
+
+			mHead += mLoopHeadLength;
+			mFilePos = mLoopStart + mLoopHeadLength;
+		}
+		else
+		{
+			//Wrap around to the start of the loop on the card
+			mFilePos = mLoopStart;
+		}
+
+		if(mFilePos >= lEnd)
+		{
+			//The whole loop fits in RAM
+			return 0;
+		}
+
+		mFile.seek(mFilePos);
+	}
+
+	uint32_t lHeadIdx = mHead & READ_AHEAD_BUFFER_MASK;
+	uint32_t lContiguous = READ_AHEAD_BUFFER_SIZE - lHeadIdx;
+	uint32_t lRemaining = lEnd - mFilePos;
+	uint32_t lNumBytes = min(min(GetFreeBytes(), lContiguous), min(aMaxBytes, lRemaining));
+
+	//Unless the transfer runs to the end of the ring or the end of the data,
+	//trim it to finish on a sector boundary so the next one starts aligned
+	if(lNumBytes < lContiguous && lNumBytes < lRemaining)
+	{
+		uint32_t lEnd = (mFilePos + lNumBytes) & ~((uint32_t)READ_AHEAD_SECTOR_SIZE - 1);
+		if(lEnd <= mFilePos)
+		{
+			//Not enough room for a whole sector yet
+			return 0;
+		}
+
+		lNumBytes = lEnd - mFilePos;
+	}
+
+	if(0 == lNumBytes)
+	{
+		return 0;
+	}
+
+	uint32_t lStartUs = SoundTelemetry::Now();
+	int lRead = mFile.read(maBuffer + lHeadIdx, (uint16_t)lNumBytes);
+	SoundTelemetry::NoteSdRead(lStartUs, lNumBytes);
+
+	if(lRead <= 0)
+	{
+		//Card error, treat it as the end of the data
+		mFilePos = mDataEnd;
+		return 0;
+	}
+
+	//Keep the start of the loop the first time it goes by
+	uint32_t lHeadPos = mLoopStart + mLoopHeadFill;
+	if(mLoopHeadFill < mLoopHeadLength && mFilePos <= lHeadPos && lHeadPos < mFilePos + lRead)
+	{
+		uint32_t lCount = min(mLoopStart + mLoopHeadLength, mFilePos + lRead) - lHeadPos;
+		memcpy(maLoopHead + mLoopHeadFill, maBuffer + lHeadIdx + (lHeadPos - mFilePos), lCount);
+		mLoopHeadFill += lCount;
+	}
+
+	mHead += lRead;
+	mFilePos += lRead;
+
+	return lRead;
+}
+
+void ReadAheadStream::SeekStartOfData()
+{
+	if(mIsOpen)
+	{
+		Reset(mWavInfo.mDataStart);
+	}
+}
+
+void ReadAheadStream::SetLooping(bool aLooping)
+{
+	mLooping = aLooping;
+}
+
+bool ReadAheadStream::IsEnded()
+{
+	return !mIsOpen || (IsFullyRead() && 0 == GetBufferedBytes());
+}
+
+bool ReadAheadStream::IsFullyRead()
+{
+	return !mLooping && mFilePos >= mDataEnd;
+}
+
+uint32_t ReadAheadStream::GetBufferedBytes()
+{
+	return mHead - mTail;
+}
+
+uint32_t ReadAheadStream::GetFreeBytes()
+{
+	return READ_AHEAD_BUFFER_SIZE - GetBufferedBytes();
+}
+
+uint8_t ReadAheadStream::GetLevel()
+{
+	return (uint8_t)(GetBufferedBytes() * 100 / READ_AHEAD_BUFFER_SIZE);
+}
+
+uint32_t ReadAheadStream::GetTimeToEmptyUs()
+{
+	if(!mIsOpen || IsFullyRead())
+	{
+		return 0xFFFFFFFF;
+	}
+
+	if(0 == mWavInfo.mByteRate)
+	{
+		return 0;
+	}
+
+	return (uint32_t)((uint64_t)GetBufferedBytes() * 1000000 / mWavInfo.mByteRate);
+}
+
+uint32_t ReadAheadStream::GetUnderruns()
+{
+	return mUnderruns;
+}
+
+const WavHeader::tWavInfo& ReadAheadStream::GetWavInfo()
+{
+	return mWavInfo;
+}
+
+void ReadAheadStream::UpdateReadGranule()
+{
+	if(WAV_FORMAT_IMA_ADPCM == mWavInfo.mFormat)
+	{
+		//Block headers and packed samples both come in groups of four bytes
+		mReadGranule = 4;
+	}
+	else
+	{
+		mReadGranule = max((uint16_t)1, mWavInfo.mBlockAlign);
+	}
+}
+
+void ReadAheadStream::UpdateLoop()
+{
+	mLoopStart = mWavInfo.mDataStart;
+	mLoopEnd = mDataEnd;
+
+	if(mWavInfo.mLoopStart < mWavInfo.mLoopEnd && mWavInfo.mLoopEnd <= mWavInfo.mDataLength)
+	{
+		mLoopStart += mWavInfo.mLoopStart;
+		mLoopEnd = mWavInfo.mDataStart + mWavInfo.mLoopEnd;
+	}
+
+	//Cache up to a sector boundary so the first card read after a wrap is aligned
+	uint32_t lHeadEnd = (mLoopStart + READ_AHEAD_LOOP_HEAD_SIZE) & ~((uint32_t)READ_AHEAD_SECTOR_SIZE - 1);
+	lHeadEnd = min(lHeadEnd, mLoopEnd);
+
+	mLoopHeadLength = lHeadEnd > mLoopStart ? lHeadEnd - mLoopStart : 0;
+	mLoopHeadFill = 0;
+}
+
+void ReadAheadStream::Realign(uint32_t aShift)
+{
+	if(0 == aShift)
+	{
+		return;
+	}
+
+	//Move the buffered bytes up the ring, last first, in pieces that don't
+	//cross the end of the ring on either side
+	uint32_t lLeft = mHead - mTail;
+	while(lLeft > 0)
+	{
+		uint32_t lSrcEnd = ((mTail + lLeft - 1) & READ_AHEAD_BUFFER_MASK) + 1;
+		uint32_t lDstEnd = ((mTail + lLeft - 1 + aShift) & READ_AHEAD_BUFFER_MASK) + 1;
+		uint32_t lCount = min(min(lSrcEnd, lDstEnd), lLeft);
+
+		memmove(maBuffer + lDstEnd - lCount, maBuffer + lSrcEnd - lCount, lCount);
+		lLeft -= lCount;
+	}
+
+	mTail += aShift;
+	mHead += aShift;
+}
+
+void ReadAheadStream::Reset(uint32_t aFilePos)
+{
+	mFilePos = aFilePos;
+
+	//Start the ring at the same offset within a sector as the file so
+	//the end of the ring always lines up with a sector boundary
+	mHead = aFilePos & (READ_AHEAD_SECTOR_SIZE - 1);
+	mTail = mHead;
+
+	mFile.seek(mFilePos);
+}
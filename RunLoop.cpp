@@ -0,0 +1,255 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * RunLoop.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "RunLoop.h"
+
+RunLoop::RunLoop()
+{
+	mNumTasks = 0;
+	mSleep = true;
+	memset(maBusyUs, 0, sizeof(maBusyUs));
+}
+
+bool RunLoop::AddTask(ARunLoopTask* apTask, ETaskPriority aPriority, uint32_t aPeriodUs, uint32_t aBudgetUs)
+{
+	if(mNumTasks >= NSABER_MAX_TASKS || nullptr == apTask)
+	{
+		return false;
+	}
+
+	//Keep the table sorted by priority, tasks of equal priority in the order added
+	int lPos = mNumTasks;
+	while(lPos > 0 && maTasks[lPos - 1].mPriority > aPriority)
+	{
+		maTasks[lPos] = maTasks[lPos - 1];
+		lPos--;
+	}
+
+	tTask& lTask = maTasks[lPos];
+	lTask.mpTask = apTask;
+	lTask.mPriority = aPriority;
+	lTask.mPeriodUs = aPeriodUs;
+	lTask.mBudgetUs = aBudgetUs;
+	lTask.mNextUs = micros();
+	lTask.mMoreWork = false;
+	lTask.mStats = tTaskStats();
+	mNumTasks++;
+
+	return true;
+}
+
+void RunLoop::RemoveTask(ARunLoopTask* apTask)
+{
+	int lOut = 0;
+	for(int lIdx = 0; lIdx < mNumTasks; lIdx++)
+	{
+		if(maTasks[lIdx].mpTask != apTask)
+		{
+			maTasks[lOut++] = maTasks[lIdx];
+		}
+	}
+	mNumTasks = lOut;
+}
+
+bool RunLoop::RunOnce()
+{
+	bool lRan = RunAudio();
+
+	for(int lIdx = 0; lIdx < mNumTasks; lIdx++)
+	{
+		tTask& lTask = maTasks[lIdx];
+		uint32_t lNow = micros();
+
+		if(eeAudioPriority == lTask.mPriority || !IsDue(lTask, lNow))
+		{
+			continue;
+		}
+
+		uint32_t lDeadline = lNow + lTask.mBudgetUs;
+
+		if(eeBackgroundPriority == lTask.mPriority)
+		{
+			//Background work gives way to anything more urgent
+			uint32_t lSlack = GetSlackUs(lTask.mPriority, lNow);
+			if(0 == lSlack)
+			{
+				continue;
+			}
+			lDeadline = lNow + min(lTask.mBudgetUs, lSlack);
+		}
+
+		RunTask(lTask, lNow, lDeadline);
+		lRan = true;
+
+		//Audio goes between every other task
+		RunAudio();
+	}
+
+	if(!lRan && mSleep)
+	{
+		NSABER_RUN_LOOP_SLEEP();
+	}
+
+	return lRan;
+}
+
+void RunLoop::RunFor(uint32_t aTimeMs)
+{
+	uint32_t lStart = millis();
+	while(millis() - lStart < aTimeMs)
+	{
+		RunOnce();
+	}
+}
+
+bool RunLoop::SetTaskPeriod(ARunLoopTask* apTask, uint32_t aPeriodUs)
+{
+	for(int lIdx = 0; lIdx < mNumTasks; lIdx++)
+	{
+		if(maTasks[lIdx].mpTask == apTask)
+		{
+			//Next run keeps to the old schedule, the ones after to the new
+			maTasks[lIdx].mPeriodUs = aPeriodUs;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+uint32_t RunLoop::GetBusyUs(ETaskPriority aPriority)
+{
+	return aPriority < eeMaxTaskPriorities ? maBusyUs[aPriority] : 0;
+}
+
+void RunLoop::SetSleepEnabled(bool aSleep)
+{
+	mSleep = aSleep;
+}
+
+bool RunLoop::GetStats(ARunLoopTask* apTask, tTaskStats& arStats)
+{
+	for(int lIdx = 0; lIdx < mNumTasks; lIdx++)
+	{
+		if(maTasks[lIdx].mpTask == apTask)
+		{
+			arStats = maTasks[lIdx].mStats;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void RunLoop::ResetStats()
+{
+	for(int lIdx = 0; lIdx < mNumTasks; lIdx++)
+	{
+		maTasks[lIdx].mStats = tTaskStats();
+	}
+}
+
+bool RunLoop::IsDue(const tTask& arTask, uint32_t aNowUs)
+{
+	return arTask.mMoreWork || (int32_t)(aNowUs - arTask.mNextUs) >= 0;
+}
+
+uint32_t RunLoop::GetSlackUs(ETaskPriority aPriority, uint32_t aNowUs)
+{
+	uint32_t lSlack = 0xFFFFFFFF;
+
+	for(int lIdx = 0; lIdx < mNumTasks && maTasks[lIdx].mPriority < aPriority; lIdx++)
+	{
+		const tTask& lTask = maTasks[lIdx];
+
+		//Tasks that run on every pass are always due, leave them a budget
+		//rather than waiting on them forever
+		if(0 == lTask.mPeriodUs)
+		{
+			lSlack = min(lSlack, lTask.mBudgetUs);
+			continue;
+		}
+
+		if(IsDue(lTask, aNowUs))
+		{
+			return 0;
+		}
+
+		lSlack = min(lSlack, lTask.mNextUs - aNowUs);
+	}
+
+	return lSlack;
+}
+
+void RunLoop::RunTask(tTask& arTask, uint32_t aNowUs, uint32_t aDeadlineUs)
+{
+	bool lWasPeriodic = !arTask.mMoreWork && arTask.mPeriodUs > 0;
+
+	arTask.mMoreWork = arTask.mpTask->Run(aDeadlineUs);
+
+	uint32_t lEnd = micros();
+	tTaskStats& lStats = arTask.mStats;
+	lStats.mRuns++;
+	lStats.mMaxRunUs = max(lStats.mMaxRunUs, lEnd - aNowUs);
+	maBusyUs[arTask.mPriority] += lEnd - aNowUs;
+	if((int32_t)(lEnd - aDeadlineUs) > 0)
+	{
+		lStats.mOverruns++;
+	}
+
+	if(0 == arTask.mPeriodUs)
+	{
+		arTask.mNextUs = lEnd;
+	}
+	else if(lWasPeriodic)
+	{
+		if(aNowUs - arTask.mNextUs > arTask.mPeriodUs)
+		{
+			lStats.mLateStarts++;
+		}
+
+		//Keep to the schedule, but skip runs that were missed altogether
+		arTask.mNextUs += arTask.mPeriodUs;
+		if((int32_t)(aNowUs - arTask.mNextUs) >= 0)
+		{
+			arTask.mNextUs = aNowUs + arTask.mPeriodUs;
+		}
+	}
+}
+
+bool RunLoop::RunAudio()
+{
+	bool lRan = false;
+
+	for(int lIdx = 0; lIdx < mNumTasks && eeAudioPriority == maTasks[lIdx].mPriority; lIdx++)
+	{
+		tTask& lTask = maTasks[lIdx];
+		uint32_t lNow = micros();
+
+		if(IsDue(lTask, lNow))
+		{
+			RunTask(lTask, lNow, lNow + lTask.mBudgetUs);
+			lRan = true;
+		}
+	}
+
+	return lRan;
+}
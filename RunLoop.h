@@ -0,0 +1,348 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * RunLoop.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef RUNLOOP_H_
+#define RUNLOOP_H_
+
+#include "Arduino.h"
+#include "Sound/ASaberSoundManager.h"
+#include "Motion/AMotionManager.h"
+#include "NSaberLog.h"
+
+//Most tasks a run loop can hold
+#if not defined NSABER_MAX_TASKS
+#define NSABER_MAX_TASKS (8)
+#endif
+
+//How the run loop waits when nothing is due. Wakes on any interrupt.
+#if not defined NSABER_RUN_LOOP_SLEEP
+#define NSABER_RUN_LOOP_SLEEP() __WFE()
+#endif
+
+/**
+ * Task priorities, most urgent first.
+ */
+enum ETaskPriority
+{
+	//Keeps the audio output fed. Runs first, and again after every other task.
+	eeAudioPriority,
+	//Sensor acquisition, runs at its sample rate
+	eeMotionPriority,
+	//Housekeeping. Only gets the time left before more urgent work is due.
+	eeBackgroundPriority,
+	//Number of priorities
+	eeMaxTaskPriorities
+};
+
+/**
+ * Counters kept for each task.
+ */
+struct tTaskStats
+{
+	//Number of times the task ran
+	uint32_t mRuns = 0;
+	//Longest single run in microseconds
+	uint32_t mMaxRunUs = 0;
+	//Runs that went past their deadline
+	uint32_t mOverruns = 0;
+	//Periodic runs that started more than a whole period late
+	uint32_t mLateStarts = 0;
+};
+
+/**
+ * A unit of work for a RunLoop. Run() must return by the deadline it is
+ * given, so long jobs do a slice at a time and ask to be run again.
+ */
+class ARunLoopTask
+{
+public:
+
+	virtual ~ARunLoopTask()
+	{
+
+	}
+
+	/**
+	 * Does one slice of work.
+	 * Args:
+	 *  aDeadlineUs - micros() value to be done by
+	 * Returns:
+	 *  TRUE if there is more work to do right away, FALSE otherwise
+	 */
+	virtual bool Run(uint32_t aDeadlineUs) = 0;
+};
+
+/**
+ * Pumps a sound manager's ContinuePlay().
+ */
+class SoundTask : public ARunLoopTask
+{
+public:
+
+	SoundTask(ASaberSoundManager* apSoundManager)
+	{
+		mpSoundManager = apSoundManager;
+	}
+
+	virtual bool Run(uint32_t aDeadlineUs)
+	{
+		mpSoundManager->ContinuePlay();
+		return false;
+	}
+
+protected:
+
+	ASaberSoundManager* mpSoundManager;
+};
+
+/**
+ * Reads a motion manager's sensors.
+ */
+class MotionTask : public ARunLoopTask
+{
+public:
+
+	MotionTask(AMotionManager* apMotionManager)
+	{
+		mpMotionManager = apMotionManager;
+	}
+
+	virtual bool Run(uint32_t aDeadlineUs)
+	{
+		mpMotionManager->Update();
+		return false;
+	}
+
+protected:
+
+	AMotionManager* mpMotionManager;
+};
+
+/**
+ * Runs a plain function, such as a pump for the I2SWavPlayer or a slice
+ * of background work.
+ */
+class FunctionTask : public ARunLoopTask
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apFunction - Function to run. Takes the deadline and returns TRUE if
+	 *               it has more work to do right away.
+	 */
+	FunctionTask(bool (*apFunction)(uint32_t aDeadlineUs))
+	{
+		mpFunction = apFunction;
+	}
+
+	virtual bool Run(uint32_t aDeadlineUs)
+	{
+		return mpFunction(aDeadlineUs);
+	}
+
+protected:
+
+	bool (*mpFunction)(uint32_t aDeadlineUs);
+};
+
+/**
+ * Writes out deferred log messages. Give it background priority so
+ * logging never delays audio or motion.
+ */
+class LogTask : public ARunLoopTask
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  arOut - Where to write the messages, such as Serial
+	 */
+	LogTask(Print& arOut)
+	{
+		mpOut = &arOut;
+	}
+
+	virtual bool Run(uint32_t aDeadlineUs)
+	{
+		return NSaberLog::Flush(*mpOut, aDeadlineUs);
+	}
+
+protected:
+
+	Print* mpOut;
+};
+
+/**
+ * Cooperative scheduler for everything a saber does in loop(): feeding the
+ * audio, reading the motion sensor and background work.
+ *
+ * Each pass runs the tasks that are due in priority order. Audio tasks run
+ * first and again after every other task, so a slow sensor read or card
+ * lookup never holds the audio back for more than one task. Periodic
+ * tasks run on a fixed schedule and skip, rather than bunch up, runs they
+ * missed. Background tasks are given a deadline no later than the next
+ * audio or motion task is due, and are skipped if that is now. When
+ * nothing is due the loop sleeps until the next interrupt.
+ *
+ * Budgets are not enforced, tasks are trusted to return by their deadline.
+ * Runs that don't are counted in the task's stats.
+ */
+class RunLoop
+{
+public:
+
+	/**
+	 * Constructor.
+	 */
+	RunLoop();
+
+	/**
+	 * Adds a task.
+	 * Args:
+	 *  apTask - Task to run
+	 *  aPriority - How urgent the task is
+	 *  aPeriodUs - Time between runs, 0 to run on every pass (the loop
+	 *              never sleeps while such a task is added)
+	 *  aBudgetUs - Time the task may take per run
+	 * Returns:
+	 *  TRUE if successful, FALSE if NSABER_MAX_TASKS tasks are already added
+	 */
+	bool AddTask(ARunLoopTask* apTask, ETaskPriority aPriority, uint32_t aPeriodUs, uint32_t aBudgetUs);
+
+	/**
+	 * Removes a task.
+	 * Args:
+	 *  apTask - Task to remove
+	 */
+	void RemoveTask(ARunLoopTask* apTask);
+
+	/**
+	 * Runs one pass over the tasks, sleeping if none were due.
+	 * Returns:
+	 *  TRUE if any task ran, FALSE otherwise
+	 */
+	bool RunOnce();
+
+	/**
+	 * Runs passes for a while.
+	 * Args:
+	 *  aTimeMs - How long to run for in milliseconds
+	 */
+	void RunFor(uint32_t aTimeMs);
+
+	/**
+	 * Changes how often a task runs.
+	 * Args:
+	 *  apTask - Task to change
+	 *  aPeriodUs - Time between runs, 0 to run on every pass
+	 * Returns:
+	 *  TRUE if successful, FALSE if the task isn't in the loop
+	 */
+	bool SetTaskPeriod(ARunLoopTask* apTask, uint32_t aPeriodUs);
+
+	/**
+	 * Gets the time spent running tasks of a priority, for working out how
+	 * busy the loop is. The count wraps, so compare two readings.
+	 * Args:
+	 *  aPriority - Priority of the tasks
+	 * Returns:
+	 *  Microseconds spent in the tasks' Run() since the loop was created
+	 */
+	uint32_t GetBusyUs(ETaskPriority aPriority);
+
+	/**
+	 * Sets whether the loop sleeps when nothing is due. Defaults to TRUE.
+	 */
+	void SetSleepEnabled(bool aSleep);
+
+	/**
+	 * Gets the counters of a task.
+	 * Args:
+	 *  apTask - Task to look up
+	 *  arStats - Output parameter, populated with the counters
+	 * Returns:
+	 *  TRUE if successful, FALSE if the task isn't in the loop
+	 */
+	bool GetStats(ARunLoopTask* apTask, tTaskStats& arStats);
+
+	/**
+	 * Clears the counters of all tasks.
+	 */
+	void ResetStats();
+
+protected:
+
+	//Scheduling state of one task
+	struct tTask
+	{
+		ARunLoopTask* mpTask;
+		ETaskPriority mPriority;
+		uint32_t mPeriodUs;
+		uint32_t mBudgetUs;
+		//micros() of the next periodic run
+		uint32_t mNextUs;
+		//TRUE if the task asked to run again right away
+		bool mMoreWork;
+		tTaskStats mStats;
+	};
+
+	/**
+	 * Checks if a task should run.
+	 */
+	bool IsDue(const tTask& arTask, uint32_t aNowUs);
+
+	/**
+	 * Gets the time until the next task more urgent than a priority is due.
+	 * Returns:
+	 *  Time in microseconds, 0 if one is due now, 0xFFFFFFFF if none are
+	 *  periodic
+	 */
+	uint32_t GetSlackUs(ETaskPriority aPriority, uint32_t aNowUs);
+
+	/**
+	 * Runs a task and works out when it runs next.
+	 */
+	void RunTask(tTask& arTask, uint32_t aNowUs, uint32_t aDeadlineUs);
+
+	/**
+	 * Runs the audio tasks that are due.
+	 * Returns:
+	 *  TRUE if any ran
+	 */
+	bool RunAudio();
+
+	//Tasks, sorted most urgent first
+	tTask maTasks[NSABER_MAX_TASKS];
+
+	//Number of valid entries in maTasks
+	uint8_t mNumTasks;
+
+	//TRUE to sleep when nothing is due
+	bool mSleep;
+
+	//Time spent in tasks of each priority
+	uint32_t maBusyUs[eeMaxTaskPriorities];
+};
+
+#endif /* RUNLOOP_H_ */
@@ -0,0 +1,405 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * SaberVoice.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Sound/SaberVoice.h"
+#include "NSaberLog.h"
+
+#define PHASE_ONE (0x10000)
+
+SaberVoice::SaberVoice()
+{
+	mBlockLen = 0;
+	mBlockPos = 0;
+	mAdpcmBytesLeft = 0;
+	mPrevSample = 0;
+	mNextSample = 0;
+	mTailLeft = 0;
+	mpSrcTable = nullptr;
+	memset(maHistory, 0, sizeof(maHistory));
+	mHistoryPos = 0;
+	mPolyphaseEnabled = true;
+	mFilterEnabled = true;
+	mPhase = 0;
+	mStep = PHASE_ONE;
+	mPitch = 0.0;
+	mGain = 32768;
+	mPaused = false;
+}
+
+bool SaberVoice::Open(const char* apPath)
+{
+	Close();
+
+	if(!mStream.Open(apPath))
+	{
+		return false;
+	}
+
+	return Prepare();
+}
+
+bool SaberVoice::OpenRegion(const char* apPath, const WavHeader::tWavInfo& arInfo)
+{
+	//Leave the stream open so a file that is already open can be reused
+	mBlockLen = 0;
+	mBlockPos = 0;
+
+	if(!mStream.OpenRegion(apPath, arInfo))
+	{
+		return false;
+	}
+
+	return Prepare();
+}
+
+bool SaberVoice::Prepare()
+{
+	const WavHeader::tWavInfo& lInfo = mStream.GetWavInfo();
+	bool lSupported = WAV_FORMAT_PCM == lInfo.mFormat
+			          && (8 == lInfo.mBitsPerSample || 16 == lInfo.mBitsPerSample)
+			          && (1 == lInfo.mNumChannels || 2 == lInfo.mNumChannels);
+
+	lSupported = lSupported || (WAV_FORMAT_IMA_ADPCM == lInfo.mFormat
+			                    && 1 == lInfo.mNumChannels
+			                    && lInfo.mBlockAlign > IMA_ADPCM_HEADER_SIZE
+			                    && 0 == lInfo.mBlockAlign % 4);
+
+	if(!lSupported)
+	{
+		mStream.Close();
+		return false;
+	}
+
+	mPaused = false;
+	SelectSrcTable();
+	SetVolume(1.0);
+	SetRate(0.0);
+	mFilter.Disable();
+	SeekStartOfData();
+
+	return true;
+}
+
+void SaberVoice::Close()
+{
+	mStream.Close();
+	mBlockLen = 0;
+	mBlockPos = 0;
+	mTailLeft = 0;
+}
+
+void SaberVoice::SetLooping(bool aLooping)
+{
+	mStream.SetLooping(aLooping);
+}
+
+void SaberVoice::SetVolume(float aVolume)
+{
+	mGain = (int32_t)(constrain(aVolume, 0.0, 1.0) * 32768.0);
+}
+
+void SaberVoice::SetRate(float aPitch)
+{
+	mPitch = aPitch;
+	UpdateStep();
+}
+
+void SaberVoice::SetFilter(float aCutoffHz, float aResonance)
+{
+	mFilter.SetCutoff(aCutoffHz, aResonance, NSABER_OUTPUT_SAMPLE_RATE);
+}
+
+void SaberVoice::SetPolyphaseEnabled(bool aEnabled)
+{
+	mPolyphaseEnabled = aEnabled;
+}
+
+void SaberVoice::SetFilterEnabled(bool aEnabled)
+{
+	if(aEnabled && !mFilterEnabled)
+	{
+		//Don't bring back whatever was left in the filter when it stopped
+		mFilter.Reset();
+	}
+
+	mFilterEnabled = aEnabled;
+}
+
+void SaberVoice::SeekStartOfData()
+{
+	mStream.SeekStartOfData();
+	mBlockLen = 0;
+	mBlockPos = 0;
+	mAdpcmBytesLeft = 0;
+	mPrevSample = 0;
+	mNextSample = 0;
+	memset(maHistory, 0, sizeof(maHistory));
+	mHistoryPos = 0;
+
+	//Two whole steps so the first two input samples are loaded before output starts
+	mPhase = 2 * PHASE_ONE;
+
+	//Output runs one input sample behind the newest, or half the filter
+	//behind when there is one
+	mTailLeft = nullptr != mpSrcTable ? SRC_TAPS / 2 : 1;
+}
+
+void SaberVoice::Pause()
+{
+	mPaused = true;
+}
+
+void SaberVoice::Resume()
+{
+	mPaused = false;
+}
+
+bool SaberVoice::IsEnded()
+{
+	return mStream.IsEnded() && mBlockPos >= mBlockLen && 0 == mTailLeft;
+}
+
+uint32_t SaberVoice::GetLengthSamples()
+{
+	const WavHeader::tWavInfo& lInfo = mStream.GetWavInfo();
+	if(!mStream.IsOpen() || 0 == lInfo.mBlockAlign || 0 == mStep)
+	{
+		return 0;
+	}
+
+	uint32_t lNumFrames = lInfo.mDataLength / lInfo.mBlockAlign;
+	if(WAV_FORMAT_IMA_ADPCM == lInfo.mFormat)
+	{
+		lNumFrames *= ImaAdpcm::SamplesPerBlock(lInfo.mBlockAlign);
+	}
+
+	return (uint32_t)(((uint64_t)lNumFrames * PHASE_ONE) / mStep);
+}
+
+uint16_t SaberVoice::Render(int32_t* apMix, uint16_t aNumSamples)
+{
+	if(mPaused || !mStream.IsOpen())
+	{
+		return 0;
+	}
+
+	bool lFiltering = mFilterEnabled && mFilter.IsEnabled();
+	const int16_t (*lpSrcTable)[SRC_TAPS] = mPolyphaseEnabled ? mpSrcTable : nullptr;
+
+	for(uint16_t lIdx = 0; lIdx < aNumSamples; lIdx++)
+	{
+		while(mPhase >= PHASE_ONE)
+		{
+			int16_t lSample;
+			if(!FetchSample(lSample))
+			{
+				return lIdx;
+			}
+
+			mPrevSample = mNextSample;
+			mNextSample = lSample;
+			mPhase -= PHASE_ONE;
+
+			//Keep the history even while interpolating linearly, so the
+			//polyphase filter can take over again without a glitch
+			if(nullptr != mpSrcTable)
+			{
+				PushHistory(lSample);
+			}
+		}
+
+		int32_t lSample;
+		if(nullptr == lpSrcTable)
+		{
+			//Linear interpolation between the neighbouring input samples.
+			//When the filter is only switched off, use the two it is centred
+			//between, so the output doesn't jump when it switches mid-sound.
+			int32_t lPrev = mPrevSample;
+			int32_t lNext = mNextSample;
+			if(nullptr != mpSrcTable)
+			{
+				lPrev = maHistory[mHistoryPos + SRC_TAPS / 2 - 1];
+				lNext = maHistory[mHistoryPos + SRC_TAPS / 2];
+			}
+			lSample = lPrev + (((lNext - lPrev) * (int32_t)(mPhase >> 1)) >> 15);
+		}
+		else
+		{
+			//Polyphase filter, the phase nearest the output position
+			const int16_t* lpTaps = lpSrcTable[mPhase >> (16 - SRC_PHASE_BITS)];
+			const int16_t* lpWindow = maHistory + mHistoryPos;
+			int32_t lAcc = 0;
+			for(uint8_t lTap = 0; lTap < SRC_TAPS; lTap++)
+			{
+				lAcc += (int32_t)lpWindow[lTap] * lpTaps[lTap];
+			}
+			lSample = lAcc >> 15;
+		}
+
+		if(lFiltering)
+		{
+			//Resonance can push the peak past 16 bits
+			lSample = constrain(mFilter.Process(lSample), -32768, 32767);
+		}
+
+		apMix[lIdx] += (lSample * mGain) >> 15;
+		mPhase += mStep;
+	}
+
+	return aNumSamples;
+}
+
+ReadAheadStream* SaberVoice::GetStream()
+{
+	return &mStream;
+}
+
+bool SaberVoice::FetchSample(int16_t& arSample)
+{
+	if(mBlockPos >= mBlockLen && 0 == DecodeBlock())
+	{
+		if(0 == mTailLeft || !mStream.IsEnded())
+		{
+			return false;
+		}
+
+		//Flush the last samples out of the interpolator
+		mTailLeft--;
+		arSample = 0;
+		return true;
+	}
+
+	arSample = maBlock[mBlockPos++];
+
+	return true;
+}
+
+uint16_t SaberVoice::DecodeBlock()
+{
+	const WavHeader::tWavInfo& lInfo = mStream.GetWavInfo();
+
+	if(WAV_FORMAT_IMA_ADPCM == lInfo.mFormat)
+	{
+		return DecodeAdpcmBlock();
+	}
+
+	//Read raw frames straight into the sample block and convert in place
+	uint16_t lMaxFrames = min(VOICE_BLOCK_SAMPLES, (int)(sizeof(maBlock) / lInfo.mBlockAlign));
+	uint8_t* lpRaw = (uint8_t*)maBlock;
+	uint16_t lNumFrames = mStream.Read(lpRaw, lMaxFrames * lInfo.mBlockAlign) / lInfo.mBlockAlign;
+
+	if(8 == lInfo.mBitsPerSample)
+	{
+		//Unsigned 8-bit, work backwards so we don't overwrite unread bytes
+		for(int lIdx = lNumFrames - 1; lIdx >= 0; lIdx--)
+		{
+			int16_t lSample = (int16_t)lpRaw[lIdx * lInfo.mNumChannels] - 128;
+			if(2 == lInfo.mNumChannels)
+			{
+				lSample = (lSample + (int16_t)lpRaw[lIdx * 2 + 1] - 128) >> 1;
+			}
+			maBlock[lIdx] = lSample << 8;
+		}
+	}
+	else if(2 == lInfo.mNumChannels)
+	{
+		//Mix stereo down to mono
+		for(uint16_t lIdx = 0; lIdx < lNumFrames; lIdx++)
+		{
+			maBlock[lIdx] = ((int32_t)maBlock[lIdx * 2] + maBlock[lIdx * 2 + 1]) >> 1;
+		}
+	}
+
+	mBlockLen = lNumFrames;
+	mBlockPos = 0;
+
+	return lNumFrames;
+}
+
+uint16_t SaberVoice::DecodeAdpcmBlock()
+{
+	uint16_t lNumSamples = 0;
+
+	//At a block boundary, the header carries the first sample and step index
+	if(0 == mAdpcmBytesLeft)
+	{
+		uint8_t laHeader[IMA_ADPCM_HEADER_SIZE];
+		if(IMA_ADPCM_HEADER_SIZE != mStream.Read(laHeader, IMA_ADPCM_HEADER_SIZE))
+		{
+			return 0;
+		}
+
+		maBlock[lNumSamples++] = ImaAdpcm::ReadHeader(laHeader, mAdpcmState);
+		mAdpcmBytesLeft = mStream.GetWavInfo().mBlockAlign - IMA_ADPCM_HEADER_SIZE;
+	}
+
+	//Decode as many packed bytes as fit in the rest of maBlock, in the
+	//groups of four the stream hands out
+	uint16_t lMaxBytes = ((VOICE_BLOCK_SAMPLES - lNumSamples) / 2) & ~3;
+	lMaxBytes = min(lMaxBytes, mAdpcmBytesLeft);
+	uint16_t lNumBytes = mStream.Read(maAdpcmCodes, lMaxBytes);
+
+	ImaAdpcm::Decode(mAdpcmState, maAdpcmCodes, lNumBytes, maBlock + lNumSamples);
+	lNumSamples += lNumBytes * 2;
+	mAdpcmBytesLeft -= lNumBytes;
+
+	mBlockLen = lNumSamples;
+	mBlockPos = 0;
+
+	return lNumSamples;
+}
+
+void SaberVoice::SelectSrcTable()
+{
+	uint32_t lFileRate = mStream.GetWavInfo().mSampleRate;
+
+	if(0 == lFileRate || NSABER_OUTPUT_SAMPLE_RATE == lFileRate)
+	{
+		mpSrcTable = nullptr;
+	}
+	else if(lFileRate < NSABER_OUTPUT_SAMPLE_RATE)
+	{
+		mpSrcTable = SrcTables::saUpTable;
+	}
+	else if(lFileRate <= 48000)
+	{
+		mpSrcTable = SrcTables::saDownTable;
+	}
+	else
+	{
+		//No filter cuts low enough, alias rather than play nothing
+		NSABER_LOG_WARN("No resampling filter for rate ", (int32_t)lFileRate);
+		mpSrcTable = nullptr;
+	}
+}
+
+void SaberVoice::UpdateStep()
+{
+	float lRatio = powf(2.0, mPitch);
+
+	uint32_t lFileRate = mStream.GetWavInfo().mSampleRate;
+	if(0 != lFileRate)
+	{
+		lRatio = lRatio * lFileRate / NSABER_OUTPUT_SAMPLE_RATE;
+	}
+
+	mStep = (uint32_t)(lRatio * PHASE_ONE);
+}
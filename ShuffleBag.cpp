@@ -0,0 +1,99 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * ShuffleBag.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Sound/ShuffleBag.h"
+
+ShuffleBag::ShuffleBag()
+{
+	Reset(0);
+}
+
+void ShuffleBag::Reset(uint8_t aNumItems)
+{
+	mNumItems = min(aNumItems, (uint8_t)SHUFFLE_BAG_MAX_ITEMS);
+	mPos = mNumItems;
+	mLast = 0xFF;
+}
+
+uint8_t ShuffleBag::Next()
+{
+	if(0 == mNumItems)
+	{
+		return 0;
+	}
+
+	if(mPos >= mNumItems)
+	{
+		Shuffle();
+	}
+
+	mLast = maOrder[mPos++];
+
+	return mLast;
+}
+
+uint8_t ShuffleBag::Peek()
+{
+	if(0 == mNumItems)
+	{
+		return 0;
+	}
+
+	//Shuffling early is fine, Next() will draw from the same order
+	if(mPos >= mNumItems)
+	{
+		Shuffle();
+	}
+
+	return maOrder[mPos];
+}
+
+uint8_t ShuffleBag::GetNumItems()
+{
+	return mNumItems;
+}
+
+void ShuffleBag::Shuffle()
+{
+	for(uint8_t lIdx = 0; lIdx < mNumItems; lIdx++)
+	{
+		maOrder[lIdx] = lIdx;
+	}
+
+	//Fisher-Yates
+	for(uint8_t lIdx = mNumItems - 1; lIdx > 0; lIdx--)
+	{
+		uint8_t lSwap = random(lIdx + 1);
+		uint8_t lItem = maOrder[lIdx];
+		maOrder[lIdx] = maOrder[lSwap];
+		maOrder[lSwap] = lItem;
+	}
+
+	//Don't let the new order start with the item that was just drawn
+	if(mNumItems > 1 && maOrder[0] == mLast)
+	{
+		uint8_t lSwap = 1 + random(mNumItems - 1);
+		maOrder[0] = maOrder[lSwap];
+		maOrder[lSwap] = mLast;
+	}
+
+	mPos = 0;
+}
@@ -43,12 +43,17 @@ public:
 
 	//See IDynamicSwing interface
 	virtual void SetSoundPitch(SoundTypes::ESoundTypes aType, float aPitch);
+
+	//See IDynamicSwing interface, only applies with a voice engine
+	virtual void SetSoundFilter(SoundTypes::ESoundTypes aType, float aCutoffHz, float aResonance = 0.707);
 protected:
 
 	void LoadDefaults();
 
 	float maSoundVols[SoundTypes::eeMaxSoundTypes];
 	float maSoundPitchs[SoundTypes::eeMaxSoundTypes];
+	float maSoundCutoffs[SoundTypes::eeMaxSoundTypes];
+	float maSoundResonances[SoundTypes::eeMaxSoundTypes];
 };
 
 #endif /* DYNAMICNECSOUNDMANAGER_H_ */
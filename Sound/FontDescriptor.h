@@ -0,0 +1,178 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * FontDescriptor.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef FONTDESCRIPTOR_H_
+#define FONTDESCRIPTOR_H_
+
+#include "Arduino.h"
+#include "SoundTypes.h"
+#include "FontLayout.h"
+#include "WavHeader.h"
+
+//Most sounds a font can hold. By default, a font of any layout with
+//every sound type full. A font with more is cut short, see SetCounts().
+#if not defined NSABER_MAX_FONT_SOUNDS
+#define NSABER_MAX_FONT_SOUNDS FONT_LAYOUT_MAX_SOUNDS
+#endif
+
+//Most distinct sample formats a packed font can mix
+#if not defined FONT_DESCRIPTOR_MAX_FORMATS
+#define FONT_DESCRIPTOR_MAX_FORMATS (4)
+#endif
+
+//Most sounds of a font that loop on less than their whole data
+#if not defined FONT_DESCRIPTOR_MAX_LOOPS
+#define FONT_DESCRIPTOR_MAX_LOOPS (8)
+#endif
+
+static_assert(NSABER_MAX_FONT_SOUNDS <= 255, "Sound slots are counted in 8 bits");
+
+//Format index of a sound that has no region (played from its own file)
+#define FONT_DESCRIPTOR_NO_FORMAT (0xFF)
+
+/**
+ * Compact description of the sounds in the selected font, built once by
+ * the sound manager when a font is selected.
+ *
+ * Sounds are stored grouped by type, so a sound is found by type and
+ * index with one addition. Nothing is stored per file name: each type
+ * keeps a pointer to its naming row in the (constant) layout table and
+ * names are formatted on demand. Sounds inside a packed font keep their
+ * data offset and length, plus an index into a small table of the
+ * distinct sample formats used by the font. The few sounds with loop
+ * points keep them in a short side table.
+ */
+class FontDescriptor
+{
+public:
+
+	/**
+	 * Constructor.
+	 */
+	FontDescriptor();
+
+	/**
+	 * Removes all sounds.
+	 */
+	void Clear();
+
+	/**
+	 * Sets how many sounds of each type the font has. Reserves room for
+	 * the sounds and clears any regions set before.
+	 * Args:
+	 *  apCounts - Number of sounds of each type, eeMaxSoundTypes entries
+	 * Returns:
+	 *  TRUE if successful, FALSE if the font has more than
+	 *  NSABER_MAX_FONT_SOUNDS sounds. The counts are cut to fit and an
+	 *  error is logged.
+	 */
+	bool SetCounts(const uint8_t* apCounts);
+
+	/**
+	 * Sets the naming used to build file names of a sound type.
+	 * Args:
+	 *  aSoundType - Type of sound
+	 *  apNaming - Naming from a layout table, or nullptr
+	 */
+	void SetNaming(SoundTypes::ESoundTypes aSoundType, const FontLayout::tSoundNaming* apNaming);
+
+	/**
+	 * Sets where a sound's sample data is within a packed font.
+	 * Args:
+	 *  aSoundType - Type of sound
+	 *  aIndex - Index of the sound
+	 *  arInfo - Format, data start, data length and loop of the sound
+	 * Returns:
+	 *  TRUE if successful, FALSE if the sound is out of range or the font
+	 *  uses too many formats. Loop points past FONT_DESCRIPTOR_MAX_LOOPS
+	 *  are dropped and those sounds loop on their whole data.
+	 */
+	bool SetRegion(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex, const WavHeader::tWavInfo& arInfo);
+
+	/**
+	 * Gets the number of sounds of a type.
+	 * Args:
+	 *  aSoundType - Type of sound
+	 */
+	uint8_t GetCount(SoundTypes::ESoundTypes aSoundType) const;
+
+	/**
+	 * Builds the file name of a sound, without the font directory.
+	 * Args:
+	 *  aSoundType - Type of sound
+	 *  aIndex - Index of the sound
+	 *  apStrOut - Output parameter, buffer of at least FONT_LAYOUT_MAX_NAME chars
+	 * Returns:
+	 *  TRUE if successful, FALSE if the font has no such sound
+	 */
+	bool GetName(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex, char* apStrOut) const;
+
+	/**
+	 * Gets where a sound's sample data is within a packed font.
+	 * Args:
+	 *  aSoundType - Type of sound
+	 *  aIndex - Index of the sound
+	 *  arInfo - Output parameter, populated with the format and region
+	 * Returns:
+	 *  TRUE if successful, FALSE if the sound has no region
+	 */
+	bool GetRegion(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex, WavHeader::tWavInfo& arInfo) const;
+
+protected:
+
+	/**
+	 * Finds the slot of a sound.
+	 * Returns:
+	 *  Slot index, or -1 if the font has no such sound
+	 */
+	int GetSlot(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex) const;
+
+	//Slot of the first sound of each type, the last entry is the total
+	uint8_t maFirstSlot[SoundTypes::eeMaxSoundTypes + 1];
+
+	//Naming of each sound type, points into a layout table
+	const FontLayout::tSoundNaming* mapNaming[SoundTypes::eeMaxSoundTypes];
+
+	//Sample data offset of each sound within the packed font
+	uint32_t maDataStart[NSABER_MAX_FONT_SOUNDS];
+
+	//Sample data length of each sound
+	uint32_t maDataLength[NSABER_MAX_FONT_SOUNDS];
+
+	//Index into maFormats of each sound, FONT_DESCRIPTOR_NO_FORMAT if none
+	uint8_t maFormat[NSABER_MAX_FONT_SOUNDS];
+
+	//Distinct sample formats used by the font (data start and length unused)
+	WavHeader::tWavInfo maFormats[FONT_DESCRIPTOR_MAX_FORMATS];
+
+	//Number of valid entries in maFormats
+	uint8_t mNumFormats;
+
+	//Slot of each sound with loop points, and the loop points
+	uint8_t maLoopSlot[FONT_DESCRIPTOR_MAX_LOOPS];
+	uint32_t maLoopStart[FONT_DESCRIPTOR_MAX_LOOPS];
+	uint32_t maLoopEnd[FONT_DESCRIPTOR_MAX_LOOPS];
+
+	//Number of valid entries in maLoopSlot
+	uint8_t mNumLoops;
+};
+
+#endif /* FONTDESCRIPTOR_H_ */
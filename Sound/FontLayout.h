@@ -0,0 +1,286 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * FontLayout.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef FONTLAYOUT_H_
+#define FONTLAYOUT_H_
+
+#include <stdint.h>
+#include "SoundTypes.h"
+
+/**
+ * File naming conventions of the sound font layouts NSaber understands.
+ *
+ * Each layout is a table with one row per sound type describing how its
+ * files are named. Sound managers resolve the table against the SD card
+ * once when a font is selected, so playing a sound costs the same whatever
+ * the layout.
+ *
+ *  NEC      - "clsh01.wav", "swng01.wav", "hum01.wav", "font.wav"
+ *             (lockup, drag and melt segments: "bgnlock01.wav", "endlock01.wav")
+ *  Plecter  - "clash1.wav", "poweron.wav", "poweron2.wav", "hum.wav"
+ *  CFX      - "clash1.wav", "poweron1.wav", "hum1.wav", "lswing1.wav"
+ */
+
+//Longest file name a layout produces, including the null terminator
+#define FONT_LAYOUT_MAX_NAME (16)
+
+//File name extension of loose sound files
+#define FONT_LAYOUT_EXTENSION ".wav"
+
+namespace FontLayout
+{
+
+//Naming of one sound type within a layout
+struct tSoundNaming
+{
+	//Sound type
+	SoundTypes::ESoundTypes mSoundType;
+	//File name stem ("clsh", "swing", etc.)
+	const char* mpStem;
+	//Most files of this type to look for
+	uint8_t mMaxCount;
+	//TRUE if the first file has no number ("poweron.wav, poweron2.wav")
+	bool mFirstUnnumbered;
+	//Number of the first numbered file
+	uint8_t mFirstNumber;
+	//Minimum number of digits, padded with leading zeros
+	uint8_t mDigits;
+};
+
+//A complete naming convention
+struct tFontLayout
+{
+	//Name of the layout
+	const char* mpName;
+	//Naming of each sound type the layout supports
+	const tSoundNaming* mpNaming;
+	//Number of entries in mpNaming
+	uint8_t mNumNaming;
+};
+
+static constexpr tSoundNaming saNecNaming[] =
+{
+	{SoundTypes::eeFontIdSnd,      "font",    1,                    true,  0, 0},
+	{SoundTypes::eeBootSnd,        "boot",    1,                    true,  0, 0},
+	{SoundTypes::eePowerUpSnd,     "out",     MAX_POWERUP_SOUNDS,   false, 1, 2},
+	{SoundTypes::eeSwingSnd,       "swng",    MAX_SWING_SOUNDS,     false, 1, 2},
+	{SoundTypes::eeClashSnd,       "clsh",    MAX_CLASH_SOUNDS,     false, 1, 2},
+	{SoundTypes::eeBlasterSnd,     "blst",    MAX_BLASTER_SOUNDS,   false, 1, 2},
+	{SoundTypes::eeLockupSnd,      "lock",    1,                    false, 1, 2},
+	{SoundTypes::eeForceSnd,       "force",   MAX_FORCE_SOUNDS,     false, 1, 2},
+	{SoundTypes::eePowerDownSnd,   "in",      MAX_POWERDOWN_SOUNDS, false, 1, 2},
+	{SoundTypes::eeHumSnd,         "hum",     4,                    false, 1, 2},
+	{SoundTypes::eeLockupBeginSnd, "bgnlock", 1,                    false, 1, 2},
+	{SoundTypes::eeLockupEndSnd,   "endlock", 1,                    false, 1, 2},
+	{SoundTypes::eeDragSnd,        "drag",    1,                    false, 1, 2},
+	{SoundTypes::eeDragBeginSnd,   "bgndrag", 1,                    false, 1, 2},
+	{SoundTypes::eeDragEndSnd,     "enddrag", 1,                    false, 1, 2},
+	{SoundTypes::eeMeltSnd,        "melt",    1,                    false, 1, 2},
+	{SoundTypes::eeMeltBeginSnd,   "bgnmelt", 1,                    false, 1, 2},
+	{SoundTypes::eeMeltEndSnd,     "endmelt", 1,                    false, 1, 2},
+};
+
+static constexpr tSoundNaming saPlecterNaming[] =
+{
+	{SoundTypes::eeFontIdSnd,      "font",     1,                     true,  0, 0},
+	{SoundTypes::eeBootSnd,        "boot",     1,                     true,  0, 0},
+	{SoundTypes::eePowerUpSnd,     "poweron",  MAX_POWERUP_SOUNDS,    true,  2, 1},
+	{SoundTypes::eeSwingSnd,       "swing",    MAX_SWING_SOUNDS,      false, 1, 1},
+	{SoundTypes::eeClashSnd,       "clash",    MAX_CLASH_SOUNDS,      false, 1, 1},
+	{SoundTypes::eeBlasterSnd,     "blaster",  MAX_BLASTER_SOUNDS,    true,  2, 1},
+	{SoundTypes::eeLockupSnd,      "lockup",   1,                     true,  0, 0},
+	{SoundTypes::eeForceSnd,       "force",    MAX_FORCE_SOUNDS,      true,  2, 1},
+	{SoundTypes::eePowerDownSnd,   "poweroff", MAX_POWERDOWN_SOUNDS,  true,  2, 1},
+	{SoundTypes::eeHumSnd,         "hum",      1,                     true,  0, 0},
+	{SoundTypes::eeLowSwingSnd,    "lswing",   MAX_LOW_SWING_SOUNDS,  false, 1, 1},
+	{SoundTypes::eeHighSwingSnd,   "hswing",   MAX_HIGH_SWING_SOUNDS, false, 1, 1},
+	{SoundTypes::eeLockupBeginSnd, "bgnlock",  1,                     true,  0, 0},
+	{SoundTypes::eeLockupEndSnd,   "endlock",  1,                     true,  0, 0},
+	{SoundTypes::eeDragSnd,        "drag",     1,                     true,  0, 0},
+	{SoundTypes::eeDragBeginSnd,   "bgndrag",  1,                     true,  0, 0},
+	{SoundTypes::eeDragEndSnd,     "enddrag",  1,                     true,  0, 0},
+	{SoundTypes::eeMeltSnd,        "melt",     1,                     true,  0, 0},
+	{SoundTypes::eeMeltBeginSnd,   "bgnmelt",  1,                     true,  0, 0},
+	{SoundTypes::eeMeltEndSnd,     "endmelt",  1,                     true,  0, 0},
+};
+
+static constexpr tSoundNaming saCfxNaming[] =
+{
+	{SoundTypes::eeFontIdSnd,      "font",     1,                     true,  0, 0},
+	{SoundTypes::eeBootSnd,        "boot",     1,                     false, 1, 1},
+	{SoundTypes::eePowerUpSnd,     "poweron",  MAX_POWERUP_SOUNDS,    false, 1, 1},
+	{SoundTypes::eeSwingSnd,       "swing",    MAX_SWING_SOUNDS,      false, 1, 1},
+	{SoundTypes::eeClashSnd,       "clash",    MAX_CLASH_SOUNDS,      false, 1, 1},
+	{SoundTypes::eeBlasterSnd,     "blaster",  MAX_BLASTER_SOUNDS,    false, 1, 1},
+	{SoundTypes::eeLockupSnd,      "lockup",   1,                     false, 1, 1},
+	{SoundTypes::eeForceSnd,       "force",    MAX_FORCE_SOUNDS,      false, 1, 1},
+	{SoundTypes::eePowerDownSnd,   "poweroff", MAX_POWERDOWN_SOUNDS,  false, 1, 1},
+	{SoundTypes::eeHumSnd,         "hum",      4,                     false, 1, 1},
+	{SoundTypes::eeLowSwingSnd,    "lswing",   MAX_LOW_SWING_SOUNDS,  false, 1, 1},
+	{SoundTypes::eeHighSwingSnd,   "hswing",   MAX_HIGH_SWING_SOUNDS, false, 1, 1},
+	{SoundTypes::eeLockupBeginSnd, "bgnlock",  1,                     false, 1, 1},
+	{SoundTypes::eeLockupEndSnd,   "endlock",  1,                     false, 1, 1},
+	{SoundTypes::eeDragSnd,        "drag",     1,                     false, 1, 1},
+	{SoundTypes::eeDragBeginSnd,   "bgndrag",  1,                     false, 1, 1},
+	{SoundTypes::eeDragEndSnd,     "enddrag",  1,                     false, 1, 1},
+	{SoundTypes::eeMeltSnd,        "melt",     1,                     false, 1, 1},
+	{SoundTypes::eeMeltBeginSnd,   "bgnmelt",  1,                     false, 1, 1},
+	{SoundTypes::eeMeltEndSnd,     "endmelt",  1,                     false, 1, 1},
+};
+
+#define FONT_LAYOUT_COUNT(aTable) ((uint8_t)(sizeof(aTable) / sizeof(aTable[0])))
+
+/**
+ * Counts the sounds a layout can name, with every type full.
+ * Args:
+ *  apNaming - Naming of each sound type
+ *  aNumNaming - Number of entries in apNaming
+ */
+constexpr uint16_t CountSounds(const tSoundNaming* apNaming, uint8_t aNumNaming)
+{
+	return 0 == aNumNaming ? 0 : apNaming[0].mMaxCount + CountSounds(apNaming + 1, aNumNaming - 1);
+}
+
+/**
+ * Returns the larger of two sound counts.
+ */
+constexpr uint16_t MaxSounds(uint16_t aFirst, uint16_t aSecond)
+{
+	return aFirst > aSecond ? aFirst : aSecond;
+}
+
+//Most sounds a font of any layout can have
+#define FONT_LAYOUT_MAX_SOUNDS \
+	(FontLayout::MaxSounds(FontLayout::CountSounds(FontLayout::saNecNaming, FONT_LAYOUT_COUNT(FontLayout::saNecNaming)), \
+	 FontLayout::MaxSounds(FontLayout::CountSounds(FontLayout::saPlecterNaming, FONT_LAYOUT_COUNT(FontLayout::saPlecterNaming)), \
+	                       FontLayout::CountSounds(FontLayout::saCfxNaming, FONT_LAYOUT_COUNT(FontLayout::saCfxNaming)))))
+
+static const tFontLayout sNecLayout = {"NEC", saNecNaming, FONT_LAYOUT_COUNT(saNecNaming)};
+static const tFontLayout sPlecterLayout = {"Plecter", saPlecterNaming, FONT_LAYOUT_COUNT(saPlecterNaming)};
+static const tFontLayout sCfxLayout = {"CFX", saCfxNaming, FONT_LAYOUT_COUNT(saCfxNaming)};
+
+/**
+ * Gets the naming convention for a channel map type.
+ * Args:
+ *  aType - Layout type. eeTrueSwing fonts use the Plecter names.
+ * Returns:
+ *  The layout
+ */
+inline const tFontLayout& GetLayout(SoundTypes::EChannelMapType aType)
+{
+	switch(aType)
+	{
+	case SoundTypes::eeClassicPlecter:
+	case SoundTypes::eeTrueSwing:
+		return sPlecterLayout;
+	case SoundTypes::eeCFX:
+		return sCfxLayout;
+	case SoundTypes::eeClassicNEC:
+	default:
+		return sNecLayout;
+	}
+}
+
+/**
+ * Looks up the naming of one sound type.
+ * Args:
+ *  arLayout - Layout to search
+ *  aSoundType - Sound type
+ * Returns:
+ *  Pointer to the naming, or nullptr if the layout has no such sound
+ */
+inline const tSoundNaming* FindNaming(const tFontLayout& arLayout, SoundTypes::ESoundTypes aSoundType)
+{
+	for(int lIdx = 0; lIdx < arLayout.mNumNaming; lIdx++)
+	{
+		if(aSoundType == arLayout.mpNaming[lIdx].mSoundType)
+		{
+			return &arLayout.mpNaming[lIdx];
+		}
+	}
+
+	return nullptr;
+}
+
+/**
+ * Builds the file name of one sound, without the font directory.
+ * Example: FormatName(<NEC clash naming>, 0, MY_BUFFER) fills MY_BUFFER
+ *          with "clsh01.wav".
+ * Args:
+ *  arNaming - Naming of the sound type
+ *  aIndex - Index of the sound, starting at zero
+ *  apStrOut - Output parameter, buffer of at least FONT_LAYOUT_MAX_NAME chars
+ * Returns:
+ *  TRUE if successful, FALSE if the index is out of range
+ */
+inline bool FormatName(const tSoundNaming& arNaming, uint16_t aIndex, char* apStrOut)
+{
+	if(aIndex >= arNaming.mMaxCount)
+	{
+		return false;
+	}
+
+	int lPos = 0;
+	for(const char* lpChar = arNaming.mpStem; '\0' != *lpChar; lpChar++)
+	{
+		apStrOut[lPos++] = *lpChar;
+	}
+
+	if(!arNaming.mFirstUnnumbered || aIndex > 0)
+	{
+		int lNumber = arNaming.mFirstNumber + aIndex;
+		if(arNaming.mFirstUnnumbered)
+		{
+			lNumber--;
+		}
+
+		//Digits come out backwards, write them in place from the right
+		char laDigits[4];
+		int lNumDigits = 0;
+		do
+		{
+			laDigits[lNumDigits++] = '0' + lNumber % 10;
+			lNumber /= 10;
+		} while(lNumber > 0 && lNumDigits < 4);
+
+		for(int lPad = lNumDigits; lPad < arNaming.mDigits; lPad++)
+		{
+			apStrOut[lPos++] = '0';
+		}
+
+		while(lNumDigits > 0)
+		{
+			apStrOut[lPos++] = laDigits[--lNumDigits];
+		}
+	}
+
+	for(const char* lpChar = FONT_LAYOUT_EXTENSION; '\0' != *lpChar; lpChar++)
+	{
+		apStrOut[lPos++] = *lpChar;
+	}
+	apStrOut[lPos] = '\0';
+
+	return true;
+}
+
+};
+
+#endif /* FONTLAYOUT_H_ */
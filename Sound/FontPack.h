@@ -0,0 +1,114 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * FontPack.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef FONTPACK_H_
+#define FONTPACK_H_
+
+#include <stdint.h>
+#include "FontLayout.h"
+
+/**
+ * Packed sound font container (".nfp").
+ *
+ * A whole font in one file, so playing a sound costs one seek instead of a
+ * directory lookup per file. Layout (all values little-endian):
+ *
+ *  tFontPackHeader          - 32 bytes at offset 0
+ *  tFontPackEntry[N]        - table of contents, immediately after the header
+ *  sample data              - one block per entry, each starting on a
+ *                             FONT_PACK_ALIGNMENT boundary
+ *
+ * Sample data is stored exactly as it appeared in the WAV "data" chunk.
+ * Files are produced on a PC by tools/necpack.
+ */
+
+#define FONT_PACK_MAGIC     "NSFP"
+#define FONT_PACK_VERSION   (1)
+
+//Sample data alignment, matches the SD card sector size
+#define FONT_PACK_ALIGNMENT (512)
+
+//File name extension of packed fonts
+#define FONT_PACK_EXTENSION ".nfp"
+
+//Maximum number of sounds a packed font can hold: a font of any layout
+//with every sound type full
+#if not defined FONT_PACK_MAX_ENTRIES
+#define FONT_PACK_MAX_ENTRIES FONT_LAYOUT_MAX_SOUNDS
+#endif
+
+//Entry flag: sound is meant to loop (hum, lockup)
+#define FONT_PACK_FLAG_LOOP (0x0001)
+
+namespace FontPack
+{
+
+//File header
+struct tFontPackHeader
+{
+	//FONT_PACK_MAGIC, not null terminated
+	char maMagic[4];
+	//FONT_PACK_VERSION
+	uint16_t mVersion;
+	//Number of entries in the table of contents
+	uint16_t mNumEntries;
+	//Total size of the file in bytes
+	uint32_t mFileSize;
+	//Reserved, set to zero
+	uint32_t mReserved;
+	//Font name, null terminated
+	char maFontName[16];
+};
+
+//Table of contents entry, one per sound
+struct tFontPackEntry
+{
+	//SoundTypes::ESoundTypes value
+	uint8_t mSoundType;
+	//Base-zero index within the sound type
+	uint8_t mIndex;
+	//FONT_PACK_FLAG_* bits
+	uint16_t mFlags;
+	//File offset of the sample data (multiple of FONT_PACK_ALIGNMENT)
+	uint32_t mDataOffset;
+	//Length of the sample data in bytes
+	uint32_t mDataLength;
+	//Sample frames per second
+	uint32_t mSampleRate;
+	//WAV format tag (1 = PCM)
+	uint16_t mFormat;
+	//Number of interleaved channels
+	uint16_t mNumChannels;
+	//Size of one sample frame (all channels) in bytes
+	uint16_t mBlockAlign;
+	//Bits in one sample of one channel
+	uint16_t mBitsPerSample;
+	//Loop region in bytes from the start of the sample data
+	uint32_t mLoopStart;
+	uint32_t mLoopEnd;
+};
+
+static_assert(sizeof(tFontPackHeader) == 32, "Font pack header layout changed");
+static_assert(sizeof(tFontPackEntry) == 32, "Font pack entry layout changed");
+
+};
+
+#endif /* FONTPACK_H_ */
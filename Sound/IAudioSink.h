@@ -0,0 +1,68 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * IAudioSink.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef IAUDIOSINK_H_
+#define IAUDIOSINK_H_
+
+#include <Arduino.h> //For int16_t
+
+/**
+ * Interface for the destination of mixed audio. Implementations hand the
+ * samples to whatever actually produces sound (an I2S driver, a DAC, a
+ * capture buffer, etc.). Samples are mono, signed 16-bit, at
+ * NSABER_OUTPUT_SAMPLE_RATE.
+ */
+class IAudioSink
+{
+public:
+
+	virtual ~IAudioSink()
+	{
+		//Do nothing
+	}
+
+	/**
+	 * Returns the number of samples that can be written right now
+	 * without blocking.
+	 */
+	virtual uint16_t GetFreeSamples() = 0;
+
+	/**
+	 * Queues samples for output. Callers never write more than
+	 * GetFreeSamples() reported.
+	 * Args:
+	 *  apSamples - Samples to write
+	 *  aNumSamples - Number of samples in apSamples
+	 */
+	virtual void WriteSamples(const int16_t* apSamples, uint16_t aNumSamples) = 0;
+
+	/**
+	 * Returns the number of samples written but not yet played. Only used
+	 * to measure output latency, sinks that cannot tell may leave the
+	 * default.
+	 */
+	virtual uint16_t GetQueuedSamples()
+	{
+		return 0;
+	}
+};
+
+#endif /* IAUDIOSINK_H_ */
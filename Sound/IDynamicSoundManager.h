@@ -25,7 +25,7 @@
 #include "SoundTypes.h"
 /**
  * Interface for dynamic swing effects. Provides handles for
- * sound players to change pitch and volume of individual sounds.
+ * sound players to change pitch, volume and tone of individual sounds.
  */
 class IDynamicSoundManager
 {
@@ -57,6 +57,21 @@ public:
 	 *     Exmaple2: Set hum pitch to double normal (higher): SetEffectPitch(SoundTypes::eeHumSnd, 1.0)
 	 */
 	virtual void SetSoundPitch(SoundTypes::ESoundTypes aType, float aPitch) = 0;
+
+	/**
+	 * Set a resonant low-pass filter on an individual sound. For example, raise
+	 * the cutoff of the swing sound with blade speed so a fast swing sounds
+	 * brighter than a slow one.
+	 * aType - Type of sound to adjust
+	 * aCutoffHz - Cutoff frequency in Hz, 0 to turn the filter off (default)
+	 * aResonance - Q of the filter. 0.707 gives no peak, higher values give a
+	 *     sharper peak at the cutoff for a whistling sweep.
+	 * Sound managers that can't filter ignore it.
+	 */
+	virtual void SetSoundFilter(SoundTypes::ESoundTypes aType, float aCutoffHz, float aResonance = 0.707)
+	{
+		//Do nothing
+	}
 };
 
 
@@ -0,0 +1,236 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * ImaAdpcm.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef IMAADPCM_H_
+#define IMAADPCM_H_
+
+#include <stdint.h>
+
+/**
+ * IMA ADPCM (WAV format tag 0x11), mono only. Four bits per sample, so a
+ * voice streams a quarter of the data it would for 16-bit PCM.
+ *
+ * Each block starts with a 4-byte header (first sample as int16, step
+ * index, reserved byte) followed by packed samples, low nibble first.
+ * The encoder is only used by the PC tools.
+ */
+
+namespace ImaAdpcm
+{
+
+//Quantizer step sizes
+static const int16_t saStepTable[89] =
+{
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+	19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+	50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+	130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+	337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+	876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+	2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+	5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+	15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+//Step index adjustment for each code
+static const int8_t saIndexTable[16] =
+{
+	-1, -1, -1, -1, 2, 4, 6, 8,
+	-1, -1, -1, -1, 2, 4, 6, 8
+};
+
+//Size of the header at the start of each block
+#define IMA_ADPCM_HEADER_SIZE (4)
+
+//Decoder/encoder state carried from one sample to the next
+struct tState
+{
+	//Last sample value
+	int32_t mPredictor = 0;
+	//Index into saStepTable
+	int8_t mIndex = 0;
+};
+
+/**
+ * Returns the number of samples in a mono block, including the one
+ * stored in the header.
+ * Args:
+ *  aBlockAlign - Size of a block in bytes
+ */
+inline uint16_t SamplesPerBlock(uint16_t aBlockAlign)
+{
+	return (aBlockAlign - IMA_ADPCM_HEADER_SIZE) * 2 + 1;
+}
+
+/**
+ * Loads the state from a block header.
+ * Args:
+ *  apHeader - IMA_ADPCM_HEADER_SIZE bytes from the start of a block
+ *  arState - Output parameter, state to initialize
+ * Returns:
+ *  The first sample of the block
+ */
+inline int16_t ReadHeader(const uint8_t* apHeader, tState& arState)
+{
+	arState.mPredictor = (int16_t)((uint16_t)apHeader[0] | ((uint16_t)apHeader[1] << 8));
+	arState.mIndex = apHeader[2] > 88 ? 88 : apHeader[2];
+
+	return (int16_t)arState.mPredictor;
+}
+
+/**
+ * Decodes one 4-bit code.
+ * Args:
+ *  arState - State to update
+ *  aCode - Code in the low four bits
+ * Returns:
+ *  The decoded sample
+ */
+inline int16_t DecodeSample(tState& arState, uint8_t aCode)
+{
+	int32_t lStep = saStepTable[arState.mIndex];
+
+	int32_t lDiff = lStep >> 3;
+	if(aCode & 1)
+	{
+		lDiff += lStep >> 2;
+	}
+	if(aCode & 2)
+	{
+		lDiff += lStep >> 1;
+	}
+	if(aCode & 4)
+	{
+		lDiff += lStep;
+	}
+
+	if(aCode & 8)
+	{
+		arState.mPredictor -= lDiff;
+	}
+	else
+	{
+		arState.mPredictor += lDiff;
+	}
+
+	if(arState.mPredictor > 32767)
+	{
+		arState.mPredictor = 32767;
+	}
+	else if(arState.mPredictor < -32768)
+	{
+		arState.mPredictor = -32768;
+	}
+
+	int lIndex = arState.mIndex + saIndexTable[aCode & 0x0F];
+	arState.mIndex = lIndex < 0 ? 0 : (lIndex > 88 ? 88 : lIndex);
+
+	return (int16_t)arState.mPredictor;
+}
+
+/**
+ * Decodes packed codes, two per byte, low nibble first.
+ * Args:
+ *  arState - State to update
+ *  apBytes - Packed codes
+ *  aNumBytes - Number of bytes in apBytes
+ *  apOut - Output buffer, must hold 2 * aNumBytes samples
+ */
+inline void Decode(tState& arState, const uint8_t* apBytes, uint16_t aNumBytes, int16_t* apOut)
+{
+	for(uint16_t lIdx = 0; lIdx < aNumBytes; lIdx++)
+	{
+		*apOut++ = DecodeSample(arState, apBytes[lIdx] & 0x0F);
+		*apOut++ = DecodeSample(arState, apBytes[lIdx] >> 4);
+	}
+}
+
+/**
+ * Encodes one sample. The state tracks what the decoder will produce.
+ * Args:
+ *  arState - State to update
+ *  aSample - Sample to encode
+ * Returns:
+ *  4-bit code
+ */
+inline uint8_t EncodeSample(tState& arState, int16_t aSample)
+{
+	int32_t lStep = saStepTable[arState.mIndex];
+	int32_t lDiff = (int32_t)aSample - arState.mPredictor;
+	uint8_t lCode = 0;
+
+	if(lDiff < 0)
+	{
+		lCode = 8;
+		lDiff = -lDiff;
+	}
+
+	if(lDiff >= lStep)
+	{
+		lCode |= 4;
+		lDiff -= lStep;
+	}
+	lStep >>= 1;
+	if(lDiff >= lStep)
+	{
+		lCode |= 2;
+		lDiff -= lStep;
+	}
+	lStep >>= 1;
+	if(lDiff >= lStep)
+	{
+		lCode |= 1;
+	}
+
+	//Keep the predictor in step with the decoder
+	DecodeSample(arState, lCode);
+
+	return lCode;
+}
+
+/**
+ * Encodes one mono block.
+ * Args:
+ *  arState - State carried over from the previous block (step index)
+ *  apSamples - SamplesPerBlock(aBlockAlign) input samples
+ *  aBlockAlign - Size of the block in bytes
+ *  apOut - Output buffer of aBlockAlign bytes
+ */
+inline void EncodeBlock(tState& arState, const int16_t* apSamples, uint16_t aBlockAlign, uint8_t* apOut)
+{
+	arState.mPredictor = apSamples[0];
+
+	apOut[0] = (uint8_t)(apSamples[0] & 0xFF);
+	apOut[1] = (uint8_t)((uint16_t)apSamples[0] >> 8);
+	apOut[2] = (uint8_t)arState.mIndex;
+	apOut[3] = 0;
+
+	for(uint16_t lIdx = 0; lIdx < aBlockAlign - IMA_ADPCM_HEADER_SIZE; lIdx++)
+	{
+		uint8_t lLow = EncodeSample(arState, apSamples[1 + lIdx * 2]);
+		uint8_t lHigh = EncodeSample(arState, apSamples[2 + lIdx * 2]);
+		apOut[IMA_ADPCM_HEADER_SIZE + lIdx] = lLow | (lHigh << 4);
+	}
+}
+
+};
+
+#endif /* IMAADPCM_H_ */
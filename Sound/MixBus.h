@@ -0,0 +1,147 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * MixBus.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef MIXBUS_H_
+#define MIXBUS_H_
+
+#include "Arduino.h"
+
+//Level the limiter holds block peaks to (Q15 of full scale, -1 dBFS)
+#if not defined MIX_BUS_LIMIT_THRESHOLD
+#define MIX_BUS_LIMIT_THRESHOLD (29204)
+#endif
+
+//Limiter release per block, as a right shift of the distance to the
+//target gain. 5 is about 45 ms at 64 samples per block.
+#if not defined MIX_BUS_RELEASE_SHIFT
+#define MIX_BUS_RELEASE_SHIFT (5)
+#endif
+
+//Envelope follower rise and fall per block, as right shifts of the
+//distance to the block level. 1 and 4 are about 3 ms and 25 ms.
+#if not defined MIX_BUS_ENVELOPE_ATTACK_SHIFT
+#define MIX_BUS_ENVELOPE_ATTACK_SHIFT (1)
+#endif
+
+#if not defined MIX_BUS_ENVELOPE_RELEASE_SHIFT
+#define MIX_BUS_ENVELOPE_RELEASE_SHIFT (4)
+#endif
+
+/**
+ * Final stage of the voice mix: master volume, a limiter and a soft
+ * clipper, all in fixed point.
+ *
+ * The limiter looks at the peak of each block before any of it is output,
+ * so the block itself is the look-ahead. When a block would go over the
+ * threshold the gain ramps down to the level that just fits by the end of
+ * the block, then recovers slowly. Whatever gets past the ramp is rounded
+ * off by the soft clipper, which bends the top of the range towards full
+ * scale instead of flattening it. Voices can then be mixed hot without
+ * hard clipping.
+ *
+ * An envelope follower tracks the average level of the output, so lights
+ * and other consumers can follow what is actually playing. The level is a
+ * single 16-bit value written once per block, which the processor writes
+ * in one go; readers in any context see either the old or the new level
+ * and never need a lock.
+ *
+ * Costs one division per block, plus one per sample above the threshold.
+ */
+class MixBus
+{
+public:
+
+	/**
+	 * Constructor.
+	 */
+	MixBus();
+
+	/**
+	 * Sets the volume applied before the limiter.
+	 * Args:
+	 *  aVolume - Volume from 0.0 (mute) to 1.0 (full volume)
+	 */
+	void SetMasterVolume(float aVolume);
+
+	/**
+	 * Turns the limiter on or off. The soft clipper always runs. On by default.
+	 */
+	void SetLimiterEnabled(bool aEnabled);
+
+	/**
+	 * Turns a block of summed voices into output samples.
+	 * Args:
+	 *  apMix - Summed voices, full scale is +/-32768
+	 *  apOut - Output parameter, populated with the output samples
+	 *  aNumSamples - Number of samples
+	 */
+	void Process(const int32_t* apMix, int16_t* apOut, uint16_t aNumSamples);
+
+	/**
+	 * Returns the limiter's current gain (Q15, 32768 means no reduction).
+	 */
+	int32_t GetLimiterGain();
+
+	/**
+	 * Returns the number of samples the soft clipper has bent since the
+	 * last call, and resets the count.
+	 */
+	uint32_t TakeClippedSamples();
+
+	/**
+	 * Returns the smoothed average level of the output, 0 to 32767.
+	 */
+	uint16_t GetLevel();
+
+	/**
+	 * Returns where the output level is published, for consumers that keep
+	 * a pointer rather than a reference to the mix bus.
+	 */
+	const volatile uint16_t* GetLevelTap();
+
+protected:
+
+	/**
+	 * Bends a sample above the threshold towards full scale.
+	 * Args:
+	 *  aSample - Sample to limit
+	 * Returns:
+	 *  Sample in the int16_t range
+	 */
+	int16_t SoftClip(int32_t aSample);
+
+	//Master volume (Q15)
+	int32_t mMasterGain;
+
+	//Limiter gain at the end of the last block (Q15)
+	int32_t mLimiterGain;
+
+	//TRUE if the limiter is on
+	bool mLimiterEnabled;
+
+	//Samples bent by the soft clipper
+	uint32_t mClippedSamples;
+
+	//Smoothed output level, written once per block
+	volatile uint16_t mLevel;
+};
+
+#endif /* MIXBUS_H_ */
@@ -25,6 +25,46 @@
 #include "AMotionReactive.h"
 #include <nRF52Audio.h>
 #include "ASaberSoundManager.h"
+#include "VoiceEngine.h"
+#include "FontPack.h"
+#include "FontLayout.h"
+#include "FontDescriptor.h"
+#include "ShuffleBag.h"
+#include "FileUtils.h"
+#include "SoundTelemetry.h"
+#include "EventQueue.h"
+
+//Lowest buffer level (0-100) of the playing voices at which the next
+//random effect may be preloaded
+#if not defined NSABER_PRELOAD_MIN_LEVEL
+#define NSABER_PRELOAD_MIN_LEVEL (50)
+#endif
+
+//Default time the hum starts before the end of the power up sound
+#if not defined NSABER_IGNITION_OVERLAP_MS
+#define NSABER_IGNITION_OVERLAP_MS (100)
+#endif
+
+//Default time the hum carries on under the power down sound
+#if not defined NSABER_RETRACT_OVERLAP_MS
+#define NSABER_RETRACT_OVERLAP_MS (0)
+#endif
+
+//WAV files the I2SWavPlayer path holds at once: hum, effect, and the
+//effect replacing it
+#define NEC_WAV_FILE_POOL_SIZE (3)
+
+//Longest font directory base name, leaves room for the font number
+#define NEC_FONT_BASE_NAME_SIZE (12)
+
+//Phase of a lockup, drag or melt sequence
+enum ELockupState
+{
+	eeLockupIdle,
+	eeLockupBegin,
+	eeLockupLoop,
+	eeLockupEnd
+};
 
 class NECSoundManager : public ASaberSoundManager
 {
@@ -58,7 +98,10 @@ public:
 	virtual bool PlaySound(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex = 0);
 
 	/**
-	 * Plays a random sound within the selected category.
+	 * Plays a random sound within the selected category. Sounds are drawn
+	 * from a shuffle bag, so every sound of the type plays once before any
+	 * plays again and none plays twice in a row. With a voice engine, the
+	 * next draw of the same type is preloaded while the card is idle.
 	 *
 	 * Args:
 	 *  aSoundType - Type of sound to play
@@ -75,6 +118,33 @@ public:
 	 */
 	virtual void SetFont(unsigned char aFontIndex);
 
+	/**
+	 * Chooses how SetFont() finds the sounds of a font directory. By
+	 * default every file is probed before SetFont() returns. With
+	 * background indexing, SetFont() only probes the sounds needed to boot
+	 * and ignite (boot, font, power up and hum) and leaves the rest to
+	 * ContinueFontIndex(). Packed fonts are described at once either way.
+	 * Args:
+	 *  aEnabled - TRUE to index in the background, FALSE otherwise
+	 */
+	virtual void SetBackgroundIndexing(bool aEnabled);
+
+	/**
+	 * Probes more files of the current font directory. Each sound type
+	 * becomes playable as soon as all of its files are found.
+	 * Args:
+	 *  aDeadlineUs - micros() value to be done by. At least one file is
+	 *                probed per call.
+	 * Returns:
+	 *  TRUE if there are more files to probe, FALSE otherwise
+	 */
+	virtual bool ContinueFontIndex(uint32_t aDeadlineUs);
+
+	/**
+	 * Returns TRUE once every sound of the current font has been found.
+	 */
+	virtual bool IsFontIndexed();
+
 	/**
 	 * Call this in a loop to keep sound playing.
 	 */
@@ -96,30 +166,168 @@ public:
 	 */
 	virtual void SetFontDirNameBase(const char* aBaseStr);
 
+	/**
+	 * Starts a lockup, drag or melt. With a voice engine, the sound plays
+	 * as a sequence: the begin segment, then the loop segment repeated until
+	 * StopLockup(), then the end segment. Each segment is preloaded while the
+	 * one before it plays and starts on the sample after it ends. Segments
+	 * the font doesn't have are skipped; drag and melt fall back to the
+	 * lockup sounds if the font has no loop for them.
+	 *
+	 * Without a voice engine only the loop plays.
+	 *
+	 * Same as PlaySound() with the loop type, which also posts the sound
+	 * started event. Effects played while a sequence is running end it,
+	 * and start right after its end segment.
+	 * Args:
+	 *  aLoopType - eeLockupSnd, eeDragSnd or eeMeltSnd
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	virtual bool StartLockup(SoundTypes::ESoundTypes aLoopType = SoundTypes::eeLockupSnd);
+
+	/**
+	 * Ends a lockup, drag or melt, moving straight to its end segment.
+	 */
+	virtual void StopLockup();
+
+	/**
+	 * Returns TRUE if a lockup, drag or melt is in its begin or loop segment.
+	 */
+	virtual bool IsLockupActive();
+
+	/**
+	 * Ignites the blade: plays a power up sound and starts the hum a set
+	 * time before it ends. With a voice engine the hum is preloaded while
+	 * the power up sound plays and starts on the exact sample. Without one
+	 * it starts on the first ContinuePlay() after that time.
+	 *
+	 * Effects played before the hum starts bring the hum in right away.
+	 * Args:
+	 *  aOverlapMs - How long before the end of the power up sound the hum
+	 *               starts, 0 to start it right after
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	virtual bool Ignite(uint16_t aOverlapMs = NSABER_IGNITION_OVERLAP_MS);
+
+	/**
+	 * Retracts the blade: plays a power down sound and stops the hum a set
+	 * time after it starts, on the exact sample with a voice engine.
+	 * Args:
+	 *  aOverlapMs - How long the hum carries on under the power down
+	 *               sound, 0 to stop it right away
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	virtual bool Retract(uint16_t aOverlapMs = NSABER_RETRACT_OVERLAP_MS);
+
+	/**
+	 * Sets the file naming convention of the fonts on the SD card. Takes
+	 * effect at the next call to SetFont(). Defaults to eeClassicNEC.
+	 * Args:
+	 *  aLayout - Naming convention (NEC, Plecter or CFX)
+	 */
+	virtual void SetFontLayout(SoundTypes::EChannelMapType aLayout);
+
+	/**
+	 * Plays sounds through an NSaber voice engine instead of the
+	 * I2SWavPlayer. The engine's voices stream through read-ahead buffers
+	 * that are refilled each time ContinuePlay() is called.
+	 *
+	 * With an engine attached, SetFont() looks for a packed font
+	 * ("fontX.nfp" next to the "fontX" directory) and, if one is found,
+	 * plays every sound from offsets within it.
+	 * Args:
+	 *  apEngine - Engine to use, or nullptr to go back to the I2SWavPlayer
+	 */
+	virtual void SetVoiceEngine(VoiceEngine* apEngine);
+
+	/**
+	 * Gets the audio timing statistics collected so far: trigger-to-output
+	 * latency per sound type, underruns per voice, the longest
+	 * ContinuePlay() call and SD read times. Statistics are only
+	 * collected when NSABER_TELEMETRY is set to 1, otherwise all values
+	 * read back as zero. Latency is only measured with a voice engine.
+	 * Args:
+	 *  arTelemetry - Output parameter, populated with the statistics
+	 */
+	virtual void GetTelemetry(tSoundTelemetry& arTelemetry);
+
+	/**
+	 * Sets a queue to post an event to when PlaySound() starts a sound and
+	 * when an effect sound ends. Posting happens in the calling context,
+	 * so don't share the queue with a producer in another context, such
+	 * as a motion manager updated from an interrupt.
+	 * Args:
+	 *  apQueue - Queue to post to, or nullptr for none
+	 */
+	virtual void SetEventQueue(SaberEventQueue* apQueue);
+
 protected:
 
 	/**
 	 * Generates a full file path for a specific saber sound.
 	 * Takes into account the current font index and type of sound.
 	 * Example: GenerateFileName(SoundTypes::eeClashSnd, MY_BUFFER, 0)
-	 *          will fill MY_BUFFER with the string "fontX/clsh1.wav" where "X"
-	 *          is the selected font. File naming is intended to match NEC convention.
+	 *          will fill MY_BUFFER with the string "fontX/clsh01.wav" where "X"
+	 *          is the selected font. File naming follows the font layout, names
+	 *          are looked up from the font descriptor.
 	 * Args:
 	 *  aSoundType - Type of sound
 	 *  apStrOut - Output parameter, pointer to buffer to fill with the path string
 	 *  aIndex - Index of the file
 	 *
-	 *  Returns: TRUE if successful, FALSE otherwise
+	 *  Returns: TRUE if successful, FALSE if the font has no such sound
 	 */
 	bool GenerateFileName(SoundTypes::ESoundTypes aSoundType,
 			              char* apStrOut,
 						  uint16_t aIndex = 0);
 
 	/**
-	 * Counts the number of each sound in the current font directory
-	 * and stores the results in maSoundCounts.
+	 * Finds every sound in the current font directory using the font
+	 * layout's naming, and describes them in mFont. With background
+	 * indexing, stops once the boot sounds are found.
+	 */
+	void ResolveFontSounds();
+
+	/**
+	 * Starts indexing the current font directory from the first file.
+	 */
+	void BeginFontIndex();
+
+	/**
+	 * Probes the next file of the current font directory. Boot sounds are
+	 * probed first, then the other types in order.
+	 * Returns:
+	 *  TRUE if there are more files to probe, FALSE otherwise
+	 */
+	bool IndexNextSound();
+
+	/**
+	 * Checks if a sound type is the loop segment of a lockup-like sequence
+	 * (lockup, drag or melt).
+	 * Args:
+	 *  aSoundType - Sound type to check
+	 * Returns: TRUE if the sound loops, FALSE otherwise
+	 */
+	bool IsLoopingSoundType(SoundTypes::ESoundTypes aSoundType);
+
+	/**
+	 * Starts a lockup, drag or melt sequence on the voice engine with its
+	 * begin segment, or its loop if the font has no begin segment.
+	 * Args:
+	 *  aLoopType - eeLockupSnd, eeDragSnd or eeMeltSnd
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
 	 */
-	void CountSoundsInFont();
+	bool StartLockupOnVoice(SoundTypes::ESoundTypes aLoopType);
+
+	/**
+	 * Advances the lockup sequence: preloads and queues the next segment,
+	 * and notices when segments have started or ended.
+	 */
+	void ContinueLockup();
 
 	/**
 	 * Performance mitigation function. Checks if sound type is eligible
@@ -130,9 +338,128 @@ protected:
 	 */
 	bool IsHighPerformanceSoundType(SoundTypes::ESoundTypes aSoundType);
 
+	/**
+	 * Plays a sound through the voice engine.
+	 * Args:
+	 *  aSoundType - Type of sound to play
+	 *  aIndex - Index of the sound to play
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool PlaySoundOnVoice(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex);
+
+	/**
+	 * Opens a sound on an engine voice, from the packed font if one is
+	 * loaded or from its own file otherwise.
+	 * Args:
+	 *  aChannel - Voice to play on
+	 *  aSoundType - Type of sound to play
+	 *  aIndex - Index of the sound to play
+	 *  aLooping - TRUE if the sound should repeat
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool StartVoice(uint8_t aChannel,
+			        SoundTypes::ESoundTypes aSoundType,
+			        uint16_t aIndex,
+			        bool aLooping);
+
+	/**
+	 * Preloads a sound onto the voice engine's standby voice, from the
+	 * packed font if one is loaded or from its own file otherwise.
+	 * Args:
+	 *  aSoundType - Type of sound
+	 *  aIndex - Index of the sound
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool PreloadSound(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex);
+
+	/**
+	 * Preloads the next random sound of mPreloadType if it isn't already,
+	 * provided the playing voices have enough data buffered to spare the
+	 * card time.
+	 */
+	void PreloadNextSound();
+
+	/**
+	 * Starts the hum Ignite() has scheduled on the voice engine right away,
+	 * for when something interrupts the power up sound.
+	 */
+	void StartQueuedHum();
+
+	/**
+	 * Reads how long a sound lasts from its WAV header.
+	 * Args:
+	 *  aSoundType - Type of sound
+	 *  aIndex - Index of the sound
+	 * Returns:
+	 *  Length in milliseconds, 0 if the sound can't be read
+	 */
+	uint32_t GetSoundLengthMs(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex);
+
+	/**
+	 * Creates a WAV file for the I2SWavPlayer, from the fixed pool when
+	 * NSABER_STATIC_ALLOCATION is set and from the heap otherwise.
+	 * Args:
+	 *  apPath - Path of the file
+	 * Returns:
+	 *  The file, or nullptr if the pool is used up
+	 */
+	PitchShiftSDWavFile* CreateWavFile(const char* apPath);
+
+	/**
+	 * Closes and frees a WAV file made by CreateWavFile().
+	 * Args:
+	 *  apFile - File to free, may be nullptr
+	 */
+	void DestroyWavFile(PitchShiftSDWavFile* apFile);
+
+	/**
+	 * Posts a sound started event if a sound was started.
+	 * Args:
+	 *  aSoundType - Type of sound that was requested
+	 *  aStarted - TRUE if it was started
+	 * Returns:
+	 *  aStarted
+	 */
+	bool PostSoundStarted(SoundTypes::ESoundTypes aSoundType, bool aStarted);
+
+	/**
+	 * Posts a sound ended event once the effect sound that was last posted
+	 * as started has ended.
+	 */
+	void PostSoundEnded();
+
+	/**
+	 * Refills the shuffle bags from the sound counts of the current font.
+	 */
+	void ResetShuffleBags();
+
+	/**
+	 * Loads the table of contents of the current font's packed font file,
+	 * if there is one, and describes its sounds in mFont.
+	 * Returns:
+	 *  TRUE if a packed font was loaded, FALSE otherwise
+	 */
+	bool LoadFontPack();
+
+	/**
+	 * Fetch the engine voice currently playing a sound type.
+	 * Args:
+	 *  aSoundType - Type of sound
+	 * Returns:
+	 *  Pointer to the voice, or nullptr if there is no engine or the
+	 *  type isn't playing
+	 */
+	SaberVoice* GetVoiceForType(SoundTypes::ESoundTypes aSoundType);
+
 	//Object to handle interface with the hardware for playback
 	I2SWavPlayer* mpWavPlayer;
 
+	//Optional voice engine, used for playback instead of mpWavPlayer when set
+	VoiceEngine* mpVoiceEngine;
+
 	//Current hum sound
 	PitchShiftSDWavFile* mpHumSound;
 
@@ -140,6 +467,8 @@ protected:
 	PitchShiftSDWavFile* mpEffectSound;
 	//Current effect sound type
 	SoundTypes::ESoundTypes mEffectSoundType;
+	//Current effect sound index
+	uint16_t mEffectSoundIndex;
 
 	//Channel to play hum on
 	int mHumChannel;
@@ -147,13 +476,76 @@ protected:
 	int mEffectChannel;
 
 	//Font base name (example "necFont" or "font") numbers get appended to make the font directory name
-	String mFontBaseNameStr;
+	char maFontBaseName[NEC_FONT_BASE_NAME_SIZE];
 
 	//Buffer to hold path for current font ("font1", "font2", etc.)
 	char maFontBaseDir[15];
 
-	//Keep track of how many of each sound type there is in the current font
-	int maSoundCounts[SoundTypes::eeMaxSoundTypes];
+	//File naming convention of the fonts
+	SoundTypes::EChannelMapType mFontLayout;
+
+	//Sounds of the current font
+	FontDescriptor mFont;
+
+	//Random order of the sounds of each type
+	ShuffleBag maShuffleBags[SoundTypes::eeMaxSoundTypes];
+
+	//Type whose next random sound should be preloaded (eeMaxSoundTypes for none)
+	SoundTypes::ESoundTypes mPreloadType;
+
+	//Sound held by the voice engine's standby voice
+	SoundTypes::ESoundTypes mPreloadedType;
+	uint16_t mPreloadedIndex;
+
+	//Phase of the current lockup sequence
+	ELockupState mLockupState;
+
+	//Segments of the current lockup sequence (eeMaxSoundTypes if missing)
+	SoundTypes::ESoundTypes mLockupBeginType;
+	SoundTypes::ESoundTypes mLockupLoopType;
+	SoundTypes::ESoundTypes mLockupEndType;
+
+	//TRUE if the next segment (or the effect after the end) is queued
+	bool mLockupQueued;
+
+	//TRUE while Ignite() has the hum scheduled on the voice engine
+	bool mHumQueued;
+
+	//Without a voice engine: hum start or stop waiting for millis() to
+	//reach mHumStartMs or mHumStopMs
+	bool mHumStartPending;
+	bool mHumStopPending;
+	uint32_t mHumStartMs;
+	uint32_t mHumStopMs;
+
+	//TRUE if the current font is being played from a packed font file
+	bool mFontPackLoaded;
+
+	//TRUE if SetFont() leaves most of the indexing to ContinueFontIndex()
+	bool mBackgroundIndexing;
+
+	//Font directory indexing: position in the probe order (eeMaxSoundTypes
+	//when done), next file of that type and sounds found so far
+	uint8_t mIndexPos;
+	uint16_t mIndexNext;
+	uint8_t maIndexCounts[SoundTypes::eeMaxSoundTypes];
+
+	//Path of the current packed font file ("fontX.nfp")
+	char maFontPackPath[MAX_FILE_NAME_SIZE];
+
+	//Queue sound events are posted to, nullptr for none
+	SaberEventQueue* mpEventQueue;
+
+	//TRUE if a started event was posted for the effect sound and its ended
+	//event is still due, and the type that was posted
+	bool mEffectEventPending;
+	SoundTypes::ESoundTypes mEffectEventType;
+
+#if NSABER_STATIC_ALLOCATION
+	//Storage for the I2SWavPlayer's WAV files, and which of it is in use
+	alignas(PitchShiftSDWavFile) uint8_t maWavFilePool[NEC_WAV_FILE_POOL_SIZE][sizeof(PitchShiftSDWavFile)];
+	bool maWavFileInUse[NEC_WAV_FILE_POOL_SIZE];
+#endif
 
 };
 
@@ -0,0 +1,161 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * ReadAheadScheduler.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef READAHEADSCHEDULER_H_
+#define READAHEADSCHEDULER_H_
+
+#include "ReadAheadStream.h"
+
+//Maximum number of streams a scheduler can service
+#if not defined READ_AHEAD_MAX_STREAMS
+#define READ_AHEAD_MAX_STREAMS (4)
+#endif
+
+//Default number of sectors per card transfer
+#define READ_AHEAD_DEFAULT_TRANSFER_SECTORS (2)
+
+/**
+ * Snapshot of read-ahead buffer health.
+ */
+struct tReadAheadStats
+{
+	//Number of card transfers issued
+	uint32_t mTransfers = 0;
+	//Total bytes read from the card
+	uint32_t mBytesRead = 0;
+	//Total short reads across all streams
+	uint32_t mUnderruns = 0;
+	//Fill level of each stream slot from 0 to 100 (0 if the slot is empty)
+	uint8_t maLevels[READ_AHEAD_MAX_STREAMS] = {0};
+	//Lowest fill level seen among open streams since the last ResetStats()
+	uint8_t mMinLevel = 100;
+};
+
+/**
+ * Keeps a set of ReadAheadStreams topped up. Each call to Service() refills
+ * whichever open stream will run dry soonest, using transfers sized to the
+ * card's preferred transfer length.
+ */
+class ReadAheadScheduler
+{
+public:
+
+	/**
+	 * Constructor.
+	 */
+	ReadAheadScheduler();
+
+	/**
+	 * Registers a stream to be serviced.
+	 * Args:
+	 *  apStream - Stream to add
+	 * Returns:
+	 *  TRUE if successful, FALSE if all slots are in use
+	 */
+	bool Add(ReadAheadStream* apStream);
+
+	/**
+	 * Stops servicing a stream.
+	 * Args:
+	 *  apStream - Stream to remove
+	 */
+	void Remove(ReadAheadStream* apStream);
+
+	/**
+	 * Refills the streams closest to running out.
+	 * Args:
+	 *  aMaxTransfers - Maximum number of card transfers to issue
+	 * Returns:
+	 *  Number of transfers issued
+	 */
+	uint8_t Service(uint8_t aMaxTransfers = 1);
+
+	/**
+	 * Sets the number of sectors requested per card transfer.
+	 * Args:
+	 *  aNumSectors - Sectors per transfer (1 to READ_AHEAD_BUFFER_SECTORS)
+	 */
+	void SetTransferSectors(uint8_t aNumSectors);
+
+	/**
+	 * Returns the number of sectors requested per card transfer.
+	 */
+	uint8_t GetTransferSectors();
+
+	/**
+	 * Times reads of different lengths from a file on the card and
+	 * configures the transfer length with the best throughput. Intended to
+	 * be called once at startup.
+	 * Args:
+	 *  apPath - Path of a file at least a few kilobytes long
+	 *  apScratch - Temporary buffer to read into
+	 *  aScratchSize - Size of apScratch in bytes, limits the longest transfer tried
+	 * Returns:
+	 *  Number of sectors per transfer selected
+	 */
+	uint8_t ProbeTransferSectors(const char* apPath, uint8_t* apScratch, uint16_t aScratchSize);
+
+	/**
+	 * Returns the fill level of a stream slot from 0 to 100.
+	 * Args:
+	 *  aSlot - Slot index, in the order streams were added
+	 */
+	uint8_t GetLevel(uint8_t aSlot);
+
+	/**
+	 * Estimates how long until the first open stream runs out, for fitting
+	 * other card work into the gaps between refills.
+	 * Returns:
+	 *  Time in microseconds, or 0xFFFFFFFF if no stream needs a refill
+	 */
+	uint32_t GetTimeToEmptyUs();
+
+	/**
+	 * Fetches a snapshot of buffer statistics.
+	 * Args:
+	 *  arStats - Output parameter, populated with the statistics
+	 */
+	void GetStats(tReadAheadStats& arStats);
+
+	/**
+	 * Clears transfer counters and the low-water mark.
+	 */
+	void ResetStats();
+
+protected:
+
+	//Registered streams, nullptr for unused slots
+	ReadAheadStream* mapStreams[READ_AHEAD_MAX_STREAMS];
+
+	//Sectors per card transfer
+	uint8_t mTransferSectors;
+
+	//Number of card transfers issued
+	uint32_t mTransfers;
+
+	//Total bytes read from the card
+	uint32_t mBytesRead;
+
+	//Lowest fill level seen among open streams
+	uint8_t mMinLevel;
+};
+
+#endif /* READAHEADSCHEDULER_H_ */
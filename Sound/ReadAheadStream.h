@@ -0,0 +1,283 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * ReadAheadStream.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef READAHEADSTREAM_H_
+#define READAHEADSTREAM_H_
+
+#include <SD.h>
+#include "Arduino.h"
+#include "WavHeader.h"
+#include "FileUtils.h"
+#include "SoundTelemetry.h"
+
+//Size of one SD card sector in bytes
+#define READ_AHEAD_SECTOR_SIZE (512)
+
+//Number of sectors buffered per stream. Must be a power of two.
+#if not defined READ_AHEAD_BUFFER_SECTORS
+#define READ_AHEAD_BUFFER_SECTORS (8)
+#endif
+
+#define READ_AHEAD_BUFFER_SIZE (READ_AHEAD_SECTOR_SIZE * READ_AHEAD_BUFFER_SECTORS)
+
+//Most bytes kept in RAM from the start of the loop region. At least two
+//sectors, so the copy always reaches the next sector boundary.
+#if not defined READ_AHEAD_LOOP_HEAD_SIZE
+#define READ_AHEAD_LOOP_HEAD_SIZE (READ_AHEAD_SECTOR_SIZE * 2)
+#endif
+
+/**
+ * Streams the sample data of a WAV file from the SD card through a RAM ring
+ * buffer. Consumers pull bytes out of the ring with Read(), and a
+ * ReadAheadScheduler tops the ring up with Refill() whenever there is time
+ * to spare, so a slow loop iteration does not starve the audio output.
+ *
+ * The ring is kept congruent with the file modulo the sector size, so
+ * refills are issued as whole, sector-aligned, multi-sector transfers.
+ *
+ * Looping streams repeat the loop region from the WAV header (the whole
+ * data if it has none). The start of the loop region is kept in RAM the
+ * first time it streams past, so a wrap around is a copy and the card
+ * only has to catch up from the next sector boundary. If the loop starts
+ * and ends at different offsets within a sector, the buffered bytes are
+ * moved along the ring at the wrap to keep it congruent.
+ */
+class ReadAheadStream
+{
+public:
+
+	/**
+	 * Constructor.
+	 */
+	ReadAheadStream();
+
+	/**
+	 * Destructor. Closes the file if it is still open.
+	 */
+	~ReadAheadStream();
+
+	/**
+	 * Opens a WAV file and prepares to stream its sample data.
+	 * Args:
+	 *  apPath - Full path of the file on the SD card
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool Open(const char* apPath);
+
+	/**
+	 * Prepares to stream a region of a file whose format is already known,
+	 * such as one sound in a packed font. If the same file is already open
+	 * the handle is reused, so switching regions costs only a seek.
+	 * Args:
+	 *  apPath - Full path of the file on the SD card
+	 *  arInfo - Format of the data and location of the region in the file
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool OpenRegion(const char* apPath, const WavHeader::tWavInfo& arInfo);
+
+	/**
+	 * Opens a file without starting a sound, keeping the one already open if
+	 * it's the same file. With NSABER_STATIC_ALLOCATION, opening a packed
+	 * font ahead of time means no file is opened while sounds play.
+	 * Args:
+	 *  apPath - Full path of the file on the SD card
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool OpenFile(const char* apPath);
+
+	/**
+	 * Closes the file and discards any buffered data.
+	 */
+	void Close();
+
+	/**
+	 * Returns TRUE if a file is open.
+	 */
+	bool IsOpen();
+
+	/**
+	 * Copies buffered sample data out of the ring. Only whole sample
+	 * frames (whole 4-byte groups for ADPCM) are copied.
+	 * Args:
+	 *  apOut - Buffer to fill
+	 *  aNumBytes - Number of bytes wanted
+	 * Returns:
+	 *  Number of bytes copied. Anything short of aNumBytes before the
+	 *  end of the data is counted as an underrun.
+	 */
+	uint16_t Read(uint8_t* apOut, uint16_t aNumBytes);
+
+	/**
+	 * Reads more data from the card into the ring with a single transfer.
+	 * Args:
+	 *  aMaxBytes - Upper bound on the transfer size
+	 * Returns:
+	 *  Number of bytes read from the card
+	 */
+	uint32_t Refill(uint32_t aMaxBytes);
+
+	/**
+	 * Restarts streaming from the first byte of sample data.
+	 */
+	void SeekStartOfData();
+
+	/**
+	 * Sets whether the data wraps around to the start of the loop region
+	 * when it reaches the end of the loop region.
+	 */
+	void SetLooping(bool aLooping);
+
+	/**
+	 * Returns TRUE once all of the data has been consumed and no wrap
+	 * around is pending.
+	 */
+	bool IsEnded();
+
+	/**
+	 * Returns TRUE if there is nothing left on the card for this stream.
+	 */
+	bool IsFullyRead();
+
+	/**
+	 * Returns the number of bytes waiting in the ring.
+	 */
+	uint32_t GetBufferedBytes();
+
+	/**
+	 * Returns the number of bytes that can be added to the ring.
+	 */
+	uint32_t GetFreeBytes();
+
+	/**
+	 * Returns the fill level of the ring from 0 (empty) to 100 (full).
+	 */
+	uint8_t GetLevel();
+
+	/**
+	 * Estimates how long the buffered data will last at the file's
+	 * native data rate.
+	 * Returns:
+	 *  Time in microseconds, or 0xFFFFFFFF if the stream needs no refill
+	 */
+	uint32_t GetTimeToEmptyUs();
+
+	/**
+	 * Returns the number of reads that could not be fully satisfied.
+	 */
+	uint32_t GetUnderruns();
+
+	/**
+	 * Returns the properties parsed from the WAV header.
+	 */
+	const WavHeader::tWavInfo& GetWavInfo();
+
+protected:
+
+	/**
+	 * Works out the read granularity for the current format.
+	 */
+	void UpdateReadGranule();
+
+	/**
+	 * Works out the loop region for the current file and forgets any
+	 * cached loop start.
+	 */
+	void UpdateLoop();
+
+	/**
+	 * Empties the ring and positions the card at a file offset.
+	 * Args:
+	 *  aFilePos - Offset of the next byte to be read from the card
+	 */
+	void Reset(uint32_t aFilePos);
+
+	/**
+	 * Moves the buffered bytes further along the ring, so the next byte
+	 * from the card lands at a different offset within a sector. There
+	 * must be at least that much room in the ring.
+	 * Args:
+	 *  aShift - Bytes to move by
+	 */
+	void Realign(uint32_t aShift);
+
+	/**
+	 * Closes the file, if one is open.
+	 */
+	void CloseFile();
+
+	//File being streamed
+	File mFile;
+
+	//TRUE if the stream has a sound to play
+	bool mIsOpen;
+
+	//TRUE if mFile is open. With NSABER_STATIC_ALLOCATION the file stays
+	//open after Close(), so the next sound from it needn't open it again.
+	bool mFileOpen;
+
+	//Path of the open file
+	char maPath[MAX_FILE_NAME_SIZE];
+
+	//TRUE if the data should wrap around
+	bool mLooping;
+
+	//Properties from the WAV header
+	WavHeader::tWavInfo mWavInfo;
+
+	//File offset of the next byte to read from the card
+	uint32_t mFilePos;
+
+	//File offset just past the end of the sample data
+	uint32_t mDataEnd;
+
+	//Total bytes written into the ring (free running)
+	uint32_t mHead;
+
+	//Total bytes consumed from the ring (free running)
+	uint32_t mTail;
+
+	//Count of short reads
+	uint32_t mUnderruns;
+
+	//Read() only hands out multiples of this many bytes
+	uint16_t mReadGranule;
+
+	//File offsets of the start of the loop and just past its end
+	uint32_t mLoopStart;
+	uint32_t mLoopEnd;
+
+	//Bytes from the start of the loop to keep in maLoopHead
+	uint16_t mLoopHeadLength;
+
+	//Bytes captured into maLoopHead so far
+	uint16_t mLoopHeadFill;
+
+	//Copy of the start of the loop
+	uint8_t maLoopHead[READ_AHEAD_LOOP_HEAD_SIZE];
+
+	//Ring buffer storage
+	uint8_t maBuffer[READ_AHEAD_BUFFER_SIZE];
+};
+
+#endif /* READAHEADSTREAM_H_ */
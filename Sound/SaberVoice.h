@@ -0,0 +1,280 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * SaberVoice.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef SABERVOICE_H_
+#define SABERVOICE_H_
+
+#include "ReadAheadStream.h"
+#include "ImaAdpcm.h"
+#include "StateVariableFilter.h"
+#include "SrcTables.h"
+
+//Sample rate of the mixed output
+#if not defined NSABER_OUTPUT_SAMPLE_RATE
+#define NSABER_OUTPUT_SAMPLE_RATE (44100)
+#endif
+
+//Number of input samples decoded at a time
+#define VOICE_BLOCK_SAMPLES (64)
+
+/**
+ * One playing sound. Pulls sample data from a ReadAheadStream, converts it
+ * to mono 16-bit, applies pitch, an optional filter and volume, and adds it
+ * into a mix buffer.
+ *
+ * Files at the output rate are interpolated linearly. Files at another
+ * rate go through a polyphase filter picked from the WAV header when the
+ * file is opened, so the conversion and any pitch shift happen in a single
+ * pass without the images linear interpolation leaves.
+ * Controls mirror those of PitchShiftSDWavFile so the sound managers can
+ * drive either one the same way.
+ */
+class SaberVoice
+{
+public:
+
+	/**
+	 * Constructor.
+	 */
+	SaberVoice();
+
+	/**
+	 * Opens a WAV file for playback. Volume, pitch and filter are reset to
+	 * defaults.
+	 * Supports 8 or 16-bit PCM, mono or stereo, and mono IMA ADPCM.
+	 * Args:
+	 *  apPath - Full path of the file on the SD card
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool Open(const char* apPath);
+
+	/**
+	 * Opens a region of a file for playback, such as one sound in a packed
+	 * font. Volume, pitch and filter are reset to defaults.
+	 * Args:
+	 *  apPath - Full path of the file on the SD card
+	 *  arInfo - Format of the data and location of the region in the file
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool OpenRegion(const char* apPath, const WavHeader::tWavInfo& arInfo);
+
+	/**
+	 * Stops playback and closes the file.
+	 */
+	void Close();
+
+	/**
+	 * Sets whether the sound starts over when it reaches the end.
+	 */
+	void SetLooping(bool aLooping);
+
+	/**
+	 * Sets the volume of this voice.
+	 * Args:
+	 *  aVolume - Volume from 0.0 (mute) to 1.0 (full volume)
+	 */
+	void SetVolume(float aVolume);
+
+	/**
+	 * Sets the pitch of this voice.
+	 * Args:
+	 *  aPitch - Pitch delta in octaves. 0.0 is normal speed, -1.0 is half
+	 *           speed, 1.0 is double speed.
+	 */
+	void SetRate(float aPitch);
+
+	/**
+	 * Sets a resonant low-pass filter on this voice, for example to brighten
+	 * a swing as the blade speeds up. Takes effect from the next block, and
+	 * can be changed every block without clicks.
+	 * Args:
+	 *  aCutoffHz - Cutoff frequency, 0 to turn the filter off
+	 *  aResonance - Q, 0.707 for no peak, higher for a sharper peak
+	 */
+	void SetFilter(float aCutoffHz, float aResonance);
+
+	/**
+	 * Allows or stops use of the polyphase filter for files that aren't at
+	 * the output rate. When stopped, they are interpolated linearly, which
+	 * costs less. Kept when a new file is opened. Defaults to TRUE.
+	 */
+	void SetPolyphaseEnabled(bool aEnabled);
+
+	/**
+	 * Allows or bypasses the filter set by SetFilter(), to save time. Kept
+	 * when a new file is opened. Defaults to TRUE.
+	 */
+	void SetFilterEnabled(bool aEnabled);
+
+	/**
+	 * Restarts the sound from the beginning.
+	 */
+	void SeekStartOfData();
+
+	/**
+	 * Stops the voice from producing samples until Resume() is called.
+	 */
+	void Pause();
+
+	/**
+	 * Continues playback after Pause().
+	 */
+	void Resume();
+
+	/**
+	 * Returns TRUE if the voice has nothing more to play.
+	 */
+	bool IsEnded();
+
+	/**
+	 * Returns how many output samples one pass through the whole sound
+	 * lasts at the current pitch.
+	 */
+	uint32_t GetLengthSamples();
+
+	/**
+	 * Adds samples from this voice into a mix buffer.
+	 * Args:
+	 *  apMix - Mix buffer to add into
+	 *  aNumSamples - Number of output samples wanted
+	 * Returns:
+	 *  Number of samples produced. Less than aNumSamples means the voice
+	 *  ended or ran out of buffered data.
+	 */
+	uint16_t Render(int32_t* apMix, uint16_t aNumSamples);
+
+	/**
+	 * Returns the stream feeding this voice.
+	 */
+	ReadAheadStream* GetStream();
+
+protected:
+
+	/**
+	 * Checks the stream format is playable and resets playback state.
+	 * Returns:
+	 *  TRUE if the format is supported, FALSE otherwise
+	 */
+	bool Prepare();
+
+	/**
+	 * Fetches the next input sample, decoding another block if needed.
+	 * Args:
+	 *  arSample - Output parameter, populated with the sample
+	 * Returns:
+	 *  TRUE if a sample was available, FALSE otherwise
+	 */
+	bool FetchSample(int16_t& arSample);
+
+	/**
+	 * Reads and converts the next block of input samples into maBlock.
+	 * Returns:
+	 *  Number of samples decoded
+	 */
+	uint16_t DecodeBlock();
+
+	/**
+	 * Decodes the next run of IMA ADPCM samples into maBlock.
+	 * Returns:
+	 *  Number of samples decoded
+	 */
+	uint16_t DecodeAdpcmBlock();
+
+	/**
+	 * Recomputes mStep from the pitch and the file's sample rate.
+	 */
+	void UpdateStep();
+
+	/**
+	 * Picks the polyphase filter for the file's sample rate.
+	 */
+	void SelectSrcTable();
+
+	/**
+	 * Adds an input sample to the polyphase filter's history.
+	 */
+	inline void PushHistory(int16_t aSample)
+	{
+		maHistory[mHistoryPos] = aSample;
+		maHistory[mHistoryPos + SRC_TAPS] = aSample;
+		mHistoryPos = (mHistoryPos + 1) & (SRC_TAPS - 1);
+	}
+
+	//Source of sample data
+	ReadAheadStream mStream;
+
+	//Decoded input samples
+	int16_t maBlock[VOICE_BLOCK_SAMPLES];
+	//Number of valid samples in maBlock
+	uint16_t mBlockLen;
+	//Next sample to take from maBlock
+	uint16_t mBlockPos;
+
+	//ADPCM decoder state
+	ImaAdpcm::tState mAdpcmState;
+	//Packed bytes left in the current ADPCM block, 0 at a block boundary
+	uint16_t mAdpcmBytesLeft;
+	//Packed ADPCM codes waiting to be decoded
+	uint8_t maAdpcmCodes[VOICE_BLOCK_SAMPLES / 2];
+
+	//Samples either side of the current output position
+	int16_t mPrevSample;
+	int16_t mNextSample;
+
+	//Silent samples still to be fed in after the end of the stream, so the
+	//interpolator gets to output the last samples it holds
+	uint8_t mTailLeft;
+
+	//Polyphase filter for the file's sample rate, nullptr to interpolate
+	//linearly
+	const int16_t (*mpSrcTable)[SRC_TAPS];
+
+	//Last SRC_TAPS input samples, stored twice so the newest SRC_TAPS are
+	//always in a row starting at mHistoryPos
+	int16_t maHistory[2 * SRC_TAPS];
+	uint8_t mHistoryPos;
+
+	//Position between the two input samples interpolated (16.16 fixed point)
+	uint32_t mPhase;
+	//Input samples advanced per output sample (16.16 fixed point)
+	uint32_t mStep;
+
+	//Current pitch delta in octaves
+	float mPitch;
+
+	//Volume (Q15)
+	int32_t mGain;
+
+	//Tone filter, applied at the output rate
+	StateVariableFilter mFilter;
+
+	//FALSE to interpolate linearly even if there is a polyphase filter
+	bool mPolyphaseEnabled;
+	//FALSE to bypass mFilter
+	bool mFilterEnabled;
+
+	//TRUE while paused
+	bool mPaused;
+};
+
+#endif /* SABERVOICE_H_ */
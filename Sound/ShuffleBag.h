@@ -0,0 +1,92 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * ShuffleBag.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef SHUFFLEBAG_H_
+#define SHUFFLEBAG_H_
+
+#include "Arduino.h"
+
+//Most items a bag can hold
+#if not defined SHUFFLE_BAG_MAX_ITEMS
+#define SHUFFLE_BAG_MAX_ITEMS (16)
+#endif
+
+/**
+ * Picks items in a random order without repeats. Every item is drawn once
+ * before any is drawn again, and the first draw from a new shuffle is never
+ * the same as the last draw of the previous one, so an item never comes up
+ * twice in a row. The next draw is decided ahead of time and can be read
+ * with Peek().
+ */
+class ShuffleBag
+{
+public:
+
+	/**
+	 * Constructor. The bag starts out empty.
+	 */
+	ShuffleBag();
+
+	/**
+	 * Empties the bag and refills it with a new number of items.
+	 * Args:
+	 *  aNumItems - Number of items, cut to SHUFFLE_BAG_MAX_ITEMS
+	 */
+	void Reset(uint8_t aNumItems);
+
+	/**
+	 * Draws the next item.
+	 * Returns:
+	 *  Item from 0 to the number of items - 1 (0 if the bag is empty)
+	 */
+	uint8_t Next();
+
+	/**
+	 * Returns the item the next call to Next() will draw, without drawing it.
+	 */
+	uint8_t Peek();
+
+	/**
+	 * Returns the number of items in the bag.
+	 */
+	uint8_t GetNumItems();
+
+protected:
+
+	/**
+	 * Shuffles all items back into the bag.
+	 */
+	void Shuffle();
+
+	//Order items will be drawn in
+	uint8_t maOrder[SHUFFLE_BAG_MAX_ITEMS];
+
+	//Number of items
+	uint8_t mNumItems;
+
+	//Position of the next draw in maOrder
+	uint8_t mPos;
+
+	//Last item drawn
+	uint8_t mLast;
+};
+
+#endif /* SHUFFLEBAG_H_ */
@@ -0,0 +1,258 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * SoundTelemetry.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef SOUNDTELEMETRY_H_
+#define SOUNDTELEMETRY_H_
+
+#include <Arduino.h>
+#include "SoundTypes.h"
+
+//Set to 1 (here or with a build flag) to collect audio timing statistics.
+//When 0, every call below is an empty inline function and compiles away.
+#if not defined NSABER_TELEMETRY
+#define NSABER_TELEMETRY (0)
+#endif
+
+//Number of voices tracked for underruns and latency
+#define TELEMETRY_MAX_VOICES (4)
+
+//Motion-to-sound traces kept for percentiles, the most recent ones
+#if not defined TELEMETRY_LATENCY_TRACES
+#define TELEMETRY_LATENCY_TRACES (64)
+#endif
+
+//Longest a detected motion waits for a sound to be triggered before the
+//next trigger is no longer put down to it
+#if not defined TELEMETRY_MOTION_TIMEOUT_US
+#define TELEMETRY_MOTION_TIMEOUT_US (250000)
+#endif
+
+/**
+ * Audio timing statistics. All times are in microseconds.
+ */
+struct tSoundTelemetry
+{
+	//Time from PlaySound() to the sound's first sample reaching the
+	//output, per sound type
+	uint32_t maLastLatencyUs[SoundTypes::eeMaxSoundTypes] = {0};
+	uint32_t maMaxLatencyUs[SoundTypes::eeMaxSoundTypes] = {0};
+
+	//Number of blocks each voice could not fill because its buffer ran dry
+	uint32_t maUnderruns[TELEMETRY_MAX_VOICES] = {0};
+
+	//Longest single call to ContinuePlay()
+	uint32_t mMaxContinuePlayUs = 0;
+
+	//SD card reads issued for streaming, and their timing
+	uint32_t mSdReads = 0;
+	uint32_t mSdBytes = 0;
+	uint32_t mTotalSdReadUs = 0;
+	uint32_t mMaxSdReadUs = 0;
+};
+
+/**
+ * Stages between the blade moving and the sound being heard.
+ */
+enum ELatencyStage
+{
+	eeLatencySample,   //Time between the motion sensor reads the motion fell between
+	eeLatencyDetect,   //Sensor read to motion detected
+	eeLatencyDispatch, //Motion detected to PlaySound()
+	eeLatencyStart,    //PlaySound() to the first block with the sound being mixed
+	eeLatencyOutput,   //Block mixed to heard, time spent in the output buffer
+	eeLatencyTotal,    //All of the above
+	eeMaxLatencyStages
+};
+
+/**
+ * Spread of one latency stage, in microseconds.
+ */
+struct tLatencyPercentiles
+{
+	uint32_t mP50Us = 0;
+	uint32_t mP90Us = 0;
+	uint32_t mP99Us = 0;
+	uint32_t mMaxUs = 0;
+};
+
+/**
+ * Motion-to-sound latency by stage, over the last TELEMETRY_LATENCY_TRACES
+ * traces.
+ */
+struct tLatencyReport
+{
+	//Traces completed since the last reset
+	uint32_t mTraces = 0;
+	//Traces the percentiles are taken from
+	uint16_t mWindow = 0;
+	tLatencyPercentiles maStages[eeMaxLatencyStages];
+};
+
+namespace SoundTelemetry
+{
+
+#if NSABER_TELEMETRY
+
+/**
+ * Returns a timestamp for timing an operation.
+ */
+inline uint32_t Now()
+{
+	return micros();
+}
+
+/**
+ * Records that a sound was requested on a voice.
+ * Args:
+ *  aChannel - Voice the sound will play on
+ *  aSoundType - Type of sound
+ */
+void NoteTrigger(uint8_t aChannel, SoundTypes::ESoundTypes aSoundType);
+
+/**
+ * Records that a voice produced output. Completes the latency
+ * measurement if a trigger is pending on the voice.
+ * Args:
+ *  aChannel - Voice that produced samples
+ *  aQueuedUs - Time the samples will wait in the output before being heard
+ */
+void NoteOutput(uint8_t aChannel, uint32_t aQueuedUs);
+
+/**
+ * Records that a motion sensor detected a motion that a sound will be
+ * played for, such as a swing or clash. The next PlaySound() of anything
+ * but the hum carries it through to the output as a latency trace.
+ * Args:
+ *  aSampleUs - micros() when the sensor read that showed the motion began
+ *  aIntervalUs - Time since the sensor read before it
+ */
+void NoteMotion(uint32_t aSampleUs, uint32_t aIntervalUs);
+
+/**
+ * Records a block that a voice could not fill.
+ * Args:
+ *  aChannel - Voice that ran dry
+ */
+void NoteUnderrun(uint8_t aChannel);
+
+/**
+ * Records the duration of a ContinuePlay() call.
+ * Args:
+ *  aStartUs - Timestamp from Now() taken at the start of the call
+ */
+void NoteContinuePlay(uint32_t aStartUs);
+
+/**
+ * Records a streaming read from the SD card.
+ * Args:
+ *  aStartUs - Timestamp from Now() taken before the read
+ *  aNumBytes - Bytes read
+ */
+void NoteSdRead(uint32_t aStartUs, uint32_t aNumBytes);
+
+/**
+ * Copies the statistics collected so far.
+ * Args:
+ *  arOut - Output parameter, populated with the statistics
+ */
+void Get(tSoundTelemetry& arOut);
+
+/**
+ * Works out motion-to-sound latency percentiles by stage.
+ * Args:
+ *  arOut - Output parameter, populated with the report
+ */
+void GetLatencyReport(tLatencyReport& arOut);
+
+/**
+ * Prints the motion-to-sound latency report as a table, one stage per line.
+ * Args:
+ *  arOut - Where to print, such as Serial
+ */
+void PrintLatencyReport(Print& arOut);
+
+/**
+ * Clears all statistics.
+ */
+void Reset();
+
+#else
+
+inline uint32_t Now()
+{
+	return 0;
+}
+
+inline void NoteTrigger(uint8_t aChannel, SoundTypes::ESoundTypes aSoundType)
+{
+	//Do nothing
+}
+
+inline void NoteOutput(uint8_t aChannel, uint32_t aQueuedUs)
+{
+	//Do nothing
+}
+
+inline void NoteMotion(uint32_t aSampleUs, uint32_t aIntervalUs)
+{
+	//Do nothing
+}
+
+inline void NoteUnderrun(uint8_t aChannel)
+{
+	//Do nothing
+}
+
+inline void NoteContinuePlay(uint32_t aStartUs)
+{
+	//Do nothing
+}
+
+inline void NoteSdRead(uint32_t aStartUs, uint32_t aNumBytes)
+{
+	//Do nothing
+}
+
+inline void Get(tSoundTelemetry& arOut)
+{
+	arOut = tSoundTelemetry();
+}
+
+inline void GetLatencyReport(tLatencyReport& arOut)
+{
+	arOut = tLatencyReport();
+}
+
+inline void PrintLatencyReport(Print& arOut)
+{
+	arOut.println("Latency tracing needs NSABER_TELEMETRY set to 1");
+}
+
+inline void Reset()
+{
+	//Do nothing
+}
+
+#endif
+
+};
+
+#endif /* SOUNDTELEMETRY_H_ */
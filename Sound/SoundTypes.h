@@ -50,6 +50,14 @@ enum ESoundTypes
 	eeMenuSoundSnd,
 	eeLowSwingSnd,
 	eeHighSwingSnd,
+	eeLockupBeginSnd,
+	eeLockupEndSnd,
+	eeDragSnd,
+	eeDragBeginSnd,
+	eeDragEndSnd,
+	eeMeltSnd,
+	eeMeltBeginSnd,
+	eeMeltEndSnd,
 	eeMaxSoundTypes
 };
 
@@ -57,64 +65,8 @@ enum EChannelMapType
 {
 	eeClassicPlecter,
 	eeTrueSwing,
-	eeClassicNEC
-};
-
-//Container class to define sound files available from a sound font
-struct tSoundFontProperties
-{
-	//Base directory of font
-	char* mBaseDir;
-
-	/**********************************************
-	 * Basic Sounds.
-	 * All fonts should have at least one of these.
-	 **********************************************/
-	//Font Identifier
-	char* mFontIdFile;
-	//Boot sound
-	char* mBootFile;
-	//Lockup
-	char* mLockupFile;
-	//Hum
-	char* mHumFile;
-
-	//Powerup sounds
-	char* maPowerUpFile[MAX_POWERUP_SOUNDS];
-	short mNumPowerUpFiles = 0;
-
-	//Swing sounds
-	char* maSwingFile[MAX_SWING_SOUNDS];
-	short mNumSwingFiles = 0;
-
-	//Clash sounds
-	char* maClashFile[MAX_CLASH_SOUNDS];
-	short mNumClashFiles = 0;
-
-	//Blaster sounds
-	char* maBlasterFile[MAX_BLASTER_SOUNDS];
-	short mNumBlasterFiles = 0;
-
-	//Power down sounds
-	char* maPowerDownFile[MAX_POWERDOWN_SOUNDS];
-	short mNumPowerDownFiles = 0;
-
-
-	/**********************************
-	 * Advanced sounds.
-	 * Some fonts may not have these.
-	 *********************************/
-	//Special "Force" sounds
-	char* maForceFile[MAX_FORCE_SOUNDS];
-	short mNumForceFiles = 0;
-
-	//Dynamic swing sounds
-	char* maLowSwingFile[MAX_LOW_SWING_SOUNDS];
-	short mNumLowSwingFiles = 0;
-
-	char* maHighSwingFile[MAX_HIGH_SWING_SOUNDS];
-	short mNumHighSwingFiles = 0;
-
+	eeClassicNEC,
+	eeCFX
 };
 
 }
@@ -0,0 +1,312 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * SrcTables.h
+ *
+ *  Generated by tools/srctables, do not edit.
+ */
+
+#ifndef SRCTABLES_H_
+#define SRCTABLES_H_
+
+#include <stdint.h>
+
+//Input samples each output sample is made from
+#define SRC_TAPS (8)
+
+//Fraction bits of the position between input samples used to pick a phase
+#define SRC_PHASE_BITS (7)
+
+#define SRC_PHASES (1 << SRC_PHASE_BITS)
+
+/**
+ * Polyphase filters for sample rate conversion, Q15. Row p holds the
+ * taps for an output sample p / SRC_PHASES of the way from input sample
+ * SRC_TAPS / 2 - 1 to the next, oldest input sample first.
+ */
+namespace SrcTables
+{
+
+//Input rate below the output rate (11.025, 16, 22.05, 32 kHz). Cutoff
+//just under the input Nyquist to remove the images
+static const int16_t saUpTable[SRC_PHASES][SRC_TAPS] =
+{
+	{    644,  -1683,   2779,  29288,   2779,  -1683,    644,      0 },
+	{    628,  -1622,   2570,  29371,   3005,  -1754,    664,    -94 },
+	{    610,  -1556,   2358,  29365,   3227,  -1821,    682,    -97 },
+	{    592,  -1491,   2148,  29355,   3452,  -1888,    700,   -100 },
+	{    574,  -1425,   1940,  29339,   3680,  -1955,    718,   -103 },
+	{    556,  -1360,   1736,  29318,   3910,  -2022,    736,   -106 },
+	{    539,  -1296,   1535,  29291,   4143,  -2089,    754,   -109 },
+	{    521,  -1232,   1337,  29261,   4378,  -2156,    771,   -112 },
+	{    503,  -1168,   1142,  29224,   4617,  -2223,    789,   -116 },
+	{    486,  -1105,    950,  29182,   4857,  -2289,    806,   -119 },
+	{    468,  -1042,    762,  29134,   5100,  -2356,    824,   -122 },
+	{    451,   -980,    576,  29082,   5346,  -2423,    841,   -125 },
+	{    433,   -918,    394,  29025,   5593,  -2489,    858,   -128 },
+	{    416,   -857,    215,  28961,   5844,  -2555,    875,   -131 },
+	{    399,   -796,     39,  28893,   6096,  -2621,    892,   -134 },
+	{    382,   -736,   -134,  28821,   6350,  -2686,    908,   -137 },
+	{    366,   -677,   -303,  28741,   6607,  -2751,    925,   -140 },
+	{    349,   -618,   -469,  28659,   6865,  -2816,    941,   -143 },
+	{    333,   -560,   -632,  28570,   7126,  -2880,    957,   -146 },
+	{    317,   -503,   -791,  28478,   7388,  -2944,    972,   -149 },
+	{    301,   -446,   -947,  28379,   7653,  -3007,    987,   -152 },
+	{    285,   -390,  -1100,  28276,   7919,  -3069,   1002,   -155 },
+	{    269,   -335,  -1249,  28167,   8187,  -3131,   1017,   -157 },
+	{    254,   -281,  -1395,  28055,   8456,  -3192,   1031,   -160 },
+	{    238,   -227,  -1537,  27936,   8727,  -3252,   1045,   -162 },
+	{    223,   -175,  -1676,  27815,   8999,  -3312,   1059,   -165 },
+	{    209,   -123,  -1811,  27685,   9273,  -3370,   1072,   -167 },
+	{    194,    -72,  -1943,  27554,   9548,  -3428,   1085,   -170 },
+	{    180,    -22,  -2072,  27418,   9824,  -3485,   1097,   -172 },
+	{    166,     27,  -2197,  27276,  10102,  -3541,   1109,   -174 },
+	{    152,     75,  -2319,  27129,  10381,  -3595,   1121,   -176 },
+	{    138,    123,  -2437,  26979,  10660,  -3649,   1132,   -178 },
+	{    125,    169,  -2552,  26824,  10941,  -3701,   1142,   -180 },
+	{    112,    215,  -2663,  26665,  11222,  -3753,   1152,   -182 },
+	{     99,    259,  -2771,  26502,  11504,  -3803,   1162,   -184 },
+	{     87,    303,  -2875,  26331,  11787,  -3851,   1171,   -185 },
+	{     75,    345,  -2976,  26160,  12071,  -3899,   1179,   -187 },
+	{     63,    387,  -3074,  25983,  12355,  -3945,   1187,   -188 },
+	{     51,    428,  -3168,  25802,  12639,  -3989,   1194,   -189 },
+	{     39,    467,  -3259,  25618,  12924,  -4032,   1201,   -190 },
+	{     28,    506,  -3346,  25429,  13209,  -4074,   1207,   -191 },
+	{     17,    543,  -3430,  25237,  13494,  -4114,   1212,   -191 },
+	{      7,    580,  -3510,  25039,  13779,  -4152,   1217,   -192 },
+	{     -3,    616,  -3588,  24839,  14064,  -4189,   1221,   -192 },
+	{    -13,    650,  -3662,  24635,  14349,  -4223,   1225,   -193 },
+	{    -23,    684,  -3732,  24427,  14634,  -4256,   1227,   -193 },
+	{    -33,    716,  -3800,  24217,  14919,  -4288,   1229,   -192 },
+	{    -42,    748,  -3864,  24001,  15203,  -4317,   1231,   -192 },
+	{    -51,    778,  -3925,  23784,  15487,  -4344,   1231,   -192 },
+	{    -59,    807,  -3982,  23561,  15770,  -4369,   1231,   -191 },
+	{    -67,    836,  -4037,  23336,  16053,  -4393,   1230,   -190 },
+	{    -75,    863,  -4088,  23108,  16335,  -4414,   1228,   -189 },
+	{    -83,    889,  -4136,  22877,  16616,  -4433,   1225,   -187 },
+	{    -91,    915,  -4181,  22643,  16896,  -4450,   1222,   -186 },
+	{    -98,    939,  -4223,  22407,  17175,  -4465,   1217,   -184 },
+	{   -105,    962,  -4261,  22166,  17453,  -4477,   1212,   -182 },
+	{   -111,    984,  -4297,  21923,  17730,  -4487,   1206,   -180 },
+	{   -117,   1005,  -4330,  21679,  18005,  -4495,   1199,   -178 },
+	{   -123,   1026,  -4360,  21429,  18279,  -4500,   1192,   -175 },
+	{   -129,   1045,  -4387,  21179,  18552,  -4503,   1183,   -172 },
+	{   -135,   1063,  -4411,  20927,  18823,  -4503,   1173,   -169 },
+	{   -140,   1080,  -4432,  20670,  19093,  -4501,   1163,   -165 },
+	{   -145,   1096,  -4450,  20413,  19361,  -4496,   1151,   -162 },
+	{   -149,   1111,  -4466,  20153,  19627,  -4489,   1139,   -158 },
+	{   -154,   1126,  -4479,  19891,  19891,  -4479,   1126,   -154 },
+	{   -158,   1139,  -4489,  19627,  20153,  -4466,   1111,   -149 },
+	{   -162,   1151,  -4496,  19361,  20413,  -4450,   1096,   -145 },
+	{   -165,   1163,  -4501,  19093,  20670,  -4432,   1080,   -140 },
+	{   -169,   1173,  -4503,  18823,  20927,  -4411,   1063,   -135 },
+	{   -172,   1183,  -4503,  18552,  21179,  -4387,   1045,   -129 },
+	{   -175,   1192,  -4500,  18279,  21429,  -4360,   1026,   -123 },
+	{   -178,   1199,  -4495,  18005,  21679,  -4330,   1005,   -117 },
+	{   -180,   1206,  -4487,  17730,  21923,  -4297,    984,   -111 },
+	{   -182,   1212,  -4477,  17453,  22166,  -4261,    962,   -105 },
+	{   -184,   1217,  -4465,  17175,  22407,  -4223,    939,    -98 },
+	{   -186,   1222,  -4450,  16896,  22643,  -4181,    915,    -91 },
+	{   -187,   1225,  -4433,  16616,  22877,  -4136,    889,    -83 },
+	{   -189,   1228,  -4414,  16335,  23108,  -4088,    863,    -75 },
+	{   -190,   1230,  -4393,  16053,  23336,  -4037,    836,    -67 },
+	{   -191,   1231,  -4369,  15770,  23561,  -3982,    807,    -59 },
+	{   -192,   1231,  -4344,  15487,  23784,  -3925,    778,    -51 },
+	{   -192,   1231,  -4317,  15203,  24001,  -3864,    748,    -42 },
+	{   -192,   1229,  -4288,  14919,  24217,  -3800,    716,    -33 },
+	{   -193,   1227,  -4256,  14634,  24427,  -3732,    684,    -23 },
+	{   -193,   1225,  -4223,  14349,  24635,  -3662,    650,    -13 },
+	{   -192,   1221,  -4189,  14064,  24839,  -3588,    616,     -3 },
+	{   -192,   1217,  -4152,  13779,  25039,  -3510,    580,      7 },
+	{   -191,   1212,  -4114,  13494,  25237,  -3430,    543,     17 },
+	{   -191,   1207,  -4074,  13209,  25429,  -3346,    506,     28 },
+	{   -190,   1201,  -4032,  12924,  25618,  -3259,    467,     39 },
+	{   -189,   1194,  -3989,  12639,  25802,  -3168,    428,     51 },
+	{   -188,   1187,  -3945,  12355,  25983,  -3074,    387,     63 },
+	{   -187,   1179,  -3899,  12071,  26160,  -2976,    345,     75 },
+	{   -185,   1171,  -3851,  11787,  26331,  -2875,    303,     87 },
+	{   -184,   1162,  -3803,  11504,  26502,  -2771,    259,     99 },
+	{   -182,   1152,  -3753,  11222,  26665,  -2663,    215,    112 },
+	{   -180,   1142,  -3701,  10941,  26824,  -2552,    169,    125 },
+	{   -178,   1132,  -3649,  10660,  26979,  -2437,    123,    138 },
+	{   -176,   1121,  -3595,  10381,  27129,  -2319,     75,    152 },
+	{   -174,   1109,  -3541,  10102,  27276,  -2197,     27,    166 },
+	{   -172,   1097,  -3485,   9824,  27418,  -2072,    -22,    180 },
+	{   -170,   1085,  -3428,   9548,  27554,  -1943,    -72,    194 },
+	{   -167,   1072,  -3370,   9273,  27685,  -1811,   -123,    209 },
+	{   -165,   1059,  -3312,   8999,  27815,  -1676,   -175,    223 },
+	{   -162,   1045,  -3252,   8727,  27936,  -1537,   -227,    238 },
+	{   -160,   1031,  -3192,   8456,  28055,  -1395,   -281,    254 },
+	{   -157,   1017,  -3131,   8187,  28167,  -1249,   -335,    269 },
+	{   -155,   1002,  -3069,   7919,  28276,  -1100,   -390,    285 },
+	{   -152,    987,  -3007,   7653,  28379,   -947,   -446,    301 },
+	{   -149,    972,  -2944,   7388,  28478,   -791,   -503,    317 },
+	{   -146,    957,  -2880,   7126,  28570,   -632,   -560,    333 },
+	{   -143,    941,  -2816,   6865,  28659,   -469,   -618,    349 },
+	{   -140,    925,  -2751,   6607,  28741,   -303,   -677,    366 },
+	{   -137,    908,  -2686,   6350,  28821,   -134,   -736,    382 },
+	{   -134,    892,  -2621,   6096,  28893,     39,   -796,    399 },
+	{   -131,    875,  -2555,   5844,  28961,    215,   -857,    416 },
+	{   -128,    858,  -2489,   5593,  29025,    394,   -918,    433 },
+	{   -125,    841,  -2423,   5346,  29082,    576,   -980,    451 },
+	{   -122,    824,  -2356,   5100,  29134,    762,  -1042,    468 },
+	{   -119,    806,  -2289,   4857,  29182,    950,  -1105,    486 },
+	{   -116,    789,  -2223,   4617,  29224,   1142,  -1168,    503 },
+	{   -112,    771,  -2156,   4378,  29261,   1337,  -1232,    521 },
+	{   -109,    754,  -2089,   4143,  29291,   1535,  -1296,    539 },
+	{   -106,    736,  -2022,   3910,  29318,   1736,  -1360,    556 },
+	{   -103,    718,  -1955,   3680,  29339,   1940,  -1425,    574 },
+	{   -100,    700,  -1888,   3452,  29355,   2148,  -1491,    592 },
+	{    -97,    682,  -1821,   3227,  29365,   2358,  -1556,    610 },
+	{    -94,    664,  -1754,   3005,  29371,   2570,  -1622,    628 }
+};
+
+//Input rate above the output rate, up to 48 kHz. Cutoff just under the
+//Nyquist of 44.1 kHz output from 48 kHz input
+static const int16_t saDownTable[SRC_PHASES][SRC_TAPS] =
+{
+	{    795,  -2419,   4334,  27348,   4334,  -2419,    795,      0 },
+	{    786,  -2372,   4140,  27420,   4553,  -2478,    807,    -88 },
+	{    776,  -2318,   3936,  27414,   4763,  -2531,    817,    -89 },
+	{    765,  -2265,   3735,  27404,   4975,  -2583,    827,    -90 },
+	{    754,  -2211,   3536,  27391,   5189,  -2636,    837,    -92 },
+	{    742,  -2157,   3339,  27374,   5404,  -2687,    846,    -93 },
+	{    731,  -2102,   3145,  27349,   5622,  -2738,    855,    -94 },
+	{    719,  -2048,   2952,  27323,   5842,  -2789,    864,    -95 },
+	{    707,  -1994,   2762,  27293,   6063,  -2839,    872,    -96 },
+	{    695,  -1939,   2574,  27258,   6286,  -2889,    880,    -97 },
+	{    683,  -1885,   2389,  27219,   6510,  -2938,    888,    -98 },
+	{    671,  -1830,   2206,  27173,   6737,  -2986,    895,    -98 },
+	{    658,  -1775,   2025,  27126,   6965,  -3034,    902,    -99 },
+	{    646,  -1721,   1847,  27073,   7194,  -3080,    909,   -100 },
+	{    633,  -1667,   1672,  27017,   7425,  -3127,    915,   -100 },
+	{    621,  -1612,   1498,  26955,   7657,  -3172,    921,   -100 },
+	{    608,  -1558,   1328,  26891,   7891,  -3217,    926,   -101 },
+	{    595,  -1504,   1160,  26821,   8126,  -3260,    931,   -101 },
+	{    582,  -1451,    994,  26749,   8362,  -3303,    936,   -101 },
+	{    569,  -1397,    831,  26671,   8600,  -3345,    940,   -101 },
+	{    557,  -1344,    671,  26589,   8838,  -3386,    944,   -101 },
+	{    544,  -1291,    513,  26503,   9078,  -3426,    947,   -100 },
+	{    531,  -1238,    358,  26413,   9319,  -3465,    950,   -100 },
+	{    518,  -1185,    206,  26318,   9560,  -3502,    952,    -99 },
+	{    505,  -1133,     56,  26222,   9803,  -3539,    953,    -99 },
+	{    492,  -1081,    -91,  26120,  10046,  -3575,    955,    -98 },
+	{    479,  -1030,   -235,  26015,  10290,  -3609,    955,    -97 },
+	{    466,   -979,   -376,  25905,  10535,  -3642,    955,    -96 },
+	{    453,   -928,   -515,  25791,  10781,  -3674,    955,    -95 },
+	{    440,   -878,   -651,  25673,  11027,  -3704,    954,    -93 },
+	{    427,   -828,   -784,  25552,  11274,  -3733,    952,    -92 },
+	{    415,   -779,   -915,  25427,  11521,  -3761,    950,    -90 },
+	{    402,   -730,  -1042,  25297,  11769,  -3787,    947,    -88 },
+	{    389,   -682,  -1167,  25166,  12017,  -3812,    944,    -87 },
+	{    377,   -634,  -1289,  25029,  12265,  -3836,    940,    -84 },
+	{    364,   -587,  -1409,  24891,  12513,  -3857,    935,    -82 },
+	{    352,   -540,  -1525,  24747,  12762,  -3878,    930,    -80 },
+	{    340,   -494,  -1639,  24599,  13011,  -3896,    924,    -77 },
+	{    328,   -449,  -1749,  24449,  13259,  -3913,    917,    -74 },
+	{    316,   -404,  -1857,  24294,  13508,  -3928,    910,    -71 },
+	{    304,   -360,  -1963,  24139,  13756,  -3942,    902,    -68 },
+	{    292,   -316,  -2065,  23979,  14004,  -3954,    893,    -65 },
+	{    280,   -273,  -2165,  23815,  14252,  -3964,    884,    -61 },
+	{    269,   -231,  -2261,  23647,  14500,  -3972,    874,    -58 },
+	{    257,   -189,  -2355,  23477,  14747,  -3978,    863,    -54 },
+	{    246,   -148,  -2447,  23304,  14993,  -3982,    852,    -50 },
+	{    235,   -108,  -2535,  23128,  15239,  -3985,    840,    -46 },
+	{    224,    -68,  -2620,  22946,  15485,  -3985,    827,    -41 },
+	{    213,    -29,  -2703,  22766,  15729,  -3984,    813,    -37 },
+	{    202,      9,  -2783,  22580,  15973,  -3980,    799,    -32 },
+	{    192,     46,  -2861,  22393,  16216,  -3975,    784,    -27 },
+	{    181,     83,  -2935,  22201,  16459,  -3967,    768,    -22 },
+	{    171,    119,  -3007,  22007,  16700,  -3957,    751,    -16 },
+	{    161,    154,  -3076,  21811,  16940,  -3945,    734,    -11 },
+	{    151,    189,  -3142,  21611,  17179,  -3931,    716,     -5 },
+	{    142,    223,  -3206,  21409,  17416,  -3914,    697,      1 },
+	{    132,    256,  -3267,  21206,  17653,  -3896,    677,      7 },
+	{    123,    288,  -3326,  21000,  17888,  -3875,    657,     13 },
+	{    114,    319,  -3381,  20789,  18122,  -3851,    636,     20 },
+	{    105,    350,  -3434,  20579,  18354,  -3826,    613,     27 },
+	{     96,    380,  -3485,  20364,  18585,  -3797,    591,     34 },
+	{     88,    409,  -3533,  20149,  18814,  -3767,    567,     41 },
+	{     80,    437,  -3578,  19931,  19041,  -3734,    543,     48 },
+	{     71,    465,  -3621,  19712,  19266,  -3699,    518,     56 },
+	{     63,    492,  -3661,  19490,  19490,  -3661,    492,     63 },
+	{     56,    518,  -3699,  19266,  19712,  -3621,    465,     71 },
+	{     48,    543,  -3734,  19041,  19931,  -3578,    437,     80 },
+	{     41,    567,  -3767,  18814,  20149,  -3533,    409,     88 },
+	{     34,    591,  -3797,  18585,  20364,  -3485,    380,     96 },
+	{     27,    613,  -3826,  18354,  20579,  -3434,    350,    105 },
+	{     20,    636,  -3851,  18122,  20789,  -3381,    319,    114 },
+	{     13,    657,  -3875,  17888,  21000,  -3326,    288,    123 },
+	{      7,    677,  -3896,  17653,  21206,  -3267,    256,    132 },
+	{      1,    697,  -3914,  17416,  21409,  -3206,    223,    142 },
+	{     -5,    716,  -3931,  17179,  21611,  -3142,    189,    151 },
+	{    -11,    734,  -3945,  16940,  21811,  -3076,    154,    161 },
+	{    -16,    751,  -3957,  16700,  22007,  -3007,    119,    171 },
+	{    -22,    768,  -3967,  16459,  22201,  -2935,     83,    181 },
+	{    -27,    784,  -3975,  16216,  22393,  -2861,     46,    192 },
+	{    -32,    799,  -3980,  15973,  22580,  -2783,      9,    202 },
+	{    -37,    813,  -3984,  15729,  22766,  -2703,    -29,    213 },
+	{    -41,    827,  -3985,  15485,  22946,  -2620,    -68,    224 },
+	{    -46,    840,  -3985,  15239,  23128,  -2535,   -108,    235 },
+	{    -50,    852,  -3982,  14993,  23304,  -2447,   -148,    246 },
+	{    -54,    863,  -3978,  14747,  23477,  -2355,   -189,    257 },
+	{    -58,    874,  -3972,  14500,  23647,  -2261,   -231,    269 },
+	{    -61,    884,  -3964,  14252,  23815,  -2165,   -273,    280 },
+	{    -65,    893,  -3954,  14004,  23979,  -2065,   -316,    292 },
+	{    -68,    902,  -3942,  13756,  24139,  -1963,   -360,    304 },
+	{    -71,    910,  -3928,  13508,  24294,  -1857,   -404,    316 },
+	{    -74,    917,  -3913,  13259,  24449,  -1749,   -449,    328 },
+	{    -77,    924,  -3896,  13011,  24599,  -1639,   -494,    340 },
+	{    -80,    930,  -3878,  12762,  24747,  -1525,   -540,    352 },
+	{    -82,    935,  -3857,  12513,  24891,  -1409,   -587,    364 },
+	{    -84,    940,  -3836,  12265,  25029,  -1289,   -634,    377 },
+	{    -87,    944,  -3812,  12017,  25166,  -1167,   -682,    389 },
+	{    -88,    947,  -3787,  11769,  25297,  -1042,   -730,    402 },
+	{    -90,    950,  -3761,  11521,  25427,   -915,   -779,    415 },
+	{    -92,    952,  -3733,  11274,  25552,   -784,   -828,    427 },
+	{    -93,    954,  -3704,  11027,  25673,   -651,   -878,    440 },
+	{    -95,    955,  -3674,  10781,  25791,   -515,   -928,    453 },
+	{    -96,    955,  -3642,  10535,  25905,   -376,   -979,    466 },
+	{    -97,    955,  -3609,  10290,  26015,   -235,  -1030,    479 },
+	{    -98,    955,  -3575,  10046,  26120,    -91,  -1081,    492 },
+	{    -99,    953,  -3539,   9803,  26222,     56,  -1133,    505 },
+	{    -99,    952,  -3502,   9560,  26318,    206,  -1185,    518 },
+	{   -100,    950,  -3465,   9319,  26413,    358,  -1238,    531 },
+	{   -100,    947,  -3426,   9078,  26503,    513,  -1291,    544 },
+	{   -101,    944,  -3386,   8838,  26589,    671,  -1344,    557 },
+	{   -101,    940,  -3345,   8600,  26671,    831,  -1397,    569 },
+	{   -101,    936,  -3303,   8362,  26749,    994,  -1451,    582 },
+	{   -101,    931,  -3260,   8126,  26821,   1160,  -1504,    595 },
+	{   -101,    926,  -3217,   7891,  26891,   1328,  -1558,    608 },
+	{   -100,    921,  -3172,   7657,  26955,   1498,  -1612,    621 },
+	{   -100,    915,  -3127,   7425,  27017,   1672,  -1667,    633 },
+	{   -100,    909,  -3080,   7194,  27073,   1847,  -1721,    646 },
+	{    -99,    902,  -3034,   6965,  27126,   2025,  -1775,    658 },
+	{    -98,    895,  -2986,   6737,  27173,   2206,  -1830,    671 },
+	{    -98,    888,  -2938,   6510,  27219,   2389,  -1885,    683 },
+	{    -97,    880,  -2889,   6286,  27258,   2574,  -1939,    695 },
+	{    -96,    872,  -2839,   6063,  27293,   2762,  -1994,    707 },
+	{    -95,    864,  -2789,   5842,  27323,   2952,  -2048,    719 },
+	{    -94,    855,  -2738,   5622,  27349,   3145,  -2102,    731 },
+	{    -93,    846,  -2687,   5404,  27374,   3339,  -2157,    742 },
+	{    -92,    837,  -2636,   5189,  27391,   3536,  -2211,    754 },
+	{    -90,    827,  -2583,   4975,  27404,   3735,  -2265,    765 },
+	{    -89,    817,  -2531,   4763,  27414,   3936,  -2318,    776 },
+	{    -88,    807,  -2478,   4553,  27420,   4140,  -2372,    786 }
+};
+
+} //namespace SrcTables
+
+#endif /* SRCTABLES_H_ */
@@ -0,0 +1,187 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * StateVariableFilter.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef STATEVARIABLEFILTER_H_
+#define STATEVARIABLEFILTER_H_
+
+#include <stdint.h>
+#include <math.h>
+
+//Fraction bits of the filter coefficients
+#define SVF_COEF_SHIFT (28)
+
+//Extra fraction bits the filter state carries over 16-bit samples
+#define SVF_STATE_SHIFT (8)
+
+/**
+ * Resonant 12 dB/octave filter in fixed point, the trapezoidal form of the
+ * state-variable filter. Unlike the classic Chamberlin form it stays stable
+ * right up to the Nyquist frequency, so the cutoff can be swept anywhere
+ * while a sound plays.
+ *
+ * SetCutoff() does the floating point work and may be called once per
+ * block; Process() is a few multiplies per sample. Header only so the PC
+ * tools can use it.
+ */
+class StateVariableFilter
+{
+public:
+
+	/**
+	 * Which output of the filter Process() returns.
+	 */
+	enum EMode
+	{
+		eeLowPass,
+		eeBandPass,
+		eeHighPass
+	};
+
+	/**
+	 * Constructor. The filter starts disabled.
+	 */
+	StateVariableFilter()
+	{
+		mEnabled = false;
+		mMode = eeLowPass;
+		mA1 = 0;
+		mA2 = 0;
+		mA3 = 0;
+		mK = 0;
+		Reset();
+	}
+
+	/**
+	 * Sets the cutoff and resonance. Filter state is kept, so the cutoff can
+	 * be changed while a sound plays without clicks.
+	 * Args:
+	 *  aCutoffHz - Cutoff frequency, 0 or less to disable the filter
+	 *  aResonance - Q, 0.707 for no peak, higher for a sharper peak at the
+	 *               cutoff. Limited to 0.5 to 20.
+	 *  aSampleRate - Rate of the samples being filtered
+	 *  aMode - Output to use
+	 */
+	void SetCutoff(float aCutoffHz, float aResonance, uint32_t aSampleRate, EMode aMode = eeLowPass)
+	{
+		if(aCutoffHz <= 0.0 || 0 == aSampleRate)
+		{
+			mEnabled = false;
+			return;
+		}
+
+		//Keep clear of Nyquist, where the prewarp goes to infinity
+		float lMaxHz = 0.45 * aSampleRate;
+		float lCutoff = aCutoffHz < lMaxHz ? aCutoffHz : lMaxHz;
+		float lQ = aResonance < 0.5 ? 0.5 : (aResonance > 20.0 ? 20.0 : aResonance);
+
+		float lG = tanf(3.14159265 * lCutoff / aSampleRate);
+		float lK = 1.0 / lQ;
+		float lA1 = 1.0 / (1.0 + lG * (lG + lK));
+		float lA2 = lG * lA1;
+		float lA3 = lG * lA2;
+
+		mA1 = (int32_t)(lA1 * (1 << SVF_COEF_SHIFT));
+		mA2 = (int32_t)(lA2 * (1 << SVF_COEF_SHIFT));
+		mA3 = (int32_t)(lA3 * (1 << SVF_COEF_SHIFT));
+		mK = (int32_t)(lK * (1 << SVF_COEF_SHIFT));
+		mMode = aMode;
+
+		if(!mEnabled)
+		{
+			//Start from silence rather than whatever was left from before
+			Reset();
+			mEnabled = true;
+		}
+	}
+
+	/**
+	 * Disables the filter, Process() passes samples through.
+	 */
+	void Disable()
+	{
+		mEnabled = false;
+	}
+
+	/**
+	 * Returns TRUE if the filter is enabled.
+	 */
+	bool IsEnabled()
+	{
+		return mEnabled;
+	}
+
+	/**
+	 * Clears the filter state.
+	 */
+	void Reset()
+	{
+		mIc1 = 0;
+		mIc2 = 0;
+	}
+
+	/**
+	 * Filters one sample. Call only while IsEnabled().
+	 * Args:
+	 *  aIn - Input sample
+	 * Returns:
+	 *  Filtered sample, may exceed 16 bits near the cutoff with high
+	 *  resonance
+	 */
+	inline int32_t Process(int32_t aIn)
+	{
+		int32_t lV0 = aIn << SVF_STATE_SHIFT;
+		int32_t lV3 = lV0 - mIc2;
+		int32_t lV1 = (int32_t)(((int64_t)mA1 * mIc1 + (int64_t)mA2 * lV3) >> SVF_COEF_SHIFT);
+		int32_t lV2 = mIc2 + (int32_t)(((int64_t)mA2 * mIc1 + (int64_t)mA3 * lV3) >> SVF_COEF_SHIFT);
+
+		mIc1 = 2 * lV1 - mIc1;
+		mIc2 = 2 * lV2 - mIc2;
+
+		int32_t lOut = lV2;
+		if(eeBandPass == mMode)
+		{
+			lOut = lV1;
+		}
+		else if(eeHighPass == mMode)
+		{
+			lOut = lV0 - lV2 - (int32_t)(((int64_t)mK * lV1) >> SVF_COEF_SHIFT);
+		}
+
+		return lOut >> SVF_STATE_SHIFT;
+	}
+
+protected:
+
+	//Coefficients (SVF_COEF_SHIFT fraction bits)
+	int32_t mA1;
+	int32_t mA2;
+	int32_t mA3;
+	int32_t mK;
+
+	//Integrator states (SVF_STATE_SHIFT fraction bits)
+	int32_t mIc1;
+	int32_t mIc2;
+
+	EMode mMode;
+	bool mEnabled;
+};
+
+#endif /* STATEVARIABLEFILTER_H_ */
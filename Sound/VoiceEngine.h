@@ -0,0 +1,396 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * VoiceEngine.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef VOICEENGINE_H_
+#define VOICEENGINE_H_
+
+#include "IAudioSink.h"
+#include "SaberVoice.h"
+#include "ReadAheadScheduler.h"
+#include "MixBus.h"
+#include "SoundTelemetry.h"
+
+//Number of simultaneous voices (hum + effect)
+#if not defined NSABER_MAX_VOICES
+#define NSABER_MAX_VOICES (2)
+#endif
+
+//Number of samples mixed per block
+#if not defined NSABER_MIX_BLOCK_SAMPLES
+#define NSABER_MIX_BLOCK_SAMPLES (64)
+#endif
+
+//Card transfers allowed per call to Service()
+#if not defined NSABER_SERVICE_TRANSFERS
+#define NSABER_SERVICE_TRANSFERS (2)
+#endif
+
+//Delay of a sound queued to follow the end of the current one
+#define VOICE_ENGINE_AT_END (0xFFFFFFFF)
+
+//Time one mix block plays for (microseconds)
+#define VOICE_ENGINE_BLOCK_US ((uint32_t)NSABER_MIX_BLOCK_SAMPLES * 1000000UL / NSABER_OUTPUT_SAMPLE_RATE)
+
+//Sectors read into the standby voice when a sound is preloaded
+#if not defined NSABER_PRELOAD_SECTORS
+#define NSABER_PRELOAD_SECTORS (4)
+#endif
+
+/**
+ * Streams, mixes and outputs NSaber voices. Each voice reads through its own
+ * read-ahead buffer, and a ReadAheadScheduler keeps those buffers full in
+ * the time left over after the output has been fed.
+ *
+ * One extra standby voice can preload a sound that is expected to play
+ * next. PlayPreloaded() then moves it onto a channel without touching the
+ * card, or QueuePreloaded() has it follow the sound on a channel with no
+ * gap, starting on the sample after the current sound ends.
+ * SchedulePreloaded() and StopAfter() start and stop voices a set number
+ * of output samples ahead, for overlaps such as the hum under the end of
+ * the power up sound.
+ *
+ * Attach an engine to a sound manager with SetVoiceEngine() to have it play
+ * sounds through the engine instead of the I2SWavPlayer.
+ */
+class VoiceEngine
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apSink - Destination for mixed audio
+	 */
+	VoiceEngine(IAudioSink* apSink);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~VoiceEngine();
+
+	/**
+	 * Fetch a voice.
+	 * Args:
+	 *  aChannel - Voice index from 0 to NSABER_MAX_VOICES - 1
+	 * Returns:
+	 *  Pointer to the voice, or nullptr if the index is out of range
+	 */
+	SaberVoice* GetVoice(uint8_t aChannel);
+
+	/**
+	 * Starts a sound on a voice, replacing whatever it was playing.
+	 * Args:
+	 *  aChannel - Voice index
+	 *  apPath - Full path of the file on the SD card
+	 *  aLooping - TRUE if the sound should repeat
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool Play(uint8_t aChannel, const char* apPath, bool aLooping);
+
+	/**
+	 * Starts a region of a file on a voice, such as one sound in a packed
+	 * font, replacing whatever it was playing.
+	 * Args:
+	 *  aChannel - Voice index
+	 *  apPath - Full path of the file on the SD card
+	 *  arInfo - Format of the data and location of the region in the file
+	 *  aLooping - TRUE if the sound should repeat
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool PlayRegion(uint8_t aChannel, const char* apPath, const WavHeader::tWavInfo& arInfo, bool aLooping);
+
+	/**
+	 * Opens a sound on the standby voice and reads its first sectors, so it
+	 * can later start without waiting on the card. Replaces any sound that
+	 * was preloaded before.
+	 * Args:
+	 *  apPath - Full path of the file on the SD card
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool Preload(const char* apPath);
+
+	/**
+	 * Opens a region of a file on the standby voice and reads its first
+	 * sectors. Replaces any sound that was preloaded before.
+	 * Args:
+	 *  apPath - Full path of the file on the SD card
+	 *  arInfo - Format of the data and location of the region in the file
+	 * Returns:
+	 *  TRUE if successful, FALSE otherwise
+	 */
+	bool PreloadRegion(const char* apPath, const WavHeader::tWavInfo& arInfo);
+
+	/**
+	 * Opens a file on every idle voice, including the standby voice,
+	 * without playing anything. Voices that are playing keep their file,
+	 * and open the new one when they next start a sound. See
+	 * ReadAheadStream::OpenFile().
+	 * Args:
+	 *  apPath - Full path of the file on the SD card
+	 * Returns:
+	 *  TRUE if every idle voice opened the file, FALSE otherwise
+	 */
+	bool OpenFileOnAllVoices(const char* apPath);
+
+	/**
+	 * Starts the preloaded sound on a voice, replacing whatever it was
+	 * playing. The replaced voice becomes the standby voice.
+	 * Args:
+	 *  aChannel - Voice index
+	 *  aLooping - TRUE if the sound should repeat
+	 * Returns:
+	 *  TRUE if successful, FALSE if nothing is preloaded
+	 */
+	bool PlayPreloaded(uint8_t aChannel, bool aLooping);
+
+	/**
+	 * Starts the preloaded sound on a voice as soon as the sound the voice
+	 * is playing ends, mid-block if need be. The sound stays preloaded (and
+	 * IsQueued() stays TRUE) until then.
+	 * Args:
+	 *  aChannel - Voice index
+	 *  aLooping - TRUE if the queued sound should repeat
+	 * Returns:
+	 *  TRUE if successful, FALSE if nothing is preloaded
+	 */
+	bool QueuePreloaded(uint8_t aChannel, bool aLooping);
+
+	/**
+	 * Starts the preloaded sound on a voice a set number of output samples
+	 * from now, mid-block if need be. Whatever the voice was playing is cut
+	 * off at that sample. The sound stays preloaded (and IsQueued() stays
+	 * TRUE) until then.
+	 * Args:
+	 *  aChannel - Voice index
+	 *  aLooping - TRUE if the queued sound should repeat
+	 *  aDelaySamples - Output samples to wait, or VOICE_ENGINE_AT_END to
+	 *                  wait for the voice's sound to end
+	 * Returns:
+	 *  TRUE if successful, FALSE if nothing is preloaded
+	 */
+	bool SchedulePreloaded(uint8_t aChannel, bool aLooping, uint32_t aDelaySamples);
+
+	/**
+	 * Stops a voice a set number of output samples from now. Starting
+	 * another sound on the voice cancels the stop. Only one stop can be
+	 * pending, a new one replaces the last.
+	 * Args:
+	 *  aChannel - Voice index
+	 *  aDelaySamples - Output samples to wait
+	 */
+	void StopAfter(uint8_t aChannel, uint32_t aDelaySamples);
+
+	/**
+	 * Returns TRUE if a sound is preloaded and ready to play.
+	 */
+	bool IsPreloaded();
+
+	/**
+	 * Returns TRUE if the preloaded sound is queued to follow a voice.
+	 */
+	bool IsQueued();
+
+	/**
+	 * Discards the preloaded sound, and cancels it if it was queued.
+	 */
+	void CancelPreload();
+
+	/**
+	 * Returns the lowest buffer fill level, from 0 to 100, of the voices
+	 * that are still reading from the card. 100 if none are.
+	 */
+	uint8_t GetLowestLevel();
+
+	/**
+	 * Restarts the sound on a voice from the beginning.
+	 * Args:
+	 *  aChannel - Voice index
+	 */
+	void Restart(uint8_t aChannel);
+
+	/**
+	 * Stops a voice and closes its file.
+	 * Args:
+	 *  aChannel - Voice index
+	 */
+	void Stop(uint8_t aChannel);
+
+	/**
+	 * Stops all voices.
+	 */
+	void StopAll();
+
+	/**
+	 * Call this in a loop. Feeds the output from the read-ahead buffers, then
+	 * uses the remaining time to refill the buffers from the card.
+	 * Returns:
+	 *  TRUE if no voice is playing, FALSE otherwise
+	 */
+	bool Service();
+
+	/**
+	 * Sets the volume applied to the final mix.
+	 * Args:
+	 *  aVolume - Volume from 0.0 (mute) to 1.0 (full volume)
+	 */
+	void SetMasterVolume(float aVolume);
+
+	/**
+	 * Allows or stops use of the polyphase filter on voices playing files
+	 * that aren't at the output rate. See SaberVoice::SetPolyphaseEnabled().
+	 */
+	void SetPolyphaseEnabled(bool aEnabled);
+
+	/**
+	 * Allows or bypasses the voices' tone filters. See
+	 * SaberVoice::SetFilterEnabled().
+	 */
+	void SetFiltersEnabled(bool aEnabled);
+
+	/**
+	 * Sets the most voices mixed at once. When more are playing, the lowest
+	 * channels sit out, frozen where they are, until fewer are playing, so
+	 * put the sound that matters least (such as the hum) on the lowest
+	 * channel. Voices waiting on a scheduled start or stop always play.
+	 * Args:
+	 *  aNumVoices - From 1 to NSABER_MAX_VOICES
+	 */
+	void SetVoiceLimit(uint8_t aNumVoices);
+
+	/**
+	 * Returns the number of times a voice has run out of buffered data
+	 * since the engine was created.
+	 */
+	uint32_t GetUnderruns();
+
+	/**
+	 * Estimates how long the audio can go without Service() before it is
+	 * at risk: the output queued in the sink, or the data buffered for the
+	 * voice closest to running out if that is less. Needs a sink that
+	 * reports GetQueuedSamples(); without a sink, only the voices count.
+	 * Returns:
+	 *  Time in microseconds
+	 */
+	uint32_t GetBufferedUs();
+
+	/**
+	 * Returns the stage that limits and outputs the mix.
+	 */
+	MixBus& GetMixBus();
+
+	/**
+	 * Returns the scheduler that refills the voices' buffers. Use it to read
+	 * buffer levels or tune the transfer length.
+	 */
+	ReadAheadScheduler& GetScheduler();
+
+protected:
+
+	/**
+	 * Finishes starting a voice that has just been opened.
+	 * Args:
+	 *  apVoice - Voice to start
+	 *  aLooping - TRUE if the sound should repeat
+	 */
+	void Start(SaberVoice* apVoice, bool aLooping);
+
+	/**
+	 * Reads the first transfer of a voice's data so it has something to
+	 * play on the next block.
+	 * Args:
+	 *  apVoice - Voice to prime
+	 */
+	void Prime(SaberVoice* apVoice);
+
+	/**
+	 * Moves the standby voice onto a channel. The replaced voice becomes
+	 * the standby voice.
+	 * Args:
+	 *  aChannel - Voice index
+	 *  aLooping - TRUE if the sound should repeat
+	 */
+	void ActivateStandby(uint8_t aChannel, bool aLooping);
+
+	/**
+	 * Reads the first sectors of the standby voice.
+	 * Returns:
+	 *  TRUE if the standby voice has data, FALSE otherwise
+	 */
+	bool PrimeStandby();
+
+	/**
+	 * Mixes the next block of output.
+	 */
+	void RenderBlock();
+
+	//Destination for mixed audio
+	IAudioSink* mpSink;
+
+	//Voices, one more than there are channels for the standby voice
+	SaberVoice maVoices[NSABER_MAX_VOICES + 1];
+
+	//Voice playing on each channel
+	SaberVoice* mapChannels[NSABER_MAX_VOICES];
+
+	//Voice not assigned to a channel, used for preloading
+	SaberVoice* mpStandby;
+
+	//TRUE if the standby voice holds a preloaded sound
+	bool mStandbyReady;
+
+	//Channel the standby voice is queued to follow, -1 if not queued
+	int8_t mQueuedChannel;
+
+	//TRUE if the queued sound should repeat
+	bool mQueuedLooping;
+
+	//Output samples until the queued sound starts, or VOICE_ENGINE_AT_END
+	uint32_t mQueuedDelay;
+
+	//Channel with a pending stop, -1 if none
+	int8_t mStopChannel;
+
+	//Output samples until the pending stop
+	uint32_t mStopDelay;
+
+	//Most voices mixed at once
+	uint8_t mVoiceLimit;
+
+	//Underruns of all voices
+	uint32_t mUnderruns;
+
+	//Keeps voice buffers full
+	ReadAheadScheduler mScheduler;
+
+	//Master volume, limiter and conversion to output samples
+	MixBus mMixBus;
+
+	//Accumulator for mixing voices
+	int32_t maMixBuffer[NSABER_MIX_BLOCK_SAMPLES];
+
+	//Final output block
+	int16_t maOutBuffer[NSABER_MIX_BLOCK_SAMPLES];
+};
+
+#endif /* VOICEENGINE_H_ */
@@ -0,0 +1,195 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * WavHeader.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef WAVHEADER_H_
+#define WAVHEADER_H_
+
+#include <SD.h>
+#include "Arduino.h"
+
+#define WAV_FORMAT_PCM       (1)
+#define WAV_FORMAT_IMA_ADPCM (0x11)
+
+//Sizes of the fixed part of a "smpl" chunk and of one loop record in it
+#define WAV_SMPL_HEADER_SIZE (36)
+#define WAV_SMPL_LOOP_SIZE   (24)
+
+namespace WavHeader
+{
+
+/**
+ * Container for the properties of a WAV file that the streaming
+ * code cares about.
+ */
+struct tWavInfo
+{
+	//Format tag from the "fmt " chunk (WAV_FORMAT_*)
+	uint16_t mFormat = 0;
+	//Number of interleaved channels
+	uint16_t mNumChannels = 0;
+	//Sample frames per second
+	uint32_t mSampleRate = 0;
+	//Bytes per second of audio data
+	uint32_t mByteRate = 0;
+	//Size of one sample frame (all channels) in bytes
+	uint16_t mBlockAlign = 0;
+	//Bits in one sample of one channel
+	uint16_t mBitsPerSample = 0;
+	//File offset of the first byte of sample data
+	uint32_t mDataStart = 0;
+	//Length of the sample data in bytes
+	uint32_t mDataLength = 0;
+	//Start of the loop in bytes from the first byte of sample data
+	uint32_t mLoopStart = 0;
+	//End of the loop in bytes from the first byte of sample data,
+	//0 to loop the whole data
+	uint32_t mLoopEnd = 0;
+};
+
+/**
+ * Reads a little-endian 16-bit value from a byte buffer.
+ */
+inline uint16_t Read16(const uint8_t* apBytes)
+{
+	return (uint16_t)apBytes[0] | ((uint16_t)apBytes[1] << 8);
+}
+
+/**
+ * Reads a little-endian 32-bit value from a byte buffer.
+ */
+inline uint32_t Read32(const uint8_t* apBytes)
+{
+	return (uint32_t)Read16(apBytes) | ((uint32_t)Read16(apBytes + 2) << 16);
+}
+
+/**
+ * Sets the loop region of a sound from the sample frame numbers found in a
+ * "smpl" chunk. Regions outside the data are ignored, as are regions of
+ * ADPCM sounds, which can only loop on whole blocks.
+ * Args:
+ *  arInfo - Sound to update, format and data length must be set
+ *  aStartFrame - First frame of the loop
+ *  aEndFrame - Frame just past the end of the loop
+ */
+inline void SetLoopFrames(tWavInfo& arInfo, uint32_t aStartFrame, uint32_t aEndFrame)
+{
+	if(WAV_FORMAT_PCM != arInfo.mFormat || 0 == arInfo.mBlockAlign)
+	{
+		return;
+	}
+
+	uint32_t lNumFrames = arInfo.mDataLength / arInfo.mBlockAlign;
+	if(aStartFrame < aEndFrame && aEndFrame <= lNumFrames)
+	{
+		arInfo.mLoopStart = aStartFrame * arInfo.mBlockAlign;
+		arInfo.mLoopEnd = aEndFrame * arInfo.mBlockAlign;
+	}
+}
+
+/**
+ * Walks the RIFF chunks of an open WAV file and fills in a tWavInfo.
+ * The first loop of a "smpl" chunk, if there is one, becomes the loop
+ * region. Unknown chunks are skipped. The file position is left undefined.
+ * Args:
+ *  arFile - Open file to parse
+ *  arInfo - Output parameter, populated with the file properties
+ * Returns:
+ *  TRUE if both a "fmt " and a "data" chunk were found, FALSE otherwise
+ */
+inline bool Parse(File& arFile, tWavInfo& arInfo)
+{
+	uint8_t laHeader[16];
+	bool lFoundFmt = false;
+	bool lFoundData = false;
+	bool lFoundLoop = false;
+	uint32_t lLoopStartFrame = 0;
+	uint32_t lLoopEndFrame = 0;
+
+	if(!arFile.seek(0) || 12 != arFile.read(laHeader, 12))
+	{
+		return false;
+	}
+
+	if(0 != memcmp(laHeader, "RIFF", 4) || 0 != memcmp(laHeader + 8, "WAVE", 4))
+	{
+		return false;
+	}
+
+	uint32_t lChunkPos = 12;
+	uint32_t lFileSize = arFile.size();
+
+	while(lChunkPos + 8 <= lFileSize)
+	{
+		if(!arFile.seek(lChunkPos) || 8 != arFile.read(laHeader, 8))
+		{
+			break;
+		}
+
+		uint32_t lChunkSize = Read32(laHeader + 4);
+
+		if(0 == memcmp(laHeader, "fmt ", 4) && lChunkSize >= 16)
+		{
+			if(16 != arFile.read(laHeader, 16))
+			{
+				break;
+			}
+
+			arInfo.mFormat = Read16(laHeader);
+			arInfo.mNumChannels = Read16(laHeader + 2);
+			arInfo.mSampleRate = Read32(laHeader + 4);
+			arInfo.mByteRate = Read32(laHeader + 8);
+			arInfo.mBlockAlign = Read16(laHeader + 12);
+			arInfo.mBitsPerSample = Read16(laHeader + 14);
+			lFoundFmt = true;
+		}
+		else if(0 == memcmp(laHeader, "data", 4))
+		{
+			arInfo.mDataStart = lChunkPos + 8;
+			arInfo.mDataLength = min(lChunkSize, lFileSize - arInfo.mDataStart);
+			lFoundData = true;
+		}
+		else if(0 == memcmp(laHeader, "smpl", 4) && lChunkSize >= WAV_SMPL_HEADER_SIZE + WAV_SMPL_LOOP_SIZE)
+		{
+			uint8_t laSmpl[WAV_SMPL_HEADER_SIZE + WAV_SMPL_LOOP_SIZE];
+			if(sizeof(laSmpl) == arFile.read(laSmpl, sizeof(laSmpl)) && Read32(laSmpl + 28) > 0)
+			{
+				//Loop end is the last frame played, inclusive
+				lLoopStartFrame = Read32(laSmpl + WAV_SMPL_HEADER_SIZE + 8);
+				lLoopEndFrame = Read32(laSmpl + WAV_SMPL_HEADER_SIZE + 12) + 1;
+				lFoundLoop = true;
+			}
+		}
+
+		//Chunks are padded to an even number of bytes
+		lChunkPos += 8 + lChunkSize + (lChunkSize & 1);
+	}
+
+	if(lFoundFmt && lFoundData && lFoundLoop)
+	{
+		SetLoopFrames(arInfo, lLoopStartFrame, lLoopEndFrame);
+	}
+
+	return lFoundFmt && lFoundData;
+}
+
+};
+
+#endif /* WAVHEADER_H_ */
@@ -0,0 +1,237 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * SoundTelemetry.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Sound/SoundTelemetry.h"
+
+#if NSABER_TELEMETRY
+
+//Statistics collected so far
+static tSoundTelemetry sTelemetry;
+
+//Trigger waiting for its first output sample, per voice
+static bool saPending[TELEMETRY_MAX_VOICES];
+static uint32_t saTriggerUs[TELEMETRY_MAX_VOICES];
+static SoundTypes::ESoundTypes saTriggerType[TELEMETRY_MAX_VOICES];
+
+//Motion waiting for its sound to be triggered
+static bool sMotionPending;
+static uint32_t sMotionSampleUs;
+static uint32_t sMotionIntervalUs;
+static uint32_t sMotionDetectUs;
+
+//Trace carried by each voice's pending trigger, if it came from a motion
+static bool saTraced[TELEMETRY_MAX_VOICES];
+static uint32_t saTraceUs[TELEMETRY_MAX_VOICES][eeMaxLatencyStages];
+
+//Completed traces, oldest overwritten first
+static uint32_t saTraces[TELEMETRY_LATENCY_TRACES][eeMaxLatencyStages];
+static uint32_t sNumTraces;
+
+//Names of the stages for PrintLatencyReport()
+static const char* const sapStageNames[eeMaxLatencyStages] =
+{
+	"Sample  ",
+	"Detect  ",
+	"Dispatch",
+	"Start   ",
+	"Output  ",
+	"Total   "
+};
+
+/**
+ * Gets a percentile of sorted values, by nearest rank.
+ */
+static uint32_t Percentile(const uint32_t* apSorted, uint16_t aCount, uint8_t aPercent)
+{
+	uint16_t lRank = ((uint32_t)aCount * aPercent + 99) / 100;
+	return apSorted[lRank > 0 ? lRank - 1 : 0];
+}
+
+void SoundTelemetry::NoteTrigger(uint8_t aChannel, SoundTypes::ESoundTypes aSoundType)
+{
+	if(aChannel < TELEMETRY_MAX_VOICES && aSoundType < SoundTypes::eeMaxSoundTypes)
+	{
+		uint32_t lNow = micros();
+
+		saPending[aChannel] = true;
+		saTriggerUs[aChannel] = lNow;
+		saTriggerType[aChannel] = aSoundType;
+		saTraced[aChannel] = false;
+
+		if(sMotionPending
+		   && SoundTypes::eeHumSnd != aSoundType
+		   && lNow - sMotionDetectUs <= TELEMETRY_MOTION_TIMEOUT_US)
+		{
+			saTraced[aChannel] = true;
+			saTraceUs[aChannel][eeLatencySample] = sMotionIntervalUs;
+			saTraceUs[aChannel][eeLatencyDetect] = sMotionDetectUs - sMotionSampleUs;
+			saTraceUs[aChannel][eeLatencyDispatch] = lNow - sMotionDetectUs;
+		}
+
+		if(SoundTypes::eeHumSnd != aSoundType)
+		{
+			sMotionPending = false;
+		}
+	}
+}
+
+void SoundTelemetry::NoteMotion(uint32_t aSampleUs, uint32_t aIntervalUs)
+{
+	sMotionPending = true;
+	sMotionSampleUs = aSampleUs;
+	sMotionIntervalUs = aIntervalUs;
+	sMotionDetectUs = micros();
+}
+
+void SoundTelemetry::NoteOutput(uint8_t aChannel, uint32_t aQueuedUs)
+{
+	if(aChannel < TELEMETRY_MAX_VOICES && saPending[aChannel])
+	{
+		saPending[aChannel] = false;
+
+		uint32_t lLatency = micros() - saTriggerUs[aChannel] + aQueuedUs;
+		SoundTypes::ESoundTypes lType = saTriggerType[aChannel];
+
+		sTelemetry.maLastLatencyUs[lType] = lLatency;
+		sTelemetry.maMaxLatencyUs[lType] = max(sTelemetry.maMaxLatencyUs[lType], lLatency);
+
+		if(saTraced[aChannel])
+		{
+			uint32_t* lpTrace = saTraces[sNumTraces % TELEMETRY_LATENCY_TRACES];
+			saTraced[aChannel] = false;
+			sNumTraces++;
+
+			memcpy(lpTrace, saTraceUs[aChannel], sizeof(saTraceUs[aChannel]));
+			lpTrace[eeLatencyStart] = lLatency - aQueuedUs;
+			lpTrace[eeLatencyOutput] = aQueuedUs;
+			lpTrace[eeLatencyTotal] = lpTrace[eeLatencySample] + lpTrace[eeLatencyDetect]
+			                          + lpTrace[eeLatencyDispatch] + lLatency;
+		}
+	}
+}
+
+void SoundTelemetry::NoteUnderrun(uint8_t aChannel)
+{
+	if(aChannel < TELEMETRY_MAX_VOICES)
+	{
+		sTelemetry.maUnderruns[aChannel]++;
+	}
+}
+
+void SoundTelemetry::NoteContinuePlay(uint32_t aStartUs)
+{
+	sTelemetry.mMaxContinuePlayUs = max(sTelemetry.mMaxContinuePlayUs, (uint32_t)(micros() - aStartUs));
+}
+
+void SoundTelemetry::NoteSdRead(uint32_t aStartUs, uint32_t aNumBytes)
+{
+	uint32_t lElapsed = micros() - aStartUs;
+
+	sTelemetry.mSdReads++;
+	sTelemetry.mSdBytes += aNumBytes;
+	sTelemetry.mTotalSdReadUs += lElapsed;
+	sTelemetry.mMaxSdReadUs = max(sTelemetry.mMaxSdReadUs, lElapsed);
+}
+
+void SoundTelemetry::Get(tSoundTelemetry& arOut)
+{
+	arOut = sTelemetry;
+}
+
+void SoundTelemetry::GetLatencyReport(tLatencyReport& arOut)
+{
+	arOut = tLatencyReport();
+	arOut.mTraces = sNumTraces;
+	arOut.mWindow = min(sNumTraces, (uint32_t)TELEMETRY_LATENCY_TRACES);
+
+	uint32_t laSorted[TELEMETRY_LATENCY_TRACES];
+
+	for(int lStage = 0; lStage < eeMaxLatencyStages && arOut.mWindow > 0; lStage++)
+	{
+		//Insertion sort, the window is small
+		for(uint16_t lIdx = 0; lIdx < arOut.mWindow; lIdx++)
+		{
+			uint32_t lValue = saTraces[lIdx][lStage];
+			int lPos = lIdx;
+			while(lPos > 0 && laSorted[lPos - 1] > lValue)
+			{
+				laSorted[lPos] = laSorted[lPos - 1];
+				lPos--;
+			}
+			laSorted[lPos] = lValue;
+		}
+
+		tLatencyPercentiles& lOut = arOut.maStages[lStage];
+		lOut.mP50Us = Percentile(laSorted, arOut.mWindow, 50);
+		lOut.mP90Us = Percentile(laSorted, arOut.mWindow, 90);
+		lOut.mP99Us = Percentile(laSorted, arOut.mWindow, 99);
+		lOut.mMaxUs = laSorted[arOut.mWindow - 1];
+	}
+}
+
+void SoundTelemetry::PrintLatencyReport(Print& arOut)
+{
+	tLatencyReport lReport;
+	GetLatencyReport(lReport);
+
+	arOut.print("Motion to sound latency (us), last ");
+	arOut.print(lReport.mWindow);
+	arOut.print(" of ");
+	arOut.print(lReport.mTraces);
+	arOut.println(" traces:");
+	arOut.println("  Stage        p50     p90     p99     max");
+
+	for(int lStage = 0; lStage < eeMaxLatencyStages; lStage++)
+	{
+		const tLatencyPercentiles& lStats = lReport.maStages[lStage];
+		uint32_t laValues[4] = { lStats.mP50Us, lStats.mP90Us, lStats.mP99Us, lStats.mMaxUs };
+
+		arOut.print("  ");
+		arOut.print(sapStageNames[lStage]);
+		for(int lIdx = 0; lIdx < 4; lIdx++)
+		{
+			//Right align in 8 columns
+			for(uint32_t lLimit = 1000000; lLimit > 1; lLimit /= 10)
+			{
+				arOut.print(laValues[lIdx] < lLimit ? " " : "");
+			}
+			arOut.print(" ");
+			arOut.print(laValues[lIdx]);
+		}
+		arOut.println();
+	}
+}
+
+void SoundTelemetry::Reset()
+{
+	sTelemetry = tSoundTelemetry();
+
+	for(int lIdx = 0; lIdx < TELEMETRY_MAX_VOICES; lIdx++)
+	{
+		saPending[lIdx] = false;
+		saTraced[lIdx] = false;
+	}
+
+	sMotionPending = false;
+	sNumTraces = 0;
+}
+
+#endif
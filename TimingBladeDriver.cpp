@@ -0,0 +1,85 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * TimingBladeDriver.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Blade/TimingBladeDriver.h"
+
+TimingBladeDriver::TimingBladeDriver(uint16_t aNumPixels, uint16_t aUsPerPixel)
+{
+	mNumPixels = min(aNumPixels, (uint16_t)NSABER_MAX_BLADE_PIXELS);
+	mUsPerPixel = aUsPerPixel;
+	mLastShowUs = 0;
+	mBusyUntilUs = 0;
+
+	memset(maFrame, 0, sizeof(maFrame));
+}
+
+uint16_t TimingBladeDriver::GetNumPixels()
+{
+	return mNumPixels;
+}
+
+bool TimingBladeDriver::IsReady()
+{
+	return (int32_t)(micros() - mBusyUntilUs) >= 0;
+}
+
+void TimingBladeDriver::Show(const tBladePixel* apPixels, uint16_t aNumPixels)
+{
+	uint32_t lNow = micros();
+	uint16_t lNumPixels = min(aNumPixels, mNumPixels);
+
+	if(mTiming.mFrames > 0)
+	{
+		uint32_t lInterval = lNow - mLastShowUs;
+		mTiming.mTotalIntervalUs += lInterval;
+
+		if(lInterval < mTiming.mMinIntervalUs)
+		{
+			mTiming.mMinIntervalUs = lInterval;
+		}
+
+		if(lInterval > mTiming.mMaxIntervalUs)
+		{
+			mTiming.mMaxIntervalUs = lInterval;
+		}
+	}
+
+	mTiming.mFrames++;
+	mLastShowUs = lNow;
+	mBusyUntilUs = lNow + (uint32_t)lNumPixels * mUsPerPixel;
+
+	memcpy(maFrame, apPixels, lNumPixels * sizeof(tBladePixel));
+}
+
+const tBladePixel* TimingBladeDriver::GetFrame()
+{
+	return maFrame;
+}
+
+void TimingBladeDriver::GetTiming(tBladeTiming& arTiming)
+{
+	arTiming = mTiming;
+}
+
+void TimingBladeDriver::ResetTiming()
+{
+	mTiming = tBladeTiming();
+}
@@ -0,0 +1,456 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * VoiceEngine.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "Sound/VoiceEngine.h"
+
+VoiceEngine::VoiceEngine(IAudioSink* apSink)
+{
+	mpSink = apSink;
+
+	//The standby voice is only refilled once it is moved onto a channel
+	for(int lIdx = 0; lIdx < NSABER_MAX_VOICES; lIdx++)
+	{
+		mapChannels[lIdx] = &maVoices[lIdx];
+		mScheduler.Add(mapChannels[lIdx]->GetStream());
+	}
+
+	mpStandby = &maVoices[NSABER_MAX_VOICES];
+	mStandbyReady = false;
+	mQueuedChannel = -1;
+	mQueuedLooping = false;
+	mQueuedDelay = VOICE_ENGINE_AT_END;
+	mStopChannel = -1;
+	mStopDelay = 0;
+	mVoiceLimit = NSABER_MAX_VOICES;
+	mUnderruns = 0;
+}
+
+VoiceEngine::~VoiceEngine()
+{
+	StopAll();
+}
+
+SaberVoice* VoiceEngine::GetVoice(uint8_t aChannel)
+{
+	if(aChannel >= NSABER_MAX_VOICES)
+	{
+		return nullptr;
+	}
+
+	return mapChannels[aChannel];
+}
+
+bool VoiceEngine::Play(uint8_t aChannel, const char* apPath, bool aLooping)
+{
+	SaberVoice* lpVoice = GetVoice(aChannel);
+	if(nullptr == lpVoice)
+	{
+		return false;
+	}
+
+	if(!lpVoice->Open(apPath))
+	{
+		return false;
+	}
+
+	Start(lpVoice, aLooping);
+
+	return true;
+}
+
+bool VoiceEngine::PlayRegion(uint8_t aChannel, const char* apPath, const WavHeader::tWavInfo& arInfo, bool aLooping)
+{
+	SaberVoice* lpVoice = GetVoice(aChannel);
+	if(nullptr == lpVoice)
+	{
+		return false;
+	}
+
+	if(!lpVoice->OpenRegion(apPath, arInfo))
+	{
+		return false;
+	}
+
+	Start(lpVoice, aLooping);
+
+	return true;
+}
+
+bool VoiceEngine::Preload(const char* apPath)
+{
+	mQueuedChannel = -1;
+	mStandbyReady = mpStandby->Open(apPath) && PrimeStandby();
+
+	return mStandbyReady;
+}
+
+bool VoiceEngine::PreloadRegion(const char* apPath, const WavHeader::tWavInfo& arInfo)
+{
+	mQueuedChannel = -1;
+	mStandbyReady = mpStandby->OpenRegion(apPath, arInfo) && PrimeStandby();
+
+	return mStandbyReady;
+}
+
+bool VoiceEngine::OpenFileOnAllVoices(const char* apPath)
+{
+	bool lSuccess = true;
+
+	for(int lIdx = 0; lIdx < NSABER_MAX_VOICES + 1; lIdx++)
+	{
+		//Swapping the file under a playing stream would read the wrong data
+		ReadAheadStream* lpStream = maVoices[lIdx].GetStream();
+		if(!lpStream->IsOpen())
+		{
+			lSuccess = lpStream->OpenFile(apPath) && lSuccess;
+		}
+	}
+
+	return lSuccess;
+}
+
+bool VoiceEngine::PlayPreloaded(uint8_t aChannel, bool aLooping)
+{
+	if(aChannel >= NSABER_MAX_VOICES || !mStandbyReady)
+	{
+		return false;
+	}
+
+	ActivateStandby(aChannel, aLooping);
+
+	return true;
+}
+
+bool VoiceEngine::QueuePreloaded(uint8_t aChannel, bool aLooping)
+{
+	return SchedulePreloaded(aChannel, aLooping, VOICE_ENGINE_AT_END);
+}
+
+bool VoiceEngine::SchedulePreloaded(uint8_t aChannel, bool aLooping, uint32_t aDelaySamples)
+{
+	if(aChannel >= NSABER_MAX_VOICES || !mStandbyReady)
+	{
+		return false;
+	}
+
+	mQueuedChannel = aChannel;
+	mQueuedLooping = aLooping;
+	mQueuedDelay = aDelaySamples;
+
+	return true;
+}
+
+void VoiceEngine::StopAfter(uint8_t aChannel, uint32_t aDelaySamples)
+{
+	if(aChannel < NSABER_MAX_VOICES)
+	{
+		mStopChannel = aChannel;
+		mStopDelay = aDelaySamples;
+	}
+}
+
+bool VoiceEngine::IsPreloaded()
+{
+	return mStandbyReady;
+}
+
+bool VoiceEngine::IsQueued()
+{
+	return mQueuedChannel >= 0;
+}
+
+void VoiceEngine::CancelPreload()
+{
+	mStandbyReady = false;
+	mQueuedChannel = -1;
+}
+
+uint8_t VoiceEngine::GetLowestLevel()
+{
+	uint8_t lLowest = 100;
+
+	for(int lIdx = 0; lIdx < NSABER_MAX_VOICES; lIdx++)
+	{
+		ReadAheadStream* lpStream = mapChannels[lIdx]->GetStream();
+		if(lpStream->IsOpen() && !lpStream->IsFullyRead())
+		{
+			lLowest = min(lLowest, lpStream->GetLevel());
+		}
+	}
+
+	return lLowest;
+}
+
+void VoiceEngine::Restart(uint8_t aChannel)
+{
+	SaberVoice* lpVoice = GetVoice(aChannel);
+	if(nullptr != lpVoice)
+	{
+		lpVoice->SeekStartOfData();
+		Prime(lpVoice);
+	}
+}
+
+void VoiceEngine::Stop(uint8_t aChannel)
+{
+	SaberVoice* lpVoice = GetVoice(aChannel);
+	if(nullptr != lpVoice)
+	{
+		lpVoice->Close();
+	}
+}
+
+void VoiceEngine::StopAll()
+{
+	for(int lIdx = 0; lIdx < NSABER_MAX_VOICES + 1; lIdx++)
+	{
+		maVoices[lIdx].Close();
+	}
+	CancelPreload();
+}
+
+bool VoiceEngine::Service()
+{
+	//Output comes first, it only needs data that is already in RAM
+	while(nullptr != mpSink && mpSink->GetFreeSamples() >= NSABER_MIX_BLOCK_SAMPLES)
+	{
+		//Unless a stream would run dry within the block, as can happen when
+		//the sink has drained further than one transfer lasts. A voice
+		//decodes up to a block ahead of what it renders.
+		if(mScheduler.GetTimeToEmptyUs() < 2 * VOICE_ENGINE_BLOCK_US)
+		{
+			mScheduler.Service(1);
+		}
+
+		RenderBlock();
+		mpSink->WriteSamples(maOutBuffer, NSABER_MIX_BLOCK_SAMPLES);
+	}
+
+	//Then top up whichever buffers are closest to running dry
+	mScheduler.Service(NSABER_SERVICE_TRANSFERS);
+
+	for(int lIdx = 0; lIdx < NSABER_MAX_VOICES; lIdx++)
+	{
+		if(!mapChannels[lIdx]->IsEnded())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void VoiceEngine::SetMasterVolume(float aVolume)
+{
+	mMixBus.SetMasterVolume(aVolume);
+}
+
+void VoiceEngine::SetPolyphaseEnabled(bool aEnabled)
+{
+	for(int lIdx = 0; lIdx < NSABER_MAX_VOICES + 1; lIdx++)
+	{
+		maVoices[lIdx].SetPolyphaseEnabled(aEnabled);
+	}
+}
+
+void VoiceEngine::SetFiltersEnabled(bool aEnabled)
+{
+	for(int lIdx = 0; lIdx < NSABER_MAX_VOICES + 1; lIdx++)
+	{
+		maVoices[lIdx].SetFilterEnabled(aEnabled);
+	}
+}
+
+void VoiceEngine::SetVoiceLimit(uint8_t aNumVoices)
+{
+	mVoiceLimit = constrain(aNumVoices, 1, NSABER_MAX_VOICES);
+}
+
+uint32_t VoiceEngine::GetUnderruns()
+{
+	return mUnderruns;
+}
+
+uint32_t VoiceEngine::GetBufferedUs()
+{
+	uint32_t lBufferedUs = mScheduler.GetTimeToEmptyUs();
+
+	if(nullptr != mpSink)
+	{
+		uint32_t lQueuedUs = (uint32_t)mpSink->GetQueuedSamples() * 1000000UL / NSABER_OUTPUT_SAMPLE_RATE;
+		lBufferedUs = min(lBufferedUs, lQueuedUs);
+	}
+
+	return lBufferedUs;
+}
+
+MixBus& VoiceEngine::GetMixBus()
+{
+	return mMixBus;
+}
+
+ReadAheadScheduler& VoiceEngine::GetScheduler()
+{
+	return mScheduler;
+}
+
+void VoiceEngine::Start(SaberVoice* apVoice, bool aLooping)
+{
+	if(mStopChannel >= 0 && mapChannels[mStopChannel] == apVoice)
+	{
+		mStopChannel = -1;
+	}
+
+	apVoice->SetLooping(aLooping);
+	Prime(apVoice);
+}
+
+void VoiceEngine::Prime(SaberVoice* apVoice)
+{
+	//Fill the buffer right away so the first block has data
+	apVoice->GetStream()->Refill((uint32_t)mScheduler.GetTransferSectors() * READ_AHEAD_SECTOR_SIZE);
+}
+
+void VoiceEngine::ActivateStandby(uint8_t aChannel, bool aLooping)
+{
+	//Swap the voices. The replaced voice keeps its file open, so preloading
+	//another region of the same packed font needs no directory lookup.
+	SaberVoice* lpOld = mapChannels[aChannel];
+	mScheduler.Remove(lpOld->GetStream());
+	mScheduler.Add(mpStandby->GetStream());
+
+	mapChannels[aChannel] = mpStandby;
+	mpStandby = lpOld;
+	CancelPreload();
+
+	if(aChannel == mStopChannel)
+	{
+		mStopChannel = -1;
+	}
+
+	//Already primed, the scheduler tops it up from here
+	mapChannels[aChannel]->SetLooping(aLooping);
+	mapChannels[aChannel]->Resume();
+}
+
+bool VoiceEngine::PrimeStandby()
+{
+	//Leave the standby voice paused until it is moved onto a channel
+	mpStandby->Pause();
+	mpStandby->GetStream()->Refill((uint32_t)NSABER_PRELOAD_SECTORS * READ_AHEAD_SECTOR_SIZE);
+
+	return mpStandby->GetStream()->GetBufferedBytes() > 0;
+}
+
+void VoiceEngine::RenderBlock()
+{
+	memset(maMixBuffer, 0, sizeof(maMixBuffer));
+
+	//How long this block waits in the sink before it is heard
+	uint32_t lQueuedUs = (uint32_t)mpSink->GetQueuedSamples() * 1000000UL / NSABER_OUTPUT_SAMPLE_RATE;
+
+	//Voices over the limit sit out this block, lowest channels first
+	int lNumSkips = -mVoiceLimit;
+	for(int lIdx = 0; lIdx < NSABER_MAX_VOICES; lIdx++)
+	{
+		if(!mapChannels[lIdx]->IsEnded())
+		{
+			lNumSkips++;
+		}
+	}
+
+	for(int lIdx = 0; lIdx < NSABER_MAX_VOICES; lIdx++)
+	{
+		if(lNumSkips > 0
+		   && lIdx != mQueuedChannel
+		   && lIdx != mStopChannel
+		   && !mapChannels[lIdx]->IsEnded())
+		{
+			lNumSkips--;
+			continue;
+		}
+
+		ReadAheadStream* lpStream = mapChannels[lIdx]->GetStream();
+		uint32_t lUnderruns = lpStream->GetUnderruns();
+
+		//Samples of this block before a scheduled start or stop
+		uint16_t lCut = NSABER_MIX_BLOCK_SAMPLES;
+		bool lStop = lIdx == mStopChannel && mStopDelay < NSABER_MIX_BLOCK_SAMPLES;
+		bool lSwitch = lIdx == mQueuedChannel
+		               && VOICE_ENGINE_AT_END != mQueuedDelay
+		               && mQueuedDelay < NSABER_MIX_BLOCK_SAMPLES;
+
+		if(lStop)
+		{
+			lCut = mStopDelay;
+		}
+		if(lSwitch)
+		{
+			lCut = min(lCut, (uint16_t)mQueuedDelay);
+		}
+
+		uint16_t lRendered = mapChannels[lIdx]->Render(maMixBuffer, lCut);
+
+		if(lStop)
+		{
+			mapChannels[lIdx]->Close();
+			mStopChannel = -1;
+		}
+
+		if(lSwitch)
+		{
+			//A scheduled sound starts on its sample even if the last one ran short
+			ActivateStandby(lIdx, mQueuedLooping);
+			lRendered = lCut + mapChannels[lIdx]->Render(maMixBuffer + lCut, NSABER_MIX_BLOCK_SAMPLES - lCut);
+		}
+		else if(lIdx == mQueuedChannel
+		        && VOICE_ENGINE_AT_END == mQueuedDelay
+		        && lRendered < NSABER_MIX_BLOCK_SAMPLES
+		        && mapChannels[lIdx]->IsEnded())
+		{
+			//A queued sound carries on from the exact sample the last one ended on
+			ActivateStandby(lIdx, mQueuedLooping);
+			lRendered += mapChannels[lIdx]->Render(maMixBuffer + lRendered, NSABER_MIX_BLOCK_SAMPLES - lRendered);
+		}
+		else if(lIdx == mQueuedChannel && VOICE_ENGINE_AT_END != mQueuedDelay)
+		{
+			mQueuedDelay -= NSABER_MIX_BLOCK_SAMPLES;
+		}
+
+		if(lIdx == mStopChannel)
+		{
+			mStopDelay -= NSABER_MIX_BLOCK_SAMPLES;
+		}
+
+		if(lRendered > 0)
+		{
+			SoundTelemetry::NoteOutput(lIdx, lQueuedUs);
+		}
+
+		if(lpStream->GetUnderruns() != lUnderruns)
+		{
+			SoundTelemetry::NoteUnderrun(lIdx);
+			mUnderruns++;
+		}
+	}
+
+	mMixBus.Process(maMixBuffer, maOutBuffer, NSABER_MIX_BLOCK_SAMPLES);
+}
@@ -0,0 +1,373 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/**
+ * This sketch runs a scripted saber session (ignition, swings, clashes,
+ * blaster deflections, lockup and retraction) and reports what it cost:
+ * CPU time spent in ContinuePlay(), heap use and audio continuity.
+ *
+ * The session is run twice, once through the I2SWavPlayer and once
+ * through a VoiceEngine feeding a sink that consumes samples in real
+ * time, so the two playback paths can be compared on the same font.
+ * Dependencies:
+ *  * nRF52Audio library <https://github.com/JakeS0ft/nRF52Audio>
+ */
+
+#include "Arduino.h"
+#include <malloc.h>
+#include <NSaber.h>
+
+//I2S Pins
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2)
+#define PIN_I2S_LRCK (A3)
+#define PIN_I2S_DIN 18
+#define PIN_I2S_SD  10
+
+//SPI's Cable Select pin for SD card reader
+#define PIN_SPI_CS  11
+
+//Samples the paced sink holds before it reports itself full
+#define SINK_CAPACITY (1024)
+
+/**
+ * One step of the scripted session.
+ */
+struct tSessionStep
+{
+	//Time from the start of the session to play the sound (milliseconds)
+	unsigned long mTimeMs;
+
+	//Sound to play
+	SoundTypes::ESoundTypes mSoundType;
+};
+
+//A busy fight: 20 seconds of swings, clashes, blaster hits and one lockup
+static const tSessionStep saSession[] =
+{
+	{    0, SoundTypes::eePowerUpSnd },
+	{  800, SoundTypes::eeHumSnd },
+	{ 1500, SoundTypes::eeSwingSnd },
+	{ 2100, SoundTypes::eeSwingSnd },
+	{ 2500, SoundTypes::eeClashSnd },
+	{ 2700, SoundTypes::eeSwingSnd },
+	{ 3300, SoundTypes::eeClashSnd },
+	{ 3400, SoundTypes::eeClashSnd },
+	{ 4000, SoundTypes::eeBlasterSnd },
+	{ 4600, SoundTypes::eeBlasterSnd },
+	{ 5100, SoundTypes::eeBlasterSnd },
+	{ 6000, SoundTypes::eeSwingSnd },
+	{ 6400, SoundTypes::eeSwingSnd },
+	{ 6800, SoundTypes::eeSwingSnd },
+	{ 7500, SoundTypes::eeLockupSnd },
+	{10500, SoundTypes::eeClashSnd },
+	{11200, SoundTypes::eeSwingSnd },
+	{11500, SoundTypes::eeSwingSnd },
+	{11800, SoundTypes::eeSwingSnd },
+	{12100, SoundTypes::eeSwingSnd },
+	{12400, SoundTypes::eeClashSnd },
+	{13000, SoundTypes::eeBlasterSnd },
+	{13300, SoundTypes::eeBlasterSnd },
+	{14000, SoundTypes::eeSwingSnd },
+	{15000, SoundTypes::eeClashSnd },
+	{16000, SoundTypes::eeSwingSnd },
+	{17000, SoundTypes::eePowerDownSnd },
+	{20000, SoundTypes::eeMaxSoundTypes }, //End of session
+};
+
+/**
+ * Audio sink that consumes samples at the output sample rate, the way the
+ * I2S hardware would, and counts the samples it had to make up because
+ * nothing had been written in time.
+ */
+class PacedSink : public IAudioSink
+{
+public:
+
+	PacedSink()
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		mLastUs = micros();
+		mQueued = 0;
+		mWritten = 0;
+		mStarvedSamples = 0;
+		mGaps = 0;
+	}
+
+	virtual uint16_t GetFreeSamples()
+	{
+		Drain();
+		return SINK_CAPACITY - mQueued;
+	}
+
+	virtual void WriteSamples(const int16_t* apSamples, uint16_t aNumSamples)
+	{
+		mQueued += aNumSamples;
+		mWritten += aNumSamples;
+	}
+
+	virtual uint16_t GetQueuedSamples()
+	{
+		return mQueued;
+	}
+
+	//Samples played as silence because the queue was empty
+	uint32_t mStarvedSamples;
+
+	//Number of times the queue ran empty
+	uint32_t mGaps;
+
+	//Total samples written
+	uint32_t mWritten;
+
+protected:
+
+	void Drain()
+	{
+		unsigned long lNow = micros();
+		uint32_t lPlayed = (uint32_t)((uint64_t)(lNow - mLastUs) * NSABER_OUTPUT_SAMPLE_RATE / 1000000UL);
+
+		if(0 == lPlayed)
+		{
+			return;
+		}
+
+		//Only advance by whole samples so no time is lost to rounding
+		mLastUs += (unsigned long)((uint64_t)lPlayed * 1000000UL / NSABER_OUTPUT_SAMPLE_RATE);
+
+		if(lPlayed > mQueued)
+		{
+			//Ignore the first drain, the queue starts out empty
+			if(mWritten > 0)
+			{
+				mStarvedSamples += lPlayed - mQueued;
+				mGaps++;
+			}
+			mQueued = 0;
+		}
+		else
+		{
+			mQueued -= lPlayed;
+		}
+	}
+
+	unsigned long mLastUs;
+	uint32_t mQueued;
+};
+
+/**
+ * Results of one session run.
+ */
+struct tBenchResult
+{
+	unsigned long mWallUs;
+	unsigned long mBusyUs;
+	unsigned long mMaxCallUs;
+	unsigned long mCalls;
+	int mHeapStart;
+	int mHeapPeak;
+	int mHeapEnd;
+};
+
+/**
+ * Returns the number of heap bytes currently allocated.
+ */
+int HeapInUse()
+{
+	struct mallinfo lInfo = mallinfo();
+	return lInfo.uordblks;
+}
+
+/**
+ * Plays the scripted session.
+ * Args:
+ *  apSndMgr - Sound manager to drive
+ *  apI2SPlayer - Player to pump, or nullptr when a voice engine is used
+ *  arResult - Output parameter, populated with the results
+ */
+void RunSession(NECSoundManager* apSndMgr, I2SWavPlayer* apI2SPlayer, tBenchResult& arResult)
+{
+	memset(&arResult, 0, sizeof(arResult));
+	arResult.mHeapStart = HeapInUse();
+	arResult.mHeapPeak = arResult.mHeapStart;
+
+	unsigned long lStart = micros();
+	int lStep = 0;
+
+	while(SoundTypes::eeMaxSoundTypes != saSession[lStep].mSoundType
+	      || (micros() - lStart) / 1000 < saSession[lStep].mTimeMs)
+	{
+		unsigned long lCallStart = micros();
+
+		if((lCallStart - lStart) / 1000 >= saSession[lStep].mTimeMs
+		   && SoundTypes::eeMaxSoundTypes != saSession[lStep].mSoundType)
+		{
+			//Stand in for the motion sensor so latency traces are recorded
+			if(SoundTypes::eeSwingSnd == saSession[lStep].mSoundType
+			   || SoundTypes::eeClashSnd == saSession[lStep].mSoundType)
+			{
+				SoundTelemetry::NoteMotion(lCallStart, 0);
+			}
+			apSndMgr->PlayRandomSound(saSession[lStep].mSoundType);
+			lStep++;
+		}
+
+		if(nullptr != apI2SPlayer)
+		{
+			apI2SPlayer->ContinuePlayback();
+		}
+		apSndMgr->ContinuePlay();
+
+		unsigned long lCallUs = micros() - lCallStart;
+		arResult.mBusyUs += lCallUs;
+		arResult.mMaxCallUs = max(arResult.mMaxCallUs, lCallUs);
+		arResult.mCalls++;
+		arResult.mHeapPeak = max(arResult.mHeapPeak, HeapInUse());
+	}
+
+	arResult.mWallUs = micros() - lStart;
+	apSndMgr->Stop();
+	arResult.mHeapEnd = HeapInUse();
+}
+
+/**
+ * Prints the results of one session run.
+ */
+void PrintResult(const char* apName, const tBenchResult& arResult)
+{
+	Serial.println(apName);
+	Serial.print("  CPU busy: "); Serial.print(arResult.mBusyUs / 1000); Serial.print(" ms of ");
+	Serial.print(arResult.mWallUs / 1000); Serial.print(" ms (");
+	Serial.print((float)arResult.mBusyUs * 100.0 / (float)arResult.mWallUs); Serial.println("%)");
+	Serial.print("  Calls: "); Serial.print(arResult.mCalls);
+	Serial.print(", worst call: "); Serial.print(arResult.mMaxCallUs); Serial.println(" us");
+	Serial.print("  Heap: start "); Serial.print(arResult.mHeapStart);
+	Serial.print(", peak "); Serial.print(arResult.mHeapPeak);
+	Serial.print(", end "); Serial.println(arResult.mHeapEnd);
+	Serial.print("  Allocated during session: "); Serial.print(arResult.mHeapPeak - arResult.mHeapStart);
+	Serial.println(arResult.mHeapPeak == arResult.mHeapStart ? " bytes, heap untouched" : " bytes");
+}
+
+/**
+ * Times the mix bus on a block that needs limiting, and on one that doesn't.
+ */
+void BenchmarkMixBus()
+{
+	MixBus lBus;
+	int32_t laMix[NSABER_MIX_BLOCK_SAMPLES];
+	int16_t laOut[NSABER_MIX_BLOCK_SAMPLES];
+	const int lBlocks = 1000;
+
+	for(int lGainPct = 50; lGainPct <= 200; lGainPct += 150)
+	{
+		for(int lIdx = 0; lIdx < NSABER_MIX_BLOCK_SAMPLES; lIdx++)
+		{
+			laMix[lIdx] = (int32_t)(sin(lIdx * 0.3) * 327.67 * lGainPct);
+		}
+
+		unsigned long lStart = micros();
+		for(int lBlock = 0; lBlock < lBlocks; lBlock++)
+		{
+			lBus.Process(laMix, laOut, NSABER_MIX_BLOCK_SAMPLES);
+		}
+		unsigned long lElapsed = micros() - lStart;
+
+		Serial.print("  Mix bus at "); Serial.print(lGainPct); Serial.print("% of full scale: ");
+		Serial.print((float)lElapsed / lBlocks); Serial.println(" us per block");
+	}
+}
+
+void RunBenchmark()
+{
+	I2SWavPlayer* lpI2SPlayer = new I2SWavPlayer(PIN_I2S_MCK,
+	                                             PIN_I2S_BCLK,
+	                                             PIN_I2S_LRCK,
+	                                             PIN_I2S_DIN,
+	                                             PIN_I2S_SD);
+	NECSoundManager* lpSndMgr = new NECSoundManager(lpI2SPlayer);
+	tBenchResult lResult;
+
+	lpI2SPlayer->Init();
+	lpI2SPlayer->StartPlayback();
+	lpSndMgr->Init();
+	lpSndMgr->SetFont(0);
+	lpSndMgr->SetMasterVolume(12);
+
+	//I2SWavPlayer path
+	RunSession(lpSndMgr, lpI2SPlayer, lResult);
+	PrintResult("I2SWavPlayer:", lResult);
+	lpI2SPlayer->StopPlayback();
+
+	//Voice engine path
+	PacedSink lSink;
+	VoiceEngine lEngine(&lSink);
+	lpSndMgr->SetVoiceEngine(&lEngine);
+	lpSndMgr->SetFont(0);
+	lpSndMgr->SetMasterVolume(12);
+	lSink.Reset();
+	SoundTelemetry::Reset();
+
+	RunSession(lpSndMgr, nullptr, lResult);
+	PrintResult("VoiceEngine:", lResult);
+
+	tReadAheadStats lStats;
+	lEngine.GetScheduler().GetStats(lStats);
+	Serial.print("  Samples: "); Serial.print(lSink.mWritten);
+	Serial.print(", gaps: "); Serial.print(lSink.mGaps);
+	Serial.print(", starved samples: "); Serial.println(lSink.mStarvedSamples);
+	Serial.print("  SD transfers: "); Serial.print(lStats.mTransfers);
+	Serial.print(", bytes: "); Serial.print(lStats.mBytesRead);
+	Serial.print(", stream underruns: "); Serial.println(lStats.mUnderruns);
+
+	tSoundTelemetry lTelemetry;
+	lpSndMgr->GetTelemetry(lTelemetry);
+	Serial.print("  Worst ContinuePlay: "); Serial.print(lTelemetry.mMaxContinuePlayUs);
+	Serial.print(" us, worst SD read: "); Serial.print(lTelemetry.mMaxSdReadUs);
+	Serial.println(" us (0 unless NSABER_TELEMETRY is 1)");
+	SoundTelemetry::PrintLatencyReport(Serial);
+
+	BenchmarkMixBus();
+
+	Serial.println("Benchmark ends.");
+
+	lpSndMgr->SetVoiceEngine(nullptr);
+	delete lpSndMgr;
+	delete lpI2SPlayer;
+}
+
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return; //Punt. We can't work without SD card
+	}
+	Serial.println("SD init completed.");
+
+	RunBenchmark();
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+	//Do nothing
+}
@@ -36,6 +36,18 @@
 NECSoundManager* gpNecPlayer;
 I2SWavPlayer* gpI2SPlayer;
 
+//Runs the audio pumps while sounds play
+RunLoop gRunLoop;
+
+/**
+ * Keeps the global I2S player pumping data.
+ */
+bool PumpI2S(uint32_t aDeadlineUs)
+{
+	gpI2SPlayer->ContinuePlayback();
+	return false;
+}
+
 /**
  * Plays all sounds of a given type.
  * Args:
@@ -50,14 +62,7 @@ void PlayAllSoundsOfType(SoundTypes::ESoundTypes aSndType, NECSoundManager* apSn
 	for(int lIdx = 0; lIdx < aSoundCount; lIdx++)
 	{
 		apSndMgr->PlaySound(aSndType, lIdx);
-
-		unsigned long lStartTime = millis();
-		while(millis() - lStartTime < aTimeForEach)
-		{
-			__WFE();
-			gpI2SPlayer->ContinuePlayback();  //Keep the global I2S player pumping data
-			apSndMgr->ContinuePlay();
-		}
+		gRunLoop.RunFor(aTimeForEach);
 	}
 }
 
@@ -81,6 +86,17 @@ void TestNECSoundPlayer()
 	gpNecPlayer->SetFont(0);                        //Select font index
 	gpNecPlayer->SetMasterVolume(12);               //Set volume from 0 (mute) to 100 (full)
 
+	//Pump the I2S player and the sound manager every millisecond, sleeping in between
+	FunctionTask lI2STask(PumpI2S);
+	SoundTask lSoundTask(gpNecPlayer);
+	gRunLoop.AddTask(&lI2STask, eeAudioPriority, 1000, 500);
+	gRunLoop.AddTask(&lSoundTask, eeAudioPriority, 1000, 500);
+
+	//Print log messages every 10 ms when there's time to spare. A period
+	//of 0 would keep the loop from ever sleeping.
+	LogTask lLogTask(Serial);
+	gRunLoop.AddTask(&lLogTask, eeBackgroundPriority, 10000, 500);
+
 	//Play several sounds of each type (must be present on the SD card or they won't play)
 	PlayAllSoundsOfType(SoundTypes::eePowerUpSnd, gpNecPlayer, 1, 3000);
 	PlayAllSoundsOfType(SoundTypes::eeHumSnd, gpNecPlayer, 1, 3000);
@@ -93,6 +109,9 @@ void TestNECSoundPlayer()
 	Serial.println("Test ends.");
 
 	//Cleanup
+	gRunLoop.RemoveTask(&lI2STask);
+	gRunLoop.RemoveTask(&lSoundTask);
+	gRunLoop.RemoveTask(&lLogTask);
 	gpI2SPlayer->StopPlayback();
 	delete gpNecPlayer;
 	delete gpI2SPlayer;
@@ -0,0 +1,176 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * filterbench.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Measures the cost of the voice filter (Sound/StateVariableFilter.h) on a
+ * PC, and checks its response.
+ *
+ * Build on a PC:
+ *   g++ -O2 -o filterbench filterbench.cpp
+ *
+ * Usage:
+ *   filterbench
+ *
+ * Prints cycles per sample with a fixed cutoff and with the cutoff swept
+ * every block the way a swing drives it, cycles per coefficient update,
+ * and the gain of the filter at a few frequencies around the cutoff.
+ * Cycles are read from the time stamp counter on x86 and estimated from
+ * the clock elsewhere (assuming 1 GHz), so compare runs on one machine.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "../../Sound/StateVariableFilter.h"
+
+#define SAMPLE_RATE (44100)
+#define BLOCK_SAMPLES (64)
+#define NUM_BLOCKS (20000)
+
+static uint64_t Cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec lNow;
+	clock_gettime(CLOCK_MONOTONIC, &lNow);
+	return (uint64_t)lNow.tv_sec * 1000000000ull + lNow.tv_nsec;
+#endif
+}
+
+//Keeps the compiler from dropping the filter output
+static volatile int32_t sSink;
+
+/**
+ * Filters noise and returns the cycles spent per sample.
+ * Args:
+ *  aSweep - TRUE to move the cutoff every block
+ *  aMode - Filter output to use
+ */
+static double BenchProcess(bool aSweep, StateVariableFilter::EMode aMode)
+{
+	static int16_t saNoise[BLOCK_SAMPLES * 16];
+	uint32_t lSeed = 1;
+	for(unsigned lIdx = 0; lIdx < sizeof(saNoise) / sizeof(saNoise[0]); lIdx++)
+	{
+		lSeed = lSeed * 1664525 + 1013904223;
+		saNoise[lIdx] = (int16_t)(lSeed >> 16);
+	}
+
+	StateVariableFilter lFilter;
+	lFilter.SetCutoff(2000.0, 2.0, SAMPLE_RATE, aMode);
+
+	int32_t lAcc = 0;
+	uint64_t lStart = Cycles();
+	for(int lBlock = 0; lBlock < NUM_BLOCKS; lBlock++)
+	{
+		if(aSweep)
+		{
+			lFilter.SetCutoff(300.0 + (lBlock % 100) * 80.0, 2.0, SAMPLE_RATE, aMode);
+		}
+
+		const int16_t* lpIn = saNoise + (lBlock % 16) * BLOCK_SAMPLES;
+		for(int lIdx = 0; lIdx < BLOCK_SAMPLES; lIdx++)
+		{
+			lAcc += lFilter.Process(lpIn[lIdx]);
+		}
+	}
+	uint64_t lEnd = Cycles();
+	sSink = lAcc;
+
+	return (double)(lEnd - lStart) / ((double)NUM_BLOCKS * BLOCK_SAMPLES);
+}
+
+/**
+ * Returns the cycles spent per coefficient update.
+ */
+static double BenchSetCutoff()
+{
+	StateVariableFilter lFilter;
+	const int lNumUpdates = 100000;
+
+	uint64_t lStart = Cycles();
+	for(int lIdx = 0; lIdx < lNumUpdates; lIdx++)
+	{
+		lFilter.SetCutoff(300.0 + (lIdx % 1000) * 8.0, 2.0, SAMPLE_RATE);
+	}
+	uint64_t lEnd = Cycles();
+	sSink = lFilter.Process(1000);
+
+	return (double)(lEnd - lStart) / lNumUpdates;
+}
+
+/**
+ * Returns the gain in dB of the filter for a sine at a frequency.
+ */
+static double MeasureGainDb(float aCutoffHz, float aResonance, float aToneHz, StateVariableFilter::EMode aMode)
+{
+	StateVariableFilter lFilter;
+	lFilter.SetCutoff(aCutoffHz, aResonance, SAMPLE_RATE, aMode);
+
+	const int lNumSamples = SAMPLE_RATE;
+	double lInPower = 0.0;
+	double lOutPower = 0.0;
+	for(int lIdx = 0; lIdx < lNumSamples; lIdx++)
+	{
+		int32_t lIn = (int32_t)(8000.0 * sin(2.0 * M_PI * aToneHz * lIdx / SAMPLE_RATE));
+		int32_t lOut = lFilter.Process(lIn);
+
+		//Skip the first half while the filter settles
+		if(lIdx >= lNumSamples / 2)
+		{
+			lInPower += (double)lIn * lIn;
+			lOutPower += (double)lOut * lOut;
+		}
+	}
+
+	return 10.0 * log10(lOutPower / lInPower);
+}
+
+int main()
+{
+	printf("Process, fixed cutoff:  %.2f cycles/sample\n", BenchProcess(false, StateVariableFilter::eeLowPass));
+	printf("Process, swept cutoff:  %.2f cycles/sample\n", BenchProcess(true, StateVariableFilter::eeLowPass));
+	printf("Process, high-pass:     %.2f cycles/sample\n", BenchProcess(false, StateVariableFilter::eeHighPass));
+	printf("SetCutoff:              %.1f cycles/update\n", BenchSetCutoff());
+
+	const float laTones[] = { 250.0, 500.0, 1000.0, 2000.0, 4000.0, 8000.0 };
+	const float laQs[] = { 0.707, 4.0 };
+
+	for(int lQIdx = 0; lQIdx < 2; lQIdx++)
+	{
+		printf("\nLow-pass 1000 Hz, Q %.3f:\n", laQs[lQIdx]);
+		for(int lIdx = 0; lIdx < 6; lIdx++)
+		{
+			printf("  %6.0f Hz %7.2f dB\n", laTones[lIdx],
+				   MeasureGainDb(1000.0, laQs[lQIdx], laTones[lIdx], StateVariableFilter::eeLowPass));
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,302 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * flightlog.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Decodes a motion flight log (Motion/FlightLog.h) written by
+ * FlightRecorder.
+ *
+ * Build on a PC:
+ *   g++ -O2 -o flightlog flightlog.cpp
+ *
+ * Usage:
+ *   flightlog [--summary] <log file>
+ *
+ * Prints one CSV line per sensor reading and event, with times in
+ * microseconds from the start of the log, then a summary of what the log
+ * holds on stderr: readings, events by type, records dropped on the saber
+ * and the longest gaps between readings. With --summary only the summary
+ * is printed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../../Motion/FlightLog.h"
+
+using namespace FlightLog;
+
+//Gaps between readings at least this many times the typical one are listed
+#define GAP_FACTOR (3)
+
+//Most gaps listed in the summary
+#define MAX_GAPS_LISTED (10)
+
+//Names of the ESaberEvent values, in order
+static const char* const saEventNames[] =
+{
+	"swing",
+	"clash",
+	"twist",
+	"sound_started",
+	"sound_ended",
+	"calibration"
+};
+
+#define NUM_EVENT_NAMES (sizeof(saEventNames) / sizeof(saEventNames[0]))
+
+//Names of the EMagnitudes values, for swing and clash details
+static const char* const saMagnitudeNames[] = { "small", "medium", "large" };
+
+/**
+ * Totals gathered while decoding.
+ */
+struct tSummary
+{
+	uint64_t mRecords;
+	uint64_t mSamples;
+	uint64_t mDropped;
+	uint64_t mDroppedMarks;
+	uint64_t maEvents[NUM_EVENT_NAMES + 1];
+	//Time of the last reading, and of the first
+	uint64_t mLastSampleUs;
+	uint64_t mFirstSampleUs;
+	//Smallest gap between readings, taken as the typical one
+	uint64_t mMinGapUs;
+	uint64_t mMaxGapUs;
+	//Gaps at least GAP_FACTOR times the smallest, listed at the end
+	uint64_t maGapStartUs[MAX_GAPS_LISTED];
+	uint64_t maGapUs[MAX_GAPS_LISTED];
+	int mNumGaps;
+	uint64_t mLongGaps;
+};
+
+/**
+ * Notes the time between two readings.
+ */
+static void NoteGap(tSummary& arSummary, uint64_t aStartUs, uint64_t aGapUs)
+{
+	if(aGapUs < arSummary.mMinGapUs)
+	{
+		arSummary.mMinGapUs = aGapUs;
+	}
+	if(aGapUs > arSummary.mMaxGapUs)
+	{
+		arSummary.mMaxGapUs = aGapUs;
+	}
+
+	//Readings come at a steady rate, so the smallest gap seen soon settles
+	if(arSummary.mSamples > 10 && aGapUs >= arSummary.mMinGapUs * GAP_FACTOR)
+	{
+		if(arSummary.mNumGaps < MAX_GAPS_LISTED)
+		{
+			arSummary.maGapStartUs[arSummary.mNumGaps] = aStartUs;
+			arSummary.maGapUs[arSummary.mNumGaps] = aGapUs;
+			arSummary.mNumGaps++;
+		}
+		arSummary.mLongGaps++;
+	}
+}
+
+/**
+ * Prints the summary.
+ */
+static void PrintSummary(const tSummary& arSummary)
+{
+	fprintf(stderr, "Records: %llu\n", (unsigned long long)arSummary.mRecords);
+	fprintf(stderr, "Readings: %llu", (unsigned long long)arSummary.mSamples);
+	if(arSummary.mSamples > 1)
+	{
+		uint64_t lSpanUs = arSummary.mLastSampleUs - arSummary.mFirstSampleUs;
+		fprintf(stderr, " over %.3f s, %.1f per second, gaps %llu to %llu us",
+		        lSpanUs / 1e6, (arSummary.mSamples - 1) * 1e6 / lSpanUs,
+		        (unsigned long long)arSummary.mMinGapUs, (unsigned long long)arSummary.mMaxGapUs);
+	}
+	fprintf(stderr, "\n");
+
+	for(unsigned int lIdx = 0; lIdx <= NUM_EVENT_NAMES; lIdx++)
+	{
+		if(arSummary.maEvents[lIdx] > 0)
+		{
+			fprintf(stderr, "Events %s: %llu\n", lIdx < NUM_EVENT_NAMES ? saEventNames[lIdx] : "other",
+			        (unsigned long long)arSummary.maEvents[lIdx]);
+		}
+	}
+
+	fprintf(stderr, "Dropped on the saber: %llu records in %llu places\n",
+	        (unsigned long long)arSummary.mDropped, (unsigned long long)arSummary.mDroppedMarks);
+
+	fprintf(stderr, "Gaps of %dx the shortest or more: %llu\n", GAP_FACTOR, (unsigned long long)arSummary.mLongGaps);
+	for(int lIdx = 0; lIdx < arSummary.mNumGaps; lIdx++)
+	{
+		fprintf(stderr, "  at %llu us: %llu us\n", (unsigned long long)arSummary.maGapStartUs[lIdx],
+		        (unsigned long long)arSummary.maGapUs[lIdx]);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool lPrintRecords = true;
+	int lArg = 1;
+
+	if(lArg < argc && 0 == strcmp(argv[lArg], "--summary"))
+	{
+		lPrintRecords = false;
+		lArg++;
+	}
+
+	if(argc - lArg != 1)
+	{
+		fprintf(stderr, "Usage: %s [--summary] <log file>\n", argv[0]);
+		return 1;
+	}
+
+	FILE* lpFile = fopen(argv[lArg], "rb");
+	if(nullptr == lpFile)
+	{
+		fprintf(stderr, "Could not open %s\n", argv[lArg]);
+		return 1;
+	}
+
+	tFlightRecord lRecord;
+	if(1 != fread(&lRecord, sizeof(lRecord), 1, lpFile)
+	   || eeHeaderRecord != lRecord.mType || FLIGHT_LOG_MAGIC != (uint16_t)lRecord.maValues[0])
+	{
+		fprintf(stderr, "%s is not a flight log\n", argv[lArg]);
+		fclose(lpFile);
+		return 1;
+	}
+	if(FLIGHT_LOG_VERSION != lRecord.mDetail)
+	{
+		fprintf(stderr, "%s is version %d, only version %d is supported\n", argv[lArg], lRecord.mDetail, FLIGHT_LOG_VERSION);
+		fclose(lpFile);
+		return 1;
+	}
+
+	tSummary lSummary;
+	memset(&lSummary, 0, sizeof(lSummary));
+	lSummary.mRecords = 1;
+	lSummary.mMinGapUs = UINT64_MAX;
+
+	//Times are kept in 64 bits from the first sync record, so micros()
+	//wrapping during a long log doesn't matter
+	bool lSynced = false;
+	uint32_t lLastSyncUs = 0;
+	uint64_t lNowUs = 0;
+
+	if(lPrintRecords)
+	{
+		printf("time_us,type,ax,ay,az,gx,gy,gz,event,detail\n");
+	}
+
+	while(1 == fread(&lRecord, sizeof(lRecord), 1, lpFile))
+	{
+		lSummary.mRecords++;
+
+		if(eeSyncRecord == lRecord.mType)
+		{
+			uint32_t lSyncUs = GetWord32(lRecord);
+			if(!lSynced)
+			{
+				lNowUs = 0;
+				lSynced = true;
+			}
+			else
+			{
+				lNowUs += (uint32_t)(lSyncUs - lLastSyncUs);
+			}
+			lLastSyncUs = lSyncUs;
+			continue;
+		}
+
+		lNowUs += lRecord.mDeltaUs;
+		lLastSyncUs += lRecord.mDeltaUs;
+
+		switch(lRecord.mType)
+		{
+		case eePadRecord:
+			break;
+		case eeSampleRecord:
+			if(lSummary.mSamples > 0)
+			{
+				NoteGap(lSummary, lSummary.mLastSampleUs, lNowUs - lSummary.mLastSampleUs);
+			}
+			else
+			{
+				lSummary.mFirstSampleUs = lNowUs;
+			}
+			lSummary.mLastSampleUs = lNowUs;
+			lSummary.mSamples++;
+
+			if(lPrintRecords)
+			{
+				printf("%llu,sample,%d,%d,%d,%d,%d,%d,,\n", (unsigned long long)lNowUs,
+				       lRecord.maValues[0], lRecord.maValues[1], lRecord.maValues[2],
+				       lRecord.maValues[3], lRecord.maValues[4], lRecord.maValues[5]);
+			}
+			break;
+		case eeEventRecord:
+		{
+			unsigned int lEvent = lRecord.mDetail < NUM_EVENT_NAMES ? lRecord.mDetail : NUM_EVENT_NAMES;
+			lSummary.maEvents[lEvent]++;
+
+			if(lPrintRecords)
+			{
+				const char* lpName = lEvent < NUM_EVENT_NAMES ? saEventNames[lEvent] : "other";
+				//Swings and clashes give a magnitude
+				if(lEvent <= 1 && lRecord.maValues[0] >= 0 && lRecord.maValues[0] <= 2)
+				{
+					printf("%llu,event,,,,,,,%s,%s\n", (unsigned long long)lNowUs, lpName, saMagnitudeNames[lRecord.maValues[0]]);
+				}
+				else
+				{
+					printf("%llu,event,,,,,,,%s,%d\n", (unsigned long long)lNowUs, lpName, lRecord.maValues[0]);
+				}
+			}
+			break;
+		}
+		case eeDroppedRecord:
+			lSummary.mDropped += GetWord32(lRecord);
+			lSummary.mDroppedMarks++;
+
+			if(lPrintRecords)
+			{
+				printf("%llu,dropped,,,,,,,,%u\n", (unsigned long long)lNowUs, GetWord32(lRecord));
+			}
+			break;
+		default:
+			fprintf(stderr, "Unknown record type %d at record %llu\n", lRecord.mType, (unsigned long long)lSummary.mRecords - 1);
+			break;
+		}
+	}
+
+	fclose(lpFile);
+
+	if(!lSynced)
+	{
+		fprintf(stderr, "No sync record, times are relative\n");
+	}
+
+	PrintSummary(lSummary);
+
+	return 0;
+}
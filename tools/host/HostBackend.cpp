@@ -0,0 +1,1376 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * HostBackend.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+#include "HostBackend.h"
+#include "Sound/SaberVoice.h" //For NSABER_OUTPUT_SAMPLE_RATE
+#include "Sound/WavHeader.h"
+
+#include <chrono>
+#include <errno.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <execinfo.h>
+
+HostSerial Serial;
+SDClass SD;
+TwoWire Wire;
+
+//Bytes in one card sector
+#define HOST_SD_SECTOR_SIZE (512)
+
+//Time one __WFE() sleeps for, roughly one timer interrupt
+#define HOST_WFE_US (10)
+
+//Allocations HostAlloc prints a backtrace for when reporting
+#define HOST_ALLOC_REPORTS (4)
+
+//Longest path on the host
+#define HOST_MAX_PATH (512)
+
+//Default length of a test font's sound (milliseconds)
+#define HOST_FONT_SOUND_MS (400)
+
+static const std::chrono::steady_clock::time_point sStart = std::chrono::steady_clock::now();
+static uint64_t sAdvancedUs = 0;
+
+uint64_t HostClock::GetUs()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sStart).count()
+	       + sAdvancedUs;
+}
+
+void HostClock::Advance(uint32_t aUs)
+{
+	sAdvancedUs += aUs;
+}
+
+uint64_t HostClock::GetAdvancedUs()
+{
+	return sAdvancedUs;
+}
+
+uint64_t HostClock::GetCpuUs()
+{
+	struct timespec lTime;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &lTime);
+	return (uint64_t)lTime.tv_sec * 1000000 + lTime.tv_nsec / 1000;
+}
+
+//----------------------------------------------------------------------------
+// Arduino core
+//----------------------------------------------------------------------------
+
+//The target's counters are 32 bits and wrap, so these do too
+unsigned long millis()
+{
+	return (uint32_t)(HostClock::GetUs() / 1000);
+}
+
+unsigned long micros()
+{
+	return (uint32_t)HostClock::GetUs();
+}
+
+void delay(unsigned long aMs)
+{
+	HostClock::Advance(aMs * 1000);
+}
+
+void delayMicroseconds(unsigned int aUs)
+{
+	HostClock::Advance(aUs);
+}
+
+void __WFE()
+{
+	HostClock::Advance(HOST_WFE_US);
+}
+
+void pinMode(uint8_t aPin, uint8_t aMode)
+{
+	//Do nothing
+}
+
+void digitalWrite(uint8_t aPin, uint8_t aValue)
+{
+	//Do nothing
+}
+
+int digitalRead(uint8_t aPin)
+{
+	return LOW;
+}
+
+void analogWrite(uint8_t aPin, int aValue)
+{
+	//Do nothing
+}
+
+long random(long aMax)
+{
+	return aMax > 0 ? rand() % aMax : 0;
+}
+
+long random(long aMin, long aMax)
+{
+	return aMax > aMin ? aMin + rand() % (aMax - aMin) : aMin;
+}
+
+void randomSeed(unsigned long aSeed)
+{
+	srand((unsigned int)aSeed);
+}
+
+char* itoa(int aValue, char* apBuffer, int aBase)
+{
+	if(16 == aBase)
+	{
+		sprintf(apBuffer, "%x", aValue);
+	}
+	else
+	{
+		sprintf(apBuffer, "%d", aValue);
+	}
+
+	return apBuffer;
+}
+
+String::String(const char* apText)
+{
+	mpBuffer = nullptr;
+	Assign(apText, strlen(apText));
+}
+
+String::String(const String& arOther)
+{
+	mpBuffer = nullptr;
+	Assign(arOther.mpBuffer, arOther.mLength);
+}
+
+String::~String()
+{
+	free(mpBuffer);
+}
+
+String& String::operator=(const String& arOther)
+{
+	if(this != &arOther)
+	{
+		Assign(arOther.mpBuffer, arOther.mLength);
+	}
+
+	return *this;
+}
+
+String& String::operator=(const char* apText)
+{
+	Assign(apText, strlen(apText));
+	return *this;
+}
+
+String& String::operator+=(const char* apText)
+{
+	unsigned int lAddLength = strlen(apText);
+	char* lpBuffer = (char*)realloc(mpBuffer, mLength + lAddLength + 1);
+	if(nullptr != lpBuffer)
+	{
+		memcpy(lpBuffer + mLength, apText, lAddLength + 1);
+		mpBuffer = lpBuffer;
+		mLength += lAddLength;
+	}
+
+	return *this;
+}
+
+void String::Assign(const char* apText, unsigned int aLength)
+{
+	char* lpBuffer = (char*)malloc(aLength + 1);
+	memcpy(lpBuffer, apText, aLength);
+	lpBuffer[aLength] = '\0';
+
+	free(mpBuffer);
+	mpBuffer = lpBuffer;
+	mLength = aLength;
+}
+
+size_t Print::write(const uint8_t* apBuffer, size_t aSize)
+{
+	size_t lWritten = 0;
+	while(lWritten < aSize && 1 == write(apBuffer[lWritten]))
+	{
+		lWritten++;
+	}
+
+	return lWritten;
+}
+
+size_t Print::print(long aValue, int aBase)
+{
+	char laText[24];
+	snprintf(laText, sizeof(laText), HEX == aBase ? "%lX" : "%ld", aValue);
+	return write(laText);
+}
+
+size_t Print::print(unsigned long aValue, int aBase)
+{
+	char laText[24];
+	snprintf(laText, sizeof(laText), HEX == aBase ? "%lX" : "%lu", aValue);
+	return write(laText);
+}
+
+size_t Print::print(double aValue, int aDigits)
+{
+	char laText[48];
+	snprintf(laText, sizeof(laText), "%.*f", aDigits, aValue);
+	return write(laText);
+}
+
+size_t HostSerial::write(uint8_t aByte)
+{
+	return fwrite(&aByte, 1, 1, stdout);
+}
+
+size_t HostSerial::write(const uint8_t* apBuffer, size_t aSize)
+{
+	return fwrite(apBuffer, 1, aSize, stdout);
+}
+
+//----------------------------------------------------------------------------
+// SD card
+//----------------------------------------------------------------------------
+
+struct tHostFileHandle
+{
+	FILE* mpFile;
+	DIR* mpDir;
+	char maPath[HOST_MAX_PATH];
+	const char* mpName;
+	//Sector the card last transferred, which the library keeps cached
+	int64_t mCachedSector;
+	//Buffer for the host file, so stdio doesn't allocate one on first use
+	//and reads after the open stay off the heap as they do on the card
+	char maBuffer[BUFSIZ];
+};
+
+static char saSdRoot[HOST_MAX_PATH / 2] = ".";
+static tHostSdLatency sSdLatency = {};
+static tHostSdStats sSdStats = {};
+static uint32_t sOpenFiles = 0;
+static uint32_t sSdWrites = 0;
+
+/**
+ * Builds the host path of a file on the card.
+ */
+static void SdHostPath(const char* apPath, char* apOut)
+{
+	while('/' == *apPath)
+	{
+		apPath++;
+	}
+	snprintf(apOut, HOST_MAX_PATH, "%s/%s", saSdRoot, apPath);
+}
+
+/**
+ * Adds card latency to the clock.
+ */
+static void SdWait(uint32_t aUs)
+{
+	sSdStats.mLatencyUs += aUs;
+	HostClock::Advance(aUs);
+}
+
+/**
+ * Charges the card time of a transfer. The sector the last transfer ended
+ * in is cached, anything else costs a command plus a sector each, and a
+ * seek if it doesn't follow on from the last transfer.
+ * Args:
+ *  apHandle - File transferred
+ *  aPosition - File position of the first byte
+ *  aSize - Bytes transferred
+ *  aWrite - TRUE for a write
+ */
+static void SdTransfer(tHostFileHandle* apHandle, uint32_t aPosition, uint32_t aSize, bool aWrite)
+{
+	int64_t lFirst = aPosition / HOST_SD_SECTOR_SIZE;
+	int64_t lLast = (aPosition + aSize - 1) / HOST_SD_SECTOR_SIZE;
+
+	if(!aWrite && lFirst == apHandle->mCachedSector)
+	{
+		lFirst++;
+	}
+
+	if(lFirst <= lLast)
+	{
+		uint32_t lSectors = (uint32_t)(lLast - lFirst + 1);
+		uint32_t lUs = sSdLatency.mCommandUs;
+
+		if(lFirst != apHandle->mCachedSector + 1 && lFirst != apHandle->mCachedSector)
+		{
+			lUs += sSdLatency.mSeekUs;
+			sSdStats.mSeeks++;
+		}
+
+		if(aWrite)
+		{
+			lUs += lSectors * sSdLatency.mSectorWriteUs;
+			sSdStats.mSectorsWritten += lSectors;
+
+			sSdWrites++;
+			if(sSdLatency.mStallEvery > 0 && 0 == sSdWrites % sSdLatency.mStallEvery)
+			{
+				lUs += sSdLatency.mStallUs;
+			}
+		}
+		else
+		{
+			lUs += lSectors * sSdLatency.mSectorReadUs;
+			sSdStats.mSectorsRead += lSectors;
+		}
+
+		SdWait(lUs);
+		apHandle->mCachedSector = lLast;
+	}
+}
+
+void HostSd::SetRoot(const char* apDir)
+{
+	strncpy(saSdRoot, apDir, sizeof(saSdRoot) - 1);
+	saSdRoot[sizeof(saSdRoot) - 1] = '\0';
+}
+
+const char* HostSd::GetRoot()
+{
+	return saSdRoot;
+}
+
+void HostSd::SetLatency(const tHostSdLatency& arLatency)
+{
+	sSdLatency = arLatency;
+	sSdWrites = 0;
+}
+
+tHostSdLatency HostSd::GetSpiCardLatency()
+{
+	tHostSdLatency lLatency;
+
+	//A 512-byte sector takes 512 us to clock over an 8 MHz SPI bus, and
+	//the card takes a few hundred microseconds to find the data
+	lLatency.mBeginUs = 60000;
+	lLatency.mOpenUs = 2500;
+	lLatency.mExistsUs = 2000;
+	lLatency.mSeekUs = 1000;
+	lLatency.mCommandUs = 250;
+	lLatency.mSectorReadUs = 520;
+	lLatency.mSectorWriteUs = 900;
+	lLatency.mStallUs = 0;
+	lLatency.mStallEvery = 0;
+
+	return lLatency;
+}
+
+void HostSd::GetStats(tHostSdStats& arStats)
+{
+	arStats = sSdStats;
+}
+
+void HostSd::ResetStats()
+{
+	memset(&sSdStats, 0, sizeof(sSdStats));
+}
+
+uint32_t HostSd::GetOpenFiles()
+{
+	return sOpenFiles;
+}
+
+File::File()
+{
+	mpHandle = nullptr;
+}
+
+File::File(tHostFileHandle* apHandle)
+{
+	mpHandle = apHandle;
+}
+
+int File::read()
+{
+	uint8_t lByte;
+	return 1 == read(&lByte, 1) ? lByte : -1;
+}
+
+int File::read(void* apBuffer, uint16_t aSize)
+{
+	if(nullptr == mpHandle || nullptr == mpHandle->mpFile || 0 == aSize)
+	{
+		return 0 == aSize ? 0 : -1;
+	}
+
+	uint32_t lPosition = (uint32_t)ftell(mpHandle->mpFile);
+	size_t lRead = fread(apBuffer, 1, aSize, mpHandle->mpFile);
+
+	sSdStats.mReads++;
+	if(lRead > 0)
+	{
+		SdTransfer(mpHandle, lPosition, (uint32_t)lRead, false);
+		sSdStats.mBytesRead += lRead;
+	}
+
+	return (int)lRead;
+}
+
+int File::peek()
+{
+	if(nullptr == mpHandle || nullptr == mpHandle->mpFile)
+	{
+		return -1;
+	}
+
+	int lByte = fgetc(mpHandle->mpFile);
+	if(EOF != lByte)
+	{
+		ungetc(lByte, mpHandle->mpFile);
+	}
+
+	return EOF == lByte ? -1 : lByte;
+}
+
+int File::available()
+{
+	return (int)(size() - position());
+}
+
+bool File::seek(uint32_t aPosition)
+{
+	if(nullptr == mpHandle || nullptr == mpHandle->mpFile || aPosition > size())
+	{
+		return false;
+	}
+
+	return 0 == fseek(mpHandle->mpFile, aPosition, SEEK_SET);
+}
+
+uint32_t File::position()
+{
+	if(nullptr == mpHandle || nullptr == mpHandle->mpFile)
+	{
+		return 0;
+	}
+
+	return (uint32_t)ftell(mpHandle->mpFile);
+}
+
+uint32_t File::size()
+{
+	struct stat lStat;
+	if(nullptr == mpHandle || nullptr == mpHandle->mpFile || 0 != fstat(fileno(mpHandle->mpFile), &lStat))
+	{
+		return 0;
+	}
+
+	return (uint32_t)lStat.st_size;
+}
+
+size_t File::write(uint8_t aByte)
+{
+	return write(&aByte, 1);
+}
+
+size_t File::write(const uint8_t* apBuffer, size_t aSize)
+{
+	if(nullptr == mpHandle || nullptr == mpHandle->mpFile || 0 == aSize)
+	{
+		return 0;
+	}
+
+	uint32_t lPosition = (uint32_t)ftell(mpHandle->mpFile);
+	size_t lWritten = fwrite(apBuffer, 1, aSize, mpHandle->mpFile);
+
+	if(lWritten > 0)
+	{
+		SdTransfer(mpHandle, lPosition, (uint32_t)lWritten, true);
+		sSdStats.mBytesWritten += lWritten;
+	}
+
+	return lWritten;
+}
+
+void File::flush()
+{
+	if(nullptr != mpHandle && nullptr != mpHandle->mpFile)
+	{
+		fflush(mpHandle->mpFile);
+	}
+}
+
+void File::close()
+{
+	if(nullptr == mpHandle)
+	{
+		return;
+	}
+
+	if(nullptr != mpHandle->mpFile)
+	{
+		fclose(mpHandle->mpFile);
+	}
+	if(nullptr != mpHandle->mpDir)
+	{
+		closedir(mpHandle->mpDir);
+	}
+
+	//Like the SD library, the handle is freed here
+	delete mpHandle;
+	mpHandle = nullptr;
+	sOpenFiles--;
+}
+
+const char* File::name()
+{
+	return nullptr == mpHandle ? "" : mpHandle->mpName;
+}
+
+bool File::isDirectory()
+{
+	return nullptr != mpHandle && nullptr != mpHandle->mpDir;
+}
+
+File File::openNextFile(uint8_t aMode)
+{
+	if(!isDirectory())
+	{
+		return File();
+	}
+
+	struct dirent* lpEntry;
+	while(nullptr != (lpEntry = readdir(mpHandle->mpDir)))
+	{
+		if('.' != lpEntry->d_name[0])
+		{
+			char laPath[HOST_MAX_PATH];
+			snprintf(laPath, sizeof(laPath), "%s/%s", mpHandle->maPath + strlen(saSdRoot), lpEntry->d_name);
+			return SD.open(laPath, aMode);
+		}
+	}
+
+	return File();
+}
+
+void File::rewindDirectory()
+{
+	if(isDirectory())
+	{
+		rewinddir(mpHandle->mpDir);
+	}
+}
+
+File::operator bool()
+{
+	return nullptr != mpHandle;
+}
+
+bool SDClass::begin(uint8_t aCsPin)
+{
+	SdWait(sSdLatency.mBeginUs);
+
+	struct stat lStat;
+	return 0 == stat(saSdRoot, &lStat) && S_ISDIR(lStat.st_mode);
+}
+
+bool SDClass::begin(uint32_t aClockHz, uint8_t aCsPin)
+{
+	return begin(aCsPin);
+}
+
+File SDClass::open(const char* apPath, uint8_t aMode)
+{
+	SdWait(sSdLatency.mOpenUs);
+	sSdStats.mOpens++;
+
+	char laPath[HOST_MAX_PATH];
+	SdHostPath(apPath, laPath);
+
+	struct stat lStat;
+	bool lExists = 0 == stat(laPath, &lStat);
+	FILE* lpFile = nullptr;
+	DIR* lpDir = nullptr;
+
+	if(lExists && S_ISDIR(lStat.st_mode))
+	{
+		lpDir = opendir(laPath);
+	}
+	else if(FILE_WRITE == aMode)
+	{
+		lpFile = fopen(laPath, lExists ? "r+b" : "w+b");
+	}
+	else if(lExists)
+	{
+		lpFile = fopen(laPath, "rb");
+	}
+
+	if(nullptr == lpFile && nullptr == lpDir)
+	{
+		return File();
+	}
+
+	//The SD library allocates each open file's handle on the heap
+	tHostFileHandle* lpHandle = new tHostFileHandle;
+	lpHandle->mpFile = lpFile;
+	lpHandle->mpDir = lpDir;
+	strncpy(lpHandle->maPath, laPath, HOST_MAX_PATH - 1);
+	lpHandle->maPath[HOST_MAX_PATH - 1] = '\0';
+	const char* lpSlash = strrchr(lpHandle->maPath, '/');
+	lpHandle->mpName = nullptr == lpSlash ? lpHandle->maPath : lpSlash + 1;
+	lpHandle->mCachedSector = -2;
+	if(nullptr != lpFile)
+	{
+		setvbuf(lpFile, lpHandle->maBuffer, _IOFBF, sizeof(lpHandle->maBuffer));
+		if(FILE_WRITE == aMode)
+		{
+			fseek(lpFile, 0, SEEK_END);
+		}
+	}
+	sOpenFiles++;
+
+	return File(lpHandle);
+}
+
+bool SDClass::exists(const char* apPath)
+{
+	SdWait(sSdLatency.mExistsUs);
+	sSdStats.mExists++;
+
+	char laPath[HOST_MAX_PATH];
+	SdHostPath(apPath, laPath);
+
+	struct stat lStat;
+	return 0 == stat(laPath, &lStat);
+}
+
+bool SDClass::remove(const char* apPath)
+{
+	char laPath[HOST_MAX_PATH];
+	SdHostPath(apPath, laPath);
+	return 0 == unlink(laPath);
+}
+
+bool SDClass::mkdir(const char* apPath)
+{
+	char laPath[HOST_MAX_PATH];
+	SdHostPath(apPath, laPath);
+	return 0 == ::mkdir(laPath, 0755) || EEXIST == errno;
+}
+
+bool SDClass::rmdir(const char* apPath)
+{
+	char laPath[HOST_MAX_PATH];
+	SdHostPath(apPath, laPath);
+	return 0 == ::rmdir(laPath);
+}
+
+//----------------------------------------------------------------------------
+// I2C bus
+//----------------------------------------------------------------------------
+
+//Devices have 7-bit addresses
+#define HOST_WIRE_DEVICES (128)
+
+static uint8_t saWireRegisters[HOST_WIRE_DEVICES][256];
+static bool saWireClearOnRead[HOST_WIRE_DEVICES][256];
+static uint8_t saWirePointer[HOST_WIRE_DEVICES];
+static const tHostWireStep* spWireScript = nullptr;
+static uint32_t sWireScriptSteps = 0;
+static uint32_t sWireScriptPos = 0;
+static uint32_t sWireScriptStartMs = 0;
+static uint32_t sWireTransactionUs = 0;
+static uint32_t sWireByteUs = 0;
+static uint32_t sWireTransactions = 0;
+
+/**
+ * Applies the steps of the script that are due.
+ */
+static void WireRunScript()
+{
+	uint32_t lElapsedMs = millis() - sWireScriptStartMs;
+
+	while(sWireScriptPos < sWireScriptSteps && spWireScript[sWireScriptPos].mTimeMs <= lElapsedMs)
+	{
+		const tHostWireStep& lrStep = spWireScript[sWireScriptPos];
+		saWireRegisters[lrStep.mAddress & 0x7F][lrStep.mRegister] = lrStep.mValue;
+		sWireScriptPos++;
+	}
+}
+
+/**
+ * Adds the bus time of one transaction to the clock.
+ */
+static void WireWait(uint32_t aBytes)
+{
+	sWireTransactions++;
+	HostClock::Advance(sWireTransactionUs + aBytes * sWireByteUs);
+}
+
+void HostWire::SetRegister(uint8_t aAddress, uint8_t aRegister, uint8_t aValue)
+{
+	saWireRegisters[aAddress & 0x7F][aRegister] = aValue;
+}
+
+void HostWire::SetRegister16(uint8_t aAddress, uint8_t aRegister, int16_t aValue)
+{
+	SetRegister(aAddress, aRegister, (uint8_t)((uint16_t)aValue >> 8));
+	SetRegister(aAddress, aRegister + 1, (uint8_t)aValue);
+}
+
+uint8_t HostWire::GetRegister(uint8_t aAddress, uint8_t aRegister)
+{
+	return saWireRegisters[aAddress & 0x7F][aRegister];
+}
+
+void HostWire::SetClearOnRead(uint8_t aAddress, uint8_t aRegister, bool aClear)
+{
+	saWireClearOnRead[aAddress & 0x7F][aRegister] = aClear;
+}
+
+void HostWire::SetScript(const tHostWireStep* apSteps, uint32_t aNumSteps)
+{
+	spWireScript = apSteps;
+	sWireScriptSteps = nullptr == apSteps ? 0 : aNumSteps;
+	sWireScriptPos = 0;
+	sWireScriptStartMs = millis();
+}
+
+bool HostWire::IsScriptDone()
+{
+	WireRunScript();
+	return sWireScriptPos >= sWireScriptSteps;
+}
+
+void HostWire::SetLatency(uint32_t aTransactionUs, uint32_t aByteUs)
+{
+	sWireTransactionUs = aTransactionUs;
+	sWireByteUs = aByteUs;
+}
+
+uint32_t HostWire::GetTransactions()
+{
+	return sWireTransactions;
+}
+
+TwoWire::TwoWire()
+{
+	mAddress = 0;
+	mTxCount = 0;
+	mRxCount = 0;
+	mRxIdx = 0;
+}
+
+void TwoWire::begin()
+{
+	//Do nothing
+}
+
+void TwoWire::setClock(uint32_t aClockHz)
+{
+	//Do nothing
+}
+
+void TwoWire::beginTransmission(int aAddress)
+{
+	mAddress = (uint8_t)(aAddress & 0x7F);
+	mTxCount = 0;
+}
+
+size_t TwoWire::write(uint8_t aByte)
+{
+	if(mTxCount >= sizeof(maTxBuffer))
+	{
+		return 0;
+	}
+
+	maTxBuffer[mTxCount++] = aByte;
+	return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool aStop)
+{
+	WireRunScript();
+	WireWait(mTxCount);
+
+	//The first byte selects the register, the rest are written from there
+	if(mTxCount > 0)
+	{
+		uint8_t lRegister = maTxBuffer[0];
+		for(int lIdx = 1; lIdx < mTxCount; lIdx++)
+		{
+			saWireRegisters[mAddress][lRegister++] = maTxBuffer[lIdx];
+		}
+		saWirePointer[mAddress] = lRegister;
+	}
+	mTxCount = 0;
+
+	return 0;
+}
+
+uint8_t TwoWire::requestFrom(int aAddress, int aCount, bool aStop)
+{
+	uint8_t lAddress = (uint8_t)(aAddress & 0x7F);
+	uint8_t lCount = (uint8_t)min(aCount, (int)sizeof(maRxBuffer));
+
+	WireRunScript();
+	WireWait(lCount);
+
+	uint8_t& lrPointer = saWirePointer[lAddress];
+	for(int lIdx = 0; lIdx < lCount; lIdx++)
+	{
+		maRxBuffer[lIdx] = saWireRegisters[lAddress][lrPointer];
+		if(saWireClearOnRead[lAddress][lrPointer])
+		{
+			saWireRegisters[lAddress][lrPointer] = 0;
+		}
+		lrPointer++;
+	}
+	mRxCount = lCount;
+	mRxIdx = 0;
+
+	return lCount;
+}
+
+int TwoWire::available()
+{
+	return mRxCount - mRxIdx;
+}
+
+int TwoWire::read()
+{
+	return mRxIdx < mRxCount ? maRxBuffer[mRxIdx++] : -1;
+}
+
+//----------------------------------------------------------------------------
+// Heap
+//----------------------------------------------------------------------------
+
+extern "C" void* __libc_malloc(size_t aSize);
+extern "C" void* __libc_calloc(size_t aCount, size_t aSize);
+extern "C" void* __libc_realloc(void* apPtr, size_t aSize);
+
+static bool sAllocCounting = false;
+static bool sAllocReport = false;
+static bool sAllocInReport = false;
+static uint32_t sAllocCount = 0;
+
+/**
+ * Counts one allocation, and prints where it came from if asked to.
+ */
+static void CountAlloc()
+{
+	if(!sAllocCounting || sAllocInReport)
+	{
+		return;
+	}
+
+	sAllocCount++;
+	if(sAllocReport && sAllocCount <= HOST_ALLOC_REPORTS)
+	{
+		sAllocInReport = true;
+		void* lapFrames[16];
+		int lFrames = backtrace(lapFrames, 16);
+		fprintf(stderr, "Allocation %u:\n", sAllocCount);
+		backtrace_symbols_fd(lapFrames, lFrames, 2);
+		sAllocInReport = false;
+	}
+}
+
+extern "C" void* malloc(size_t aSize)
+{
+	CountAlloc();
+	return __libc_malloc(aSize);
+}
+
+extern "C" void* calloc(size_t aCount, size_t aSize)
+{
+	CountAlloc();
+	return __libc_calloc(aCount, aSize);
+}
+
+extern "C" void* realloc(void* apPtr, size_t aSize)
+{
+	CountAlloc();
+	return __libc_realloc(apPtr, aSize);
+}
+
+void HostAlloc::Begin(bool aReport)
+{
+	sAllocCount = 0;
+	sAllocReport = aReport;
+	sAllocCounting = true;
+}
+
+uint32_t HostAlloc::End()
+{
+	sAllocCounting = false;
+	return sAllocCount;
+}
+
+uint32_t HostAlloc::GetCount()
+{
+	return sAllocCount;
+}
+
+//----------------------------------------------------------------------------
+// Audio
+//----------------------------------------------------------------------------
+
+HostAudioSink::HostAudioSink(uint16_t aCapacity, bool aPaced)
+{
+	mCapacity = aCapacity;
+	mPaced = aPaced;
+	mpCapture = nullptr;
+	mMaxCapture = 0;
+	Reset();
+}
+
+void HostAudioSink::Reset()
+{
+	mLastUs = HostClock::GetUs();
+	mQueued = 0;
+	mWritten = 0;
+	mGaps = 0;
+	mStarvedSamples = 0;
+	mCaptured = 0;
+}
+
+void HostAudioSink::SetCapture(int16_t* apBuffer, uint32_t aMaxSamples)
+{
+	mpCapture = apBuffer;
+	mMaxCapture = aMaxSamples;
+	mCaptured = 0;
+}
+
+void HostAudioSink::Play(uint32_t aNumSamples)
+{
+	if(aNumSamples > mQueued)
+	{
+		//The queue starts out empty, that's not a gap
+		if(mWritten > 0)
+		{
+			mStarvedSamples += aNumSamples - mQueued;
+			mGaps++;
+		}
+		mQueued = 0;
+	}
+	else
+	{
+		mQueued -= aNumSamples;
+	}
+}
+
+void HostAudioSink::Drain()
+{
+	if(!mPaced)
+	{
+		return;
+	}
+
+	uint64_t lNow = HostClock::GetUs();
+	uint32_t lPlayed = (uint32_t)((lNow - mLastUs) * NSABER_OUTPUT_SAMPLE_RATE / 1000000);
+
+	if(lPlayed > 0)
+	{
+		//Only advance by whole samples so no time is lost to rounding
+		mLastUs += (uint64_t)lPlayed * 1000000 / NSABER_OUTPUT_SAMPLE_RATE;
+		Play(lPlayed);
+	}
+}
+
+uint16_t HostAudioSink::GetFreeSamples()
+{
+	Drain();
+	return mQueued >= mCapacity ? 0 : (uint16_t)(mCapacity - mQueued);
+}
+
+void HostAudioSink::WriteSamples(const int16_t* apSamples, uint16_t aNumSamples)
+{
+	Drain();
+	mQueued += aNumSamples;
+	mWritten += aNumSamples;
+
+	if(nullptr != mpCapture)
+	{
+		uint32_t lCopy = min((uint32_t)aNumSamples, mMaxCapture - mCaptured);
+		memcpy(mpCapture + mCaptured, apSamples, lCopy * sizeof(int16_t));
+		mCaptured += lCopy;
+	}
+}
+
+uint16_t HostAudioSink::GetQueuedSamples()
+{
+	Drain();
+	return (uint16_t)min(mQueued, (uint32_t)0xFFFF);
+}
+
+PitchShiftSDWavFile::PitchShiftSDWavFile(const char* apPath)
+{
+	mDataStart = 0;
+	mDataEnd = 0;
+	mLooping = false;
+	mPaused = false;
+	mEnded = true;
+	mVolume = 1.0;
+	mPos = 0;
+	mBaseStep = 1 << 16;
+	mStep = mBaseStep;
+	mBufferCount = 0;
+
+	mFile = SD.open(apPath);
+	if(!mFile)
+	{
+		return;
+	}
+
+	WavHeader::tWavInfo lInfo;
+	if(!WavHeader::Parse(mFile, lInfo)
+	   || WAV_FORMAT_PCM != lInfo.mFormat
+	   || 1 != lInfo.mNumChannels
+	   || 16 != lInfo.mBitsPerSample)
+	{
+		mFile.close();
+		return;
+	}
+
+	mDataStart = lInfo.mDataStart;
+	mDataEnd = lInfo.mDataStart + lInfo.mDataLength;
+	mStep = (uint32_t)((uint64_t)lInfo.mSampleRate * 65536 / NSABER_OUTPUT_SAMPLE_RATE);
+	mBaseStep = mStep;
+	SeekStartOfData();
+}
+
+PitchShiftSDWavFile::~PitchShiftSDWavFile()
+{
+	Close();
+}
+
+void PitchShiftSDWavFile::Close()
+{
+	mFile.close();
+	mEnded = true;
+}
+
+void PitchShiftSDWavFile::Pause()
+{
+	mPaused = true;
+}
+
+bool PitchShiftSDWavFile::IsEnded()
+{
+	return mEnded;
+}
+
+void PitchShiftSDWavFile::SeekStartOfData()
+{
+	if(!mFile)
+	{
+		return;
+	}
+
+	mFile.seek(mDataStart);
+	mPos = 0;
+	mBufferCount = 0;
+	mPaused = false;
+	mEnded = false;
+}
+
+void PitchShiftSDWavFile::SetLooping(bool aLooping)
+{
+	mLooping = aLooping;
+}
+
+void PitchShiftSDWavFile::SetVolume(float aVolume)
+{
+	mVolume = aVolume;
+}
+
+void PitchShiftSDWavFile::SetRate(float aPitch)
+{
+	mStep = (uint32_t)(mBaseStep * pow(2.0, aPitch));
+}
+
+bool PitchShiftSDWavFile::Fill()
+{
+	uint32_t lPosition = mFile.position();
+
+	if(lPosition >= mDataEnd)
+	{
+		if(!mLooping)
+		{
+			return false;
+		}
+		mFile.seek(mDataStart);
+		lPosition = mDataStart;
+	}
+
+	uint32_t lBytes = min((uint32_t)sizeof(maBuffer), mDataEnd - lPosition);
+	int lRead = mFile.read(maBuffer, (uint16_t)lBytes);
+	mBufferCount = lRead > 0 ? (uint16_t)(lRead / sizeof(int16_t)) : 0;
+
+	return mBufferCount > 0;
+}
+
+void PitchShiftSDWavFile::MixSamples(int32_t* apMix, uint16_t aNumSamples)
+{
+	if(mEnded || mPaused)
+	{
+		return;
+	}
+
+	for(int lIdx = 0; lIdx < aNumSamples; lIdx++)
+	{
+		while((mPos >> 16) >= mBufferCount)
+		{
+			mPos -= (uint32_t)mBufferCount << 16;
+			if(!Fill())
+			{
+				mEnded = true;
+				return;
+			}
+		}
+
+		apMix[lIdx] += (int32_t)(maBuffer[mPos >> 16] * mVolume);
+		mPos += mStep;
+	}
+}
+
+I2SWavPlayer::I2SWavPlayer(int aMckPin, int aBclkPin, int aLrckPin, int aDinPin, int aSdPin)
+{
+	for(int lIdx = 0; lIdx < I2S_PLAYER_CHANNELS; lIdx++)
+	{
+		mapFiles[lIdx] = nullptr;
+	}
+	mpSink = nullptr;
+	mVolume = 1.0;
+	mPlaying = false;
+}
+
+void I2SWavPlayer::Init()
+{
+	//Do nothing
+}
+
+void I2SWavPlayer::StartPlayback()
+{
+	mPlaying = true;
+}
+
+void I2SWavPlayer::StopPlayback()
+{
+	mPlaying = false;
+}
+
+void I2SWavPlayer::ContinuePlayback()
+{
+	if(!mPlaying || nullptr == mpSink)
+	{
+		return;
+	}
+
+	int32_t laMix[64];
+	int16_t laOut[64];
+	uint16_t lFree;
+
+	//Like the I2S peripheral, play silence when there's nothing to play
+	while((lFree = mpSink->GetFreeSamples()) > 0)
+	{
+		uint16_t lCount = min(lFree, (uint16_t)64);
+		memset(laMix, 0, sizeof(laMix));
+
+		for(int lChannel = 0; lChannel < I2S_PLAYER_CHANNELS; lChannel++)
+		{
+			if(nullptr != mapFiles[lChannel])
+			{
+				mapFiles[lChannel]->MixSamples(laMix, lCount);
+			}
+		}
+
+		for(int lIdx = 0; lIdx < lCount; lIdx++)
+		{
+			laOut[lIdx] = (int16_t)constrain((int32_t)(laMix[lIdx] * mVolume), -32768, 32767);
+		}
+		mpSink->WriteSamples(laOut, lCount);
+	}
+}
+
+void I2SWavPlayer::SetWavFile(ISDWavFile* apFile, int aChannel)
+{
+	if(aChannel >= 0 && aChannel < I2S_PLAYER_CHANNELS)
+	{
+		mapFiles[aChannel] = apFile;
+	}
+}
+
+bool I2SWavPlayer::IsEnded()
+{
+	for(int lIdx = 0; lIdx < I2S_PLAYER_CHANNELS; lIdx++)
+	{
+		if(nullptr != mapFiles[lIdx] && !mapFiles[lIdx]->IsEnded())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void I2SWavPlayer::SetVolume(float aVolume)
+{
+	mVolume = aVolume;
+}
+
+void I2SWavPlayer::SetSink(IAudioSink* apSink)
+{
+	mpSink = apSink;
+}
+
+//----------------------------------------------------------------------------
+// Test fonts
+//----------------------------------------------------------------------------
+
+/**
+ * Writes a 32-bit little-endian field.
+ */
+static void Write32(uint8_t* apOut, uint32_t aValue)
+{
+	for(int lByte = 0; lByte < 4; lByte++)
+	{
+		apOut[lByte] = (uint8_t)(aValue >> (lByte * 8));
+	}
+}
+
+bool HostFont::WriteWav(const char* apPath, const int16_t* apSamples, uint32_t aNumSamples, uint32_t aSampleRate,
+                        uint32_t aLoopStart, uint32_t aLoopEnd)
+{
+	FILE* lpFile = fopen(apPath, "wb");
+	if(nullptr == lpFile)
+	{
+		return false;
+	}
+
+	uint32_t lDataSize = aNumSamples * sizeof(int16_t);
+	uint8_t laHeader[44];
+	const uint32_t laFields[][2] =
+	{
+		{4, 36 + lDataSize}, {16, 16}, {24, aSampleRate}, {28, aSampleRate * 2}, {40, lDataSize},
+	};
+
+	//One loop, sample positions with the end inclusive
+	uint8_t laSmpl[8 + 60] = {};
+	bool lHasLoop = aLoopEnd > aLoopStart;
+	memcpy(laSmpl, "smpl", 4);
+	Write32(laSmpl + 4, 60);
+	Write32(laSmpl + 8 + 28, 1);
+	Write32(laSmpl + 8 + 44, aLoopStart);
+	Write32(laSmpl + 8 + 48, aLoopEnd - 1);
+
+	memcpy(laHeader, "RIFF\0\0\0\0WAVEfmt ", 16);
+	memcpy(laHeader + 36, "data", 4);
+	for(const auto& lrField : laFields)
+	{
+		Write32(laHeader + lrField[0], lrField[1]);
+	}
+	if(lHasLoop)
+	{
+		Write32(laHeader + 4, 36 + lDataSize + sizeof(laSmpl));
+	}
+	//PCM, one channel, 2 bytes per frame, 16 bits per sample
+	const uint8_t laFormat[] = {1, 0, 1, 0};
+	const uint8_t laFrame[] = {2, 0, 16, 0};
+	memcpy(laHeader + 20, laFormat, 4);
+	memcpy(laHeader + 32, laFrame, 4);
+
+	bool lSuccess = 1 == fwrite(laHeader, sizeof(laHeader), 1, lpFile)
+	                && aNumSamples == fwrite(apSamples, sizeof(int16_t), aNumSamples, lpFile)
+	                && (!lHasLoop || 1 == fwrite(laSmpl, sizeof(laSmpl), 1, lpFile));
+	fclose(lpFile);
+
+	return lSuccess;
+}
+
+/**
+ * Writes one sound of a test font: a tone sweeping from aStartHz to aEndHz
+ * with some noise, faded in and out unless it loops.
+ */
+static bool WriteFontSound(const char* apDir, const char* apName, uint32_t aSampleRate, uint32_t aMs,
+                           float aStartHz, float aEndHz, float aNoise, bool aLoop)
+{
+	char laPath[HOST_MAX_PATH];
+	snprintf(laPath, sizeof(laPath), "%s/%s.wav", apDir, apName);
+
+	uint32_t lNumSamples = aSampleRate * aMs / 1000;
+	int16_t* lpSamples = new int16_t[lNumSamples];
+	double lPhase = 0;
+
+	for(uint32_t lIdx = 0; lIdx < lNumSamples; lIdx++)
+	{
+		double lFraction = (double)lIdx / lNumSamples;
+		double lFade = 1.0;
+		if(!aLoop)
+		{
+			lFade = min(1.0, min(lFraction, 1.0 - lFraction) * 20);
+		}
+
+		lPhase += 2 * M_PI * (aStartHz + (aEndHz - aStartHz) * lFraction) / aSampleRate;
+		double lNoise = aNoise * ((rand() % 2001) - 1000) / 1000.0;
+		lpSamples[lIdx] = (int16_t)(12000 * lFade * (sin(lPhase) + lNoise));
+	}
+
+	bool lSuccess = HostFont::WriteWav(laPath, lpSamples, lNumSamples, aSampleRate);
+	delete[] lpSamples;
+
+	return lSuccess;
+}
+
+bool HostFont::WriteNecFont(const char* apDir, uint32_t aSampleRate)
+{
+	::mkdir(apDir, 0755);
+
+	//The hum is a whole number of cycles so it loops without a click
+	bool lSuccess = WriteFontSound(apDir, "hum01", aSampleRate, 500, 110, 110, 0, true)
+	                && WriteFontSound(apDir, "font", aSampleRate, 250, 440, 660, 0, false)
+	                && WriteFontSound(apDir, "boot", aSampleRate, 350, 880, 440, 0, false)
+	                && WriteFontSound(apDir, "out01", aSampleRate, 700, 60, 220, 0.3, false)
+	                && WriteFontSound(apDir, "in01", aSampleRate, 600, 220, 60, 0.3, false)
+	                && WriteFontSound(apDir, "lock01", aSampleRate, 500, 300, 300, 0.8, true)
+	                && WriteFontSound(apDir, "blst01", aSampleRate, 280, 1200, 400, 0.2, false);
+
+	char laName[16];
+	for(int lIdx = 1; lSuccess && lIdx <= 8; lIdx++)
+	{
+		snprintf(laName, sizeof(laName), "swng%02d", lIdx);
+		lSuccess = WriteFontSound(apDir, laName, aSampleRate, HOST_FONT_SOUND_MS + lIdx * 5, 140, 200 + lIdx * 20, 0.4, false);
+	}
+	for(int lIdx = 1; lSuccess && lIdx <= 4; lIdx++)
+	{
+		snprintf(laName, sizeof(laName), "clsh%02d", lIdx);
+		lSuccess = WriteFontSound(apDir, laName, aSampleRate, 600, 900 - lIdx * 50, 200, 0.9, false);
+	}
+
+	return lSuccess;
+}
@@ -0,0 +1,327 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * HostBackend.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Controls for the host stand-ins of the Arduino, SD, Wire and nRF52Audio
+ * libraries, used by the host benchmark and tests to build a simulated
+ * saber: a card with realistic latency, a scripted motion sensor and a
+ * sink that plays audio in real time.
+ *
+ * Time is the host's steady clock plus whatever latency the simulated
+ * devices have added, so a slow card read shows up in micros() the way it
+ * would on the target, without the host actually waiting.
+ */
+
+#ifndef HOSTBACKEND_H_
+#define HOSTBACKEND_H_
+
+#include <Arduino.h>
+#include <SD.h>
+#include <Wire.h>
+#include <nRF52Audio.h>
+#include "Sound/IAudioSink.h"
+
+/**
+ * Simulated time.
+ */
+class HostClock
+{
+public:
+	/**
+	 * Gets the time since start up, including simulated latency.
+	 */
+	static uint64_t GetUs();
+
+	/**
+	 * Moves time on without waiting, for latency of a simulated device.
+	 * Args:
+	 *  aUs - Microseconds to add
+	 */
+	static void Advance(uint32_t aUs);
+
+	/**
+	 * Gets the total simulated latency added so far.
+	 */
+	static uint64_t GetAdvancedUs();
+
+	/**
+	 * Gets the CPU time this process has used, which leaves out both
+	 * simulated latency and time spent descheduled.
+	 */
+	static uint64_t GetCpuUs();
+};
+
+/**
+ * Latency of the simulated card. Zero everywhere (the default) makes the
+ * card as fast as the host's file system.
+ */
+struct tHostSdLatency
+{
+	//SD.begin(), card initialisation
+	uint32_t mBeginUs;
+	//SD.open(), directory search
+	uint32_t mOpenUs;
+	//SD.exists()
+	uint32_t mExistsUs;
+	//Read or write that is not sequential with the last one
+	uint32_t mSeekUs;
+	//Each read or write call that reaches the card
+	uint32_t mCommandUs;
+	//Each 512-byte sector read from the card
+	uint32_t mSectorReadUs;
+	//Each 512-byte sector written to the card
+	uint32_t mSectorWriteUs;
+	//Extra time every mStallEvery-th write takes, as when the card stops
+	//to erase a block. 0 for no stalls.
+	uint32_t mStallUs;
+	uint32_t mStallEvery;
+};
+
+/**
+ * Card activity counters.
+ */
+struct tHostSdStats
+{
+	uint32_t mOpens;
+	uint32_t mExists;
+	uint32_t mReads;
+	uint32_t mSeeks;
+	uint32_t mSectorsRead;
+	uint32_t mSectorsWritten;
+	uint64_t mBytesRead;
+	uint64_t mBytesWritten;
+	//Latency the card added to HostClock
+	uint64_t mLatencyUs;
+};
+
+/**
+ * The simulated card, a directory on the host.
+ */
+class HostSd
+{
+public:
+	/**
+	 * Sets the directory that is the root of the card.
+	 */
+	static void SetRoot(const char* apDir);
+
+	static const char* GetRoot();
+
+	static void SetLatency(const tHostSdLatency& arLatency);
+
+	/**
+	 * Gets the latency of a typical card on an 8 MHz SPI bus.
+	 */
+	static tHostSdLatency GetSpiCardLatency();
+
+	static void GetStats(tHostSdStats& arStats);
+	static void ResetStats();
+
+	/**
+	 * Gets the number of files open right now.
+	 */
+	static uint32_t GetOpenFiles();
+};
+
+/**
+ * One step of a motion script: at mTimeMs after the script starts, a
+ * register takes a new value.
+ */
+struct tHostWireStep
+{
+	uint32_t mTimeMs;
+	uint8_t mAddress;
+	uint8_t mRegister;
+	uint8_t mValue;
+};
+
+/**
+ * The simulated I2C bus. Each device is a map of 256 registers. Reads
+ * start at the register last written and auto-increment, like the
+ * MPU-6050's.
+ */
+class HostWire
+{
+public:
+	static void SetRegister(uint8_t aAddress, uint8_t aRegister, uint8_t aValue);
+
+	/**
+	 * Sets a big-endian 16-bit register pair, like the MPU-6050's
+	 * ACCEL_XOUT_H/ACCEL_XOUT_L.
+	 */
+	static void SetRegister16(uint8_t aAddress, uint8_t aRegister, int16_t aValue);
+
+	static uint8_t GetRegister(uint8_t aAddress, uint8_t aRegister);
+
+	/**
+	 * Makes a register read as zero after it has been read once, like an
+	 * interrupt status register.
+	 */
+	static void SetClearOnRead(uint8_t aAddress, uint8_t aRegister, bool aClear);
+
+	/**
+	 * Plays a script of register changes, starting now. Steps must be in
+	 * time order; the script is not copied.
+	 * Args:
+	 *  apSteps - Steps, or nullptr to stop the script
+	 *  aNumSteps - Number of steps
+	 */
+	static void SetScript(const tHostWireStep* apSteps, uint32_t aNumSteps);
+
+	/**
+	 * Returns TRUE once every step of the script has been applied.
+	 */
+	static bool IsScriptDone();
+
+	/**
+	 * Sets the bus time of each transaction and of each byte moved.
+	 */
+	static void SetLatency(uint32_t aTransactionUs, uint32_t aByteUs);
+
+	static uint32_t GetTransactions();
+};
+
+/**
+ * Heap allocation counter. malloc(), calloc(), realloc() and operator new
+ * are counted between Begin() and End().
+ */
+class HostAlloc
+{
+public:
+	/**
+	 * Starts counting.
+	 * Args:
+	 *  aReport - TRUE to print a backtrace of each of the first few
+	 *            allocations to stderr
+	 */
+	static void Begin(bool aReport = false);
+
+	/**
+	 * Stops counting.
+	 * Returns:
+	 *  Allocations since Begin()
+	 */
+	static uint32_t End();
+
+	/**
+	 * Gets the number of allocations since Begin().
+	 */
+	static uint32_t GetCount();
+};
+
+/**
+ * Audio sink that plays samples at NSABER_OUTPUT_SAMPLE_RATE by HostClock,
+ * the way the I2S hardware would, and counts the samples it had to make up
+ * because nothing had been written in time.
+ */
+class HostAudioSink : public IAudioSink
+{
+public:
+	/**
+	 * Constructor.
+	 * Args:
+	 *  aCapacity - Samples the sink holds before it reports itself full
+	 *  aPaced - TRUE to play samples in real time. FALSE to play them
+	 *           only when Play() is called.
+	 */
+	HostAudioSink(uint16_t aCapacity = 1024, bool aPaced = true);
+
+	/**
+	 * Empties the sink and clears the counters.
+	 */
+	void Reset();
+
+	/**
+	 * Keeps a copy of every sample written, up to aMaxSamples. The buffer
+	 * must outlive the sink.
+	 */
+	void SetCapture(int16_t* apBuffer, uint32_t aMaxSamples);
+
+	/**
+	 * Plays queued samples, for an unpaced sink.
+	 * Args:
+	 *  aNumSamples - Samples to play, silence if fewer are queued
+	 */
+	void Play(uint32_t aNumSamples);
+
+	virtual uint16_t GetFreeSamples();
+	virtual void WriteSamples(const int16_t* apSamples, uint16_t aNumSamples);
+	virtual uint16_t GetQueuedSamples();
+
+	uint32_t GetWritten() { return mWritten; }
+	uint32_t GetCaptured() { return mCaptured; }
+
+	//Number of times the queue ran empty after the first write
+	uint32_t GetGaps() { return mGaps; }
+
+	//Samples played as silence because the queue was empty
+	uint32_t GetStarvedSamples() { return mStarvedSamples; }
+
+protected:
+	void Drain();
+
+	uint16_t mCapacity;
+	bool mPaced;
+	uint64_t mLastUs;
+	uint32_t mQueued;
+	uint32_t mWritten;
+	uint32_t mGaps;
+	uint32_t mStarvedSamples;
+	int16_t* mpCapture;
+	uint32_t mMaxCapture;
+	uint32_t mCaptured;
+};
+
+/**
+ * Writes test fonts: NEC-named WAV files of tones and noise, so the host
+ * benchmark and tests don't need a real font.
+ */
+class HostFont
+{
+public:
+	/**
+	 * Writes a font directory.
+	 * Args:
+	 *  apDir - Directory to create, "necfont1" under the card root for
+	 *          font 0 with the default base name
+	 *  aSampleRate - Sample rate of the files
+	 * Returns:
+	 *  TRUE if successful
+	 */
+	static bool WriteNecFont(const char* apDir, uint32_t aSampleRate = 44100);
+
+	/**
+	 * Writes one 16-bit mono WAV file.
+	 * Args:
+	 *  apPath - Path on the host
+	 *  apSamples - Samples
+	 *  aNumSamples - Number of samples
+	 *  aSampleRate - Sample rate
+	 *  aLoopStart - First sample of the loop in a "smpl" chunk
+	 *  aLoopEnd - Sample after the loop, 0 to leave out the "smpl" chunk
+	 * Returns:
+	 *  TRUE if successful
+	 */
+	static bool WriteWav(const char* apPath, const int16_t* apSamples, uint32_t aNumSamples, uint32_t aSampleRate,
+	                     uint32_t aLoopStart = 0, uint32_t aLoopEnd = 0);
+};
+
+#endif /* HOSTBACKEND_H_ */
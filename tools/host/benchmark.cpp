@@ -0,0 +1,320 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * benchmark.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Host version of examples/Benchmark: runs the same scripted saber session
+ * on a simulated card with the latency of a real one, once through the
+ * I2SWavPlayer and once through a VoiceEngine, and reports what each cost:
+ * CPU time, heap allocations and audio continuity.
+ *
+ * Unlike the sketch, swings and clashes come from a Mpu6050LiteMotionManager
+ * reading a scripted sensor over the simulated I2C bus, so the motion path
+ * and its bus time are part of the session.
+ *
+ * Usage:
+ *   benchmark <card directory>
+ *
+ * The card needs the font written by hostcard in "necfont1".
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+
+//Address of the MPU-6050
+#define MPU_ADDRESS (0x68)
+
+//Register of the gyro's X axis, and the value a swing reads as
+#define MPU_GYRO_XOUT (0x43)
+#define MPU_SWING_VALUE (0x40)
+
+//Motion detect bit of MPU6050_RA_INT_STATUS
+#define MPU_INT_MOTION (0x40)
+
+//How long a swing lasts (milliseconds)
+#define SWING_MS (80)
+
+//Samples the paced sink holds before it reports itself full
+#define SINK_CAPACITY (1024)
+
+//The session loop runs once per tick of a 1 ms timer
+#define LOOP_PERIOD_US (1000)
+
+/**
+ * One step of the scripted session.
+ */
+struct tSessionStep
+{
+	//Time from the start of the session to play the sound (milliseconds)
+	unsigned long mTimeMs;
+
+	//Sound to play. Swings and clashes are motion played by the sensor.
+	SoundTypes::ESoundTypes mSoundType;
+};
+
+//The session of examples/Benchmark: 20 seconds of swings, clashes,
+//blaster hits and one lockup
+static const tSessionStep saSession[] =
+{
+	{    0, SoundTypes::eePowerUpSnd },
+	{  800, SoundTypes::eeHumSnd },
+	{ 1500, SoundTypes::eeSwingSnd },
+	{ 2100, SoundTypes::eeSwingSnd },
+	{ 2500, SoundTypes::eeClashSnd },
+	{ 2700, SoundTypes::eeSwingSnd },
+	{ 3300, SoundTypes::eeClashSnd },
+	{ 3400, SoundTypes::eeClashSnd },
+	{ 4000, SoundTypes::eeBlasterSnd },
+	{ 4600, SoundTypes::eeBlasterSnd },
+	{ 5100, SoundTypes::eeBlasterSnd },
+	{ 6000, SoundTypes::eeSwingSnd },
+	{ 6400, SoundTypes::eeSwingSnd },
+	{ 6800, SoundTypes::eeSwingSnd },
+	{ 7500, SoundTypes::eeLockupSnd },
+	{10500, SoundTypes::eeClashSnd },
+	{11200, SoundTypes::eeSwingSnd },
+	{11500, SoundTypes::eeSwingSnd },
+	{11800, SoundTypes::eeSwingSnd },
+	{12100, SoundTypes::eeSwingSnd },
+	{12400, SoundTypes::eeClashSnd },
+	{13000, SoundTypes::eeBlasterSnd },
+	{13300, SoundTypes::eeBlasterSnd },
+	{14000, SoundTypes::eeSwingSnd },
+	{15000, SoundTypes::eeClashSnd },
+	{16000, SoundTypes::eeSwingSnd },
+	{17000, SoundTypes::eePowerDownSnd },
+	{20000, SoundTypes::eeMaxSoundTypes }, //End of session
+};
+
+#define SESSION_STEPS (sizeof(saSession) / sizeof(saSession[0]))
+
+//The sensor's side of the session, two register changes per step at most
+static tHostWireStep saMotionScript[SESSION_STEPS * 2];
+static uint32_t sMotionSteps = 0;
+
+/**
+ * Results of one session run.
+ */
+struct tBenchResult
+{
+	uint64_t mWallUs;
+	uint64_t mCpuUs;
+	uint64_t mBusyUs;
+	uint32_t mMaxCallUs;
+	uint32_t mCalls;
+	uint32_t mAllocations;
+	uint32_t mSwings;
+	uint32_t mClashes;
+	tHostSdStats mSd;
+};
+
+/**
+ * Turns the swings and clashes of the session into sensor register
+ * changes.
+ */
+static void BuildMotionScript()
+{
+	for(uint32_t lIdx = 0; lIdx < SESSION_STEPS; lIdx++)
+	{
+		const tSessionStep& lrStep = saSession[lIdx];
+
+		if(SoundTypes::eeSwingSnd == lrStep.mSoundType)
+		{
+			saMotionScript[sMotionSteps++] = { (uint32_t)lrStep.mTimeMs, MPU_ADDRESS, MPU_GYRO_XOUT, MPU_SWING_VALUE };
+			saMotionScript[sMotionSteps++] = { (uint32_t)lrStep.mTimeMs + SWING_MS, MPU_ADDRESS, MPU_GYRO_XOUT, 0 };
+		}
+		else if(SoundTypes::eeClashSnd == lrStep.mSoundType)
+		{
+			saMotionScript[sMotionSteps++] = { (uint32_t)lrStep.mTimeMs, MPU_ADDRESS, MPU6050_RA_INT_STATUS, MPU_INT_MOTION };
+		}
+	}
+}
+
+/**
+ * Plays the scripted session.
+ * Args:
+ *  apSndMgr - Sound manager to drive
+ *  apI2SPlayer - Player to pump, or nullptr when a voice engine is used
+ *  apMotion - Motion manager reading the scripted sensor
+ *  arResult - Output parameter, populated with the results
+ */
+static void RunSession(NECSoundManager* apSndMgr, I2SWavPlayer* apI2SPlayer, AMotionManager* apMotion, tBenchResult& arResult)
+{
+	memset(&arResult, 0, sizeof(arResult));
+	HostSd::ResetStats();
+	HostWire::SetScript(saMotionScript, sMotionSteps);
+
+	uint64_t lStart = HostClock::GetUs();
+	uint64_t lCpuStart = HostClock::GetCpuUs();
+	uint32_t lStep = 0;
+	bool lWasSwing = false;
+	bool lWasClash = false;
+
+	HostAlloc::Begin();
+
+	while(SoundTypes::eeMaxSoundTypes != saSession[lStep].mSoundType
+	      || (HostClock::GetUs() - lStart) / 1000 < saSession[lStep].mTimeMs)
+	{
+		uint64_t lCallStart = HostClock::GetUs();
+
+		apMotion->Update();
+
+		if(apMotion->IsSwing() && !lWasSwing)
+		{
+			apSndMgr->PlayRandomSound(SoundTypes::eeSwingSnd);
+			arResult.mSwings++;
+		}
+		if(apMotion->IsClash() && !lWasClash)
+		{
+			apSndMgr->PlayRandomSound(SoundTypes::eeClashSnd);
+			arResult.mClashes++;
+		}
+		lWasSwing = apMotion->IsSwing();
+		lWasClash = apMotion->IsClash();
+
+		if((lCallStart - lStart) / 1000 >= saSession[lStep].mTimeMs
+		   && SoundTypes::eeMaxSoundTypes != saSession[lStep].mSoundType)
+		{
+			if(SoundTypes::eeSwingSnd != saSession[lStep].mSoundType
+			   && SoundTypes::eeClashSnd != saSession[lStep].mSoundType)
+			{
+				apSndMgr->PlayRandomSound(saSession[lStep].mSoundType);
+			}
+			lStep++;
+		}
+
+		if(nullptr != apI2SPlayer)
+		{
+			apI2SPlayer->ContinuePlayback();
+		}
+		apSndMgr->ContinuePlay();
+
+		uint32_t lCallUs = (uint32_t)(HostClock::GetUs() - lCallStart);
+		arResult.mBusyUs += lCallUs;
+		arResult.mMaxCallUs = max(arResult.mMaxCallUs, lCallUs);
+		arResult.mCalls++;
+
+		//Sleep until the next tick rather than spin, so the CPU time is
+		//the session's own work
+		if(lCallUs < LOOP_PERIOD_US)
+		{
+			HostClock::Advance(LOOP_PERIOD_US - lCallUs);
+		}
+	}
+
+	arResult.mAllocations = HostAlloc::End();
+	arResult.mCpuUs = HostClock::GetCpuUs() - lCpuStart;
+	arResult.mWallUs = HostClock::GetUs() - lStart;
+	HostSd::GetStats(arResult.mSd);
+	apSndMgr->Stop();
+}
+
+/**
+ * Prints the results of one session run.
+ */
+static void PrintResult(const char* apName, const tBenchResult& arResult, HostAudioSink& arSink)
+{
+	Serial.println(apName);
+	Serial.print("  Busy: "); Serial.print((unsigned long)(arResult.mBusyUs / 1000));
+	Serial.print(" ms of "); Serial.print((unsigned long)(arResult.mWallUs / 1000));
+	Serial.print(" ms ("); Serial.print((double)arResult.mBusyUs * 100.0 / (double)arResult.mWallUs);
+	Serial.print("%) including card and bus time, worst call ");
+	Serial.print(arResult.mMaxCallUs); Serial.println(" us");
+	Serial.print("  Host CPU time: "); Serial.print((unsigned long)(arResult.mCpuUs / 1000));
+	Serial.print(" ms over "); Serial.print(arResult.mCalls); Serial.println(" calls");
+	Serial.print("  Heap allocations during session: "); Serial.println(arResult.mAllocations);
+	Serial.print("  Motion: "); Serial.print(arResult.mSwings); Serial.print(" swings, ");
+	Serial.print(arResult.mClashes); Serial.println(" clashes");
+	Serial.print("  Card: "); Serial.print(arResult.mSd.mOpens); Serial.print(" opens, ");
+	Serial.print(arResult.mSd.mReads); Serial.print(" reads, ");
+	Serial.print(arResult.mSd.mSeeks); Serial.print(" seeks, ");
+	Serial.print(arResult.mSd.mSectorsRead); Serial.print(" sectors, ");
+	Serial.print((unsigned long)(arResult.mSd.mLatencyUs / 1000)); Serial.println(" ms busy");
+	Serial.print("  Audio: "); Serial.print(arSink.GetWritten()); Serial.print(" samples, ");
+	Serial.print(arSink.GetGaps()); Serial.print(" gaps, ");
+	Serial.print(arSink.GetStarvedSamples()); Serial.println(" starved samples");
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	HostSd::SetRoot(argv[1]);
+	HostSd::SetLatency(HostSd::GetSpiCardLatency());
+	//400 kHz I2C: about 22 us per byte plus the address
+	HostWire::SetLatency(25, 22);
+	HostWire::SetClearOnRead(MPU_ADDRESS, MPU6050_RA_INT_STATUS, true);
+	BuildMotionScript();
+
+	if(!SD.begin(8000000, 11) || !SD.exists("necfont1"))
+	{
+		Serial.println("No font on the card, run hostcard first.");
+		return 1;
+	}
+
+	MPU6050LiteTolData lTolerances = { 250, 200, 100, 1000, 5000 };
+	Mpu6050LiteMotionManager lMotion(&lTolerances);
+	lMotion.Init();
+
+	I2SWavPlayer lI2SPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lI2SPlayer);
+	HostAudioSink lSink(SINK_CAPACITY);
+	tBenchResult lResult;
+
+	lI2SPlayer.SetSink(&lSink);
+	lI2SPlayer.Init();
+	lI2SPlayer.StartPlayback();
+	lSndMgr.Init();
+	lSndMgr.SetFont(0);
+	lSndMgr.SetMasterVolume(12);
+
+	//I2SWavPlayer path
+	lSink.Reset();
+	RunSession(&lSndMgr, &lI2SPlayer, &lMotion, lResult);
+	PrintResult("I2SWavPlayer:", lResult, lSink);
+	lI2SPlayer.StopPlayback();
+
+	//Voice engine path
+	VoiceEngine lEngine(&lSink);
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetFont(0);
+	lSndMgr.SetMasterVolume(12);
+	lSink.Reset();
+	SoundTelemetry::Reset();
+
+	RunSession(&lSndMgr, nullptr, &lMotion, lResult);
+	PrintResult("VoiceEngine:", lResult, lSink);
+
+	tReadAheadStats lStats;
+	lEngine.GetScheduler().GetStats(lStats);
+	Serial.print("  Read-ahead: "); Serial.print(lStats.mTransfers); Serial.print(" transfers, ");
+	Serial.print(lStats.mBytesRead); Serial.print(" bytes, ");
+	Serial.print(lStats.mUnderruns); Serial.println(" stream underruns");
+	SoundTelemetry::PrintLatencyReport(Serial);
+
+	lSndMgr.SetVoiceEngine(nullptr);
+	Serial.println("Benchmark ends.");
+
+	return 0;
+}
@@ -0,0 +1,54 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * hostcard.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Writes a test card for the host benchmark and tests: a directory with a
+ * generated NEC font in "necfont1".
+ *
+ * Usage:
+ *   hostcard <card directory> [sample rate]
+ */
+
+#include "HostBackend.h"
+#include <sys/stat.h>
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory> [sample rate]\n", argv[0]);
+		return 1;
+	}
+
+	uint32_t lSampleRate = argc > 2 ? (uint32_t)atoi(argv[2]) : 44100;
+	char laFontDir[512];
+	snprintf(laFontDir, sizeof(laFontDir), "%s/necfont1", argv[1]);
+
+	mkdir(argv[1], 0755);
+	if(!HostFont::WriteNecFont(laFontDir, lSampleRate))
+	{
+		fprintf(stderr, "Could not write %s\n", laFontDir);
+		return 1;
+	}
+
+	printf("Wrote %s at %u Hz\n", laFontDir, lSampleRate);
+	return 0;
+}
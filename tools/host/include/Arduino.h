@@ -0,0 +1,151 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * Arduino.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Host stand-in for the parts of the Arduino core NSaber uses, so the
+ * library builds and runs on Linux. Time comes from HostClock (see
+ * HostBackend.h), so simulated card and bus latency shows up in micros()
+ * without actually waiting.
+ */
+
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define LOW    (0)
+#define HIGH   (1)
+#define INPUT  (0)
+#define OUTPUT (1)
+
+#define DEC (10)
+#define HEX (16)
+
+#define A0 (14)
+#define A1 (15)
+#define A2 (16)
+#define A3 (17)
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long aMs);
+void delayMicroseconds(unsigned int aUs);
+
+void pinMode(uint8_t aPin, uint8_t aMode);
+void digitalWrite(uint8_t aPin, uint8_t aValue);
+int digitalRead(uint8_t aPin);
+void analogWrite(uint8_t aPin, int aValue);
+
+long random(long aMax);
+long random(long aMin, long aMax);
+void randomSeed(unsigned long aSeed);
+
+char* itoa(int aValue, char* apBuffer, int aBase);
+
+//Cortex-M intrinsics. Sleeping lets simulated time run on a little so a
+//loop waiting for an interrupt still sees time pass.
+void __WFE();
+inline void __SEV() {}
+inline void __disable_irq() {}
+inline void __enable_irq() {}
+
+/**
+ * Heap-backed string, like the Arduino String. Only what NSaber and its
+ * examples use.
+ */
+class String
+{
+public:
+	String(const char* apText = "");
+	String(const String& arOther);
+	~String();
+	String& operator=(const String& arOther);
+	String& operator=(const char* apText);
+	String& operator+=(const char* apText);
+	const char* c_str() const { return mpBuffer; }
+	unsigned int length() const { return mLength; }
+
+protected:
+	void Assign(const char* apText, unsigned int aLength);
+
+	char* mpBuffer;
+	unsigned int mLength;
+};
+
+/**
+ * Text output, like the Arduino Print class.
+ */
+class Print
+{
+public:
+	virtual ~Print() {}
+
+	virtual size_t write(uint8_t aByte) = 0;
+	virtual size_t write(const uint8_t* apBuffer, size_t aSize);
+	virtual int availableForWrite() { return 0; }
+
+	size_t write(const char* apText) { return write((const uint8_t*)apText, strlen(apText)); }
+
+	size_t print(const char* apText) { return write(apText); }
+	size_t print(const String& arText) { return write(arText.c_str()); }
+	size_t print(char aChar) { return write((uint8_t)aChar); }
+	size_t print(int aValue, int aBase = DEC) { return print((long)aValue, aBase); }
+	size_t print(unsigned int aValue, int aBase = DEC) { return print((unsigned long)aValue, aBase); }
+	size_t print(long aValue, int aBase = DEC);
+	size_t print(unsigned long aValue, int aBase = DEC);
+	size_t print(double aValue, int aDigits = 2);
+
+	size_t println() { return write("\r\n"); }
+	template<typename T> size_t println(T aValue) { size_t lSize = print(aValue); return lSize + println(); }
+	template<typename T> size_t println(T aValue, int aFormat) { size_t lSize = print(aValue, aFormat); return lSize + println(); }
+};
+
+/**
+ * Serial port, writes to stdout.
+ */
+class HostSerial : public Print
+{
+public:
+	void begin(unsigned long aBaud) {}
+	operator bool() { return true; }
+	virtual size_t write(uint8_t aByte);
+	virtual size_t write(const uint8_t* apBuffer, size_t aSize);
+	virtual int availableForWrite() { return 256; }
+	using Print::write;
+};
+
+extern HostSerial Serial;
+
+#endif /* HOST_ARDUINO_H_ */
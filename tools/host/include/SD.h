@@ -0,0 +1,90 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * SD.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Host stand-in for the Arduino SD library. Files live in a directory on
+ * the host, set with HostSd::SetRoot(), and every card operation adds its
+ * simulated latency to HostClock. Like the real library, opening a file
+ * allocates its handle on the heap and close() frees it.
+ */
+
+#ifndef HOST_SD_H_
+#define HOST_SD_H_
+
+#include "Arduino.h"
+
+#define FILE_READ  (0x01)
+#define FILE_WRITE (0x13)
+
+//An open file on the host, owned by a File
+struct tHostFileHandle;
+
+/**
+ * Open file or directory, like the SD library's File. Copies share the
+ * handle, and close() through any of them closes it.
+ */
+class File
+{
+public:
+	File();
+	File(tHostFileHandle* apHandle);
+
+	int read();
+	int read(void* apBuffer, uint16_t aSize);
+	int peek();
+	int available();
+	bool seek(uint32_t aPosition);
+	uint32_t position();
+	uint32_t size();
+	size_t write(uint8_t aByte);
+	size_t write(const uint8_t* apBuffer, size_t aSize);
+	void flush();
+	void close();
+	const char* name();
+	bool isDirectory();
+	File openNextFile(uint8_t aMode = FILE_READ);
+	void rewindDirectory();
+	operator bool();
+
+protected:
+	tHostFileHandle* mpHandle;
+};
+
+/**
+ * The card, like the SD library's SDClass.
+ */
+class SDClass
+{
+public:
+	bool begin(uint8_t aCsPin = 0);
+	bool begin(uint32_t aClockHz, uint8_t aCsPin);
+	File open(const char* apPath, uint8_t aMode = FILE_READ);
+	File open(const String& arPath, uint8_t aMode = FILE_READ) { return open(arPath.c_str(), aMode); }
+	bool exists(const char* apPath);
+	bool exists(const String& arPath) { return exists(arPath.c_str()); }
+	bool remove(const char* apPath);
+	bool mkdir(const char* apPath);
+	bool rmdir(const char* apPath);
+};
+
+extern SDClass SD;
+
+#endif /* HOST_SD_H_ */
@@ -0,0 +1,64 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * Wire.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Host stand-in for the Arduino Wire (I2C) library. Devices are register
+ * maps kept by HostWire (see HostBackend.h), which tests and benchmarks
+ * set or script. Each transaction adds its simulated bus time to
+ * HostClock.
+ */
+
+#ifndef HOST_WIRE_H_
+#define HOST_WIRE_H_
+
+#include "Arduino.h"
+
+/**
+ * I2C bus, like the Wire library's TwoWire.
+ */
+class TwoWire
+{
+public:
+	TwoWire();
+	void begin();
+	void setClock(uint32_t aClockHz);
+	void beginTransmission(int aAddress);
+	size_t write(uint8_t aByte);
+	uint8_t endTransmission(bool aStop = true);
+	uint8_t requestFrom(int aAddress, int aCount, bool aStop = true);
+	int available();
+	int read();
+
+protected:
+	//Address of the transaction being built
+	uint8_t mAddress;
+	//Bytes written since beginTransmission()
+	uint8_t maTxBuffer[32];
+	uint8_t mTxCount;
+	//Bytes read by requestFrom() not yet taken by read()
+	uint8_t maRxBuffer[32];
+	uint8_t mRxCount;
+	uint8_t mRxIdx;
+};
+
+extern TwoWire Wire;
+
+#endif /* HOST_WIRE_H_ */
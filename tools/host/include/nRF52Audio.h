@@ -0,0 +1,161 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * nRF52Audio.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Host stand-in for the nRF52Audio library: WAV files read through the SD
+ * stand-in and an I2S player that mixes them into an IAudioSink instead of
+ * the I2S peripheral. Only 16-bit mono PCM files are played, which is what
+ * NSaber fonts hold.
+ */
+
+#ifndef HOST_NRF52AUDIO_H_
+#define HOST_NRF52AUDIO_H_
+
+#include "Arduino.h"
+#include "SD.h"
+#include "Sound/IAudioSink.h"
+
+//Channels the I2S player mixes
+#define I2S_PLAYER_CHANNELS (2)
+
+/**
+ * A WAV file on the card.
+ */
+class ISDWavFile
+{
+public:
+	virtual ~ISDWavFile() {}
+
+	virtual void Close() = 0;
+	virtual void Pause() = 0;
+	virtual bool IsEnded() = 0;
+	virtual void SeekStartOfData() = 0;
+	virtual void SetLooping(bool aLooping) = 0;
+	virtual void SetVolume(float aVolume) = 0;
+
+	/**
+	 * Adds the next samples, scaled by the file's volume, to a mix. Host
+	 * only, used by I2SWavPlayer.
+	 * Args:
+	 *  apMix - Mix to add to
+	 *  aNumSamples - Samples to add
+	 */
+	virtual void MixSamples(int32_t* apMix, uint16_t aNumSamples) = 0;
+};
+
+/**
+ * A WAV file played at an adjustable rate.
+ */
+class PitchShiftSDWavFile : public ISDWavFile
+{
+public:
+	/**
+	 * Constructor. Opens the file and reads its header.
+	 * Args:
+	 *  apPath - Path of the file on the card
+	 */
+	PitchShiftSDWavFile(const char* apPath);
+	virtual ~PitchShiftSDWavFile();
+
+	virtual void Close();
+	virtual void Pause();
+	virtual bool IsEnded();
+	virtual void SeekStartOfData();
+	virtual void SetLooping(bool aLooping);
+	virtual void SetVolume(float aVolume);
+	virtual void MixSamples(int32_t* apMix, uint16_t aNumSamples);
+
+	/**
+	 * Sets the pitch.
+	 * Args:
+	 *  aPitch - Pitch delta in octaves, 0.0 for normal speed
+	 */
+	void SetRate(float aPitch);
+
+protected:
+	/**
+	 * Refills the read buffer from the card.
+	 * Returns:
+	 *  TRUE if there are samples to play
+	 */
+	bool Fill();
+
+	File mFile;
+	uint32_t mDataStart;
+	uint32_t mDataEnd;
+	bool mLooping;
+	bool mPaused;
+	bool mEnded;
+	float mVolume;
+	//Playback position in the read buffer, 16.16 fixed point, and step per
+	//output sample at the file's own rate (mBaseStep) and at the pitch set
+	uint32_t mPos;
+	uint32_t mBaseStep;
+	uint32_t mStep;
+	int16_t maBuffer[256];
+	uint16_t mBufferCount;
+};
+
+/**
+ * Plays up to I2S_PLAYER_CHANNELS WAV files, mixed, into a sample sink.
+ */
+class I2SWavPlayer
+{
+public:
+	/**
+	 * Constructor. The pins are ignored on the host.
+	 */
+	I2SWavPlayer(int aMckPin, int aBclkPin, int aLrckPin, int aDinPin, int aSdPin);
+
+	void Init();
+	void StartPlayback();
+	void StopPlayback();
+
+	/**
+	 * Mixes as many samples as the sink has room for.
+	 */
+	void ContinuePlayback();
+
+	/**
+	 * Sets the file played on a channel.
+	 * Args:
+	 *  apFile - File to play, nullptr for none
+	 *  aChannel - Channel, 0 to I2S_PLAYER_CHANNELS - 1
+	 */
+	void SetWavFile(ISDWavFile* apFile, int aChannel);
+
+	bool IsEnded();
+	void SetVolume(float aVolume);
+
+	/**
+	 * Sets where the mix goes. Host only; without a sink, playback is
+	 * discarded.
+	 */
+	void SetSink(IAudioSink* apSink);
+
+protected:
+	ISDWavFile* mapFiles[I2S_PLAYER_CHANNELS];
+	IAudioSink* mpSink;
+	float mVolume;
+	bool mPlaying;
+};
+
+#endif /* HOST_NRF52AUDIO_H_ */
@@ -0,0 +1,261 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * BladeTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Frame timing and effects of the blade engine, sending to a timing
+ * driver on the host clock: frames every NSABER_BLADE_FRAME_MS, frames
+ * dropped rather than queued while a slow strip is still sending, the
+ * render time counters, the ignition and retraction wipes, wipes that
+ * turn round halfway, and the one black frame when the blade goes out.
+ *
+ * Usage:
+ *   BladeTest
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+
+//Pixels on the simulated strip
+#define BLADE_PIXELS (100)
+
+//Length of the wipes (milliseconds)
+#define WIPE_MS (300)
+
+//Time the loop takes between calls to Update() (microseconds)
+#define LOOP_STEP_US (100)
+
+//Pixels a wipe may be off by: the tip pixel, and a millisecond of rounding
+#define WIPE_SLACK_PIXELS (2)
+
+/**
+ * Calls Update() as a loop would, for a while.
+ * Args:
+ *  arEngine - Engine to update
+ *  aTimeMs - How long to run for
+ */
+static void RunFor(BladeEngine& arEngine, uint32_t aTimeMs)
+{
+	uint32_t lStartUs = micros();
+	while(micros() - lStartUs < aTimeMs * 1000)
+	{
+		arEngine.Update();
+		HostClock::Advance(LOOP_STEP_US);
+	}
+}
+
+/**
+ * Calls Update() until it sends a frame.
+ * Args:
+ *  arEngine - Engine to update
+ * Returns:
+ *  TRUE if a frame was sent within two frame times
+ */
+static bool NextFrame(BladeEngine& arEngine)
+{
+	uint32_t lStartUs = micros();
+	while(micros() - lStartUs < 2 * NSABER_BLADE_FRAME_MS * 1000)
+	{
+		if(arEngine.Update())
+		{
+			return true;
+		}
+		HostClock::Advance(LOOP_STEP_US);
+	}
+
+	return false;
+}
+
+/**
+ * Counts the lit pixels in the last frame sent.
+ */
+static uint16_t CountLit(TimingBladeDriver& arDriver)
+{
+	const tBladePixel* lpFrame = arDriver.GetFrame();
+	uint16_t lLit = 0;
+
+	for(uint16_t lIdx = 0; lIdx < arDriver.GetNumPixels(); lIdx++)
+	{
+		if(lpFrame[lIdx].mRed > 0 || lpFrame[lIdx].mGreen > 0 || lpFrame[lIdx].mBlue > 0)
+		{
+			lLit++;
+		}
+	}
+
+	return lLit;
+}
+
+/**
+ * Checks the lit length of the next frame against a wipe.
+ * Args:
+ *  arEngine - Engine to update
+ *  arDriver - Its driver
+ *  aFromPixels - Lit pixels at aFromMs
+ *  aFromMs - millis() the wipe was at aFromPixels
+ *  aRising - TRUE for an ignition, FALSE for a retraction
+ */
+static void CheckWipe(BladeEngine& arEngine, TimingBladeDriver& arDriver,
+                      int32_t aFromPixels, uint32_t aFromMs, bool aRising)
+{
+	HOST_CHECK(NextFrame(arEngine));
+
+	int32_t lMoved = (int32_t)(millis() - aFromMs) * BLADE_PIXELS / WIPE_MS;
+	int32_t lExpected = constrain(aRising ? aFromPixels + lMoved : aFromPixels - lMoved, 0, BLADE_PIXELS);
+	int32_t lLit = CountLit(arDriver);
+	if(abs(lLit - lExpected) > WIPE_SLACK_PIXELS)
+	{
+		printf("%u ms into the wipe: %d pixels lit, expected %d\n", (uint32_t)(millis() - aFromMs), lLit, lExpected);
+	}
+	HOST_CHECK(abs(lLit - lExpected) <= WIPE_SLACK_PIXELS);
+}
+
+/**
+ * Frame pacing with a strip that sends in no time, and the render counters.
+ */
+static void CheckPacing()
+{
+	TimingBladeDriver lDriver(BLADE_PIXELS);
+	BladeEngine lEngine(&lDriver);
+	tBladeTiming lTiming;
+	tBladeStats lStats;
+
+	lEngine.Ignite(WIPE_MS);
+	RunFor(lEngine, 1000);
+	lDriver.GetTiming(lTiming);
+	lEngine.GetStats(lStats);
+
+	printf("Fast strip: %u frames, %u-%u us apart, render max %u us, total %u us, %u busy skips\n",
+	       lTiming.mFrames, lTiming.mMinIntervalUs, lTiming.mMaxIntervalUs,
+	       lStats.mMaxRenderUs, lStats.mTotalRenderUs, lStats.mBusySkips);
+
+	HOST_CHECK(lStats.mFrames == lTiming.mFrames);
+	HOST_CHECK(lTiming.mFrames >= 1000 / NSABER_BLADE_FRAME_MS - 1);
+	HOST_CHECK(lTiming.mFrames <= 1000 / NSABER_BLADE_FRAME_MS + 1);
+	//On a frame boundary, give or take the millisecond and a loop step
+	HOST_CHECK(lTiming.mMinIntervalUs >= NSABER_BLADE_FRAME_MS * 1000 - 1000);
+	HOST_CHECK(lTiming.mMaxIntervalUs <= NSABER_BLADE_FRAME_MS * 1000 + 1000);
+	HOST_CHECK(0 == lStats.mBusySkips);
+
+	//The longest render is at least the average, and well inside a frame
+	HOST_CHECK((uint64_t)lStats.mMaxRenderUs * lStats.mFrames >= lStats.mTotalRenderUs);
+	HOST_CHECK(lStats.mMaxRenderUs < NSABER_BLADE_FRAME_MS * 1000);
+
+	lEngine.ResetStats();
+	lEngine.GetStats(lStats);
+	HOST_CHECK(0 == lStats.mFrames && 0 == lStats.mMaxRenderUs && 0 == lStats.mTotalRenderUs);
+}
+
+/**
+ * A strip that takes 1.5 frame times to send: every other frame is due
+ * while it is still busy and is dropped.
+ */
+static void CheckBusySkips()
+{
+	TimingBladeDriver lDriver(BLADE_PIXELS, NSABER_BLADE_FRAME_MS * 1500 / BLADE_PIXELS);
+	BladeEngine lEngine(&lDriver);
+	tBladeTiming lTiming;
+	tBladeStats lStats;
+
+	lEngine.Ignite(WIPE_MS);
+	RunFor(lEngine, 1000);
+	lDriver.GetTiming(lTiming);
+	lEngine.GetStats(lStats);
+
+	printf("Slow strip: %u frames, %u-%u us apart, %u busy skips\n",
+	       lTiming.mFrames, lTiming.mMinIntervalUs, lTiming.mMaxIntervalUs, lStats.mBusySkips);
+
+	HOST_CHECK(lStats.mFrames == lTiming.mFrames);
+	HOST_CHECK(lTiming.mMinIntervalUs >= 2 * NSABER_BLADE_FRAME_MS * 1000 - 1000);
+	HOST_CHECK(lTiming.mMaxIntervalUs <= 2 * NSABER_BLADE_FRAME_MS * 1000 + 1000);
+	HOST_CHECK(lStats.mBusySkips + 1 >= lStats.mFrames && lStats.mBusySkips <= lStats.mFrames + 1);
+}
+
+/**
+ * Wipe lengths, wipes that turn round halfway and the black frame.
+ */
+static void CheckWipes()
+{
+	TimingBladeDriver lDriver(BLADE_PIXELS);
+	BladeEngine lEngine(&lDriver);
+	tBladeTiming lTiming;
+
+	lEngine.SetFlickerDepth(0);
+
+	//Ignition from the base
+	lEngine.Ignite(WIPE_MS);
+	uint32_t lStartMs = millis();
+	for(int lFrame = 0; lFrame < 10; lFrame++)
+	{
+		CheckWipe(lEngine, lDriver, 0, lStartMs, true);
+	}
+
+	//Retract halfway through: carries on down from the lit length
+	uint32_t lTurnMs = millis();
+	int32_t lTurnPixels = CountLit(lDriver);
+	HOST_CHECK(lTurnPixels > WIPE_SLACK_PIXELS && lTurnPixels < BLADE_PIXELS - WIPE_SLACK_PIXELS);
+	lEngine.Retract(WIPE_MS);
+	HOST_CHECK(eeBladeRetracting == lEngine.GetState());
+	for(int lFrame = 0; lFrame < 5; lFrame++)
+	{
+		CheckWipe(lEngine, lDriver, lTurnPixels, lTurnMs, false);
+	}
+
+	//And ignite again before it is out
+	lTurnMs = millis();
+	lTurnPixels = CountLit(lDriver);
+	HOST_CHECK(lTurnPixels > WIPE_SLACK_PIXELS);
+	lEngine.Ignite(WIPE_MS);
+	HOST_CHECK(eeBladeIgniting == lEngine.GetState());
+	for(int lFrame = 0; lFrame < 5; lFrame++)
+	{
+		CheckWipe(lEngine, lDriver, lTurnPixels, lTurnMs, true);
+	}
+
+	RunFor(lEngine, WIPE_MS);
+	HOST_CHECK(eeBladeOn == lEngine.GetState());
+	HOST_CHECK(NextFrame(lEngine));
+	HOST_CHECK(BLADE_PIXELS == CountLit(lDriver));
+
+	//Full retraction, then one black frame and nothing more
+	lEngine.Retract(WIPE_MS);
+	lStartMs = millis();
+	for(int lFrame = 0; lFrame < 10; lFrame++)
+	{
+		CheckWipe(lEngine, lDriver, BLADE_PIXELS, lStartMs, false);
+	}
+	RunFor(lEngine, WIPE_MS);
+	HOST_CHECK(eeBladeOff == lEngine.GetState());
+	HOST_CHECK(0 == CountLit(lDriver));
+
+	lDriver.ResetTiming();
+	RunFor(lEngine, 200);
+	lDriver.GetTiming(lTiming);
+	HOST_CHECK(0 == lTiming.mFrames);
+}
+
+int main(int argc, char** argv)
+{
+	CheckPacing();
+	CheckBusySkips();
+	CheckWipes();
+
+	return HostTest::Result();
+}
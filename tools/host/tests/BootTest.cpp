@@ -0,0 +1,160 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * BootTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Time to ready with and without the BootSequence, on a card with the
+ * latency of an SPI card and the full test font. Finding every sound
+ * before the motion sensor is set up holds up ignition; the boot sequence
+ * leaves all but the first few for later and has to keep the boot sound
+ * playing while it finds them.
+ *
+ * Usage:
+ *   BootTest <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+
+//Samples the I2S player's sink holds, a little over 20 ms
+#define SINK_CAPACITY (1024)
+
+//Longest the pipelined boot may take to find the whole font (milliseconds)
+#define INDEX_TIMEOUT_MS (5000)
+
+static I2SWavPlayer* spI2SPlayer = nullptr;
+
+/**
+ * Pumps the I2S player, as the sketch does.
+ */
+static bool PumpI2S(uint32_t aDeadlineUs)
+{
+	spI2SPlayer->ContinuePlayback();
+	return false;
+}
+
+/**
+ * Selects the font, starts the boot sound and sets up the motion sensor
+ * one after the other.
+ * Returns:
+ *  Milliseconds until ready to ignite
+ */
+static uint32_t BootInOrder()
+{
+	HostAudioSink lSink(SINK_CAPACITY);
+	I2SWavPlayer lI2SPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lI2SPlayer);
+	MPU6050LiteTolData lTolerances = { 250, 200, 100, 1000, 5000 };
+	Mpu6050LiteMotionManager lMotion(&lTolerances);
+
+	lI2SPlayer.SetSink(&lSink);
+	lI2SPlayer.Init();
+	lI2SPlayer.StartPlayback();
+	lSndMgr.Init();
+
+	uint32_t lStart = millis();
+	HOST_CHECK(SD.begin(8000000, 11));
+	lSndMgr.SetFont(0);
+	HOST_CHECK(lSndMgr.PlaySound(SoundTypes::eeBootSnd));
+	lMotion.Init();
+
+	lI2SPlayer.StopPlayback();
+
+	return millis() - lStart;
+}
+
+/**
+ * Boots with a BootSequence on a run loop.
+ * Args:
+ *  arIndexedMs - Output parameter, milliseconds until the font is indexed
+ *  arGaps - Output parameter, audio gaps while booting
+ * Returns:
+ *  Milliseconds until ready to ignite
+ */
+static uint32_t BootPipelined(uint32_t& arIndexedMs, uint32_t& arGaps)
+{
+	HostAudioSink lSink(SINK_CAPACITY);
+	I2SWavPlayer lI2SPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lI2SPlayer);
+	MPU6050LiteTolData lTolerances = { 250, 200, 100, 1000, 5000 };
+	Mpu6050LiteMotionManager lMotion(&lTolerances);
+	BootSequence lBoot(&lSndMgr, &lMotion);
+
+	spI2SPlayer = &lI2SPlayer;
+	lI2SPlayer.SetSink(&lSink);
+	lI2SPlayer.Init();
+	lI2SPlayer.StartPlayback();
+	lSndMgr.Init();
+
+	FunctionTask lI2STask(PumpI2S);
+	SoundTask lSoundTask(&lSndMgr);
+	RunLoop lLoop;
+	lLoop.SetSleepEnabled(false);
+	lLoop.AddTask(&lI2STask, eeAudioPriority, 1000, 500);
+	lLoop.AddTask(&lSoundTask, eeAudioPriority, 1000, 500);
+	lLoop.AddTask(&lBoot, eeBackgroundPriority, 0, 2000);
+
+	HOST_CHECK(lBoot.Start(11, 8000000, 0));
+	uint32_t lStart = millis();
+	while(!lBoot.IsDone() && millis() - lStart < INDEX_TIMEOUT_MS)
+	{
+		lLoop.RunOnce();
+	}
+	HOST_CHECK(lBoot.IsDone());
+
+	lI2SPlayer.StopPlayback();
+	spI2SPlayer = nullptr;
+
+	tBootTimeline lTimeline;
+	lBoot.GetTimeline(lTimeline);
+	arIndexedMs = lTimeline.maStepMs[eeBootFontIndexed] - lTimeline.maStepMs[eeBootStarted];
+	arGaps = lSink.GetGaps();
+
+	return lTimeline.maStepMs[eeBootReady] - lTimeline.maStepMs[eeBootStarted];
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	HostSd::SetRoot(argv[1]);
+	HostSd::SetLatency(HostSd::GetSpiCardLatency());
+	HostWire::SetLatency(25, 22);
+
+	uint32_t lInOrderMs = BootInOrder();
+
+	uint32_t lIndexedMs = 0;
+	uint32_t lGaps = 0;
+	uint32_t lPipelinedMs = BootPipelined(lIndexedMs, lGaps);
+
+	printf("in order: ready at %u ms\n", lInOrderMs);
+	printf("boot sequence: ready at %u ms, font indexed at %u ms, %u audio gaps\n",
+	       lPipelinedMs, lIndexedMs, lGaps);
+
+	HOST_CHECK(lPipelinedMs < lInOrderMs);
+	HOST_CHECK(0 == lGaps);
+
+	return HostTest::Result();
+}
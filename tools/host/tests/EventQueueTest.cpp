@@ -0,0 +1,204 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * EventQueueTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * The event queue under a real producer and consumer running on separate
+ * threads, and the sound events of an ignition and a retraction.
+ *
+ * Usage:
+ *   EventQueueTest <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+#include <atomic>
+#include <thread>
+
+//Events pushed through the queue by the producer thread
+#define STRESS_EVENTS (2000000)
+
+//Events the producer thread gave up on when the queue was full
+static uint32_t sLost = 0;
+
+/**
+ * Pushes numbered events as fast as it can. The number goes in mTimeUs,
+ * since micros() is for the main thread only. Most events are retried
+ * until the queue takes them; every 16th is pushed once and may be lost,
+ * so the queue is kept full and also drops.
+ */
+static void Produce(SaberEventQueue* apQueue, std::atomic<bool>* apDone)
+{
+	tSaberEvent lEvent = {};
+	for(uint32_t lIdx = 0; lIdx < STRESS_EVENTS; lIdx++)
+	{
+		lEvent.mTimeUs = lIdx;
+		lEvent.mValue = (int16_t)lIdx;
+
+		if(0 == lIdx % 16)
+		{
+			sLost += apQueue->Push(lEvent) ? 0 : 1;
+		}
+		else
+		{
+			//Let the consumer in, even with a single core
+			while(!apQueue->Push(lEvent))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+	apDone->store(true);
+}
+
+/**
+ * Pops events on this thread while another thread pushes them, and checks
+ * every event either arrives whole and in order or is counted as dropped.
+ */
+static void TestThreads()
+{
+	static SaberEventQueue sQueue;
+	std::atomic<bool> lDone(false);
+	uint32_t lReceived = 0;
+	uint32_t lOutOfOrder = 0;
+	uint32_t lTorn = 0;
+	int64_t lLast = -1;
+
+	std::thread lProducer(Produce, &sQueue, &lDone);
+
+	tSaberEvent lEvent;
+	bool lDrained = false;
+	while(!lDrained)
+	{
+		//Check for the producer finishing before the last look at the queue
+		bool lProducerDone = lDone.load();
+
+		while(sQueue.Pop(lEvent))
+		{
+			lReceived++;
+			if((int64_t)lEvent.mTimeUs <= lLast)
+			{
+				lOutOfOrder++;
+			}
+			if(lEvent.mValue != (int16_t)lEvent.mTimeUs)
+			{
+				lTorn++;
+			}
+			lLast = lEvent.mTimeUs;
+		}
+
+		lDrained = lProducerDone;
+		std::this_thread::yield();
+	}
+	lProducer.join();
+
+	printf("threads: %u received, %u lost, %u pushes dropped, %u out of order, %u torn\n",
+	       lReceived, sLost, sQueue.GetDropped(), lOutOfOrder, lTorn);
+
+	HOST_CHECK(STRESS_EVENTS == lReceived + sLost);
+	HOST_CHECK(sQueue.GetDropped() >= sLost);
+	HOST_CHECK(0 == lOutOfOrder);
+	HOST_CHECK(0 == lTorn);
+}
+
+/**
+ * Counts sound started and ended events by sound type, emptying the queue.
+ */
+static void CountEvents(SaberEventQueue& arQueue, uint8_t* apStarted, uint8_t* apEnded)
+{
+	tSaberEvent lEvent;
+	while(arQueue.Pop(lEvent))
+	{
+		if(eeSoundStartedEvent == lEvent.mType)
+		{
+			apStarted[lEvent.mDetail]++;
+		}
+		else if(eeSoundEndedEvent == lEvent.mType)
+		{
+			apEnded[lEvent.mDetail]++;
+		}
+	}
+}
+
+/**
+ * Ignites and retracts on a voice engine and checks the power up, hum and
+ * power down sounds are each reported as started once, and the effects as
+ * ended.
+ */
+static void TestIgnition(const char* apCard)
+{
+	HostSd::SetRoot(apCard);
+
+	HostAudioSink lSink;
+	VoiceEngine lEngine(&lSink);
+	I2SWavPlayer lPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lPlayer);
+	SaberEventQueue lQueue;
+	uint8_t laStarted[SoundTypes::eeMaxSoundTypes] = {};
+	uint8_t laEnded[SoundTypes::eeMaxSoundTypes] = {};
+
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetFont(0);
+	lSndMgr.SetEventQueue(&lQueue);
+
+	HOST_CHECK(lSndMgr.Ignite());
+	for(int lMs = 0; lMs < 1500; lMs++)
+	{
+		lSndMgr.ContinuePlay();
+		HostClock::Advance(1000);
+		CountEvents(lQueue, laStarted, laEnded);
+	}
+
+	HOST_CHECK(lSndMgr.Retract());
+	for(int lMs = 0; lMs < 1500; lMs++)
+	{
+		lSndMgr.ContinuePlay();
+		HostClock::Advance(1000);
+		CountEvents(lQueue, laStarted, laEnded);
+	}
+	lSndMgr.SetVoiceEngine(nullptr);
+
+	printf("ignition: power up started %u ended %u, hum started %u, power down started %u ended %u\n",
+	       laStarted[SoundTypes::eePowerUpSnd], laEnded[SoundTypes::eePowerUpSnd],
+	       laStarted[SoundTypes::eeHumSnd],
+	       laStarted[SoundTypes::eePowerDownSnd], laEnded[SoundTypes::eePowerDownSnd]);
+
+	HOST_CHECK(1 == laStarted[SoundTypes::eePowerUpSnd]);
+	HOST_CHECK(1 == laEnded[SoundTypes::eePowerUpSnd]);
+	HOST_CHECK(1 == laStarted[SoundTypes::eeHumSnd]);
+	HOST_CHECK(1 == laStarted[SoundTypes::eePowerDownSnd]);
+	HOST_CHECK(1 == laEnded[SoundTypes::eePowerDownSnd]);
+	HOST_CHECK(0 == lQueue.GetDropped());
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	TestThreads();
+	TestIgnition(argv[1]);
+
+	return HostTest::Result();
+}
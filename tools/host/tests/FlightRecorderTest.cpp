@@ -0,0 +1,249 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * FlightRecorderTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * The flight recorder writing to the card alongside the voice engine. A
+ * scripted sensor swings the saber for 20 s while the run loop plays the
+ * hum and swings, and the recorder logs every reading. With the card
+ * writing at its usual speed, the writes must fit in the gaps the audio
+ * leaves: no gaps in the output, no records dropped. With a long stall on
+ * some writes, the output may run dry during the pass with the stall, as
+ * it catches up, but the recorder must back off rather than cause gaps
+ * anywhere else, and get writing again.
+ *
+ * Usage:
+ *   FlightRecorderTest <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+
+//Address of the MPU-6050
+#define MPU_ADDRESS (0x68)
+
+//Register of the gyro's X axis, and the value a swing reads as
+#define MPU_GYRO_XOUT (0x43)
+#define MPU_SWING_VALUE (0x40)
+
+//Number of swings, and how long each lasts (milliseconds)
+#define SWINGS (60)
+#define SWING_MS (80)
+
+//Length of a session (milliseconds)
+#define SESSION_MS (20000)
+
+//Samples the output holds, about 23 ms as on the board
+#define SINK_CAPACITY (1024)
+
+//A card stopping to erase: 40 ms on every 20th write
+#define STALL_US (40000)
+#define STALL_EVERY (20)
+
+//Host time between passes, not simulated, that counts as the test itself
+//being descheduled. The host clock runs on, so the output can run dry.
+#define HOST_STALL_US (10000)
+
+static tHostWireStep saScript[SWINGS * 2];
+static NECSoundManager* spSndMgr = nullptr;
+static AMotionManager* spMotion = nullptr;
+
+/**
+ * What happened in a session.
+ */
+struct tSession
+{
+	tFlightRecorderStats mRecorder;
+	//Times the output ran empty
+	uint32_t mGaps;
+	//Of those, the ones in passes with neither a slow write nor a host stall
+	uint32_t mOtherGaps;
+	//From the first slow write to the next write, 0 if there was none
+	uint32_t mResumeMs;
+	//Times the host held the test up for longer than HOST_STALL_US
+	uint32_t mHostStalls;
+};
+
+/**
+ * The sketch's loop: plays a swing when one begins.
+ */
+static bool PollSwing(uint32_t aDeadlineUs)
+{
+	static bool sWasSwing = false;
+
+	bool lIsSwing = spMotion->IsSwing();
+	if(lIsSwing && !sWasSwing)
+	{
+		spSndMgr->PlayRandomSound(SoundTypes::eeSwingSnd);
+	}
+	sWasSwing = lIsSwing;
+
+	return false;
+}
+
+/**
+ * Runs a session with the recorder on.
+ * Args:
+ *  arLatency - Card latency
+ *  arSession - Output parameter, populated with what happened
+ */
+static void RunSession(const tHostSdLatency& arLatency, tSession& arSession)
+{
+	HostSd::SetLatency(arLatency);
+
+	HostAudioSink lSink(SINK_CAPACITY);
+	VoiceEngine lEngine(&lSink);
+	I2SWavPlayer lPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lPlayer);
+	MPU6050LiteTolData lTolerances = { 250, 200, 100, 1000, 5000 };
+	Mpu6050LiteMotionManager lMotion(&lTolerances);
+	FlightRecorder lRecorder(&lEngine);
+	spSndMgr = &lSndMgr;
+	spMotion = &lMotion;
+
+	lMotion.Init();
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetFont(0);
+	lSndMgr.PlaySound(SoundTypes::eeHumSnd);
+
+	RunLoop lLoop;
+	SoundTask lSoundTask(&lSndMgr);
+	MotionTask lMotionTask(&lMotion);
+	FunctionTask lPollTask(PollSwing);
+	lLoop.AddTask(&lSoundTask, eeAudioPriority, 1000, 500);
+	lLoop.AddTask(&lMotionTask, eeMotionPriority, 1000, 1000);
+	lLoop.AddTask(&lPollTask, eeMotionPriority, 2000, 200);
+	lLoop.AddTask(&lRecorder, eeBackgroundPriority, 0, 5000);
+
+	HOST_CHECK(lRecorder.Start("flight.nfl"));
+	lMotion.SetRecorder(&lRecorder);
+	HostWire::SetScript(saScript, SWINGS * 2);
+
+	uint32_t lStartMs = millis();
+	uint32_t lSlowMs = 0;
+	uint32_t lSlowSectors = 0;
+	uint64_t lPassUs = HostClock::GetUs();
+	uint64_t lPassAdvancedUs = HostClock::GetAdvancedUs();
+	uint32_t lGaps = 0;
+	uint32_t lSlowWrites = 0;
+	arSession.mResumeMs = 0;
+	arSession.mHostStalls = 0;
+	arSession.mOtherGaps = 0;
+	while(millis() - lStartMs < SESSION_MS)
+	{
+		lLoop.RunOnce();
+
+		bool lHostStall = false;
+		uint64_t lNowUs = HostClock::GetUs();
+		uint64_t lAdvancedUs = HostClock::GetAdvancedUs();
+		if((lNowUs - lPassUs) - (lAdvancedUs - lPassAdvancedUs) > HOST_STALL_US)
+		{
+			arSession.mHostStalls++;
+			lHostStall = true;
+		}
+		lPassUs = lNowUs;
+		lPassAdvancedUs = lAdvancedUs;
+
+		tFlightRecorderStats lStats;
+		lRecorder.GetStats(lStats);
+		if(lSink.GetGaps() != lGaps && lStats.mSlowWrites == lSlowWrites && !lHostStall)
+		{
+			arSession.mOtherGaps += lSink.GetGaps() - lGaps;
+		}
+		lGaps = lSink.GetGaps();
+		lSlowWrites = lStats.mSlowWrites;
+
+		if(0 == lSlowMs && lStats.mSlowWrites > 0)
+		{
+			lSlowMs = millis();
+			lSlowSectors = lStats.mSectorsWritten;
+		}
+		else if(0 != lSlowMs && 0 == arSession.mResumeMs && lStats.mSectorsWritten > lSlowSectors)
+		{
+			arSession.mResumeMs = millis() - lSlowMs;
+		}
+	}
+
+	//Stopping writes out the rest with no one feeding the audio, so count
+	//the gaps first
+	arSession.mGaps = lSink.GetGaps();
+	lMotion.SetRecorder(nullptr);
+	lRecorder.GetStats(arSession.mRecorder);
+	lRecorder.Stop();
+	lSndMgr.SetVoiceEngine(nullptr);
+
+	printf("%u records, %u dropped, %u sectors, %u deferrals, %u slow writes, longest write %u us\n",
+	       arSession.mRecorder.mRecords, arSession.mRecorder.mDropped, arSession.mRecorder.mSectorsWritten,
+	       arSession.mRecorder.mDeferrals, arSession.mRecorder.mSlowWrites, arSession.mRecorder.mMaxWriteUs);
+	printf("%u audio gaps, %u outside a slow write or host stall, %u host stalls",
+	       arSession.mGaps, arSession.mOtherGaps, arSession.mHostStalls);
+	if(arSession.mRecorder.mSlowWrites > 0)
+	{
+		printf(", writes resumed %u ms after the first slow one", arSession.mResumeMs);
+	}
+	printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	HostSd::SetRoot(argv[1]);
+	HostSd::SetLatency(HostSd::GetSpiCardLatency());
+	//400 kHz I2C: about 22 us per byte plus the address
+	HostWire::SetLatency(25, 22);
+	HOST_CHECK(SD.begin(8000000, 11));
+
+	//Swings 150 to 500 ms apart
+	uint32_t lTimeMs = 300;
+	for(int lIdx = 0; lIdx < SWINGS; lIdx++)
+	{
+		saScript[lIdx * 2] = { lTimeMs, MPU_ADDRESS, MPU_GYRO_XOUT, MPU_SWING_VALUE };
+		saScript[lIdx * 2 + 1] = { lTimeMs + SWING_MS, MPU_ADDRESS, MPU_GYRO_XOUT, 0 };
+		lTimeMs += 150 + (lIdx * 97) % 350;
+	}
+
+	tSession lSession;
+
+	printf("Card at SPI speed:\n");
+	RunSession(HostSd::GetSpiCardLatency(), lSession);
+	HOST_CHECK(lSession.mRecorder.mSectorsWritten > 0);
+	HOST_CHECK(0 == lSession.mRecorder.mWriteErrors);
+	HOST_CHECK(0 == lSession.mRecorder.mDropped);
+	HOST_CHECK(0 == lSession.mRecorder.mSlowWrites);
+	HOST_CHECK(0 == lSession.mOtherGaps);
+
+	tHostSdLatency lStalling = HostSd::GetSpiCardLatency();
+	lStalling.mStallUs = STALL_US;
+	lStalling.mStallEvery = STALL_EVERY;
+
+	printf("Card stalling %u ms every %u writes:\n", STALL_US / 1000, STALL_EVERY);
+	RunSession(lStalling, lSession);
+	HOST_CHECK(lSession.mRecorder.mSlowWrites > 0);
+	HOST_CHECK(0 == lSession.mOtherGaps);
+	HOST_CHECK(lSession.mResumeMs > 0 && lSession.mResumeMs < 5000);
+
+	return HostTest::Result();
+}
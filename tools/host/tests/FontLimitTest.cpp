@@ -0,0 +1,196 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * FontLimitTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Fonts at the largest size the layouts allow: every sound type of a CFX
+ * font full, 16 swings, lswings and hswings and all. Such a font must
+ * fit the font descriptor and play every sound, both packed and from its
+ * directory, and one more sound than that must be refused.
+ *
+ * Usage:
+ *   FontLimitTest <necpack> <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+#include <sys/stat.h>
+
+//Samples in each test sound
+#define SOUND_SAMPLES (441)
+
+/**
+ * Writes a sound of every name a layout has into a directory.
+ * Returns:
+ *  Number of sounds written, 0 if one could not be
+ */
+static uint16_t WriteFullFont(const char* apDir, const FontLayout::tFontLayout& arLayout)
+{
+	int16_t laSamples[SOUND_SAMPLES];
+	char laPath[1024];
+	char laName[FONT_LAYOUT_MAX_NAME];
+	uint16_t lNumSounds = 0;
+
+	for(int lIdx = 0; lIdx < SOUND_SAMPLES; lIdx++)
+	{
+		laSamples[lIdx] = (int16_t)(8000 * sin(2 * M_PI * 441 * lIdx / 44100));
+	}
+
+	mkdir(apDir, 0755);
+	for(int lType = 0; lType < arLayout.mNumNaming; lType++)
+	{
+		const FontLayout::tSoundNaming& lrNaming = arLayout.mpNaming[lType];
+		for(uint16_t lIdx = 0; lIdx < lrNaming.mMaxCount; lIdx++)
+		{
+			FontLayout::FormatName(lrNaming, lIdx, laName);
+			snprintf(laPath, sizeof(laPath), "%s/%s", apDir, laName);
+			if(!HostFont::WriteWav(laPath, laSamples, SOUND_SAMPLES, 44100))
+			{
+				return 0;
+			}
+			lNumSounds++;
+		}
+	}
+
+	return lNumSounds;
+}
+
+/**
+ * Plays every sound a layout names from the selected font.
+ * Returns:
+ *  Number of sounds that played
+ */
+static uint16_t PlayAll(NECSoundManager& arSndMgr, HostAudioSink& arSink, const FontLayout::tFontLayout& arLayout)
+{
+	uint16_t lPlayed = 0;
+
+	for(int lType = 0; lType < arLayout.mNumNaming; lType++)
+	{
+		const FontLayout::tSoundNaming& lrNaming = arLayout.mpNaming[lType];
+		for(uint16_t lIdx = 0; lIdx < lrNaming.mMaxCount; lIdx++)
+		{
+			if(arSndMgr.PlaySound(lrNaming.mSoundType, lIdx))
+			{
+				lPlayed++;
+			}
+			else
+			{
+				printf("%s %u did not play\n", lrNaming.mpStem, lIdx);
+			}
+			arSink.Play(NSABER_MIX_BLOCK_SAMPLES);
+			arSndMgr.ContinuePlay();
+		}
+	}
+
+	return lPlayed;
+}
+
+/**
+ * The descriptor holds a full font of each layout, and no more.
+ */
+static void CheckDescriptor()
+{
+	const SoundTypes::EChannelMapType laLayouts[] =
+	{
+		SoundTypes::eeClassicNEC, SoundTypes::eeClassicPlecter, SoundTypes::eeCFX
+	};
+	FontDescriptor lFont;
+
+	for(SoundTypes::EChannelMapType lLayoutType : laLayouts)
+	{
+		const FontLayout::tFontLayout& lrLayout = FontLayout::GetLayout(lLayoutType);
+		uint8_t laCounts[SoundTypes::eeMaxSoundTypes] = {0};
+		for(int lType = 0; lType < lrLayout.mNumNaming; lType++)
+		{
+			laCounts[lrLayout.mpNaming[lType].mSoundType] = lrLayout.mpNaming[lType].mMaxCount;
+		}
+
+		HOST_CHECK(lFont.SetCounts(laCounts));
+		for(int lType = 0; lType < lrLayout.mNumNaming; lType++)
+		{
+			const FontLayout::tSoundNaming& lrNaming = lrLayout.mpNaming[lType];
+			HOST_CHECK(lrNaming.mMaxCount == lFont.GetCount(lrNaming.mSoundType));
+		}
+	}
+
+	//One over the limit is refused, and cut short
+	uint8_t laCounts[SoundTypes::eeMaxSoundTypes] = {0};
+	laCounts[SoundTypes::eeSwingSnd] = MAX_SWING_SOUNDS;
+	laCounts[SoundTypes::eeClashSnd] = NSABER_MAX_FONT_SOUNDS - MAX_SWING_SOUNDS;
+	HOST_CHECK(lFont.SetCounts(laCounts));
+	laCounts[SoundTypes::eeHumSnd] = 1;
+	HOST_CHECK(!lFont.SetCounts(laCounts));
+	HOST_CHECK(0 == lFont.GetCount(SoundTypes::eeHumSnd));
+	HOST_CHECK(MAX_SWING_SOUNDS == lFont.GetCount(SoundTypes::eeSwingSnd));
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 3)
+	{
+		fprintf(stderr, "Usage: %s <necpack> <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	const FontLayout::tFontLayout& lrLayout = FontLayout::GetLayout(SoundTypes::eeCFX);
+	char laCard[512];
+	char laPath[2048];
+
+	CheckDescriptor();
+
+	//Font 1 only packed, font 2 only loose
+	snprintf(laCard, sizeof(laCard), "%s/full", argv[2]);
+	mkdir(laCard, 0755);
+	snprintf(laPath, sizeof(laPath), "%s/cfxsrc", laCard);
+	uint16_t lNumSounds = WriteFullFont(laPath, lrLayout);
+	printf("Full CFX font: %u sounds, limit %u\n", lNumSounds, (unsigned)NSABER_MAX_FONT_SOUNDS);
+	HOST_CHECK(lNumSounds > 64);
+	HOST_CHECK(lNumSounds <= NSABER_MAX_FONT_SOUNDS);
+
+	snprintf(laPath, sizeof(laPath), "\"%s\" --layout cfx \"%s/cfxsrc\" \"%s/cfxfont1.nfp\" > /dev/null",
+	         argv[1], laCard, laCard);
+	HOST_CHECK(0 == system(laPath));
+	snprintf(laPath, sizeof(laPath), "%s/cfxfont2", laCard);
+	HOST_CHECK(lNumSounds == WriteFullFont(laPath, lrLayout));
+
+	HostSd::SetRoot(laCard);
+	HostAudioSink lSink(1024, false);
+	VoiceEngine lEngine(&lSink);
+	I2SWavPlayer lPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lPlayer);
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetFontLayout(SoundTypes::eeCFX);
+	lSndMgr.SetFontDirNameBase("cfxfont");
+
+	lSndMgr.SetFont(0);
+	uint16_t lPlayed = PlayAll(lSndMgr, lSink, lrLayout);
+	printf("Packed: %u of %u sounds played\n", lPlayed, lNumSounds);
+	HOST_CHECK(lNumSounds == lPlayed);
+
+	lSndMgr.SetFont(1);
+	lPlayed = PlayAll(lSndMgr, lSink, lrLayout);
+	printf("Loose: %u of %u sounds played\n", lPlayed, lNumSounds);
+	HOST_CHECK(lNumSounds == lPlayed);
+
+	lSndMgr.SetVoiceEngine(nullptr);
+
+	return HostTest::Result();
+}
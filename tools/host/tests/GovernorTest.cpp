@@ -0,0 +1,145 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * GovernorTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * The quality governor under a simulated motion load: a motion task that
+ * takes a set time out of every millisecond, with the voice engine
+ * serviced at audio priority every millisecond as in the sketch. The load
+ * and the loop's sleep are added to the host clock rather than spent, so
+ * the test runs faster than real time.
+ *
+ * Usage:
+ *   GovernorTest
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+
+//Motion task period at full quality and when slowed down
+#define MOTION_PERIOD_US (1000)
+#define SLOW_MOTION_PERIOD_US (2000)
+
+//Governor period
+#define GOVERNOR_PERIOD_US (50000)
+
+static uint32_t sLoadUs = 0;
+static VoiceEngine* spEngine = nullptr;
+
+/**
+ * Stands in for the motion manager, taking sLoadUs each run.
+ */
+static bool RunMotion(uint32_t aDeadlineUs)
+{
+	HostClock::Advance(sLoadUs);
+	return false;
+}
+
+/**
+ * Services the voice engine.
+ */
+static bool RunAudio(uint32_t aDeadlineUs)
+{
+	spEngine->Service();
+	return false;
+}
+
+/**
+ * Runs the loop with a motion load for a while.
+ * Args:
+ *  arLoop - Run loop with the tasks
+ *  arGovernor - Governor to watch
+ *  aLoadUs - Time the motion task takes each run
+ *  aMs - How long to run
+ *  apName - Name of the load to print
+ * Returns:
+ *  Milliseconds until the governor first reached the slowest level, or
+ *  aMs if it didn't
+ */
+static uint32_t RunLoad(RunLoop& arLoop, QualityGovernor& arGovernor, uint32_t aLoadUs, uint32_t aMs, const char* apName)
+{
+	sLoadUs = aLoadUs;
+	uint32_t lStart = millis();
+	uint32_t lSlowestMs = aMs;
+
+	while(millis() - lStart < aMs)
+	{
+		arLoop.RunOnce();
+		if(eeQualitySlowMotion == arGovernor.GetLevel() && aMs == lSlowestMs)
+		{
+			lSlowestMs = millis() - lStart;
+		}
+	}
+
+	tGovernorStats lStats;
+	arGovernor.GetStats(lStats);
+	printf("%s load (%u us per run): level %u, headroom %u%%, %u steps down, %u up, "
+	       "%u runs before the next step up\n",
+	       apName, aLoadUs, lStats.mLevel, lStats.mHeadroomPct, lStats.mStepsDown, lStats.mStepsUp,
+	       lStats.mRecoverRuns);
+
+	return lSlowestMs;
+}
+
+int main(int argc, char** argv)
+{
+	HostAudioSink lSink;
+	VoiceEngine lEngine(&lSink);
+	spEngine = &lEngine;
+
+	RunLoop lLoop;
+	FunctionTask lAudio(RunAudio);
+	FunctionTask lMotion(RunMotion);
+	QualityGovernor lGovernor(lLoop, &lEngine);
+
+	lLoop.AddTask(&lAudio, eeAudioPriority, 1000, 500);
+	lLoop.AddTask(&lMotion, eeMotionPriority, MOTION_PERIOD_US, 1000);
+	lLoop.AddTask(&lGovernor, eeMotionPriority, GOVERNOR_PERIOD_US, 100);
+	lGovernor.SetMotionTask(&lMotion, MOTION_PERIOD_US, SLOW_MOTION_PERIOD_US);
+
+	tGovernorStats lStats;
+
+	//Plenty of headroom, nothing changes
+	RunLoad(lLoop, lGovernor, 200, 2000, "light");
+	lGovernor.GetStats(lStats);
+	HOST_CHECK(eeQualityFull == lStats.mLevel);
+	HOST_CHECK(0 == lStats.mStepsDown);
+
+	//Too much at 1 ms, fine at 2 ms. Steps down one level per run to slow
+	//motion, then every try at stepping up fails and waits twice as long.
+	uint32_t lSlowestMs = RunLoad(lLoop, lGovernor, 930, 12000, "heavy");
+	lGovernor.GetStats(lStats);
+	printf("heavy load reached slow motion after %u ms\n", lSlowestMs);
+	HOST_CHECK(lSlowestMs <= 4 * GOVERNOR_PERIOD_US / 1000);
+	HOST_CHECK(eeQualitySlowMotion == lStats.mLevel || eeQualityFewerVoices == lStats.mLevel);
+	HOST_CHECK(lStats.mRecoverRuns >= 4 * NSABER_GOVERNOR_RECOVER_RUNS);
+	//With the back off, a handful of failed step ups at most
+	HOST_CHECK(lStats.mStepsUp <= 5);
+
+	//Load gone, back to full quality. The first step up waits out the back
+	//off, and each step only counts as held after the same wait, so this
+	//takes up to a back off per level.
+	RunLoad(lLoop, lGovernor, 100, 40000, "light again");
+	lGovernor.GetStats(lStats);
+	HOST_CHECK(eeQualityFull == lStats.mLevel);
+
+	return HostTest::Result();
+}
@@ -0,0 +1,69 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * HostTest.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Checks for the host tests. A failed check prints where it failed and
+ * makes the test exit with an error, but the test carries on so one run
+ * shows every failure.
+ */
+
+#ifndef HOSTTEST_H_
+#define HOSTTEST_H_
+
+#include <stdio.h>
+
+/**
+ * Checks a condition.
+ */
+#define HOST_CHECK(aCondition) HostTest::Check((aCondition), #aCondition, __FILE__, __LINE__)
+
+namespace HostTest
+{
+
+inline int& Failures()
+{
+	static int sFailures = 0;
+	return sFailures;
+}
+
+inline bool Check(bool aCondition, const char* apText, const char* apFile, int aLine)
+{
+	if(!aCondition)
+	{
+		printf("%s:%d: check failed: %s\n", apFile, aLine, apText);
+		Failures()++;
+	}
+
+	return aCondition;
+}
+
+/**
+ * Gets the exit code of the test: 0 if every check passed.
+ */
+inline int Result()
+{
+	printf("%s\n", 0 == Failures() ? "PASSED" : "FAILED");
+	return 0 == Failures() ? 0 : 1;
+}
+
+} //namespace HostTest
+
+#endif /* HOSTTEST_H_ */
@@ -0,0 +1,229 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * IgniteTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Ignition and retraction on the voice engine. Ignite() schedules the hum
+ * to come in the overlap before the end of the power up sound, counted
+ * from the power up's GetLengthSamples(): it must start on that sample,
+ * once, and loop on from there without a gap. Retract() has the hum stop
+ * the overlap after the power down starts.
+ *
+ * The test font is silent apart from marks on the first and last sample
+ * of the power up and power down, and a hum of a steady level with a mark
+ * on its first sample, so every output sample says which voices played it.
+ *
+ * Usage:
+ *   IgniteTest <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+#include <sys/stat.h>
+
+//Sound lengths, none a whole number of mix blocks or sectors
+#define POWER_UP_SAMPLES (20011)
+#define POWER_DOWN_SAMPLES (9007)
+#define HUM_SAMPLES (4409)
+
+//Overlaps, in milliseconds and samples
+#define IGNITE_OVERLAP_MS (50)
+#define IGNITE_OVERLAP (IGNITE_OVERLAP_MS * NSABER_OUTPUT_SAMPLE_RATE / 1000)
+#define RETRACT_OVERLAP_MS (30)
+#define RETRACT_OVERLAP (RETRACT_OVERLAP_MS * NSABER_OUTPUT_SAMPLE_RATE / 1000)
+
+//Marks on the first and last samples of the power up and power down
+#define POWER_UP_MARK (12000)
+#define POWER_DOWN_MARK (-12000)
+#define LAST_MARK (3000)
+
+//The hum's level, and the mark on its first sample
+#define HUM_LEVEL (1000)
+#define HUM_MARK (2000)
+
+//Sample the saber is retracted on, a while into the hum
+#define RETRACT_SAMPLE (POWER_UP_SAMPLES + 3 * HUM_SAMPLES + 1234)
+
+//Samples of output captured
+#define CAPTURE_SAMPLES (RETRACT_SAMPLE + POWER_DOWN_SAMPLES + 4096)
+
+/**
+ * Writes a sound to the font.
+ */
+static bool WriteSound(const char* apDir, const char* apName, int16_t aLevel, int16_t aFirst, int16_t aLast,
+		               uint32_t aNumSamples, bool aLooping)
+{
+	static int16_t saSamples[POWER_UP_SAMPLES];
+	char laPath[1024];
+
+	for(uint32_t lIdx = 0; lIdx < aNumSamples; lIdx++)
+	{
+		saSamples[lIdx] = aLevel;
+	}
+	saSamples[0] = aFirst;
+	saSamples[aNumSamples - 1] = aLast;
+	snprintf(laPath, sizeof(laPath), "%s/%s", apDir, apName);
+
+	return HostFont::WriteWav(laPath, saSamples, aNumSamples, NSABER_OUTPUT_SAMPLE_RATE, 0, aLooping ? aNumSamples : 0);
+}
+
+/**
+ * Counts the sound started events waiting for a sound type, and empties
+ * the queue.
+ */
+static uint32_t CountStarted(SaberEventQueue& arEvents, SoundTypes::ESoundTypes aSoundType)
+{
+	uint32_t lCount = 0;
+	tSaberEvent lEvent;
+	while(arEvents.Pop(lEvent))
+	{
+		lCount += eeSoundStartedEvent == lEvent.mType && aSoundType == lEvent.mDetail;
+	}
+
+	return lCount;
+}
+
+/**
+ * Returns what the hum adds to an output sample while it plays.
+ * Args:
+ *  aAt - Output sample
+ *  aHumAt - Output sample the hum started on
+ */
+static int32_t HumAt(uint32_t aAt, uint32_t aHumAt)
+{
+	return 0 == (aAt - aHumAt) % HUM_SAMPLES ? HUM_MARK : HUM_LEVEL;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	char laCard[512];
+	char laFontDir[1024];
+	snprintf(laCard, sizeof(laCard), "%s/ignite", argv[1]);
+	snprintf(laFontDir, sizeof(laFontDir), "%s/necfont1", laCard);
+	mkdir(laCard, 0755);
+	mkdir(laFontDir, 0755);
+	HOST_CHECK(WriteSound(laFontDir, "out01.wav", 0, POWER_UP_MARK, LAST_MARK, POWER_UP_SAMPLES, false));
+	HOST_CHECK(WriteSound(laFontDir, "in01.wav", 0, POWER_DOWN_MARK, LAST_MARK, POWER_DOWN_SAMPLES, false));
+	HOST_CHECK(WriteSound(laFontDir, "hum01.wav", HUM_LEVEL, HUM_MARK, HUM_LEVEL, HUM_SAMPLES, true));
+	HostSd::SetRoot(laCard);
+	HOST_CHECK(SD.begin(8000000, 11));
+
+	static int16_t saCapture[CAPTURE_SAMPLES];
+	HostAudioSink lSink(1024, false);
+	VoiceEngine lEngine(&lSink);
+	I2SWavPlayer lPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lPlayer);
+	SaberEventQueue lEvents;
+
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetEventQueue(&lEvents);
+	lSndMgr.SetFont(0);
+	CountStarted(lEvents, SoundTypes::eeHumSnd);
+	lSink.SetCapture(saCapture, CAPTURE_SAMPLES);
+
+	//The power up is the only voice playing, whichever channel it is on
+	HOST_CHECK(lSndMgr.Ignite(IGNITE_OVERLAP_MS));
+	uint32_t lPowerUpLength = lEngine.GetVoice(0)->GetLengthSamples();
+	for(uint8_t lChannel = 1; lChannel < NSABER_MAX_VOICES; lChannel++)
+	{
+		lPowerUpLength = max(lPowerUpLength, lEngine.GetVoice(lChannel)->GetLengthSamples());
+	}
+	HOST_CHECK(POWER_UP_SAMPLES == lPowerUpLength);
+
+	uint32_t lRetractAt = 0;
+	uint32_t lHumEvents = 0;
+	while(lSink.GetCaptured() < CAPTURE_SAMPLES)
+	{
+		if(0 == lRetractAt && lSink.GetWritten() >= RETRACT_SAMPLE)
+		{
+			lHumEvents += CountStarted(lEvents, SoundTypes::eeHumSnd);
+			lRetractAt = lSink.GetWritten();
+			HOST_CHECK(lSndMgr.Retract(RETRACT_OVERLAP_MS));
+		}
+		lSink.Play(NSABER_MIX_BLOCK_SAMPLES);
+		lSndMgr.ContinuePlay();
+	}
+	lHumEvents += CountStarted(lEvents, SoundTypes::eeHumSnd);
+	lSndMgr.SetVoiceEngine(nullptr);
+
+	//Every sample is the sum of the voices that should be playing it
+	uint32_t lHumAt = POWER_UP_SAMPLES - IGNITE_OVERLAP;
+	uint32_t lHumEnd = lRetractAt + RETRACT_OVERLAP;
+	uint32_t lWrong = 0;
+	uint32_t lFirstWrong = 0;
+	for(uint32_t lIdx = 0; lIdx < CAPTURE_SAMPLES; lIdx++)
+	{
+		int32_t lExpected = 0;
+		if(0 == lIdx)
+		{
+			lExpected += POWER_UP_MARK;
+		}
+		else if(POWER_UP_SAMPLES - 1 == lIdx)
+		{
+			lExpected += LAST_MARK;
+		}
+
+		if(lIdx >= lHumAt && lIdx < lHumEnd)
+		{
+			lExpected += HumAt(lIdx, lHumAt);
+		}
+
+		if(lRetractAt == lIdx)
+		{
+			lExpected += POWER_DOWN_MARK;
+		}
+		else if(lRetractAt + POWER_DOWN_SAMPLES - 1 == lIdx)
+		{
+			lExpected += LAST_MARK;
+		}
+
+		if(saCapture[lIdx] != lExpected)
+		{
+			if(0 == lWrong)
+			{
+				lFirstWrong = lIdx;
+			}
+			lWrong++;
+		}
+	}
+
+	printf("power up %u samples, hum due at %u, retracted at %u, hum due to stop at %u: "
+	       "%u samples wrong from %u, %u hum started events\n",
+	       lPowerUpLength, lHumAt, lRetractAt, lHumEnd, lWrong, lFirstWrong, lHumEvents);
+	if(lWrong > 0)
+	{
+		for(uint32_t lIdx = lFirstWrong > 4 ? lFirstWrong - 4 : 0; lIdx < lFirstWrong + 4; lIdx++)
+		{
+			printf("  %u: %d\n", lIdx, saCapture[lIdx]);
+		}
+	}
+
+	HOST_CHECK(0 == lWrong);
+	HOST_CHECK(1 == lHumEvents);
+
+	return HostTest::Result();
+}
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * LatencyTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Motion-to-sound latency on the voice engine, by stage. A scripted
+ * sensor swings the saber every few hundred milliseconds. The run loop
+ * updates the motion manager every millisecond, which reads the sensor
+ * every 5 ms over a 400 kHz bus. The sketch polls for swings every 2 ms
+ * and plays one, and the telemetry traces each swing until its first sample
+ * leaves the output buffer.
+ *
+ * Usage:
+ *   LatencyTest <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+
+#if !NSABER_TELEMETRY
+#error LatencyTest needs NSABER_TELEMETRY
+#endif
+
+//Address of the MPU-6050
+#define MPU_ADDRESS (0x68)
+
+//Register of the gyro's X axis, and the value a swing reads as
+#define MPU_GYRO_XOUT (0x43)
+#define MPU_SWING_VALUE (0x40)
+
+//Number of swings, and how long each lasts (milliseconds)
+#define SWINGS (60)
+#define SWING_MS (80)
+
+//Samples the output holds, about 23 ms as on the board
+#define SINK_CAPACITY (1024)
+
+static tHostWireStep saScript[SWINGS * 2];
+static NECSoundManager* spSndMgr = nullptr;
+static AMotionManager* spMotion = nullptr;
+static uint32_t sSwings = 0;
+
+/**
+ * The sketch's loop: plays a swing when one begins.
+ */
+static bool PollSwing(uint32_t aDeadlineUs)
+{
+	static bool sWasSwing = false;
+
+	bool lIsSwing = spMotion->IsSwing();
+	if(lIsSwing && !sWasSwing)
+	{
+		spSndMgr->PlayRandomSound(SoundTypes::eeSwingSnd);
+		sSwings++;
+	}
+	sWasSwing = lIsSwing;
+
+	return false;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	HostSd::SetRoot(argv[1]);
+	HostSd::SetLatency(HostSd::GetSpiCardLatency());
+	//400 kHz I2C: about 22 us per byte plus the address
+	HostWire::SetLatency(25, 22);
+
+	//Swings 150 to 500 ms apart, so they land anywhere in the poll cycle
+	uint32_t lTimeMs = 300;
+	for(int lIdx = 0; lIdx < SWINGS; lIdx++)
+	{
+		saScript[lIdx * 2] = { lTimeMs, MPU_ADDRESS, MPU_GYRO_XOUT, MPU_SWING_VALUE };
+		saScript[lIdx * 2 + 1] = { lTimeMs + SWING_MS, MPU_ADDRESS, MPU_GYRO_XOUT, 0 };
+		lTimeMs += 150 + (lIdx * 97) % 350;
+	}
+
+	HostAudioSink lSink(SINK_CAPACITY);
+	VoiceEngine lEngine(&lSink);
+	I2SWavPlayer lPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lPlayer);
+	MPU6050LiteTolData lTolerances = { 250, 200, 100, 1000, 5000 };
+	Mpu6050LiteMotionManager lMotion(&lTolerances);
+	spSndMgr = &lSndMgr;
+	spMotion = &lMotion;
+
+	HOST_CHECK(SD.begin(8000000, 11));
+	lMotion.Init();
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetFont(0);
+	lSndMgr.PlaySound(SoundTypes::eeHumSnd);
+
+	RunLoop lLoop;
+	SoundTask lSoundTask(&lSndMgr);
+	MotionTask lMotionTask(&lMotion);
+	FunctionTask lPollTask(PollSwing);
+	lLoop.AddTask(&lSoundTask, eeAudioPriority, 1000, 500);
+	lLoop.AddTask(&lMotionTask, eeMotionPriority, 1000, 1000);
+	lLoop.AddTask(&lPollTask, eeMotionPriority, 2000, 200);
+
+	SoundTelemetry::Reset();
+	HostWire::SetScript(saScript, SWINGS * 2);
+	while(!HostWire::IsScriptDone())
+	{
+		lLoop.RunOnce();
+	}
+	lLoop.RunFor(1000);
+	lSndMgr.SetVoiceEngine(nullptr);
+
+	tLatencyReport lReport;
+	SoundTelemetry::GetLatencyReport(lReport);
+	SoundTelemetry::PrintLatencyReport(Serial);
+	printf("%u swings, %u traces, %u audio gaps\n", sSwings, lReport.mTraces, lSink.GetGaps());
+
+	HOST_CHECK(SWINGS == sSwings);
+	HOST_CHECK(lReport.mTraces >= SWINGS * 9 / 10);
+	HOST_CHECK(0 == lSink.GetGaps());
+
+	//Stages line up with the loop: a read every 5 ms, a poll every 2 ms
+	//and the output buffer. A task can run late behind one that opens a
+	//file on the card and reads the start of it, such as the sound manager
+	//preloading the next swing.
+	const tLatencyPercentiles& lrSample = lReport.maStages[eeLatencySample];
+	const tLatencyPercentiles& lrDispatch = lReport.maStages[eeLatencyDispatch];
+	const tLatencyPercentiles& lrOutput = lReport.maStages[eeLatencyOutput];
+	const tLatencyPercentiles& lrTotal = lReport.maStages[eeLatencyTotal];
+	uint32_t lBufferUs = (uint32_t)((uint64_t)SINK_CAPACITY * 1000000 / NSABER_OUTPUT_SAMPLE_RATE);
+	uint32_t lLateUs = HostSd::GetSpiCardLatency().mOpenUs + 2000;
+	HOST_CHECK(lrSample.mMaxUs <= 5000 + lLateUs);
+	HOST_CHECK(lrDispatch.mP90Us <= 2000 + 500);
+	HOST_CHECK(lrDispatch.mMaxUs <= 2000 + lLateUs);
+	HOST_CHECK(lrOutput.mP50Us <= lBufferUs + 2000);
+	HOST_CHECK(lrTotal.mP50Us <= lBufferUs + 10000);
+
+	return HostTest::Result();
+}
@@ -0,0 +1,238 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * LockupTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Lockup sequences on the voice engine. Starting one posts the sound
+ * started event once, whether it is started with StartLockup() or with
+ * PlaySound(). Its begin segment, loop and end segment each start on the
+ * sample they are scheduled for: the begin segment on the first sample
+ * rendered, the loop right after the begin segment's last sample and
+ * again at each turn, and the end segment on the first sample rendered
+ * after StopLockup(), which plays through to its last sample.
+ *
+ * Usage:
+ *   LockupTest <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+#include <sys/stat.h>
+
+//Segment lengths, none a whole number of mix blocks or sectors
+#define BEGIN_SAMPLES (3001)
+#define LOOP_SAMPLES (2203)
+#define END_SAMPLES (2557)
+
+//Marks on the first sample of each segment and on the last
+#define BEGIN_MARK (12000)
+#define LOOP_MARK (6000)
+#define END_MARK (-12000)
+#define LAST_MARK (3000)
+
+//Turns of the loop before the lockup is stopped, half way through the next
+#define LOOP_TURNS (5)
+#define STOP_SAMPLE (BEGIN_SAMPLES + LOOP_SAMPLES * LOOP_TURNS + LOOP_SAMPLES / 2)
+
+//Samples of output captured
+#define CAPTURE_SAMPLES (STOP_SAMPLE + END_SAMPLES + 4096)
+
+//Most marks of one kind looked for
+#define MAX_MARKS (16)
+
+/**
+ * Where the marks of one kind turned up in the output.
+ */
+struct tMarks
+{
+	uint32_t maAt[MAX_MARKS];
+	uint32_t mCount;
+};
+
+/**
+ * Writes a segment: a mark on its first sample and one on its last, with
+ * silence in between.
+ */
+static bool WriteSegment(const char* apDir, const char* apName, int16_t aMark, uint32_t aNumSamples, bool aLooping)
+{
+	static int16_t saSamples[BEGIN_SAMPLES + LOOP_SAMPLES + END_SAMPLES];
+	char laPath[1024];
+
+	memset(saSamples, 0, sizeof(saSamples));
+	saSamples[0] = aMark;
+	saSamples[aNumSamples - 1] = LAST_MARK;
+	snprintf(laPath, sizeof(laPath), "%s/%s", apDir, apName);
+
+	return HostFont::WriteWav(laPath, saSamples, aNumSamples, NSABER_OUTPUT_SAMPLE_RATE, 0, aLooping ? aNumSamples : 0);
+}
+
+/**
+ * Counts the sound started events waiting for a sound type, and empties
+ * the queue.
+ */
+static uint32_t CountStarted(SaberEventQueue& arEvents, SoundTypes::ESoundTypes aSoundType)
+{
+	uint32_t lCount = 0;
+	tSaberEvent lEvent;
+	while(arEvents.Pop(lEvent))
+	{
+		lCount += eeSoundStartedEvent == lEvent.mType && aSoundType == lEvent.mDetail;
+	}
+
+	return lCount;
+}
+
+/**
+ * Notes a mark's position.
+ */
+static void AddMark(tMarks& arMarks, uint32_t aAt)
+{
+	if(arMarks.mCount < MAX_MARKS)
+	{
+		arMarks.maAt[arMarks.mCount] = aAt;
+	}
+	arMarks.mCount++;
+}
+
+/**
+ * Plays a lockup from the first sample, stops it part way through a turn
+ * of the loop, and checks where each segment came in.
+ * Args:
+ *  aDirect - TRUE to start it with StartLockup(), FALSE with PlaySound()
+ */
+static void PlayLockup(bool aDirect)
+{
+	static int16_t saCapture[CAPTURE_SAMPLES];
+
+	HostAudioSink lSink(1024, false);
+	VoiceEngine lEngine(&lSink);
+	I2SWavPlayer lPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lPlayer);
+	SaberEventQueue lEvents;
+
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetEventQueue(&lEvents);
+	lSndMgr.SetFont(0);
+	CountStarted(lEvents, SoundTypes::eeLockupSnd);
+	lSink.SetCapture(saCapture, CAPTURE_SAMPLES);
+
+	HOST_CHECK(aDirect ? lSndMgr.StartLockup() : lSndMgr.PlaySound(SoundTypes::eeLockupSnd));
+	HOST_CHECK(1 == CountStarted(lEvents, SoundTypes::eeLockupSnd));
+	HOST_CHECK(lSndMgr.IsLockupActive());
+
+	uint32_t lStopAt = 0;
+	while(lSink.GetCaptured() < CAPTURE_SAMPLES)
+	{
+		if(0 == lStopAt && lSink.GetWritten() >= STOP_SAMPLE)
+		{
+			//Nothing written yet is heard before the end segment
+			lStopAt = lSink.GetWritten();
+			lSndMgr.StopLockup();
+			HOST_CHECK(!lSndMgr.IsLockupActive());
+		}
+		lSink.Play(NSABER_MIX_BLOCK_SAMPLES);
+		lSndMgr.ContinuePlay();
+	}
+	lSndMgr.SetVoiceEngine(nullptr);
+
+	tMarks lBegins = {};
+	tMarks lLoops = {};
+	tMarks lEnds = {};
+	tMarks lLasts = {};
+	uint32_t lStray = 0;
+	for(uint32_t lIdx = 0; lIdx < CAPTURE_SAMPLES; lIdx++)
+	{
+		switch(saCapture[lIdx])
+		{
+		case 0:
+			break;
+		case BEGIN_MARK:
+			AddMark(lBegins, lIdx);
+			break;
+		case LOOP_MARK:
+			AddMark(lLoops, lIdx);
+			break;
+		case END_MARK:
+			AddMark(lEnds, lIdx);
+			break;
+		case LAST_MARK:
+			AddMark(lLasts, lIdx);
+			break;
+		default:
+			lStray++;
+			break;
+		}
+	}
+
+	printf("%s: begin at %u, %u loop turns from %u, stopped at %u, end at %u, %u last samples\n",
+	       aDirect ? "StartLockup()" : "PlaySound()", lBegins.maAt[0], lLoops.mCount, lLoops.maAt[0],
+	       lStopAt, lEnds.maAt[0], lLasts.mCount);
+
+	HOST_CHECK(0 == lStray);
+
+	//Begin segment on the first sample, all of it
+	HOST_CHECK(1 == lBegins.mCount);
+	HOST_CHECK(0 == lBegins.maAt[0]);
+	HOST_CHECK(BEGIN_SAMPLES - 1 == lLasts.maAt[0]);
+
+	//Loop right after it, a whole turn at a time until the stop
+	HOST_CHECK(LOOP_TURNS + 1 == lLoops.mCount);
+	for(uint32_t lTurn = 0; lTurn < lLoops.mCount && lTurn < MAX_MARKS; lTurn++)
+	{
+		HOST_CHECK(BEGIN_SAMPLES + lTurn * LOOP_SAMPLES == lLoops.maAt[lTurn]);
+		if(lTurn < LOOP_TURNS)
+		{
+			HOST_CHECK(BEGIN_SAMPLES + (lTurn + 1) * LOOP_SAMPLES - 1 == lLasts.maAt[lTurn + 1]);
+		}
+	}
+
+	//End segment on the first sample after the stop, all of it
+	HOST_CHECK(1 == lEnds.mCount);
+	HOST_CHECK(lStopAt == lEnds.maAt[0]);
+	HOST_CHECK(LOOP_TURNS + 2 == lLasts.mCount);
+	HOST_CHECK(lStopAt + END_SAMPLES - 1 == lLasts.maAt[LOOP_TURNS + 1]);
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	char laCard[512];
+	char laFontDir[1024];
+	snprintf(laCard, sizeof(laCard), "%s/lockup", argv[1]);
+	snprintf(laFontDir, sizeof(laFontDir), "%s/necfont1", laCard);
+	mkdir(laCard, 0755);
+	mkdir(laFontDir, 0755);
+	HOST_CHECK(WriteSegment(laFontDir, "bgnlock01.wav", BEGIN_MARK, BEGIN_SAMPLES, false));
+	HOST_CHECK(WriteSegment(laFontDir, "lock01.wav", LOOP_MARK, LOOP_SAMPLES, true));
+	HOST_CHECK(WriteSegment(laFontDir, "endlock01.wav", END_MARK, END_SAMPLES, false));
+	HostSd::SetRoot(laCard);
+	HOST_CHECK(SD.begin(8000000, 11));
+
+	PlayLockup(true);
+	PlayLockup(false);
+
+	return HostTest::Result();
+}
@@ -0,0 +1,170 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * LogTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Cost of a log call, and the log task as the NSaberSound example adds
+ * it: every message written out, and the run loop still sleeping between
+ * audio runs.
+ *
+ * Usage:
+ *   LogTest
+ */
+
+//Keep every level, so the DEBUG calls below are compiled in
+#define NSABER_LOG_LEVEL NSABER_LOG_LEVEL_DEBUG
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+
+//Calls timed for each cost
+#define TIMED_CALLS (4000000)
+
+//Length of the run loop check (milliseconds)
+#define LOOP_MS (20)
+
+/**
+ * Output that throws the text away and counts the lines.
+ */
+class NullPrint : public Print
+{
+public:
+	virtual size_t write(uint8_t aByte)
+	{
+		if('\n' == aByte)
+		{
+			mLines++;
+		}
+		return 1;
+	}
+
+	uint32_t mLines = 0;
+};
+
+static NullPrint sOut;
+static uint32_t sAudioRuns = 0;
+
+/**
+ * Feeds the audio, taking 100 us, and logs a message each time.
+ */
+static bool PumpAudio(uint32_t aDeadlineUs)
+{
+	sAudioRuns++;
+	NSABER_LOG_DEBUG("Audio run ", (int32_t)sAudioRuns);
+	HostClock::Advance(100);
+	return false;
+}
+
+/**
+ * Times DEBUG calls that are stored, emptying the ring between bursts.
+ * Returns:
+ *  Host CPU time per call (nanoseconds)
+ */
+static float TimeStoredCalls()
+{
+	const int lBurst = NSABER_LOG_RECORDS - 1;
+	uint64_t lCpuUs = 0;
+
+	for(int lIdx = 0; lIdx < TIMED_CALLS; lIdx += lBurst)
+	{
+		uint64_t lStart = HostClock::GetCpuUs();
+		for(int lCall = 0; lCall < lBurst; lCall++)
+		{
+			NSABER_LOG_DEBUG("Trying to play ", "swing01.wav");
+		}
+		lCpuUs += HostClock::GetCpuUs() - lStart;
+
+		while(NSaberLog::Flush(sOut, micros() + 1000))
+		{
+			//Write out the rest
+		}
+	}
+
+	return lCpuUs * 1000.0f / TIMED_CALLS;
+}
+
+/**
+ * Times DEBUG calls made while the ring is full, which are only counted.
+ * Returns:
+ *  Host CPU time per call (nanoseconds)
+ */
+static float TimeDroppedCalls()
+{
+	for(int lCall = 0; lCall < NSABER_LOG_RECORDS; lCall++)
+	{
+		NSABER_LOG_DEBUG("Filling the ring");
+	}
+
+	uint64_t lStart = HostClock::GetCpuUs();
+	for(int lCall = 0; lCall < TIMED_CALLS; lCall++)
+	{
+		NSABER_LOG_DEBUG("Trying to play ", "swing01.wav");
+	}
+	float lNs = (HostClock::GetCpuUs() - lStart) * 1000.0f / TIMED_CALLS;
+
+	while(NSaberLog::Flush(sOut, micros() + 1000))
+	{
+		//Write out the rest
+	}
+
+	return lNs;
+}
+
+int main(int argc, char** argv)
+{
+	float lStoredNs = TimeStoredCalls();
+	float lDroppedNs = TimeDroppedCalls();
+	printf("DEBUG call: %.0f ns stored, %.0f ns dropped\n", lStoredNs, lDroppedNs);
+	//A message must stay far cheaper than printing it
+	HOST_CHECK(lStoredNs < 1000);
+	HOST_CHECK(lDroppedNs < lStoredNs);
+
+	//The example's loop: audio every millisecond, the log every 10 ms
+	FunctionTask lAudio(PumpAudio);
+	LogTask lLog(sOut);
+	RunLoop lLoop;
+	HOST_CHECK(lLoop.AddTask(&lAudio, eeAudioPriority, 1000, 500));
+	HOST_CHECK(lLoop.AddTask(&lLog, eeBackgroundPriority, 10000, 500));
+
+	sOut.mLines = 0;
+	uint32_t lPasses = 0;
+	uint32_t lIdlePasses = 0;
+	uint32_t lStartMs = millis();
+	while(millis() - lStartMs < LOOP_MS)
+	{
+		lPasses++;
+		if(!lLoop.RunOnce())
+		{
+			lIdlePasses++;
+		}
+	}
+	lLoop.RemoveTask(&lAudio);
+	lLoop.RunFor(20);
+
+	printf("%u of %u passes idle, %u audio runs, %u messages written\n",
+	       lIdlePasses, lPasses, sAudioRuns, sOut.mLines);
+	HOST_CHECK(sAudioRuns >= LOOP_MS - 1);
+	HOST_CHECK(sOut.mLines == sAudioRuns);
+	//Asleep for most of the 900 us between audio runs, 10 us a pass
+	HOST_CHECK(lIdlePasses >= sAudioRuns * 50);
+
+	return HostTest::Result();
+}
@@ -0,0 +1,183 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * MixBusTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Cost per block of the mix bus, and that the limiter and soft clipper
+ * keep a hot mix inside full scale. The cost is host CPU time, a guide to
+ * the relative cost only; the Benchmark example times it on the board.
+ * Also the envelope follower's attack and release on a step, as read
+ * through the level tap the blade follows.
+ *
+ * Usage:
+ *   MixBusTest
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+
+//Blocks timed at each level
+#define TIMED_BLOCKS (200000)
+
+//Level of the step the envelope follower is given
+#define STEP_LEVEL (10000)
+
+//Blocks the step is held for, and then left off for
+#define STEP_BLOCKS (200)
+
+//Length of a block (microseconds)
+#define BLOCK_US ((float)NSABER_MIX_BLOCK_SAMPLES * 1000000 / NSABER_OUTPUT_SAMPLE_RATE)
+
+/**
+ * Times the mix bus on a sine at a percentage of full scale.
+ * Args:
+ *  aGainPct - Peak of the mix, percent of full scale
+ * Returns:
+ *  Host CPU time per block (nanoseconds)
+ */
+static float TimeBlocks(int aGainPct)
+{
+	MixBus lBus;
+	int32_t laMix[NSABER_MIX_BLOCK_SAMPLES];
+	int16_t laOut[NSABER_MIX_BLOCK_SAMPLES];
+	int32_t lInPeak = 0;
+	int32_t lOutPeak = 0;
+
+	for(int lIdx = 0; lIdx < NSABER_MIX_BLOCK_SAMPLES; lIdx++)
+	{
+		laMix[lIdx] = (int32_t)(sin(lIdx * 0.3) * 327.67 * aGainPct);
+		lInPeak = max(lInPeak, abs(laMix[lIdx]));
+	}
+
+	uint64_t lStart = HostClock::GetCpuUs();
+	for(int lBlock = 0; lBlock < TIMED_BLOCKS; lBlock++)
+	{
+		lBus.Process(laMix, laOut, NSABER_MIX_BLOCK_SAMPLES);
+		lOutPeak = max(lOutPeak, (int32_t)abs(laOut[lBlock % NSABER_MIX_BLOCK_SAMPLES]));
+	}
+	float lNs = (HostClock::GetCpuUs() - lStart) * 1000.0f / TIMED_BLOCKS;
+
+	printf("%3d%% of full scale: %.0f ns per block, output peak %d, limiter gain %d\n",
+	       aGainPct, lNs, (int)lOutPeak, (int)lBus.GetLimiterGain());
+
+	if(aGainPct <= 100)
+	{
+		//Below the threshold the bus passes the mix through
+		HOST_CHECK(32768 == lBus.GetLimiterGain());
+		HOST_CHECK(abs(lOutPeak - lInPeak) <= lInPeak / 100);
+	}
+	else
+	{
+		HOST_CHECK(lBus.GetLimiterGain() < 32768);
+		HOST_CHECK(lOutPeak <= 32767);
+	}
+
+	return lNs;
+}
+
+/**
+ * Runs blocks of a steady level through the bus, and gets the time the
+ * level read through the tap takes to cover 63% of the way to it (one time
+ * constant) and to get all the way there.
+ * Args:
+ *  arBus - Mix bus
+ *  aLevel - Level of the blocks
+ *  arTauUs - Output parameter, time to cover 63% of the step
+ *  arSettleUs - Output parameter, time to reach the level, 0 if it didn't
+ * Returns:
+ *  TRUE if the level moved steadily towards the step and never past it,
+ *  and the tap always agreed with GetLevel()
+ */
+static bool RunStep(MixBus& arBus, int32_t aLevel, float& arTauUs, float& arSettleUs)
+{
+	int32_t laMix[NSABER_MIX_BLOCK_SAMPLES];
+	int16_t laOut[NSABER_MIX_BLOCK_SAMPLES];
+	const volatile uint16_t* lpTap = arBus.GetLevelTap();
+	int32_t lStart = *lpTap;
+	int32_t lTauLevel = lStart + (aLevel - lStart) * 63 / 100;
+	int32_t lLast = lStart;
+	bool lSteady = true;
+
+	for(int lIdx = 0; lIdx < NSABER_MIX_BLOCK_SAMPLES; lIdx++)
+	{
+		laMix[lIdx] = aLevel;
+	}
+
+	arTauUs = 0;
+	arSettleUs = 0;
+	for(int lBlock = 1; lBlock <= STEP_BLOCKS; lBlock++)
+	{
+		arBus.Process(laMix, laOut, NSABER_MIX_BLOCK_SAMPLES);
+		int32_t lLevel = *lpTap;
+
+		lSteady = lSteady && lLevel == arBus.GetLevel();
+		lSteady = lSteady && (aLevel >= lStart ? lLevel >= lLast && lLevel <= aLevel
+		                                       : lLevel <= lLast && lLevel >= aLevel);
+		if(0 == arTauUs && (aLevel >= lStart ? lLevel >= lTauLevel : lLevel <= lTauLevel))
+		{
+			arTauUs = lBlock * BLOCK_US;
+		}
+		if(0 == arSettleUs && lLevel == aLevel)
+		{
+			arSettleUs = lBlock * BLOCK_US;
+		}
+		lLast = lLevel;
+	}
+
+	return lSteady;
+}
+
+/**
+ * The envelope follower rises in about 3 ms and falls in about 25 ms, as
+ * MixBus.h has it, and settles on the level of the step either way.
+ */
+static void CheckEnvelope()
+{
+	MixBus lBus;
+	float lAttackUs;
+	float lAttackSettleUs;
+	float lReleaseUs;
+	float lReleaseSettleUs;
+
+	HOST_CHECK(0 == lBus.GetLevel());
+	HOST_CHECK(RunStep(lBus, STEP_LEVEL, lAttackUs, lAttackSettleUs));
+	HOST_CHECK(RunStep(lBus, 0, lReleaseUs, lReleaseSettleUs));
+
+	printf("envelope: attack %.1f ms (settled in %.1f ms), release %.1f ms (settled in %.1f ms)\n",
+	       lAttackUs / 1000, lAttackSettleUs / 1000, lReleaseUs / 1000, lReleaseSettleUs / 1000);
+
+	//Times are whole blocks of about 1.45 ms
+	HOST_CHECK(lAttackUs > 0 && lAttackUs <= 3000);
+	HOST_CHECK(lAttackSettleUs > 0 && lAttackSettleUs <= 30000);
+	HOST_CHECK(lReleaseUs >= 20000 && lReleaseUs <= 26000);
+	HOST_CHECK(lReleaseSettleUs > 0 && lReleaseSettleUs <= 250000);
+}
+
+int main(int argc, char** argv)
+{
+	CheckEnvelope();
+
+	//Generous bounds; a host at -O2 takes a few hundred ns at most
+	HOST_CHECK(TimeBlocks(50) < 1000);
+	HOST_CHECK(TimeBlocks(200) < 1000);
+
+	return HostTest::Result();
+}
@@ -0,0 +1,105 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * P2QuantileTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Accuracy of the P-squared estimates the motion calibrator is built on:
+ * each percentile it uses is estimated over a stream of normal and of
+ * exponential samples and compared to the exact percentile of the same
+ * samples, sorted.
+ *
+ * Usage:
+ *   P2QuantileTest <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+//Samples per estimate, about 20 s of calibration at one read per 5 ms
+#define STREAM_SAMPLES (4000)
+
+//Largest error allowed, relative to the exact percentile
+#define MAX_ERROR (0.02)
+
+//The percentiles the calibrator estimates
+static const float saQuantiles[] =
+{
+	NSABER_CALIBRATE_SWING_SMALL,
+	NSABER_CALIBRATE_TWIST,
+	NSABER_CALIBRATE_SWING_MEDIUM,
+	NSABER_CALIBRATE_SWING_LARGE,
+	NSABER_CALIBRATE_CLASH
+};
+
+/**
+ * Estimates each percentile over the same stream and checks it against
+ * the exact one.
+ * Args:
+ *  apName - Name of the distribution, for the report
+ *  arDist - Distribution to draw from
+ * Returns:
+ *  Largest error relative to the exact percentile
+ */
+template <typename Dist>
+static float CheckStream(const char* apName, Dist& arDist)
+{
+	float lWorst = 0;
+
+	for(float lQuantile : saQuantiles)
+	{
+		std::mt19937 lGen(1);
+		std::vector<float> lSamples;
+		P2Quantile lEstimate(lQuantile);
+
+		for(int lIdx = 0; lIdx < STREAM_SAMPLES; lIdx++)
+		{
+			float lValue = arDist(lGen);
+			lEstimate.Add(lValue);
+			lSamples.push_back(lValue);
+		}
+
+		std::sort(lSamples.begin(), lSamples.end());
+		float lExact = lSamples[(size_t)(lQuantile * (lSamples.size() - 1))];
+		float lError = fabs(lEstimate.Get() - lExact) / lExact;
+		lWorst = max(lWorst, lError);
+
+		printf("%s p%02d: estimate %.1f, exact %.1f, error %.2f%%\n",
+		       apName, (int)(lQuantile * 100 + 0.5), lEstimate.Get(), lExact, lError * 100);
+	}
+
+	return lWorst;
+}
+
+int main(int argc, char** argv)
+{
+	//Swing rates: mostly around a typical swing, spread both ways
+	std::normal_distribution<float> lNormal(200, 60);
+	HOST_CHECK(CheckStream("normal", lNormal) < MAX_ERROR);
+
+	//Changes in acceleration: mostly small with a long tail of hits
+	std::exponential_distribution<float> lExponential(0.02);
+	HOST_CHECK(CheckStream("exponential", lExponential) < MAX_ERROR);
+
+	return HostTest::Result();
+}
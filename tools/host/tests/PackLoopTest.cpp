@@ -0,0 +1,154 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * PackLoopTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Loops of sounds packed as ADPCM by necpack: a hum that is a whole number
+ * of cycles long has to loop without a click, even though its length is
+ * not a whole number of ADPCM blocks. The same goes for a loop set by a
+ * "smpl" chunk that starts and ends inside blocks.
+ *
+ * Usage:
+ *   PackLoopTest <necpack> <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+#include <sys/stat.h>
+
+//Samples of output checked, a few times round the loop
+#define CAPTURE_SAMPLES (44100 * 2)
+
+//Samples skipped at the start, where the encoder's step size is still
+//settling in the first block. Only the loop's seam is checked.
+#define SETTLE_SAMPLES (1024)
+
+/**
+ * Plays a packed hum and gets the largest step between samples relative
+ * to the step a sine of the hum's frequency and the output's peak would
+ * take. 1.0 for a clean sine, several times that across a click.
+ * Args:
+ *  apCard - Card with the packed font
+ *  aHz - Frequency of the hum
+ */
+static float PlayHum(const char* apCard, float aHz)
+{
+	static int16_t saCapture[CAPTURE_SAMPLES];
+
+	HostSd::SetRoot(apCard);
+
+	HostAudioSink lSink(1024, false);
+	VoiceEngine lEngine(&lSink);
+	I2SWavPlayer lPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lPlayer);
+
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetFont(0);
+	HOST_CHECK(lSndMgr.PlaySound(SoundTypes::eeHumSnd));
+
+	lSink.SetCapture(saCapture, CAPTURE_SAMPLES);
+	while(lSink.GetCaptured() < CAPTURE_SAMPLES)
+	{
+		lSink.Play(NSABER_MIX_BLOCK_SAMPLES);
+		lSndMgr.ContinuePlay();
+	}
+	lSndMgr.SetVoiceEngine(nullptr);
+
+	int lPeak = 1;
+	int lMaxStep = 0;
+	for(int lIdx = SETTLE_SAMPLES; lIdx < CAPTURE_SAMPLES; lIdx++)
+	{
+		lPeak = max(lPeak, abs(saCapture[lIdx]));
+		lMaxStep = max(lMaxStep, abs(saCapture[lIdx] - saCapture[lIdx - 1]));
+	}
+
+	return lMaxStep / (lPeak * 2 * M_PI * aHz / NSABER_OUTPUT_SAMPLE_RATE);
+}
+
+/**
+ * Writes a sine to a font of its own and packs it as ADPCM. With a loop,
+ * the samples after it are silent, so playing past the loop end shows.
+ * Args:
+ *  apNecpack - Path of necpack
+ *  apCard - Card directory to create
+ *  aHz - Frequency
+ *  aNumSamples - Length
+ *  aLoopStart - First sample of the loop
+ *  aLoopEnd - Sample after the loop, 0 to loop the whole sound
+ * Returns:
+ *  TRUE if successful
+ */
+static bool PackSine(const char* apNecpack, const char* apCard, float aHz, uint32_t aNumSamples,
+                     uint32_t aLoopStart = 0, uint32_t aLoopEnd = 0)
+{
+	static int16_t saSamples[44100 * 2];
+	char laPath[2048];
+
+	for(uint32_t lIdx = 0; lIdx < aNumSamples; lIdx++)
+	{
+		saSamples[lIdx] = 0;
+		if(0 == aLoopEnd || lIdx < aLoopEnd)
+		{
+			saSamples[lIdx] = (int16_t)(16000 * sin(2 * M_PI * aHz * lIdx / 44100));
+		}
+	}
+
+	mkdir(apCard, 0755);
+	snprintf(laPath, sizeof(laPath), "%s/necfont1", apCard);
+	mkdir(laPath, 0755);
+	snprintf(laPath, sizeof(laPath), "%s/necfont1/hum01.wav", apCard);
+	if(!HostFont::WriteWav(laPath, saSamples, aNumSamples, 44100, aLoopStart, aLoopEnd))
+	{
+		return false;
+	}
+
+	snprintf(laPath, sizeof(laPath), "\"%s\" --adpcm \"%s/necfont1\" \"%s/necfont1.nfp\" > /dev/null",
+	         apNecpack, apCard, apCard);
+	return 0 == system(laPath);
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 3)
+	{
+		fprintf(stderr, "Usage: %s <necpack> <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	char laCard[512];
+
+	//Half a second of 110 Hz, 55 cycles in 43.7 blocks
+	snprintf(laCard, sizeof(laCard), "%s/loop", argv[2]);
+	HOST_CHECK(PackSine(argv[1], laCard, 110, 22050));
+	float lStep = PlayHum(laCard, 110);
+	printf("whole sound loop: largest step %.2f times a clean sine's\n", lStep);
+	HOST_CHECK(lStep < 1.5);
+
+	//Ten cycles of 147 Hz from sample 1000 to 3999, neither on a block
+	//boundary, then silence
+	snprintf(laCard, sizeof(laCard), "%s/smpl", argv[2]);
+	HOST_CHECK(PackSine(argv[1], laCard, 147, 6000, 1000, 4000));
+	lStep = PlayHum(laCard, 147);
+	printf("smpl loop: largest step %.2f times a clean sine's\n", lStep);
+	HOST_CHECK(lStep < 1.5);
+
+	return HostTest::Result();
+}
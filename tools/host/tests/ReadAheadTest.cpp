@@ -0,0 +1,297 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * ReadAheadTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Read-ahead streaming against a card with the latency of a real one: a
+ * busy session has to play without a gap, with the card read in whole
+ * transfers, from both a packed font and a font directory. Changing the
+ * font has to stop whatever the old one was playing. A loop whose start
+ * and end are at different offsets within a sector has to repeat exactly,
+ * with the ring kept in line with the card's sectors across the wrap.
+ *
+ * Usage:
+ *   ReadAheadTest <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+#include <sys/stat.h>
+
+//Length of the session (milliseconds)
+#define SESSION_MS (10000)
+
+//Samples captured after a font change
+#define CAPTURE_SAMPLES (4410)
+
+//Sound with a loop that starts and ends at different offsets in a sector
+#define LOOP_SOUND_SAMPLES (20000)
+#define LOOP_START_SAMPLE (1001)
+#define LOOP_END_SAMPLE (17333)
+
+//Times round the loop the stream is read
+#define LOOP_TURNS (4)
+
+//Most bytes taken from the stream at a time, and the most read into it.
+//The amount taken varies, so the ring holds different amounts at each wrap.
+#define LOOP_READ_BYTES (1200)
+#define LOOP_REFILL_BYTES (4 * READ_AHEAD_SECTOR_SIZE)
+
+/**
+ * Stream that shows where its ring is relative to the card.
+ */
+class TestStream : public ReadAheadStream
+{
+public:
+	/**
+	 * Returns TRUE if the next byte from the card goes into the ring at the
+	 * same offset within a sector as it has in the file.
+	 */
+	bool IsInLine()
+	{
+		return 0 == ((mHead - mFilePos) & (READ_AHEAD_SECTOR_SIZE - 1));
+	}
+
+	/**
+	 * Returns TRUE if the next transfer starts part way into a sector.
+	 * At the end of the loop it starts wherever the wrap leaves off, which
+	 * is the first sector boundary after the part of the loop kept in RAM.
+	 */
+	bool IsMidSector()
+	{
+		return mFilePos < mLoopEnd && 0 != (mFilePos & (READ_AHEAD_SECTOR_SIZE - 1));
+	}
+};
+
+/**
+ * Plays hum with a swing every 150 ms and a clash every second, servicing
+ * the engine once per millisecond.
+ */
+static void RunSession(NECSoundManager& arSndMgr, uint32_t aMs)
+{
+	uint32_t lStart = millis();
+	uint32_t lNextSwing = lStart;
+	uint32_t lNextClash = lStart + 500;
+
+	while(millis() - lStart < aMs)
+	{
+		uint32_t lNow = millis();
+		if((int32_t)(lNow - lNextSwing) >= 0)
+		{
+			arSndMgr.PlayRandomSound(SoundTypes::eeSwingSnd);
+			lNextSwing += 150;
+		}
+		if((int32_t)(lNow - lNextClash) >= 0)
+		{
+			arSndMgr.PlayRandomSound(SoundTypes::eeClashSnd);
+			lNextClash += 1000;
+		}
+
+		uint64_t lCallStart = HostClock::GetUs();
+		arSndMgr.ContinuePlay();
+		uint32_t lCallUs = (uint32_t)(HostClock::GetUs() - lCallStart);
+		HostClock::Advance(lCallUs < 1000 ? 1000 - lCallUs : 0);
+	}
+}
+
+/**
+ * Runs the session on one card and checks the audio was continuous.
+ */
+static void TestStreaming(const char* apCard, const char* apName)
+{
+	HostSd::SetRoot(apCard);
+	HostSd::ResetStats();
+
+	HostAudioSink lSink;
+	VoiceEngine lEngine(&lSink);
+	I2SWavPlayer lPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lPlayer);
+
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetFont(0);
+	lSndMgr.PlaySound(SoundTypes::eeHumSnd);
+	lSink.Reset();
+	lEngine.GetScheduler().ResetStats();
+
+	RunSession(lSndMgr, SESSION_MS);
+
+	tReadAheadStats lStats;
+	tHostSdStats lSd;
+	lEngine.GetScheduler().GetStats(lStats);
+	HostSd::GetStats(lSd);
+
+	uint32_t lBytesPerTransfer = lStats.mTransfers > 0 ? lStats.mBytesRead / lStats.mTransfers : 0;
+	printf("%s: %u samples, %u gaps, %u underruns, %u transfers of %u bytes on average, "
+	       "%u opens, %u seeks, card busy %u ms, lowest level %u%%\n",
+	       apName, lSink.GetWritten(), lSink.GetGaps(), lEngine.GetUnderruns(), lStats.mTransfers,
+	       lBytesPerTransfer, lSd.mOpens, lSd.mSeeks, (uint32_t)(lSd.mLatencyUs / 1000), lStats.mMinLevel);
+
+	HOST_CHECK(lSink.GetWritten() >= (uint32_t)((uint64_t)SESSION_MS * NSABER_OUTPUT_SAMPLE_RATE / 1000));
+	HOST_CHECK(0 == lSink.GetGaps());
+	HOST_CHECK(0 == lEngine.GetUnderruns());
+
+	//Transfers are whole, apart from the ends of sounds
+	HOST_CHECK(lBytesPerTransfer >= READ_AHEAD_DEFAULT_TRANSFER_SECTORS * READ_AHEAD_SECTOR_SIZE * 3 / 4);
+
+	lSndMgr.SetVoiceEngine(nullptr);
+}
+
+/**
+ * Changes font in the middle of a hum and a clash, and checks both stop.
+ */
+static void TestFontChange(const char* apCard)
+{
+	static int16_t saCapture[CAPTURE_SAMPLES];
+
+	HostSd::SetRoot(apCard);
+
+	HostAudioSink lSink;
+	VoiceEngine lEngine(&lSink);
+	I2SWavPlayer lPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lPlayer);
+
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetFont(0);
+	lSndMgr.PlaySound(SoundTypes::eeHumSnd);
+	lSndMgr.PlaySound(SoundTypes::eeClashSnd, 0);
+	for(int lIdx = 0; lIdx < 50; lIdx++)
+	{
+		lSndMgr.ContinuePlay();
+		HostClock::Advance(1000);
+	}
+
+	lSndMgr.SetFont(0);
+
+	bool lAllEnded = true;
+	for(int lIdx = 0; lIdx < NSABER_MAX_VOICES; lIdx++)
+	{
+		lAllEnded = lAllEnded && lEngine.GetVoice(lIdx)->IsEnded();
+	}
+
+	lSink.SetCapture(saCapture, CAPTURE_SAMPLES);
+	while(lSink.GetCaptured() < CAPTURE_SAMPLES)
+	{
+		lSndMgr.ContinuePlay();
+		HostClock::Advance(1000);
+	}
+
+	int lPeak = 0;
+	for(int lIdx = 0; lIdx < CAPTURE_SAMPLES; lIdx++)
+	{
+		lPeak = max(lPeak, abs(saCapture[lIdx]));
+	}
+	printf("font change: voices ended %d, peak after change %d\n", lAllEnded, lPeak);
+
+	HOST_CHECK(lAllEnded);
+	HOST_CHECK(0 == lPeak);
+
+	lSndMgr.SetVoiceEngine(nullptr);
+}
+
+/**
+ * Streams a loop that isn't sector aligned a few times round, and checks
+ * the data and where the card reads start.
+ */
+static void TestUnalignedLoop(const char* apCard)
+{
+	static int16_t saSamples[LOOP_SOUND_SAMPLES];
+	static TestStream sStream;
+	char laPath[1024];
+
+	for(int lIdx = 0; lIdx < LOOP_SOUND_SAMPLES; lIdx++)
+	{
+		saSamples[lIdx] = (int16_t)(lIdx * 3 + 1);
+	}
+	snprintf(laPath, sizeof(laPath), "%s/unaligned.wav", apCard);
+	HOST_CHECK(HostFont::WriteWav(laPath, saSamples, LOOP_SOUND_SAMPLES, NSABER_OUTPUT_SAMPLE_RATE,
+	                              LOOP_START_SAMPLE, LOOP_END_SAMPLE));
+
+	HostSd::SetRoot(apCard);
+	HOST_CHECK(sStream.Open("unaligned.wav"));
+	sStream.SetLooping(true);
+
+	//The first lap from the start of the data, then the loop over and over
+	uint32_t lTotal = LOOP_END_SAMPLE + (LOOP_END_SAMPLE - LOOP_START_SAMPLE) * (LOOP_TURNS - 1);
+	uint32_t lSample = 0;
+	uint32_t lMismatches = 0;
+	uint32_t lTransfers = 0;
+	uint32_t lUnalignedStarts = 0;
+	uint32_t lOutOfLine = 0;
+	int16_t laOut[LOOP_READ_BYTES / 2];
+	for(uint32_t lPass = 0; lSample < lTotal; lPass++)
+	{
+		//Only the first transfer, from the end of the header, may start
+		//part way into a sector
+		bool lMidSector = sStream.IsMidSector();
+		uint32_t lRead = sStream.Refill(LOOP_REFILL_BYTES);
+		if(lRead > 0)
+		{
+			lUnalignedStarts += lTransfers > 0 && lMidSector;
+			lTransfers++;
+		}
+		lOutOfLine += !sStream.IsInLine();
+
+		uint16_t lNumBytes = sStream.Read((uint8_t*)laOut, 64 + (lPass * 149) % (LOOP_READ_BYTES - 64));
+		for(uint16_t lIdx = 0; lIdx < lNumBytes / 2 && lSample < lTotal; lIdx++, lSample++)
+		{
+			uint32_t lPos = lSample;
+			if(lPos >= LOOP_END_SAMPLE)
+			{
+				lPos = LOOP_START_SAMPLE + (lPos - LOOP_END_SAMPLE) % (LOOP_END_SAMPLE - LOOP_START_SAMPLE);
+			}
+			lMismatches += laOut[lIdx] != saSamples[lPos];
+		}
+	}
+	sStream.Close();
+
+	printf("unaligned loop: %u samples, %u wrong, %u transfers, %u starting mid-sector, %u refills out of line\n",
+	       lSample, lMismatches, lTransfers, lUnalignedStarts, lOutOfLine);
+
+	HOST_CHECK(0 == lMismatches);
+	HOST_CHECK(0 == lUnalignedStarts);
+	HOST_CHECK(0 == lOutOfLine);
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	//The same font, loose, on a card of its own
+	char laLooseCard[512];
+	char laLooseFont[512 + 16];
+	snprintf(laLooseCard, sizeof(laLooseCard), "%s/loose", argv[1]);
+	snprintf(laLooseFont, sizeof(laLooseFont), "%s/necfont1", laLooseCard);
+	mkdir(laLooseCard, 0755);
+	HOST_CHECK(HostFont::WriteNecFont(laLooseFont));
+
+	HostSd::SetLatency(HostSd::GetSpiCardLatency());
+
+	TestStreaming(argv[1], "packed font");
+	TestStreaming(laLooseCard, "font directory");
+	TestFontChange(argv[1]);
+	TestUnalignedLoop(argv[1]);
+
+	return HostTest::Result();
+}
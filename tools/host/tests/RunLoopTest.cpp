@@ -0,0 +1,324 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * RunLoopTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Scheduling in the run loop: background work has to get time next to a
+ * task that runs on every pass, audio has to run ahead of everything else,
+ * background work has to keep to its budget and leave the next motion
+ * read on time, and the loop has to sleep when nothing is due.
+ *
+ * Usage:
+ *   RunLoopTest
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+
+//Time one __WFE() sleeps for on the host
+#define WFE_US (10)
+
+//Most task runs the order check records
+#define MAX_TRACE (16)
+
+static uint32_t sMotionRuns = 0;
+static uint32_t sBackgroundRuns = 0;
+
+//Tasks in the order they ran
+static char saTrace[MAX_TRACE + 1];
+static uint8_t sTraceLen = 0;
+
+//When motion reads were first due, and the most any started after its time
+static uint32_t sMotionStartUs = 0;
+static uint32_t sMaxMotionLateUs = 0;
+static uint32_t sLateMotionRuns = 0;
+
+//Longest time to its deadline any background slice was given
+static int32_t sMaxBackgroundSliceUs = 0;
+
+/**
+ * Polls the sensor on every pass, taking 50 us.
+ */
+static bool PollMotion(uint32_t aDeadlineUs)
+{
+	sMotionRuns++;
+	HostClock::Advance(50);
+	return false;
+}
+
+/**
+ * A slice of background work, taking 100 us.
+ */
+static bool DoBackground(uint32_t aDeadlineUs)
+{
+	sBackgroundRuns++;
+	HostClock::Advance(100);
+	return false;
+}
+
+/**
+ * Tasks that note down that they ran.
+ */
+static bool TraceAudio(uint32_t aDeadlineUs)
+{
+	if(sTraceLen < MAX_TRACE)
+	{
+		saTrace[sTraceLen++] = 'A';
+	}
+	return false;
+}
+
+static bool TraceMotion(uint32_t aDeadlineUs)
+{
+	if(sTraceLen < MAX_TRACE)
+	{
+		saTrace[sTraceLen++] = 'M';
+	}
+	HostClock::Advance(50);
+	return false;
+}
+
+static bool TraceBackground(uint32_t aDeadlineUs)
+{
+	if(sTraceLen < MAX_TRACE)
+	{
+		saTrace[sTraceLen++] = 'B';
+	}
+	return false;
+}
+
+/**
+ * Feeds the audio, taking 30 us.
+ */
+static bool FeedAudio(uint32_t aDeadlineUs)
+{
+	HostClock::Advance(30);
+	return false;
+}
+
+/**
+ * Reads the sensor every 2 ms and notes how late the read started.
+ */
+static bool ReadMotion(uint32_t aDeadlineUs)
+{
+	uint32_t lLateUs = micros() - (sMotionStartUs + sMotionRuns * 2000);
+	sMaxMotionLateUs = max(sMaxMotionLateUs, lLateUs);
+	sLateMotionRuns += lLateUs > 100;
+	sMotionRuns++;
+
+	HostClock::Advance(50);
+	return false;
+}
+
+/**
+ * Background work that always has more to do, and works right up to the
+ * deadline it is given.
+ */
+static bool WorkToDeadline(uint32_t aDeadlineUs)
+{
+	uint32_t lStart = micros();
+	sMaxBackgroundSliceUs = max(sMaxBackgroundSliceUs, (int32_t)(aDeadlineUs - lStart));
+	sBackgroundRuns++;
+
+	while((int32_t)(aDeadlineUs - micros()) > 20)
+	{
+		HostClock::Advance(10);
+	}
+
+	return true;
+}
+
+/**
+ * Tasks that do nothing, for the sleep check.
+ */
+static bool DoNothing(uint32_t aDeadlineUs)
+{
+	return false;
+}
+
+/**
+ * Background work next to a task that runs on every pass.
+ */
+static void CheckBackgroundShare()
+{
+	FunctionTask lMotion(PollMotion);
+	FunctionTask lBackground(DoBackground);
+
+	sMotionRuns = 0;
+	sBackgroundRuns = 0;
+
+	RunLoop lLoop;
+	lLoop.SetSleepEnabled(false);
+	HOST_CHECK(lLoop.AddTask(&lMotion, eeMotionPriority, 0, 200));
+	HOST_CHECK(lLoop.AddTask(&lBackground, eeBackgroundPriority, 1000, 500));
+
+	lLoop.RunFor(100);
+
+	printf("motion ran %u times, background %u times\n", sMotionRuns, sBackgroundRuns);
+	HOST_CHECK(sMotionRuns > 0);
+	//Once a millisecond, give or take a pass
+	HOST_CHECK(sBackgroundRuns >= 90);
+}
+
+/**
+ * Audio runs first when everything is due at once, however the tasks were
+ * added, and then between the others whenever it is due again.
+ */
+static void CheckOrder()
+{
+	FunctionTask lAudio(TraceAudio);
+	FunctionTask lMotion(TraceMotion);
+	FunctionTask lBackground(TraceBackground);
+
+	RunLoop lLoop;
+	lLoop.SetSleepEnabled(false);
+	HOST_CHECK(lLoop.AddTask(&lBackground, eeBackgroundPriority, 1000, 500));
+	HOST_CHECK(lLoop.AddTask(&lMotion, eeMotionPriority, 1000, 200));
+	HOST_CHECK(lLoop.AddTask(&lAudio, eeAudioPriority, 1000, 200));
+
+	sTraceLen = 0;
+	HOST_CHECK(lLoop.RunOnce());
+	saTrace[sTraceLen] = '\0';
+	printf("first pass ran %s\n", saTrace);
+	HOST_CHECK(0 == strcmp("AMB", saTrace));
+
+	//Audio due again by the time motion is done goes in before background
+	RunLoop lFastLoop;
+	lFastLoop.SetSleepEnabled(false);
+	HOST_CHECK(lFastLoop.AddTask(&lBackground, eeBackgroundPriority, 1000, 500));
+	HOST_CHECK(lFastLoop.AddTask(&lMotion, eeMotionPriority, 1000, 200));
+	HOST_CHECK(lFastLoop.AddTask(&lAudio, eeAudioPriority, 40, 200));
+
+	sTraceLen = 0;
+	HOST_CHECK(lFastLoop.RunOnce());
+	saTrace[sTraceLen] = '\0';
+	printf("pass with audio due every 40 us ran %s\n", saTrace);
+	HOST_CHECK(0 == strcmp("AMAB", saTrace));
+}
+
+/**
+ * Background work is given no more than its budget, and no more than the
+ * time left before the next motion read, so the reads keep to time.
+ */
+static void CheckBackgroundDeadline()
+{
+	FunctionTask lAudio(FeedAudio);
+	FunctionTask lMotion(ReadMotion);
+	FunctionTask lBackground(WorkToDeadline);
+
+	sMotionRuns = 0;
+	sBackgroundRuns = 0;
+	sMaxMotionLateUs = 0;
+	sLateMotionRuns = 0;
+	sMaxBackgroundSliceUs = 0;
+
+	RunLoop lLoop;
+	lLoop.SetSleepEnabled(false);
+	HOST_CHECK(lLoop.AddTask(&lAudio, eeAudioPriority, 1000, 200));
+	sMotionStartUs = micros();
+	HOST_CHECK(lLoop.AddTask(&lMotion, eeMotionPriority, 2000, 200));
+	HOST_CHECK(lLoop.AddTask(&lBackground, eeBackgroundPriority, 0, 700));
+
+	lLoop.RunFor(200);
+
+	tTaskStats lMotionStats;
+	tTaskStats lBackgroundStats;
+	HOST_CHECK(lLoop.GetStats(&lMotion, lMotionStats));
+	HOST_CHECK(lLoop.GetStats(&lBackground, lBackgroundStats));
+	printf("%u background slices, longest %d us, %u overran; %u motion reads, %u late, latest by %u us\n",
+	       sBackgroundRuns, sMaxBackgroundSliceUs, lBackgroundStats.mOverruns,
+	       sMotionRuns, sLateMotionRuns, sMaxMotionLateUs);
+
+	HOST_CHECK(sBackgroundRuns > 0);
+	HOST_CHECK(sMaxBackgroundSliceUs <= 700);
+	HOST_CHECK(sMotionRuns >= 95);
+	HOST_CHECK(0 == lMotionStats.mLateStarts);
+	//The host can deschedule the test now and then, which can push a slice
+	//past its deadline or a read past its time. Otherwise slices end by
+	//their deadline and reads start within an audio run of their time.
+	HOST_CHECK(lBackgroundStats.mOverruns <= sBackgroundRuns / 100);
+	HOST_CHECK(sLateMotionRuns <= sMotionRuns / 50);
+}
+
+/**
+ * The loop sleeps on every pass that runs nothing, and never while a task
+ * runs on every pass.
+ */
+static void CheckSleep()
+{
+	FunctionTask lAudio(DoNothing);
+	FunctionTask lMotion(DoNothing);
+	FunctionTask lBackground(DoNothing);
+
+	RunLoop lLoop;
+	HOST_CHECK(lLoop.AddTask(&lAudio, eeAudioPriority, 1000, 200));
+	HOST_CHECK(lLoop.AddTask(&lMotion, eeMotionPriority, 5000, 200));
+	HOST_CHECK(lLoop.AddTask(&lBackground, eeBackgroundPriority, 10000, 500));
+
+	uint32_t lPasses = 0;
+	uint32_t lIdle = 0;
+	uint64_t lSleptUs = HostClock::GetAdvancedUs();
+	uint32_t lStart = millis();
+	while(millis() - lStart < 50)
+	{
+		lPasses++;
+		lIdle += !lLoop.RunOnce();
+	}
+	lSleptUs = HostClock::GetAdvancedUs() - lSleptUs;
+
+	printf("%u of %u passes idle, slept %u us\n", lIdle, lPasses, (uint32_t)lSleptUs);
+	HOST_CHECK(lIdle > lPasses * 9 / 10);
+	HOST_CHECK(lSleptUs == (uint64_t)lIdle * WFE_US);
+
+	//With sleep turned off, idle passes return at once
+	lLoop.SetSleepEnabled(false);
+	lSleptUs = HostClock::GetAdvancedUs();
+	lIdle = 0;
+	for(int lPass = 0; lPass < 1000; lPass++)
+	{
+		lIdle += !lLoop.RunOnce();
+	}
+	HOST_CHECK(lIdle > 0);
+	HOST_CHECK(HostClock::GetAdvancedUs() == lSleptUs);
+
+	//A task that runs on every pass keeps the loop awake
+	RunLoop lBusyLoop;
+	HOST_CHECK(lBusyLoop.AddTask(&lAudio, eeAudioPriority, 1000, 200));
+	HOST_CHECK(lBusyLoop.AddTask(&lMotion, eeMotionPriority, 0, 200));
+	lSleptUs = HostClock::GetAdvancedUs();
+	lIdle = 0;
+	for(int lPass = 0; lPass < 1000; lPass++)
+	{
+		lIdle += !lBusyLoop.RunOnce();
+	}
+	HOST_CHECK(0 == lIdle);
+	HOST_CHECK(HostClock::GetAdvancedUs() == lSleptUs);
+}
+
+int main(int argc, char** argv)
+{
+	CheckBackgroundShare();
+	CheckOrder();
+	CheckBackgroundDeadline();
+	CheckSleep();
+
+	return HostTest::Result();
+}
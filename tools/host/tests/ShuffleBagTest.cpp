@@ -0,0 +1,228 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * ShuffleBagTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Random sound selection. The shuffle bag on its own must never draw the
+ * same item twice in a row, even across refills, and must reach every
+ * item. With the voice engine, random swings over a hum must each be
+ * served from the standby voice: the sound the manager preloaded is the
+ * one that plays, and starting it touches the card not at all.
+ *
+ * Usage:
+ *   ShuffleBagTest <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+
+//Draws per bag size
+#define BAG_DRAWS (2000)
+
+//Number of random swings, and the range of times between them (ms)
+#define SWINGS (133)
+#define SWING_MIN_MS (100)
+#define SWING_MAX_MS (300)
+
+/**
+ * Sound manager that records the sounds it plays and shows what it has
+ * preloaded.
+ */
+class TestSoundManager : public NECSoundManager
+{
+public:
+	TestSoundManager(I2SWavPlayer* apPlayer) :
+		NECSoundManager(apPlayer),
+		mLastIndex(0xFFFF)
+	{
+	}
+
+	virtual bool PlaySound(SoundTypes::ESoundTypes aSoundType, uint16_t aIndex = 0)
+	{
+		mLastIndex = aIndex;
+		return NECSoundManager::PlaySound(aSoundType, aIndex);
+	}
+
+	/**
+	 * Returns TRUE if the standby voice holds the next random sound of a type.
+	 */
+	bool IsNextPreloaded(SoundTypes::ESoundTypes aSoundType)
+	{
+		return mpVoiceEngine->IsPreloaded()
+		       && mPreloadedType == aSoundType
+		       && mPreloadedIndex == maShuffleBags[aSoundType].Peek();
+	}
+
+	uint16_t GetPreloadedIndex() { return mPreloadedIndex; }
+	uint8_t GetNumSounds(SoundTypes::ESoundTypes aSoundType) { return mFont.GetCount(aSoundType); }
+
+	//Index of the last sound played
+	uint16_t mLastIndex;
+};
+
+/**
+ * Draws from bags of every size across many refills.
+ */
+static void CheckBag()
+{
+	for(uint8_t lNumItems = 1; lNumItems <= SHUFFLE_BAG_MAX_ITEMS; lNumItems++)
+	{
+		ShuffleBag lBag;
+		lBag.Reset(lNumItems);
+		HOST_CHECK(lNumItems == lBag.GetNumItems());
+
+		uint32_t laCounts[SHUFFLE_BAG_MAX_ITEMS] = { 0 };
+		uint32_t lRepeats = 0;
+		uint32_t lPeekMisses = 0;
+		uint32_t lBadRounds = 0;
+		uint16_t lRoundMask = 0;
+		uint8_t lLast = 0xFF;
+		for(uint32_t lDraw = 0; lDraw < BAG_DRAWS; lDraw++)
+		{
+			uint8_t lPeek = lBag.Peek();
+			uint8_t lItem = lBag.Next();
+			if(lItem >= lNumItems)
+			{
+				HOST_CHECK(lItem < lNumItems);
+				return;
+			}
+
+			lPeekMisses += lPeek != lItem;
+			lRepeats += lNumItems > 1 && lItem == lLast;
+			laCounts[lItem]++;
+			lLast = lItem;
+
+			//Every item once in each round of draws
+			lRoundMask |= 1 << lItem;
+			if(0 == (lDraw + 1) % lNumItems)
+			{
+				lBadRounds += lRoundMask != (1 << lNumItems) - 1;
+				lRoundMask = 0;
+			}
+		}
+
+		HOST_CHECK(0 == lRepeats);
+		HOST_CHECK(0 == lPeekMisses);
+		HOST_CHECK(0 == lBadRounds);
+		for(uint8_t lIdx = 0; lIdx < lNumItems; lIdx++)
+		{
+			HOST_CHECK(laCounts[lIdx] >= BAG_DRAWS / lNumItems);
+		}
+	}
+
+	//An empty bag draws 0
+	ShuffleBag lEmpty;
+	HOST_CHECK(0 == lEmpty.Peek());
+	HOST_CHECK(0 == lEmpty.Next());
+}
+
+/**
+ * Plays random swings over a hum.
+ */
+static void CheckPreload()
+{
+	HostAudioSink lSink(1024);
+	VoiceEngine lEngine(&lSink);
+	I2SWavPlayer lPlayer(0, 0, 0, 0, 0);
+	TestSoundManager lSndMgr(&lPlayer);
+
+	HOST_CHECK(SD.begin(8000000, 11));
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetFont(0);
+	HOST_CHECK(lSndMgr.PlaySound(SoundTypes::eeHumSnd));
+
+	uint32_t laCounts[SHUFFLE_BAG_MAX_ITEMS] = { 0 };
+	uint32_t lRepeats = 0;
+	uint32_t lNotPreloaded = 0;
+	uint32_t lMismatches = 0;
+	uint32_t lCardTouches = 0;
+	uint16_t lLast = 0xFFFF;
+	uint32_t lNextUs = micros() + SWING_MIN_MS * 1000;
+	for(uint32_t lSwing = 0; lSwing < SWINGS;)
+	{
+		lSndMgr.ContinuePlay();
+		if((int32_t)(micros() - lNextUs) < 0)
+		{
+			continue;
+		}
+
+		bool lPreloaded = lSndMgr.IsNextPreloaded(SoundTypes::eeSwingSnd);
+		uint16_t lPreloadedIdx = lSndMgr.GetPreloadedIndex();
+		tHostSdStats lBefore;
+		HostSd::GetStats(lBefore);
+		HOST_CHECK(lSndMgr.PlayRandomSound(SoundTypes::eeSwingSnd));
+		tHostSdStats lAfter;
+		HostSd::GetStats(lAfter);
+
+		//The first swing can't have been preloaded, nothing had played
+		if(lSwing > 0)
+		{
+			lNotPreloaded += !lPreloaded;
+			lMismatches += lPreloaded && lPreloadedIdx != lSndMgr.mLastIndex;
+			lCardTouches += lAfter.mOpens != lBefore.mOpens
+			                || lAfter.mSeeks != lBefore.mSeeks
+			                || lAfter.mReads != lBefore.mReads;
+		}
+
+		lRepeats += lSndMgr.mLastIndex == lLast;
+		if(lSndMgr.mLastIndex < SHUFFLE_BAG_MAX_ITEMS)
+		{
+			laCounts[lSndMgr.mLastIndex]++;
+		}
+		lLast = lSndMgr.mLastIndex;
+
+		lSwing++;
+		lNextUs = micros() + (SWING_MIN_MS + random(SWING_MAX_MS - SWING_MIN_MS)) * 1000;
+	}
+	lSndMgr.SetVoiceEngine(nullptr);
+
+	uint8_t lNumSwings = lSndMgr.GetNumSounds(SoundTypes::eeSwingSnd);
+	printf("%u swings of %u: %u not preloaded, %u mismatched, %u touched the card, %u repeats, %u gaps, %u underruns\n",
+	       SWINGS, lNumSwings, lNotPreloaded, lMismatches, lCardTouches, lRepeats, lSink.GetGaps(), lEngine.GetUnderruns());
+
+	HOST_CHECK(0 == lNotPreloaded);
+	HOST_CHECK(0 == lMismatches);
+	HOST_CHECK(0 == lCardTouches);
+	HOST_CHECK(0 == lRepeats);
+	HOST_CHECK(0 == lSink.GetGaps());
+	HOST_CHECK(0 == lEngine.GetUnderruns());
+	for(uint8_t lIdx = 0; lIdx < lNumSwings; lIdx++)
+	{
+		HOST_CHECK(laCounts[lIdx] >= SWINGS / lNumSwings);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	HostSd::SetRoot(argv[1]);
+	HostSd::SetLatency(HostSd::GetSpiCardLatency());
+
+	CheckBag();
+	CheckPreload();
+
+	return HostTest::Result();
+}
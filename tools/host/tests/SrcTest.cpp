@@ -0,0 +1,244 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * SrcTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Quality of a voice's sample-rate conversion: sine WAVs at other rates
+ * than the output, played through SaberVoice with the polyphase filter
+ * and with linear interpolation. Reports the SNR of each against a
+ * fitted sine, and the host cost per output sample. Switching between the
+ * two in the middle of a sound, as the quality governor does, must not
+ * make the output jump.
+ *
+ * Usage:
+ *   SrcTest <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+#include <sys/stat.h>
+#include <vector>
+
+//Length of each test file (seconds)
+#define TONE_SECONDS (2)
+
+//Output blocks rendered per run
+#define RENDER_BLOCKS (600)
+
+/**
+ * Result of playing one file.
+ */
+struct tSrcResult
+{
+	//Signal to noise ratio (dB)
+	double mSnrDb;
+	//Host CPU time per output sample (nanoseconds)
+	double mNsPerSample;
+};
+
+/**
+ * Gets the ratio of a fitted sine's power to the power of what is left,
+ * skipping the first quarter while the filter fills.
+ */
+static double GetSnrDb(const std::vector<int32_t>& arOut, double aHz)
+{
+	size_t lStart = arOut.size() / 4;
+	double lSs = 0, lCc = 0, lSc = 0, lYs = 0, lYc = 0;
+
+	for(size_t lIdx = lStart; lIdx < arOut.size(); lIdx++)
+	{
+		double lSin = sin(2 * M_PI * aHz * lIdx / NSABER_OUTPUT_SAMPLE_RATE);
+		double lCos = cos(2 * M_PI * aHz * lIdx / NSABER_OUTPUT_SAMPLE_RATE);
+		lSs += lSin * lSin;
+		lCc += lCos * lCos;
+		lSc += lSin * lCos;
+		lYs += arOut[lIdx] * lSin;
+		lYc += arOut[lIdx] * lCos;
+	}
+
+	double lDet = lSs * lCc - lSc * lSc;
+	double lA = (lYs * lCc - lYc * lSc) / lDet;
+	double lB = (lYc * lSs - lYs * lSc) / lDet;
+	double lSignal = 0;
+	double lNoise = 0;
+
+	for(size_t lIdx = lStart; lIdx < arOut.size(); lIdx++)
+	{
+		double lFit = lA * sin(2 * M_PI * aHz * lIdx / NSABER_OUTPUT_SAMPLE_RATE)
+		              + lB * cos(2 * M_PI * aHz * lIdx / NSABER_OUTPUT_SAMPLE_RATE);
+		lSignal += lFit * lFit;
+		lNoise += (arOut[lIdx] - lFit) * (arOut[lIdx] - lFit);
+	}
+
+	return 10 * log10(lSignal / lNoise);
+}
+
+/**
+ * Writes a sine WAV to the card root as tone.wav.
+ */
+static void WriteTone(const char* apDir, uint32_t aRate, double aHz)
+{
+	std::vector<int16_t> lSamples(aRate * TONE_SECONDS);
+	for(size_t lIdx = 0; lIdx < lSamples.size(); lIdx++)
+	{
+		lSamples[lIdx] = (int16_t)lrint(16000 * sin(2 * M_PI * aHz * lIdx / aRate));
+	}
+
+	char laPath[2048];
+	snprintf(laPath, sizeof(laPath), "%s/tone.wav", apDir);
+	HOST_CHECK(HostFont::WriteWav(laPath, lSamples.data(), lSamples.size(), aRate));
+}
+
+/**
+ * Writes a sine WAV and plays it through a voice.
+ * Args:
+ *  apDir - Directory of the card root
+ *  aRate - Sample rate of the file
+ *  aHz - Frequency of the tone
+ *  aPolyphase - FALSE to interpolate linearly
+ */
+static tSrcResult PlayTone(const char* apDir, uint32_t aRate, double aHz, bool aPolyphase)
+{
+	WriteTone(apDir, aRate, aHz);
+
+	tSrcResult lResult = {0, 0};
+	SaberVoice lVoice;
+	if(!lVoice.Open("/tone.wav"))
+	{
+		HOST_CHECK(false);
+		return lResult;
+	}
+	lVoice.SetPolyphaseEnabled(aPolyphase);
+
+	std::vector<int32_t> lOut;
+	int32_t laMix[VOICE_BLOCK_SAMPLES];
+	uint64_t lCpuUs = 0;
+
+	for(int lBlock = 0; lBlock < RENDER_BLOCKS; lBlock++)
+	{
+		lVoice.GetStream()->Refill(100000);
+		memset(laMix, 0, sizeof(laMix));
+
+		uint64_t lStart = HostClock::GetCpuUs();
+		uint16_t lNum = lVoice.Render(laMix, VOICE_BLOCK_SAMPLES);
+		lCpuUs += HostClock::GetCpuUs() - lStart;
+
+		lOut.insert(lOut.end(), laMix, laMix + lNum);
+	}
+	lVoice.Close();
+
+	//The voice steps through the file in 16.16 fixed point, which puts the
+	//tone a few hundredths of a cent off; fit the tone it actually plays
+	float lRatio = 1.0f * aRate / NSABER_OUTPUT_SAMPLE_RATE;
+	uint32_t lStep = (uint32_t)(lRatio * 0x10000);
+	double lPlayedHz = aHz * lStep / (0x10000 * (double)aRate / NSABER_OUTPUT_SAMPLE_RATE);
+
+	lResult.mSnrDb = GetSnrDb(lOut, lPlayedHz);
+	lResult.mNsPerSample = lOut.empty() ? 0 : lCpuUs * 1000.0 / lOut.size();
+
+	return lResult;
+}
+
+/**
+ * Plays a tone, switching the polyphase filter off and on every few
+ * blocks.
+ * Returns:
+ *  Largest step between output samples relative to the step of a clean
+ *  sine at the tone's frequency and peak
+ */
+static double PlaySwitching(const char* apDir, uint32_t aRate, double aHz)
+{
+	WriteTone(apDir, aRate, aHz);
+
+	SaberVoice lVoice;
+	if(!lVoice.Open("/tone.wav"))
+	{
+		HOST_CHECK(false);
+		return 0;
+	}
+
+	int32_t laMix[VOICE_BLOCK_SAMPLES];
+	int32_t lLast = 0;
+	int32_t lMaxStep = 0;
+	int32_t lPeak = 1;
+
+	for(int lBlock = 0; lBlock < RENDER_BLOCKS; lBlock++)
+	{
+		lVoice.SetPolyphaseEnabled(0 == (lBlock / 5) % 2);
+		lVoice.GetStream()->Refill(100000);
+		memset(laMix, 0, sizeof(laMix));
+		uint16_t lNum = lVoice.Render(laMix, VOICE_BLOCK_SAMPLES);
+
+		//Skip the first blocks while the filter fills
+		for(uint16_t lIdx = 0; lIdx < lNum; lIdx++)
+		{
+			if(lBlock >= 10)
+			{
+				lMaxStep = max(lMaxStep, abs(laMix[lIdx] - lLast));
+				lPeak = max(lPeak, abs(laMix[lIdx]));
+			}
+			lLast = laMix[lIdx];
+		}
+	}
+	lVoice.Close();
+
+	return lMaxStep / (lPeak * 2 * M_PI * aHz / NSABER_OUTPUT_SAMPLE_RATE);
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	char laDir[1024];
+	snprintf(laDir, sizeof(laDir), "%s/src", argv[1]);
+	mkdir(laDir, 0755);
+	HostSd::SetRoot(laDir);
+
+	const uint32_t laRates[] = {16000, 22050, 32000, 48000};
+	const double laTones[] = {0.05, 0.2};
+
+	for(uint32_t lRate : laRates)
+	{
+		for(double lTone : laTones)
+		{
+			double lHz = lTone * lRate;
+			tSrcResult lPoly = PlayTone(laDir, lRate, lHz, true);
+			tSrcResult lLinear = PlayTone(laDir, lRate, lHz, false);
+
+			printf("%5u Hz file, %5.0f Hz tone: polyphase %4.1f dB (%.1f ns per sample), "
+			       "linear %4.1f dB (%.1f ns per sample)\n",
+			       lRate, lHz, lPoly.mSnrDb, lPoly.mNsPerSample, lLinear.mSnrDb, lLinear.mNsPerSample);
+
+			HOST_CHECK(lPoly.mSnrDb >= 45);
+			HOST_CHECK(lPoly.mSnrDb > lLinear.mSnrDb);
+		}
+	}
+
+	double lStep = PlaySwitching(laDir, 22050, 1102.5);
+	printf("switching every 5 blocks: largest step %.2f times a clean sine's\n", lStep);
+	HOST_CHECK(lStep < 1.5);
+
+	return HostTest::Result();
+}
@@ -0,0 +1,136 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * ZeroHeapTest
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Heap use of a session in the NSABER_STATIC_ALLOCATION build. Once a
+ * packed font is selected, triggering sounds on the voice engine must not
+ * allocate. The host SD card allocates a handle for every file it opens,
+ * like the SdFat library, so a trigger that opens a file shows up too.
+ * The legacy I2SWavPlayer path still opens a file per sound; its count is
+ * printed but not checked.
+ * Runs as part of the build, which fails if the engine allocates.
+ *
+ * Usage:
+ *   ZeroHeapTest <card directory>
+ */
+
+#include <NSaber.h>
+#include "HostBackend.h"
+#include "HostTest.h"
+
+#if !NSABER_STATIC_ALLOCATION
+#error ZeroHeapTest needs NSABER_STATIC_ALLOCATION
+#endif
+
+//Length of each session (milliseconds)
+#define SESSION_MS (5000)
+
+/**
+ * Plays hum with a swing every 150 ms and a clash every second, calling
+ * ContinuePlay() once per millisecond, and counts heap allocations.
+ * Args:
+ *  arSndMgr - Sound manager with a font selected
+ *  apPlayer - I2SWavPlayer to pump, nullptr on the voice engine path
+ *  aReport - TRUE to print where the first few allocations come from
+ * Returns:
+ *  Allocations during the session
+ */
+static uint32_t RunSession(NECSoundManager& arSndMgr, I2SWavPlayer* apPlayer, bool aReport)
+{
+	arSndMgr.PlaySound(SoundTypes::eeHumSnd);
+
+	HostAlloc::Begin(aReport);
+
+	uint32_t lStart = millis();
+	uint32_t lNextSwing = lStart;
+	uint32_t lNextClash = lStart + 500;
+
+	while(millis() - lStart < SESSION_MS)
+	{
+		uint32_t lNow = millis();
+		if((int32_t)(lNow - lNextSwing) >= 0)
+		{
+			arSndMgr.PlayRandomSound(SoundTypes::eeSwingSnd);
+			lNextSwing += 150;
+		}
+		if((int32_t)(lNow - lNextClash) >= 0)
+		{
+			arSndMgr.PlayRandomSound(SoundTypes::eeClashSnd);
+			lNextClash += 1000;
+		}
+
+		if(nullptr != apPlayer)
+		{
+			apPlayer->ContinuePlayback();
+		}
+		arSndMgr.ContinuePlay();
+		HostClock::Advance(1000);
+	}
+
+	return HostAlloc::End();
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <card directory>\n", argv[0]);
+		return 1;
+	}
+
+	HostSd::SetRoot(argv[1]);
+	HostSd::SetLatency(HostSd::GetSpiCardLatency());
+	HOST_CHECK(SD.begin(8000000, 11));
+
+	HostAudioSink lSink;
+	I2SWavPlayer lI2SPlayer(0, 0, 0, 0, 0);
+	NECSoundManager lSndMgr(&lI2SPlayer);
+
+	lI2SPlayer.SetSink(&lSink);
+	lI2SPlayer.Init();
+	lI2SPlayer.StartPlayback();
+	lSndMgr.Init();
+	lSndMgr.SetFont(0);
+
+	uint32_t lLegacy = RunSession(lSndMgr, &lI2SPlayer, false);
+	lI2SPlayer.StopPlayback();
+
+	VoiceEngine lEngine(&lSink);
+	lSink.Reset();
+	lSndMgr.SetVoiceEngine(&lEngine);
+	lSndMgr.SetFont(0);
+
+	HostSd::ResetStats();
+	uint32_t lEngineAllocs = RunSession(lSndMgr, nullptr, true);
+	tHostSdStats lSd;
+	HostSd::GetStats(lSd);
+	lSndMgr.SetVoiceEngine(nullptr);
+
+	printf("I2SWavPlayer: %u allocations in %u ms\n", lLegacy, SESSION_MS);
+	printf("voice engine, packed font: %u allocations, %u opens, %u samples in %u ms\n",
+	       lEngineAllocs, lSd.mOpens, lSink.GetWritten(), SESSION_MS);
+
+	HOST_CHECK(0 == lEngineAllocs);
+	HOST_CHECK(0 == lSd.mOpens);
+	HOST_CHECK(lSink.GetWritten() > 0);
+
+	return HostTest::Result();
+}
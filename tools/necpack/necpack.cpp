@@ -0,0 +1,586 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * necpack.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Converts a sound font directory into a packed font (".nfp") that
+ * NECSoundManager can play from with a single seek per sound.
+ *
+ * Build on a PC:
+ *   g++ -O2 -o necpack necpack.cpp
+ *
+ * Usage:
+ *   necpack [--adpcm] [--layout nec|plecter|cfx] <font directory> <output file> [font name]
+ *
+ *   --layout File naming of the font directory, see Sound/FontLayout.h.
+ *            Defaults to nec.
+ *   --adpcm  Store sounds as mono IMA ADPCM, a quarter of the size of 16-bit
+ *            PCM. Also reports how long decoding takes on this machine.
+ *
+ * Example:
+ *   necpack /media/sd/necfont1 /media/sd/necfont1.nfp "Graflex"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+
+#include "../../Sound/SoundTypes.h"
+#include "../../Sound/FontPack.h"
+#include "../../Sound/FontLayout.h"
+#include "../../Sound/ImaAdpcm.h"
+
+#define WAV_FORMAT_PCM       (1)
+#define WAV_FORMAT_IMA_ADPCM (0x11)
+
+//ADPCM block size, 505 samples per block
+#define ADPCM_BLOCK_ALIGN (256)
+
+//Longest crossfade that fits a loop to whole ADPCM blocks (samples)
+#define ADPCM_LOOP_FADE (2048)
+
+//A sound found in the font directory
+struct tSound
+{
+	FontPack::tFontPackEntry mEntry;
+	std::vector<uint8_t> mData;
+};
+
+static uint16_t Read16(const uint8_t* apBytes)
+{
+	return (uint16_t)apBytes[0] | ((uint16_t)apBytes[1] << 8);
+}
+
+static uint32_t Read32(const uint8_t* apBytes)
+{
+	return (uint32_t)Read16(apBytes) | ((uint32_t)Read16(apBytes + 2) << 16);
+}
+
+/**
+ * Loads the format, sample data and loop points of a WAV file. The first
+ * loop of a "smpl" chunk sets the loop points of PCM files, otherwise the
+ * whole data loops.
+ * Args:
+ *  apPath - File to load
+ *  arSound - Output parameter, populated with the format and data
+ * Returns:
+ *  TRUE if successful, FALSE otherwise
+ */
+static bool LoadWav(const char* apPath, tSound& arSound)
+{
+	FILE* lpFile = fopen(apPath, "rb");
+	if(nullptr == lpFile)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> lBytes;
+	uint8_t laChunk[4096];
+	size_t lRead;
+	while((lRead = fread(laChunk, 1, sizeof(laChunk), lpFile)) > 0)
+	{
+		lBytes.insert(lBytes.end(), laChunk, laChunk + lRead);
+	}
+	fclose(lpFile);
+
+	if(lBytes.size() < 12 || 0 != memcmp(&lBytes[0], "RIFF", 4) || 0 != memcmp(&lBytes[8], "WAVE", 4))
+	{
+		fprintf(stderr, "%s: not a WAV file\n", apPath);
+		return false;
+	}
+
+	bool lFoundFmt = false;
+	bool lFoundData = false;
+	bool lFoundLoop = false;
+	uint32_t lLoopStartFrame = 0;
+	uint32_t lLoopEndFrame = 0;
+	size_t lPos = 12;
+
+	while(lPos + 8 <= lBytes.size())
+	{
+		uint32_t lChunkSize = Read32(&lBytes[lPos + 4]);
+		const uint8_t* lpBody = &lBytes[lPos + 8];
+		size_t lAvailable = lBytes.size() - (lPos + 8);
+
+		if(0 == memcmp(&lBytes[lPos], "fmt ", 4) && lChunkSize >= 16 && lAvailable >= 16)
+		{
+			arSound.mEntry.mFormat = Read16(lpBody);
+			arSound.mEntry.mNumChannels = Read16(lpBody + 2);
+			arSound.mEntry.mSampleRate = Read32(lpBody + 4);
+			arSound.mEntry.mBlockAlign = Read16(lpBody + 12);
+			arSound.mEntry.mBitsPerSample = Read16(lpBody + 14);
+			lFoundFmt = true;
+		}
+		else if(0 == memcmp(&lBytes[lPos], "data", 4))
+		{
+			size_t lLength = lChunkSize < lAvailable ? lChunkSize : lAvailable;
+			arSound.mData.assign(lpBody, lpBody + lLength);
+			lFoundData = true;
+		}
+		else if(0 == memcmp(&lBytes[lPos], "smpl", 4) && lChunkSize >= 60 && lAvailable >= 60
+		        && Read32(lpBody + 28) > 0)
+		{
+			//Loop end is the last frame played, inclusive
+			lLoopStartFrame = Read32(lpBody + 36 + 8);
+			lLoopEndFrame = Read32(lpBody + 36 + 12) + 1;
+			lFoundLoop = true;
+		}
+
+		lPos += 8 + lChunkSize + (lChunkSize & 1);
+	}
+
+	if(!lFoundFmt || !lFoundData)
+	{
+		fprintf(stderr, "%s: missing fmt or data chunk\n", apPath);
+		return false;
+	}
+
+	arSound.mEntry.mDataLength = arSound.mData.size();
+	arSound.mEntry.mLoopStart = 0;
+	arSound.mEntry.mLoopEnd = arSound.mData.size();
+
+	if(lFoundLoop)
+	{
+		size_t lNumFrames = arSound.mEntry.mBlockAlign ? arSound.mData.size() / arSound.mEntry.mBlockAlign : 0;
+
+		if(WAV_FORMAT_PCM == arSound.mEntry.mFormat && lLoopStartFrame < lLoopEndFrame && lLoopEndFrame <= lNumFrames)
+		{
+			arSound.mEntry.mLoopStart = lLoopStartFrame * arSound.mEntry.mBlockAlign;
+			arSound.mEntry.mLoopEnd = lLoopEndFrame * arSound.mEntry.mBlockAlign;
+		}
+		else
+		{
+			fprintf(stderr, "%s: ignoring loop points\n", apPath);
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Looks up a font layout by name.
+ * Args:
+ *  apName - "nec", "plecter" or "cfx"
+ *  arType - Output parameter, populated with the layout type
+ * Returns:
+ *  TRUE if successful, FALSE if the name is unknown
+ */
+static bool ParseLayout(const char* apName, SoundTypes::EChannelMapType& arType)
+{
+	if(0 == strcmp(apName, "nec"))
+	{
+		arType = SoundTypes::eeClassicNEC;
+	}
+	else if(0 == strcmp(apName, "plecter"))
+	{
+		arType = SoundTypes::eeClassicPlecter;
+	}
+	else if(0 == strcmp(apName, "cfx"))
+	{
+		arType = SoundTypes::eeCFX;
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Converts PCM sample data to mono 16-bit.
+ * Args:
+ *  arSound - Sound to read
+ *  arOut - Output parameter, populated with the samples
+ * Returns:
+ *  TRUE if successful, FALSE if the format isn't supported
+ */
+static bool ToMono16(const tSound& arSound, std::vector<int16_t>& arOut)
+{
+	const FontPack::tFontPackEntry& lEntry = arSound.mEntry;
+
+	if(WAV_FORMAT_PCM != lEntry.mFormat || 0 == lEntry.mBlockAlign
+	   || (8 != lEntry.mBitsPerSample && 16 != lEntry.mBitsPerSample))
+	{
+		return false;
+	}
+
+	size_t lNumFrames = arSound.mData.size() / lEntry.mBlockAlign;
+	arOut.resize(lNumFrames);
+
+	for(size_t lFrame = 0; lFrame < lNumFrames; lFrame++)
+	{
+		const uint8_t* lpFrame = &arSound.mData[lFrame * lEntry.mBlockAlign];
+		int32_t lSum = 0;
+
+		for(int lChannel = 0; lChannel < lEntry.mNumChannels; lChannel++)
+		{
+			if(8 == lEntry.mBitsPerSample)
+			{
+				lSum += ((int32_t)lpFrame[lChannel] - 128) << 8;
+			}
+			else
+			{
+				lSum += (int16_t)Read16(lpFrame + lChannel * 2);
+			}
+		}
+
+		arOut[lFrame] = lSum / lEntry.mNumChannels;
+	}
+
+	return true;
+}
+
+/**
+ * Fills the looped part of a sound so it can be looped on whole blocks.
+ * The loop starts at the first block boundary at or after its start and
+ * runs for the whole blocks it takes to hold the loop once. The loop
+ * continues from that boundary, and the extra samples in the last block
+ * crossfade into the samples that lead up to the boundary, so the wrap
+ * back to it is seamless.
+ * Args:
+ *  arSamples - Samples of the sound, resized to end with the loop
+ *  aLoopStart - First sample of the loop
+ *  aLoopLength - Samples in the loop
+ *  aSamplesPerBlock - Samples in an ADPCM block
+ * Returns:
+ *  Index of the block the loop starts at
+ */
+static size_t FillBlockLoop(std::vector<int16_t>& arSamples, size_t aLoopStart, size_t aLoopLength, uint16_t aSamplesPerBlock)
+{
+	size_t lLoopBlock = (aLoopStart + aSamplesPerBlock - 1) / aSamplesPerBlock;
+	size_t lLoopBlocks = (aLoopLength + aSamplesPerBlock - 1) / aSamplesPerBlock;
+	size_t lSpan = lLoopBlocks * aSamplesPerBlock;
+
+	//The loop as it plays from the block boundary on
+	std::vector<int16_t> lLoop(aLoopLength);
+	size_t lPhase = lLoopBlock * aSamplesPerBlock - aLoopStart;
+	for(size_t lIdx = 0; lIdx < aLoopLength; lIdx++)
+	{
+		lLoop[lIdx] = arSamples[aLoopStart + (lPhase + lIdx) % aLoopLength];
+	}
+
+	//The span is lExtra samples longer than the loop. Over its last
+	//lFade samples, fade from the loop carrying on to the loop lExtra
+	//samples back, which arrives at the start exactly as the span ends.
+	size_t lExtra = lSpan - aLoopLength;
+	size_t lFade = std::min(lSpan, (size_t)ADPCM_LOOP_FADE);
+	size_t lFirst = lLoopBlock * aSamplesPerBlock;
+
+	arSamples.resize(lFirst + lSpan);
+	for(size_t lIdx = 0; lIdx < lSpan; lIdx++)
+	{
+		int32_t lSample = lLoop[lIdx % aLoopLength];
+
+		if(lExtra > 0 && lIdx + lFade >= lSpan)
+		{
+			int32_t lTarget = lLoop[(lIdx + aLoopLength - lExtra) % aLoopLength];
+			int32_t lWeight = (int32_t)(lIdx + lFade + 1 - lSpan);
+			lSample += (lTarget - lSample) * lWeight / (int32_t)lFade;
+		}
+
+		arSamples[lFirst + lIdx] = (int16_t)lSample;
+	}
+
+	return lLoopBlock;
+}
+
+/**
+ * Re-encodes a PCM sound as mono IMA ADPCM. The last block is padded with
+ * silence. ADPCM can only loop on whole blocks, see FillBlockLoop() for how
+ * looping sounds are fitted to them.
+ * Args:
+ *  arSound - Sound to convert in place
+ * Returns:
+ *  TRUE if successful, FALSE if the format isn't supported
+ */
+static bool ConvertToAdpcm(tSound& arSound)
+{
+	std::vector<int16_t> lSamples;
+	if(!ToMono16(arSound, lSamples))
+	{
+		return false;
+	}
+
+	uint16_t lSamplesPerBlock = ImaAdpcm::SamplesPerBlock(ADPCM_BLOCK_ALIGN);
+	size_t lNumBlocks = (lSamples.size() + lSamplesPerBlock - 1) / lSamplesPerBlock;
+	size_t lLoopBlock = 0;
+
+	if((arSound.mEntry.mFlags & FONT_PACK_FLAG_LOOP) && !lSamples.empty())
+	{
+		size_t lLoopStart = arSound.mEntry.mLoopStart / arSound.mEntry.mBlockAlign;
+		size_t lLoopLength = arSound.mEntry.mLoopEnd / arSound.mEntry.mBlockAlign - lLoopStart;
+
+		lLoopBlock = FillBlockLoop(lSamples, lLoopStart, lLoopLength, lSamplesPerBlock);
+		lNumBlocks = lSamples.size() / lSamplesPerBlock;
+	}
+	else
+	{
+		lSamples.resize(lNumBlocks * lSamplesPerBlock, 0);
+	}
+
+	arSound.mData.resize(lNumBlocks * ADPCM_BLOCK_ALIGN);
+
+	ImaAdpcm::tState lState;
+	for(size_t lBlock = 0; lBlock < lNumBlocks; lBlock++)
+	{
+		ImaAdpcm::EncodeBlock(lState,
+				              &lSamples[lBlock * lSamplesPerBlock],
+				              ADPCM_BLOCK_ALIGN,
+				              &arSound.mData[lBlock * ADPCM_BLOCK_ALIGN]);
+	}
+
+	//The decoder takes the step size from the loop block's header when it
+	//wraps. Encode the loop again starting from the step size it ends on,
+	//so it doesn't start over from the smallest step on every pass.
+	if(arSound.mEntry.mFlags & FONT_PACK_FLAG_LOOP)
+	{
+		for(int lPass = 0; lPass < 2; lPass++)
+		{
+			for(size_t lBlock = lLoopBlock; lBlock < lNumBlocks; lBlock++)
+			{
+				ImaAdpcm::EncodeBlock(lState,
+						              &lSamples[lBlock * lSamplesPerBlock],
+						              ADPCM_BLOCK_ALIGN,
+						              &arSound.mData[lBlock * ADPCM_BLOCK_ALIGN]);
+			}
+		}
+	}
+
+	arSound.mEntry.mFormat = WAV_FORMAT_IMA_ADPCM;
+	arSound.mEntry.mNumChannels = 1;
+	arSound.mEntry.mBitsPerSample = 4;
+	arSound.mEntry.mBlockAlign = ADPCM_BLOCK_ALIGN;
+	arSound.mEntry.mDataLength = arSound.mData.size();
+	arSound.mEntry.mLoopStart = lLoopBlock * ADPCM_BLOCK_ALIGN;
+	arSound.mEntry.mLoopEnd = arSound.mData.size();
+
+	return true;
+}
+
+/**
+ * Times the decoder over all ADPCM sounds and prints the cost per sample
+ * next to the card bandwidth it saves.
+ */
+static void BenchmarkAdpcm(const std::vector<tSound>& arSounds, uint64_t aPcmBytes)
+{
+	uint64_t lAdpcmBytes = 0;
+	uint64_t lNumSamples = 0;
+	int16_t laOut[ADPCM_BLOCK_ALIGN * 2];
+	volatile int32_t lSink = 0;
+
+	clock_t lStart = clock();
+	for(int lPass = 0; lPass < 20; lPass++)
+	{
+		for(size_t lIdx = 0; lIdx < arSounds.size(); lIdx++)
+		{
+			const std::vector<uint8_t>& lData = arSounds[lIdx].mData;
+			for(size_t lPos = 0; lPos + ADPCM_BLOCK_ALIGN <= lData.size(); lPos += ADPCM_BLOCK_ALIGN)
+			{
+				ImaAdpcm::tState lState;
+				laOut[0] = ImaAdpcm::ReadHeader(&lData[lPos], lState);
+				ImaAdpcm::Decode(lState, &lData[lPos + IMA_ADPCM_HEADER_SIZE],
+						         ADPCM_BLOCK_ALIGN - IMA_ADPCM_HEADER_SIZE, laOut + 1);
+				lSink += laOut[ADPCM_BLOCK_ALIGN];
+				lNumSamples += ImaAdpcm::SamplesPerBlock(ADPCM_BLOCK_ALIGN);
+			}
+
+			if(0 == lPass)
+			{
+				lAdpcmBytes += lData.size();
+			}
+		}
+	}
+	double lSeconds = (double)(clock() - lStart) / CLOCKS_PER_SEC;
+
+	printf("ADPCM: %llu bytes of PCM stored as %llu bytes (%.1fx smaller)\n",
+			(unsigned long long)aPcmBytes, (unsigned long long)lAdpcmBytes,
+			lAdpcmBytes ? (double)aPcmBytes / lAdpcmBytes : 0.0);
+	printf("ADPCM: decode %.2f ns/sample on this machine\n",
+			lNumSamples ? lSeconds * 1e9 / lNumSamples : 0.0);
+	printf("ADPCM: card traffic per 22.05 kHz voice %u -> %u bytes/s\n",
+			22050 * 2, 22050 * ADPCM_BLOCK_ALIGN / ImaAdpcm::SamplesPerBlock(ADPCM_BLOCK_ALIGN));
+}
+
+static uint32_t AlignUp(uint32_t aValue)
+{
+	return (aValue + FONT_PACK_ALIGNMENT - 1) & ~(uint32_t)(FONT_PACK_ALIGNMENT - 1);
+}
+
+int main(int argc, char** argv)
+{
+	bool lAdpcm = false;
+	SoundTypes::EChannelMapType lLayoutType = SoundTypes::eeClassicNEC;
+	bool lArgsValid = true;
+	int lArg = 1;
+
+	while(lArg < argc && '-' == argv[lArg][0] && lArgsValid)
+	{
+		if(0 == strcmp(argv[lArg], "--adpcm"))
+		{
+			lAdpcm = true;
+			lArg++;
+		}
+		else if(0 == strcmp(argv[lArg], "--layout") && lArg + 1 < argc)
+		{
+			lArgsValid = ParseLayout(argv[lArg + 1], lLayoutType);
+			lArg += 2;
+		}
+		else
+		{
+			lArgsValid = false;
+		}
+	}
+
+	if(!lArgsValid || argc - lArg < 2)
+	{
+		fprintf(stderr, "Usage: %s [--adpcm] [--layout nec|plecter|cfx] <font directory> <output file> [font name]\n", argv[0]);
+		return 1;
+	}
+
+	const char* lpDir = argv[lArg];
+	const char* lpOutPath = argv[lArg + 1];
+	const char* lpFontName = argc - lArg > 2 ? argv[lArg + 2] : "";
+
+	std::vector<tSound> lSounds;
+	uint64_t lPcmBytes = 0;
+
+	const FontLayout::tFontLayout& lLayout = FontLayout::GetLayout(lLayoutType);
+
+	for(int lType = 0; lType < lLayout.mNumNaming; lType++)
+	{
+		const FontLayout::tSoundNaming& lNaming = lLayout.mpNaming[lType];
+		bool lLooping = SoundTypes::eeHumSnd == lNaming.mSoundType
+						|| SoundTypes::eeLockupSnd == lNaming.mSoundType
+						|| SoundTypes::eeDragSnd == lNaming.mSoundType
+						|| SoundTypes::eeMeltSnd == lNaming.mSoundType;
+
+		for(int lIdx = 0; lIdx < lNaming.mMaxCount; lIdx++)
+		{
+			char laName[FONT_LAYOUT_MAX_NAME];
+			FontLayout::FormatName(lNaming, lIdx, laName);
+
+			char laPath[1024];
+			snprintf(laPath, sizeof(laPath), "%s/%s", lpDir, laName);
+
+			tSound lSound;
+			memset(&lSound.mEntry, 0, sizeof(lSound.mEntry));
+			if(!LoadWav(laPath, lSound))
+			{
+				//Numbering has no gaps, stop at the first missing file
+				break;
+			}
+
+			lSound.mEntry.mSoundType = lNaming.mSoundType;
+			lSound.mEntry.mIndex = lIdx;
+			lSound.mEntry.mFlags = lLooping ? FONT_PACK_FLAG_LOOP : 0;
+			lSounds.push_back(lSound);
+
+			printf("%-40s %7u bytes %5u Hz %u ch %2u bit\n", laPath,
+					lSound.mEntry.mDataLength, lSound.mEntry.mSampleRate,
+					lSound.mEntry.mNumChannels, lSound.mEntry.mBitsPerSample);
+
+			if(lAdpcm)
+			{
+				lPcmBytes += lSound.mData.size();
+				if(!ConvertToAdpcm(lSounds.back()))
+				{
+					fprintf(stderr, "%s: only PCM can be converted to ADPCM\n", laPath);
+					return 1;
+				}
+			}
+		}
+	}
+
+	if(lSounds.empty())
+	{
+		fprintf(stderr, "No %s sounds found in %s\n", lLayout.mpName, lpDir);
+		return 1;
+	}
+
+	if(lSounds.size() > FONT_PACK_MAX_ENTRIES)
+	{
+		fprintf(stderr, "Too many sounds (%u), the limit is %u\n",
+				(unsigned)lSounds.size(), (unsigned)FONT_PACK_MAX_ENTRIES);
+		return 1;
+	}
+
+	//Lay out the sample data, each sound starting on a sector boundary
+	uint32_t lOffset = AlignUp(sizeof(FontPack::tFontPackHeader)
+			                   + lSounds.size() * sizeof(FontPack::tFontPackEntry));
+
+	for(size_t lIdx = 0; lIdx < lSounds.size(); lIdx++)
+	{
+		lSounds[lIdx].mEntry.mDataOffset = lOffset;
+		lOffset = AlignUp(lOffset + lSounds[lIdx].mEntry.mDataLength);
+	}
+
+	FontPack::tFontPackHeader lHeader;
+	memset(&lHeader, 0, sizeof(lHeader));
+	memcpy(lHeader.maMagic, FONT_PACK_MAGIC, 4);
+	lHeader.mVersion = FONT_PACK_VERSION;
+	lHeader.mNumEntries = lSounds.size();
+	lHeader.mFileSize = lOffset;
+	strncpy(lHeader.maFontName, lpFontName, sizeof(lHeader.maFontName) - 1);
+
+	FILE* lpOut = fopen(lpOutPath, "wb");
+	if(nullptr == lpOut)
+	{
+		perror(lpOutPath);
+		return 1;
+	}
+
+	fwrite(&lHeader, sizeof(lHeader), 1, lpOut);
+	for(size_t lIdx = 0; lIdx < lSounds.size(); lIdx++)
+	{
+		fwrite(&lSounds[lIdx].mEntry, sizeof(FontPack::tFontPackEntry), 1, lpOut);
+	}
+
+	static const uint8_t saPadding[FONT_PACK_ALIGNMENT] = {0};
+	for(size_t lIdx = 0; lIdx < lSounds.size(); lIdx++)
+	{
+		const tSound& lSound = lSounds[lIdx];
+		long lPos = ftell(lpOut);
+		fwrite(saPadding, 1, lSound.mEntry.mDataOffset - lPos, lpOut);
+		fwrite(&lSound.mData[0], 1, lSound.mData.size(), lpOut);
+	}
+
+	long lPos = ftell(lpOut);
+	fwrite(saPadding, 1, lHeader.mFileSize - lPos, lpOut);
+
+	if(0 != fclose(lpOut))
+	{
+		perror(lpOutPath);
+		return 1;
+	}
+
+	if(lAdpcm)
+	{
+		BenchmarkAdpcm(lSounds, lPcmBytes);
+	}
+
+	printf("Wrote %u sounds, %u bytes to %s\n", (unsigned)lSounds.size(), lHeader.mFileSize, lpOutPath);
+
+	return 0;
+}
@@ -0,0 +1,178 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * srctables.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: JakeSoft
+ */
+
+/**
+ * Generates Sound/SrcTables.h, the polyphase filter tables SaberVoice uses
+ * to play WAV files whose sample rate differs from the output rate.
+ *
+ * Build on a PC:
+ *   g++ -O2 -o srctables srctables.cpp
+ *
+ * Usage:
+ *   srctables > ../../Sound/SrcTables.h
+ *
+ * Each table is a Kaiser windowed sinc low-pass cut into SRC_PHASES
+ * phases of SRC_TAPS taps. Phase p holds the taps for an output sample
+ * p / SRC_PHASES of the way between the two middle input samples. Taps of
+ * each phase sum to exactly 1.0 (Q15), so DC passes unchanged.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#define SRC_TAPS (8)
+#define SRC_PHASE_BITS (7)
+#define SRC_PHASES (1 << SRC_PHASE_BITS)
+
+//Kaiser window shape, higher trades a wider transition for less ripple
+#define KAISER_BETA (5.0)
+
+//A table to generate
+struct tTableSpec
+{
+	//Name of the array
+	const char* mpName;
+	//What it's for
+	const char* mpComment;
+	//Cutoff as a fraction of the input sample rate
+	double mCutoff;
+};
+
+static const tTableSpec saTables[] =
+{
+	{ "saUpTable", "Input rate below the output rate (11.025, 16, 22.05, 32 kHz). Cutoff\n//just under the input Nyquist to remove the images", 0.45 },
+	{ "saDownTable", "Input rate above the output rate, up to 48 kHz. Cutoff just under the\n//Nyquist of 44.1 kHz output from 48 kHz input", 0.42 },
+};
+
+/**
+ * Modified Bessel function of the first kind, order zero.
+ */
+static double Bessel0(double aX)
+{
+	double lSum = 1.0;
+	double lTerm = 1.0;
+	for(int lK = 1; lK < 30; lK++)
+	{
+		double lHalf = aX / (2.0 * lK);
+		lTerm *= lHalf * lHalf;
+		lSum += lTerm;
+	}
+
+	return lSum;
+}
+
+/**
+ * Prints one table.
+ */
+static void PrintTable(const tTableSpec& arSpec)
+{
+	printf("//%s\n", arSpec.mpComment);
+	printf("static const int16_t %s[SRC_PHASES][SRC_TAPS] =\n{\n", arSpec.mpName);
+
+	const double lHalfLen = SRC_TAPS / 2.0;
+
+	for(int lPhase = 0; lPhase < SRC_PHASES; lPhase++)
+	{
+		double lFrac = (double)lPhase / SRC_PHASES;
+		double laTaps[SRC_TAPS];
+		double lSum = 0.0;
+
+		for(int lTap = 0; lTap < SRC_TAPS; lTap++)
+		{
+			//Distance from this tap to the output position
+			double lT = (SRC_TAPS / 2 - 1) + lFrac - lTap;
+			double lX = 2.0 * arSpec.mCutoff * lT;
+			double lSinc = fabs(lX) < 1e-9 ? 1.0 : sin(M_PI * lX) / (M_PI * lX);
+			double lRatio = lT / lHalfLen;
+			double lWindow = fabs(lT) >= lHalfLen ? 0.0 : Bessel0(KAISER_BETA * sqrt(1.0 - lRatio * lRatio)) / Bessel0(KAISER_BETA);
+
+			laTaps[lTap] = lSinc * lWindow;
+			lSum += laTaps[lTap];
+		}
+
+		int laQ15[SRC_TAPS];
+		int lQ15Sum = 0;
+		for(int lTap = 0; lTap < SRC_TAPS; lTap++)
+		{
+			laQ15[lTap] = (int)lrint(laTaps[lTap] / lSum * 32768.0);
+			lQ15Sum += laQ15[lTap];
+		}
+
+		//Put the rounding error on the biggest tap
+		laQ15[SRC_TAPS / 2 - 1 + (lFrac >= 0.5 ? 1 : 0)] += 32768 - lQ15Sum;
+
+		printf("\t{");
+		for(int lTap = 0; lTap < SRC_TAPS; lTap++)
+		{
+			printf("%s%6d", 0 == lTap ? " " : ", ", laQ15[lTap]);
+		}
+		printf(" }%s\n", lPhase < SRC_PHASES - 1 ? "," : "");
+	}
+
+	printf("};\n\n");
+}
+
+int main()
+{
+	printf("%s", "/******************************************************************************\n"
+	       " * This library is free software; you can redistribute it and/or\n"
+	       " * modify it under the terms of the GNU Lesser General Public\n"
+	       " * License as published by the Free Software Foundation; either\n"
+	       " * version 2.1 of the License, or (at your option) any later version.\n"
+	       " *\n"
+	       " * This library is distributed in the hope that it will be useful,\n"
+	       " * but WITHOUT ANY WARRANTY; without even the implied warranty of\n"
+	       " * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU\n"
+	       " * Lesser General Public License for more details.\n"
+	       " * You should have received a copy of the GNU Lesser General Public\n"
+	       " * License along with this library; if not, write to the Free Software\n"
+	       " * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA\n"
+	       " ******************************************************************************/\n"
+	       "/*\n"
+	       " * SrcTables.h\n"
+	       " *\n"
+	       " *  Generated by tools/srctables, do not edit.\n"
+	       " */\n\n"
+	       "#ifndef SRCTABLES_H_\n"
+	       "#define SRCTABLES_H_\n\n"
+	       "#include <stdint.h>\n\n");
+
+	printf("//Input samples each output sample is made from\n#define SRC_TAPS (%d)\n\n", SRC_TAPS);
+	printf("//Fraction bits of the position between input samples used to pick a phase\n#define SRC_PHASE_BITS (%d)\n\n", SRC_PHASE_BITS);
+	printf("#define SRC_PHASES (1 << SRC_PHASE_BITS)\n\n");
+
+	printf("/**\n"
+	       " * Polyphase filters for sample rate conversion, Q15. Row p holds the\n"
+	       " * taps for an output sample p / SRC_PHASES of the way from input sample\n"
+	       " * SRC_TAPS / 2 - 1 to the next, oldest input sample first.\n"
+	       " */\n"
+	       "namespace SrcTables\n{\n\n");
+
+	for(unsigned lIdx = 0; lIdx < sizeof(saTables) / sizeof(saTables[0]); lIdx++)
+	{
+		PrintTable(saTables[lIdx]);
+	}
+
+	printf("} //namespace SrcTables\n\n#endif /* SRCTABLES_H_ */\n");
+
+	return 0;
+}